@@ -0,0 +1,55 @@
+// A $group whose input is sorted on the group key returns each group as soon as the key changes.
+// Check that it produces the same groups as an unsorted $group, including when some keys are
+// arrays and when the sort is provided by a multikey index.
+
+(function() {
+    'use strict';
+
+    var t = db.jstests_aggregation_stream_group;
+    t.drop();
+
+    for (var i = 0; i < 100; i++) {
+        assert.writeOK(t.insert({a: i % 7, b: i % 3, c: i}));
+    }
+    assert.writeOK(t.insert({b: 1, c: -1}));
+    assert.writeOK(t.insert({a: null, b: 2, c: -2}));
+
+    function sortById(results) {
+        return results.sort(function(x, y) {
+            return bsonWoCompare({_id: x._id}, {_id: y._id});
+        });
+    }
+
+    function assertSameGroups(sortSpec, groupSpec) {
+        var expected = sortById(t.aggregate([{$group: groupSpec}]).toArray());
+        var actual = t.aggregate([{$sort: sortSpec}, {$group: groupSpec}]).toArray();
+        assert.eq(expected.length, actual.length, tojson(actual));
+        assert.eq(expected, sortById(actual));
+    }
+
+    var groupOnA = {_id: '$a', n: {$sum: 1}, total: {$sum: '$c'}};
+    var groupOnAB = {_id: {a: '$a', b: '$b'}, n: {$sum: 1}, total: {$sum: '$c'}};
+
+    // In-pipeline sort.
+    assertSameGroups({a: 1}, groupOnA);
+    assertSameGroups({a: -1, c: 1}, groupOnA);
+    assertSameGroups({b: 1, a: -1}, groupOnAB);
+
+    // Sort provided by an index.
+    assert.commandWorked(t.ensureIndex({a: 1, b: 1}));
+    assertSameGroups({a: 1}, groupOnA);
+    assertSameGroups({a: 1, b: 1}, groupOnAB);
+
+    // Arrays sort by their smallest element, so documents with equal array keys are not
+    // necessarily adjacent. The index is now multikey as well.
+    assert.writeOK(t.insert({a: [1, 5], b: 0, c: 1000}));
+    assert.writeOK(t.insert({a: 1, b: 0, c: 1001}));
+    assert.writeOK(t.insert({a: [1, 5], b: 0, c: 1002}));
+    assertSameGroups({a: 1}, groupOnA);
+    assertSameGroups({a: 1, b: 1}, groupOnAB);
+
+    assert.commandWorked(t.dropIndexes());
+    assertSameGroups({a: 1}, groupOnA);
+    assertSameGroups({a: -1}, groupOnA);
+    assertSameGroups({a: 1, b: 1}, groupOnAB);
+})();
@@ -0,0 +1,38 @@
+// A $group whose input is sorted on the group key, or whose key is constant, holds only the
+// group in progress in memory. That group cannot be spilled to disk, so it is held to the $group
+// memory limit whether or not allowDiskUse is set.
+
+(function() {
+    'use strict';
+
+    var t = db.jstests_aggregation_stream_group_memory_limit;
+    t.drop();
+
+    var memoryLimitMB = 100;
+    var bigStr = Array(1024 * 1024 + 1).toString();  // 1MB of ','
+    for (var i = 0; i < memoryLimitMB + 1; i++) {
+        assert.writeOK(t.insert({a: 1, bigStr: i + bigStr}));
+    }
+    assert.commandWorked(t.ensureIndex({a: 1}));
+
+    var kStreamingGroupMemoryCode = 28801;
+
+    function assertExceedsLimit(pipeline) {
+        var res = t.runCommand('aggregate', {pipeline: pipeline});
+        assert.commandFailedWithCode(res, kStreamingGroupMemoryCode);
+
+        res = t.runCommand('aggregate', {pipeline: pipeline, allowDiskUse: true});
+        assert.commandFailedWithCode(res, kStreamingGroupMemoryCode);
+    }
+
+    // A constant key makes a single group.
+    assertExceedsLimit([{$group: {_id: null, bigStrs: {$push: '$bigStr'}}}]);
+
+    // The index provides the sort, and every document has the same key.
+    assertExceedsLimit([{$sort: {a: 1}}, {$group: {_id: '$a', bigStrs: {$push: '$bigStr'}}}]);
+
+    // The limit applies to each group in turn, not to all of the input.
+    var res = t.aggregate([{$sort: {bigStr: 1}}, {$group: {_id: '$bigStr', n: {$sum: 1}}}],
+                          {allowDiskUse: true});
+    assert.eq(memoryLimitMB + 1, res.itcount());
+})();
@@ -0,0 +1,56 @@
+// A $group whose input is sorted on the group key streams its groups, but $sort orders missing
+// values together with undefined ones and before null ones, while $group puts missing and null
+// values in the same group. Check that documents whose keys are missing, undefined and null, and
+// interleave in sort order, are grouped as an unsorted $group would group them.
+
+(function() {
+    'use strict';
+
+    var t = db.jstests_aggregation_stream_group_null_keys;
+    t.drop();
+
+    // Missing and undefined keys sort as equal, so they arrive in insertion order, interleaved.
+    for (var i = 0; i < 4; i++) {
+        assert.writeOK(t.insert({b: i % 2, c: i}));
+        assert.writeOK(t.insert({a: undefined, b: undefined, c: 10 + i}));
+        assert.writeOK(t.insert({a: null, b: null, c: 20 + i}));
+        assert.writeOK(t.insert({a: i, c: 30 + i}));
+    }
+    assert.eq(4, t.count({a: {$type: 6}}), 'expected undefined values to be stored as undefined');
+
+    function sortById(results) {
+        return results.sort(function(x, y) {
+            return bsonWoCompare({_id: x._id}, {_id: y._id});
+        });
+    }
+
+    function assertSameGroups(sortSpec, groupSpec) {
+        var expected = sortById(t.aggregate([{$group: groupSpec}]).toArray());
+        var actual = t.aggregate([{$sort: sortSpec}, {$group: groupSpec}]).toArray();
+        assert.eq(expected.length, actual.length, tojson(actual));
+        assert.eq(expected, sortById(actual));
+    }
+
+    var groupOnA = {_id: '$a', n: {$sum: 1}, cs: {$push: '$c'}};
+    var groupOnAB = {_id: {a: '$a', b: '$b'}, n: {$sum: 1}, cs: {$push: '$c'}};
+
+    // Missing and null values of 'a' share one group, and undefined values have their own.
+    var groups = t.aggregate([{$sort: {a: 1}}, {$group: groupOnA}]).toArray();
+    assert.eq(6, groups.length, tojson(groups));
+    groups.forEach(function(group) {
+        if (group._id === null) {
+            assert.eq(8, group.n, tojson(groups));
+        }
+    });
+
+    // In-pipeline sort.
+    assertSameGroups({a: 1}, groupOnA);
+    assertSameGroups({a: -1}, groupOnA);
+    assertSameGroups({a: 1, b: 1}, groupOnAB);
+    assertSameGroups({a: 1, b: -1}, groupOnAB);
+
+    // Sort provided by an index.
+    assert.commandWorked(t.ensureIndex({a: 1, b: 1}));
+    assertSameGroups({a: 1}, groupOnA);
+    assertSameGroups({a: 1, b: 1}, groupOnAB);
+})();
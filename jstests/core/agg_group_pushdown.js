@@ -0,0 +1,79 @@
+// Tests that a $group which only counts the documents from the $match before it, or which only
+// finds the distinct values of an indexed field, is answered from the index without fetching any
+// documents, and gives the same results as when it reads every document.
+(function() {
+    'use strict';
+
+    load('jstests/libs/analyze_plan.js');
+
+    var coll = db.jstests_agg_group_pushdown;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        var doc = {a: i % 10, b: i};
+        if (i % 100 === 0) {
+            delete doc.a;
+        }
+        bulk.insert(doc);
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.ensureIndex({a: 1}));
+    assert.commandWorked(coll.ensureIndex({b: 1}));
+
+    function runPipeline(pipeline) {
+        return coll.aggregate(pipeline).toArray().sort(function(x, y) {
+            return bsonWoCompare(x, y);
+        });
+    }
+
+    // Runs 'pipeline' both as it is and with a $project in front of its $group, which keeps the
+    // $group from being pushed down, and checks that the results match.
+    function assertSameResults(match, group) {
+        var pushed = runPipeline([{$match: match}, {$group: group}]);
+        var unpushed =
+            runPipeline([{$match: match}, {$project: {a: 1, b: 1}}, {$group: group}]);
+        assert.eq(unpushed, pushed, tojson({match: match, group: group}));
+        return pushed;
+    }
+
+    function cursorStage(pipeline) {
+        return coll.aggregate(pipeline, {explain: true}).stages[0].$cursor;
+    }
+
+    var count = {_id: null, n: {$sum: 1}, twice: {$sum: 2}};
+
+    // Counts over one interval, several intervals and no interval.
+    var res = assertSameResults({a: {$gte: 3, $lte: 5}}, count);
+    assert.eq([{_id: null, n: 300, twice: 600}], res);
+    res = assertSameResults({a: {$in: [1, 4, 8]}}, count);
+    assert.eq([{_id: null, n: 300, twice: 600}], res);
+    res = assertSameResults({b: {$in: [1, 2, 500, 2000]}}, count);
+    assert.eq([{_id: null, n: 3, twice: 6}], res);
+    assertSameResults({}, count);
+    assert.eq([], assertSameResults({a: 42}, count));
+
+    var explain = cursorStage([{$match: {a: {$in: [1, 4, 8]}}}, {$group: count}]);
+    assert(planHasStage(explain.queryPlanner.winningPlan, 'COUNT_SCAN'), tojson(explain));
+    assert(!planHasStage(explain.queryPlanner.winningPlan, 'FETCH'), tojson(explain));
+    assert(explain.hasOwnProperty('countGroup'), tojson(explain));
+
+    // A predicate the index can't answer alone still gives the right count.
+    assertSameResults({a: 3, b: {$mod: [7, 0]}}, count);
+
+    // Distinct values of an indexed field, including null for the documents which lack it.
+    var distinct = {_id: '$a'};
+    res = assertSameResults({}, distinct);
+    assert.eq(11, res.length);
+    assertSameResults({a: {$gt: 6}}, distinct);
+
+    explain = cursorStage([{$match: {a: {$gt: 6}}}, {$group: distinct}]);
+    assert(planHasStage(explain.queryPlanner.winningPlan, 'DISTINCT_SCAN'), tojson(explain));
+
+    // Once the index is multikey, the distinct values in it are no longer the group keys.
+    assert.writeOK(coll.insert({a: [1, 2]}));
+    res = assertSameResults({}, distinct);
+    assert.eq(12, res.length);
+    explain = cursorStage([{$match: {a: {$gt: 6}}}, {$group: distinct}]);
+    assert(!planHasStage(explain.queryPlanner.winningPlan, 'DISTINCT_SCAN'), tojson(explain));
+})();
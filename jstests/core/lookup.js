@@ -0,0 +1,95 @@
+// Tests $lookup joined through an index on the foreign field and through a hash table built from
+// the foreign collection. Each input document must be joined with exactly the foreign documents
+// that match {<foreignField>: {$eq: <value of localField>}}.
+(function() {
+    'use strict';
+
+    var local = db.jstests_lookup_local;
+    var foreign = db.jstests_lookup_foreign;
+    local.drop();
+    foreign.drop();
+
+    var localDocs = [
+        {_id: 0, a: 1},
+        {_id: 1, a: 2},
+        {_id: 2, a: [1, 3]},
+        {_id: 3},
+        {_id: 4, a: null},
+        {_id: 5, a: NumberLong(3)},
+        {_id: 6, a: {x: 1}},
+        {_id: 7, a: 'str'},
+    ];
+    localDocs.forEach(function(doc) {
+        assert.writeOK(local.insert(doc));
+    });
+
+    var foreignDocs = [
+        {_id: 0, b: 1},
+        {_id: 1, b: [2, 3]},
+        {_id: 2, b: 1.0},
+        {_id: 3},
+        {_id: 4, b: null},
+        {_id: 5, b: [[1, 3], 4]},
+        {_id: 6, b: {x: 1}},
+        {_id: 7, b: [{x: 1}]},
+        {_id: 8, c: {d: 3}},
+        {_id: 9, c: [{d: 3}, {d: [1, 'str']}]},
+        {_id: 10, b: 'str'},
+    ];
+    foreignDocs.forEach(function(doc) {
+        assert.writeOK(foreign.insert(doc));
+    });
+
+    function byId(x, y) {
+        return x._id - y._id;
+    }
+
+    function checkJoin(localField, foreignField) {
+        var results = local.aggregate([
+                               {
+                                 $lookup: {
+                                     from: foreign.getName(),
+                                     localField: localField,
+                                     foreignField: foreignField,
+                                     as: 'joined'
+                                 }
+                               },
+                               {$sort: {_id: 1}}
+                           ]).toArray();
+        assert.eq(localDocs.length, results.length);
+
+        results.forEach(function(doc) {
+            var query = {};
+            query[foreignField] = {$eq: doc.hasOwnProperty(localField) ? doc[localField] : null};
+            var expected = foreign.find(query).toArray().sort(byId);
+            assert.eq(expected, doc.joined.sort(byId), tojson({doc: doc, query: query}));
+        });
+    }
+
+    // Without an index, the foreign collection is read into a hash table.
+    checkJoin('a', 'b');
+    checkJoin('a', 'c.d');
+    checkJoin('missing', 'b');
+
+    // With an index on the foreign field, each input document is joined through it.
+    assert.commandWorked(foreign.ensureIndex({b: 1}));
+    checkJoin('a', 'b');
+
+    // A missing 'from' collection is empty.
+    var missingFrom = {from: 'jstests_lookup_none', localField: 'a', foreignField: 'b', as: 'j'};
+    var results = local.aggregate([{$lookup: missingFrom}]).toArray();
+    assert.eq(localDocs.length, results.length);
+    results.forEach(function(doc) {
+        assert.eq([], doc.j);
+    });
+
+    // Invalid specifications are rejected.
+    function assertLookupFails(spec, code) {
+        assert.commandFailedWithCode(
+            db.runCommand({aggregate: local.getName(), pipeline: [{$lookup: spec}]}), code);
+    }
+    assertLookupFails('str', 28796);
+    assertLookupFails({from: 1, localField: 'a', foreignField: 'b', as: 'c'}, 28797);
+    assertLookupFails({from: 'f', localField: 'a', foreignField: 'b', as: 'c', x: 'y'}, 28798);
+    assertLookupFails({from: 'f', localField: 'a', as: 'c'}, 28799);
+})();
@@ -0,0 +1,127 @@
+// Tests that map functions which emit a field and reduce functions which sum their values, which
+// the server runs without calling into JavaScript, give the same results as when they are run in
+// JavaScript.
+(function() {
+    'use strict';
+
+    var coll = db.mr_native;
+    coll.drop();
+    var out = db.mr_native_out;
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 500; i++) {
+        var doc = {
+            _id: i,
+            a: i % 7,
+            b: {c: 'k' + (i % 5)},
+            n: i * 1.5,
+            ni: NumberInt(i),
+            nl: NumberLong(i)
+        };
+        if (i % 50 === 0) {
+            delete doc.a;
+        }
+        if (i % 60 === 0) {
+            doc.a = [1, 2];
+        }
+        if (i % 70 === 0) {
+            doc.b = 'not an object';
+        }
+        if (i % 80 === 0) {
+            doc.n = 'not a number';
+        }
+        bulk.insert(doc);
+    }
+    assert.writeOK(bulk.execute());
+
+    function sortById(results) {
+        return results.sort(function(x, y) {
+            return bsonWoCompare({_id: x._id}, {_id: y._id});
+        });
+    }
+
+    // Runs the mapReduce with 'options' both as it is and with a scope, which keeps the functions
+    // in JavaScript, and checks that the results match.
+    function assertSameResults(map, reduce, options) {
+        options = Object.extend({out: {inline: 1}}, options || {});
+        var inJS = Object.extend({scope: {unused: 1}}, options);
+
+        var nativeRes = coll.mapReduce(map, reduce, options);
+        assert.commandWorked(nativeRes);
+        var nativeOut = sortById(options.out.inline ? nativeRes.results : out.find().toArray());
+
+        var jsRes = coll.mapReduce(map, reduce, inJS);
+        assert.commandWorked(jsRes);
+        var jsOut = sortById(options.out.inline ? jsRes.results : out.find().toArray());
+
+        assert.eq(jsOut, nativeOut, tojson({map: map, reduce: reduce}));
+        assert.eq(jsRes.counts.input, nativeRes.counts.input);
+        assert.eq(jsRes.counts.emit, nativeRes.counts.emit);
+        assert.eq(jsRes.counts.output, nativeRes.counts.output);
+        return nativeOut;
+    }
+
+    var arraySum = function(key, values) {
+        return Array.sum(values);
+    };
+    var loopSum = function(key, values) {
+        var sum = 0;
+        for (var i = 0; i < values.length; i++) {
+            sum += values[i];
+        }
+        return sum;
+    };
+
+    // Counts by a field which is sometimes missing or an array.
+    var res = assertSameResults(function() {
+        emit(this.a, 1);
+    }, arraySum);
+    assert.eq(9, res.length);
+    assertSameResults(function() {
+        emit(this.a, 1);
+    }, loopSum);
+
+    // Sums of doubles, ints, longs and a field which is sometimes a string.
+    [function() {
+        emit(this.a, this.n);
+    },
+     function() {
+         emit(this.a, this.ni);
+     },
+     function() {
+         emit(this.a, this.nl);
+     }].forEach(function(map) {
+        assertSameResults(map, arraySum);
+        assertSameResults(map, loopSum);
+    });
+
+    // A dotted path whose parent is sometimes not an object.
+    res = assertSameResults(function() {
+        emit(this.b.c, -2.5);
+    }, loopSum);
+    assert.eq(6, res.length);
+
+    // A map function which isn't run natively with a reduce function which is, and the other way
+    // around.
+    assertSameResults(function() {
+        emit(this.a, this.n * 2);
+    }, arraySum);
+    assertSameResults(function() {
+        emit(this.a, this.n);
+    }, function(key, values) {
+        return values.length;
+    });
+
+    // Output to a collection, with a query, sort, limit and finalizer.
+    assertSameResults(function() {
+        emit(this.b.c, this.n);
+    }, arraySum, {
+        out: out.getName(),
+        query: {_id: {$gte: 100}},
+        sort: {_id: 1},
+        limit: 300,
+        finalize: function(key, value) {
+            return {total: value};
+        }
+    });
+})();
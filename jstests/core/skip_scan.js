@@ -0,0 +1,65 @@
+// Tests that a compound index can answer a query over its trailing fields by skipping from one
+// value of the leading field to the next.
+(function() {
+    'use strict';
+
+    load('jstests/libs/analyze_plan.js');
+
+    var coll = db.jstests_skip_scan;
+    coll.drop();
+
+    var kNumLeading = 5;
+    var kNumTrailing = 2000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var a = 0; a < kNumLeading; a++) {
+        for (var b = 0; b < kNumTrailing; b++) {
+            bulk.insert({a: a, b: b, c: b % 3});
+        }
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.ensureIndex({a: 1, b: 1}));
+
+    function sortedResults(cursor) {
+        return cursor.toArray().sort(function(x, y) {
+            return (x.a - y.a) || (x.b - y.b);
+        });
+    }
+
+    // A point predicate on the trailing field.
+    var explain = coll.find({b: 17}).explain('executionStats');
+    assert(planHasStage(explain.queryPlanner.winningPlan, 'SKIP_SCAN'), tojson(explain));
+    assert.eq(kNumLeading, explain.executionStats.nReturned, tojson(explain));
+    assert.lt(explain.executionStats.totalKeysExamined, 5 * kNumLeading, tojson(explain));
+
+    // The results match those of a collection scan, including for a range which spans several
+    // batches and a predicate the index can't answer.
+    var queries = [{b: 17}, {b: {$gte: 100, $lt: 140}}, {b: {$in: [3, 1999, 4000]}, c: 0}];
+    queries.forEach(function(query) {
+        assert.eq(sortedResults(coll.find(query, {_id: 0}).batchSize(7)),
+                  sortedResults(coll.find(query, {_id: 0}).hint({$natural: 1})),
+                  tojson(query));
+    });
+
+    // A skip scan provides the index's sort in either direction.
+    [1, -1].forEach(function(dir) {
+        var sortedQuery = coll.find({b: {$in: [5, 6]}}, {_id: 0, c: 0}).sort({a: dir, b: dir});
+        explain = sortedQuery.explain('executionStats');
+        assert(planHasStage(explain.queryPlanner.winningPlan, 'SKIP_SCAN'), tojson(explain));
+        assert(!planHasStage(explain.queryPlanner.winningPlan, 'SORT'), tojson(explain));
+
+        var expected = [];
+        for (var a = 0; a < kNumLeading; a++) {
+            expected.push({a: a, b: 5}, {a: a, b: 6});
+        }
+        if (dir === -1) {
+            expected.reverse();
+        }
+        assert.eq(expected, sortedQuery.batchSize(3).toArray(), tojson({dir: dir}));
+    });
+
+    // A multikey index can't be skip-scanned.
+    assert.writeOK(coll.insert({a: [1, 2], b: 17}));
+    explain = coll.find({b: 17}).explain('executionStats');
+    assert(!planHasStage(explain.queryPlanner.winningPlan, 'SKIP_SCAN'), tojson(explain));
+    assert.eq(kNumLeading + 1, explain.executionStats.nReturned, tojson(explain));
+})();
@@ -0,0 +1,60 @@
+// Tests that an awaitData getMore on a capped collection returns as soon as a concurrent insert
+// commits, rather than waiting out its maxTimeMS.
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    var db = conn.getDB('test');
+    var collName = 'awaitdata_commit_notify';
+    var coll = db[collName];
+
+    coll.drop();
+    assert.commandWorked(db.createCollection(collName, {capped: true, size: 4096}));
+    assert.writeOK(coll.insert({_id: 0}));
+
+    var cmdRes = db.runCommand({find: collName, batchSize: 1, tailable: true, awaitData: true});
+    assert.commandWorked(cmdRes);
+    assert.gt(cmdRes.cursor.id, NumberLong(0));
+    assert.eq(cmdRes.cursor.firstBatch.length, 1);
+    var cursorId = cmdRes.cursor.id;
+
+    // Nothing new arrives: the getMore waits for its full maxTimeMS and returns an empty batch.
+    var start = new Date();
+    cmdRes = db.runCommand({getMore: cursorId, collection: collName, maxTimeMS: 500});
+    assert.commandWorked(cmdRes);
+    assert.eq(cmdRes.cursor.nextBatch.length, 0);
+    var elapsed = new Date() - start;
+    assert.gte(elapsed, 400);
+    assert.lt(elapsed, 10 * 1000, tojson(cmdRes));
+
+    // Without its own maxTimeMS the getMore waits for the one second awaitData default, then
+    // returns an empty batch and leaves the cursor open.
+    start = new Date();
+    cmdRes = db.runCommand({getMore: cursorId, collection: collName});
+    assert.commandWorked(cmdRes);
+    assert.eq(cmdRes.cursor.nextBatch.length, 0);
+    assert.eq(cmdRes.cursor.id, cursorId);
+    elapsed = new Date() - start;
+    assert.gte(elapsed, 900);
+    assert.lt(elapsed, 10 * 1000, tojson(cmdRes));
+
+    // An insert made while the getMore is waiting wakes it up well before its maxTimeMS.
+    var kMaxTimeMS = 20 * 1000;
+    var awaitShell = startParallelShell(function() {
+        sleep(500);
+        assert.writeOK(db.awaitdata_commit_notify.insert({_id: 1}));
+    }, conn.port);
+
+    start = new Date();
+    cmdRes = db.runCommand({getMore: cursorId, collection: collName, maxTimeMS: kMaxTimeMS});
+    elapsed = new Date() - start;
+    awaitShell();
+
+    assert.commandWorked(cmdRes);
+    assert.eq(cmdRes.cursor.nextBatch, [{_id: 1}]);
+    assert.lt(elapsed, kMaxTimeMS / 2, tojson(cmdRes));
+    print('awaitData getMore returned after ' + elapsed + 'ms');
+
+    MongoRunner.stopMongod(conn);
+})();
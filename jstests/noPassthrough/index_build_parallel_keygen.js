@@ -0,0 +1,71 @@
+// Builds indexes in the foreground with keys generated on several threads and checks that they
+// match the same indexes built on a single thread. This includes multikey, partial, unique and
+// sparse indexes.
+
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod({setParameter: 'indexBuildKeyGenerationThreads=4'});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    var testDB = conn.getDB('test');
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, indexBuildSorterParallelism: 2}));
+    var coll = testDB.index_build_parallel_keygen;
+    coll.drop();
+
+    var kNumDocs = 100 * 1000;
+    var padding = new Array(100).join('x');
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < kNumDocs; i++) {
+        var doc = {u: i, a: i % 1000, s: padding + (i % 7)};
+        if (i % 3 === 0) {
+            doc.m = [i, i + 1, i % 5];
+        }
+        bulk.insert(doc);
+    }
+    assert.writeOK(bulk.execute());
+
+    var specs = [
+        {key: {a: 1, s: -1}, name: 'a_s'},
+        {key: {m: 1}, name: 'm'},
+        {key: {u: 1}, name: 'u', unique: true},
+        {key: {m: 1, a: 1}, name: 'm_a_sparse', sparse: true},
+        {key: {a: 1}, name: 'a_partial', partialFilterExpression: {a: {$gt: 500}}},
+    ];
+
+    function buildAndCount() {
+        assert.commandWorked(coll.dropIndexes());
+        assert.commandWorked(testDB.runCommand({createIndexes: coll.getName(), indexes: specs}));
+        assert.commandWorked(coll.validate(true));
+
+        var counts = {};
+        specs.forEach(function(spec) {
+            counts[spec.name] = coll.find().hint(spec.name).itcount();
+        });
+        counts.firstKeys = coll.find({}, {_id: 0, a: 1, s: 1})
+                               .hint('a_s')
+                               .limit(20)
+                               .toArray();
+        return counts;
+    }
+
+    var parallel = buildAndCount();
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, indexBuildKeyGenerationThreads: 1}));
+    var serial = buildAndCount();
+    assert.eq(serial, parallel);
+
+    // Duplicate keys still fail the build.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, indexBuildKeyGenerationThreads: 4}));
+    assert.writeOK(coll.insert({u: 17}));
+    assert.commandWorked(coll.dropIndexes());
+    assert.commandFailedWithCode(coll.ensureIndex({u: 1}, {unique: true}),
+                                 ErrorCodes.DuplicateKey);
+
+    // So do documents that can't be indexed.
+    assert.writeOK(coll.insert({p: [1, 2], q: [3, 4]}));
+    assert.commandFailed(coll.ensureIndex({p: 1, q: 1}));
+    assert.eq(1, coll.getIndexes().length);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,74 @@
+// Inserts from one write command are grouped into a single WriteUnitOfWork. Check that a failure
+// within a group is still reported against the right document, for ordered and unordered
+// batches, and that the outcome matches inserting every document on its own.
+
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    var testDB = conn.getDB('test');
+    var coll = testDB.insert_batch_fallback;
+
+    function runBatches() {
+        var results = {};
+
+        // A duplicate _id in the middle of an ordered batch stops the batch there.
+        coll.drop();
+        var docs = [];
+        for (var i = 0; i < 200; i++) {
+            docs.push({_id: i, x: i});
+        }
+        docs[150] = {_id: 10, x: 150};
+        var res = testDB.runCommand({insert: coll.getName(), documents: docs, ordered: true});
+        assert.eq(150, res.n, tojson(res));
+        assert.eq(1, res.writeErrors.length, tojson(res));
+        assert.eq(150, res.writeErrors[0].index, tojson(res));
+        results.ordered = coll.find().sort({_id: 1}).toArray();
+
+        // An unordered batch inserts everything else.
+        coll.drop();
+        res = testDB.runCommand({insert: coll.getName(), documents: docs, ordered: false});
+        assert.eq(199, res.n, tojson(res));
+        assert.eq(1, res.writeErrors.length, tojson(res));
+        assert.eq(150, res.writeErrors[0].index, tojson(res));
+        results.unordered = coll.find().sort({_id: 1}).toArray();
+
+        // Unique secondary index violations are reported the same way.
+        coll.drop();
+        assert.commandWorked(coll.ensureIndex({u: 1}, {unique: true}));
+        docs = [];
+        for (var i = 0; i < 100; i++) {
+            docs.push({_id: i, u: (i === 70 || i === 90) ? 5 : i});
+        }
+        res = testDB.runCommand({insert: coll.getName(), documents: docs, ordered: false});
+        assert.eq(98, res.n, tojson(res));
+        var errorIndexes = res.writeErrors.map(function(e) {
+            return e.index;
+        });
+        assert.eq([70, 90], errorIndexes, tojson(res));
+        results.unique = coll.find().sort({_id: 1}).toArray();
+
+        // Capped collections keep only the newest documents.
+        coll.drop();
+        assert.commandWorked(
+            testDB.createCollection(coll.getName(), {capped: true, size: 100000, max: 50}));
+        docs = [];
+        for (var i = 0; i < 120; i++) {
+            docs.push({_id: i});
+        }
+        assert.commandWorked(testDB.runCommand({insert: coll.getName(), documents: docs}));
+        results.capped = coll.find().sort({$natural: 1}).toArray();
+        assert.eq(50, results.capped.length);
+        assert.eq(70, results.capped[0]._id);
+
+        return results;
+    }
+
+    var batched = runBatches();
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, internalInsertMaxBatchSize: 1}));
+    var single = runBatches();
+    assert.eq(single, batched);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,140 @@
+// Tests the workerPool listenerMode: a connection storm is serviced correctly in both modes, a
+// client which stalls in the middle of a message does not hold up the other connections, and
+// requests which block for a long time cannot starve the request that would unblock them.
+
+(function() {
+    'use strict';
+
+    var kNumConnections = 300;
+    var kOpsPerConnection = 10;
+
+    function connectionStorm(mongo) {
+        var host = mongo.host;
+
+        var conns = [];
+        for (var i = 0; i < kNumConnections; i++) {
+            conns.push(new Mongo(host));
+        }
+
+        // Interleave requests across all connections so that many of them are open and idle
+        // between requests, which is what the worker pool multiplexes.
+        for (var op = 0; op < kOpsPerConnection; op++) {
+            for (var i = 0; i < conns.length; i++) {
+                var coll = conns[i].getDB('test').storm;
+                assert.writeOK(coll.insert({conn: i, op: op}));
+                assert.eq(op + 1, coll.find({conn: i}).itcount());
+            }
+        }
+
+        var serverStatus = assert.commandWorked(mongo.getDB('admin').serverStatus());
+        assert.gte(serverStatus.connections.current, kNumConnections, tojson(serverStatus));
+        assert.eq(kNumConnections * kOpsPerConnection, mongo.getDB('test').storm.count());
+    }
+
+    function runStorm(mode) {
+        var mongo = MongoRunner.runMongod({setParameter: 'listenerMode=' + mode});
+        assert.neq(null, mongo, 'mongod failed to start with listenerMode ' + mode);
+        var isLinux = mongo.getDB('admin').hostInfo().os.type == 'Linux';
+
+        connectionStorm(mongo);
+
+        MongoRunner.stopMongod(mongo);
+        return isLinux;
+    }
+
+    // Starts a mongod which processes a single request at a time, unless requests block.
+    function runSingleWorkerMongod() {
+        var mongo = MongoRunner.runMongod({
+            setParameter: {
+                listenerMode: 'workerPool',
+                listenerWorkerThreads: 1,
+                listenerMaxWorkerThreads: 1
+            }
+        });
+        assert.neq(null, mongo, 'mongod failed to start with a single listener worker');
+        return mongo;
+    }
+
+    function currentConnections(mongo) {
+        return assert.commandWorked(mongo.getDB('admin').serverStatus()).connections.current;
+    }
+
+    // Clients which send the first bytes of a message header and then stall must not keep the
+    // worker from servicing other connections.
+    function testStalledClients() {
+        var mongo = runSingleWorkerMongod();
+        var kNumStalledClients = 4;
+        var connsBefore = currentConnections(mongo);
+
+        // Each client sends 5 bytes of a header announcing a 58 byte message, then stalls.
+        var pids = [];
+        for (var i = 0; i < kNumStalledClients; i++) {
+            pids.push(startMongoProgramNoConnect(
+                'bash',
+                '-c',
+                'exec 3<>/dev/tcp/127.0.0.1/' + mongo.port +
+                    ' && printf "\\x3a\\x00\\x00\\x00\\x01" >&3 && sleep 600'));
+        }
+        assert.soon(function() {
+            return currentConnections(mongo) >= connsBefore + kNumStalledClients;
+        }, 'stalled clients failed to connect');
+
+        // Both an existing and a new connection are still serviced promptly.
+        var start = new Date();
+        var coll = mongo.getDB('test').stalled_clients;
+        assert.writeOK(coll.insert({_id: 0}));
+        assert.eq(1, coll.find().itcount());
+        var other = new Mongo(mongo.host);
+        assert.commandWorked(other.getDB('admin').runCommand({ping: 1}));
+        assert.eq(1, other.getDB('test').stalled_clients.find().itcount());
+        var elapsed = new Date() - start;
+        assert.lt(elapsed, 10 * 1000, 'requests were held up by stalled clients');
+
+        pids.forEach(function(pid) {
+            stopMongoProgramByPid(pid);
+        });
+        MongoRunner.stopMongod(mongo);
+    }
+
+    // Writes blocked behind fsyncLock must not keep the fsyncUnlock which releases them from
+    // being processed.
+    function testFsyncLockCycle() {
+        var mongo = runSingleWorkerMongod();
+        var kNumBlockedWriters = 3;
+        var admin = mongo.getDB('admin');
+
+        assert.commandWorked(admin.fsyncLock());
+
+        var writers = [];
+        for (var i = 0; i < kNumBlockedWriters; i++) {
+            writers.push(startParallelShell(
+                'assert.writeOK(db.getSiblingDB("test").fsync_lock_cycle.insert({w: ' + i + '}));',
+                mongo.port));
+        }
+
+        // Wait for every write to be blocked, each of them occupying a worker for as long as the
+        // server stays locked.
+        assert.soon(function() {
+            var ops = admin.currentOp({ns: 'test.fsync_lock_cycle', waitingForLock: true}).inprog;
+            return ops.length == kNumBlockedWriters;
+        }, 'writes did not block behind fsyncLock');
+
+        assert.commandWorked(admin.fsyncUnlock());
+        writers.forEach(function(awaitShell) {
+            assert.eq(0, awaitShell());
+        });
+        assert.eq(kNumBlockedWriters, mongo.getDB('test').fsync_lock_cycle.count());
+
+        MongoRunner.stopMongod(mongo);
+    }
+
+    // The worker pool is only available on Linux.
+    if (runStorm('threadPerConnection')) {
+        runStorm('workerPool');
+        testStalledClients();
+        testFsyncLockCycle();
+    }
+
+    // Unknown modes are rejected at startup.
+    assert.eq(null, MongoRunner.runMongod({setParameter: 'listenerMode=bogus'}));
+})();
@@ -0,0 +1,74 @@
+// Checks that plan cache entries saved to local.system.plancache are restored after a restart,
+// both into the collection they were saved from and into another collection with identically
+// specified indexes.
+
+(function() {
+    'use strict';
+
+    var dbpath = MongoRunner.dataPath + 'plan_cache_persistence';
+    resetDbpath(dbpath);
+
+    function startMongod() {
+        var conn = MongoRunner.runMongod({
+            dbpath: dbpath,
+            noCleanData: true,
+            setParameter: 'planCachePersistenceIntervalSecs=1',
+        });
+        assert.neq(null, conn, 'mongod was unable to start up');
+        assert.commandWorked(
+            conn.adminCommand({setParameter: 1, planCachePersistenceEnabled: true}));
+        return conn;
+    }
+
+    function numShapes(coll) {
+        var res = assert.commandWorked(coll.runCommand('planCacheListQueryShapes'));
+        return res.shapes.length;
+    }
+
+    var query = {a: {$gte: 90}, b: 5};
+
+    var conn = startMongod();
+    var testDB = conn.getDB('test');
+    var coll = testDB.plan_cache_persistence;
+    var other = testDB.plan_cache_persistence_other;
+
+    [coll, other].forEach(function(c) {
+        for (var i = 0; i < 100; i++) {
+            assert.writeOK(c.insert({a: i, b: i % 10}));
+        }
+        assert.commandWorked(c.ensureIndex({a: 1}));
+        assert.commandWorked(c.ensureIndex({b: 1}));
+    });
+
+    // Only 'coll' is queried, so only it has a cache entry before the restart.
+    assert.eq(1, coll.find(query).itcount());
+    assert.eq(1, numShapes(coll));
+    assert.eq(0, numShapes(other));
+
+    assert.soon(function() {
+        return conn.getDB('local').system.plancache.count() > 0;
+    }, 'plan cache entries were not saved');
+
+    MongoRunner.stopMongod(conn);
+
+    conn = startMongod();
+    testDB = conn.getDB('test');
+    coll = testDB.plan_cache_persistence;
+    other = testDB.plan_cache_persistence_other;
+
+    assert.soon(function() {
+        return numShapes(coll) == 1 && numShapes(other) == 1;
+    }, 'plan cache entries were not restored');
+
+    // The restored entries are used to answer the query.
+    assert.eq(1, coll.find(query).itcount());
+    assert.eq(1, other.find(query).itcount());
+    assert.eq(1, numShapes(coll));
+
+    // Dropping an index invalidates the restored entry.
+    assert.commandWorked(other.dropIndex({b: 1}));
+    assert.eq(0, numShapes(other));
+    assert.eq(1, other.find(query).itcount());
+
+    MongoRunner.stopMongod(conn);
+})();
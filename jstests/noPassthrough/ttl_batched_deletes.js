@@ -0,0 +1,48 @@
+// Tests that the TTL monitor deletes the expired documents of several indexes in batches, and
+// reports its batches and lag in serverStatus.
+(function() {
+    "use strict";
+    var runner = MongoRunner.runMongod({
+        setParameter: {
+            ttlMonitorSleepSecs: 1,
+            ttlMonitorMaxConcurrentIndexes: 2,
+            ttlMonitorDeleteBatchSize: 10,
+            ttlMonitorMaxDeletesPerSecond: 1000
+        }
+    });
+    var testDB = runner.getDB("test");
+
+    var metrics = testDB.serverStatus().metrics.ttl;
+    assert(metrics.hasOwnProperty("pendingIndexes"), tojson(metrics));
+    assert(metrics.hasOwnProperty("lagMillis"), tojson(metrics));
+    var batchesBefore = metrics.deleteBatches;
+
+    // Each collection has 100 documents which expired an hour ago and 10 which never expire.
+    var hourAgo = new Date(new Date().getTime() - 3600 * 1000);
+    var colls = [testDB.ttl_batched_a, testDB.ttl_batched_b, testDB.ttl_batched_c];
+    colls.forEach(function(coll) {
+        coll.drop();
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < 100; i++) {
+            bulk.insert({x: hourAgo});
+        }
+        for (var i = 0; i < 10; i++) {
+            bulk.insert({x: i});
+        }
+        assert.writeOK(bulk.execute());
+        assert.commandWorked(coll.ensureIndex({x: 1}, {expireAfterSeconds: 60}));
+    });
+
+    assert.soon(function() {
+        return colls.every(function(coll) {
+            return coll.count() === 10;
+        });
+    }, "TTL monitor didn't delete the expired documents before timing out.");
+
+    metrics = testDB.serverStatus().metrics.ttl;
+    assert.lte(300, metrics.deletedDocuments, tojson(metrics));
+    assert.lte(batchesBefore + 30, metrics.deleteBatches, tojson(metrics));
+    assert.lte(0, metrics.lagMillis, tojson(metrics));
+
+    MongoRunner.stopMongod(runner);
+})();
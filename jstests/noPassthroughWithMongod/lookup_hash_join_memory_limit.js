@@ -0,0 +1,78 @@
+// Tests that $lookup gives the same results when the foreign collection does not fit in the memory
+// allowed for its hash table, both when the join sorts each side to disk instead and, without
+// allowDiskUse, when each input document is joined by querying the foreign collection.
+(function() {
+    'use strict';
+
+    var local = db.lookup_memory_limit_local;
+    var foreign = db.lookup_memory_limit_foreign;
+    local.drop();
+    foreign.drop();
+
+    var bulk = local.initializeUnorderedBulkOp();
+    for (var i = 0; i < 100; i++) {
+        bulk.insert({_id: i, a: i % 10});
+    }
+    assert.writeOK(bulk.execute());
+
+    bulk = foreign.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, b: i % 20, padding: new Array(100).join('x')});
+    }
+    assert.writeOK(bulk.execute());
+
+    var pipeline = [
+        {$lookup: {from: foreign.getName(), localField: 'a', foreignField: 'b', as: 'joined'}},
+        {$sort: {_id: 1}}
+    ];
+
+    function runLookup(options) {
+        var results = local.aggregate(pipeline, options).toArray();
+        results.forEach(function(doc) {
+            doc.joined.sort(function(x, y) {
+                return x._id - y._id;
+            });
+        });
+        return results;
+    }
+
+    function explainStrategy() {
+        var res = db.runCommand({aggregate: local.getName(), pipeline: pipeline, explain: true});
+        assert.commandWorked(res);
+        return res.stages[1].$lookup.strategy;
+    }
+
+    assert.eq('hashJoin', explainStrategy());
+    var hashed = runLookup();
+    assert.eq(100, hashed.length);
+    hashed.forEach(function(doc) {
+        assert.eq(50, doc.joined.length, tojson(doc));
+    });
+
+    var res = db.adminCommand({getParameter: 1, internalLookupHashJoinMaxMemoryBytes: 1});
+    assert.commandWorked(res);
+    var original = res.internalLookupHashJoinMaxMemoryBytes;
+
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalLookupHashJoinMaxMemoryBytes: 10 * 1024}));
+    try {
+        assert.eq(hashed, runLookup({allowDiskUse: true}));
+        assert.eq(hashed, runLookup());
+
+        // Documents lacking either field, or holding arrays, are joined as by the hash table.
+        assert.writeOK(local.insert([{_id: 100}, {_id: 101, a: [1, 2]}, {_id: 102, a: null}]));
+        assert.writeOK(foreign.insert([{_id: 1000}, {_id: 1001, b: [1, null]}]));
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalLookupHashJoinMaxMemoryBytes: original}));
+        hashed = runLookup();
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalLookupHashJoinMaxMemoryBytes: 10 * 1024}));
+        assert.eq(hashed, runLookup({allowDiskUse: true}));
+    } finally {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalLookupHashJoinMaxMemoryBytes: original}));
+    }
+
+    assert.commandWorked(foreign.ensureIndex({b: 1}));
+    assert.eq('indexedLoop', explainStrategy());
+})();
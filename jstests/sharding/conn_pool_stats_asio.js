@@ -0,0 +1,40 @@
+// Tests that connPoolStats on mongos reports the connections pooled by the ASIO network interface
+// behind the sharding task executor.
+(function() {
+    'use strict';
+
+    var st = new ShardingTest({
+        shards: 1,
+        mongos: 1,
+        other: {mongosOptions: {setParameter: 'outboundNetworkImpl=ASIO'}}
+    });
+
+    var mongos = st.s0;
+    var coll = mongos.getDB('test').conn_pool_stats_asio;
+    assert.writeOK(coll.insert({_id: 0}));
+
+    // The find command runs on the shards through the sharding task executor. Run it more than
+    // once, so that a later run can reuse a pooled connection.
+    for (var i = 0; i < 3; i++) {
+        var findRes = coll.runCommand('find', {filter: {_id: 0}});
+        assert.commandWorked(findRes);
+        assert.eq(findRes.cursor.firstBatch, [{_id: 0}]);
+    }
+
+    var res = mongos.getDB('admin').runCommand({connPoolStats: 1});
+    assert.commandWorked(res);
+    printjson(res);
+
+    var stats = res.shardingTaskExecutor;
+    assert(stats, 'connPoolStats is missing shardingTaskExecutor: ' + tojson(res));
+    assert.gte(stats.totalCreated, 1, tojson(stats));
+    assert.gte(stats.totalReused, 1, tojson(stats));
+    assert.gte(stats.totalAvailable, 0, tojson(stats));
+
+    var shardHost = mongos.getDB('config').shards.findOne().host;
+    assert(stats.hosts[shardHost], 'no pool stats for ' + shardHost + ': ' + tojson(stats));
+    assert.gte(stats.hosts[shardHost].created, 1, tojson(stats));
+    assert.gte(stats.hosts[shardHost].available, 0, tojson(stats));
+
+    st.stop();
+})();
@@ -0,0 +1,56 @@
+//
+// Tests that many operations finding a mongos's routing information stale at the same time, as
+// after a migration, all get correct results while they share one refresh of it.
+//
+(function() {
+    'use strict';
+
+    var st = new ShardingTest({shards: 2, mongos: 2});
+    st.stopBalancer();
+
+    var mongos0DB = st.s0.getDB('test');
+    var mongos1DB = st.s1.getDB('test');
+
+    assert.commandWorked(mongos0DB.adminCommand({enableSharding: 'test'}));
+    st.ensurePrimaryShard('test', 'shard0000');
+    assert.commandWorked(mongos0DB.adminCommand({shardCollection: 'test.user', key: {x: 1}}));
+    for (var x = 10; x < 100; x += 10) {
+        assert.commandWorked(mongos0DB.adminCommand({split: 'test.user', middle: {x: x}}));
+    }
+
+    var bulk = mongos0DB.user.initializeUnorderedBulkOp();
+    for (var i = 0; i < 100; i++) {
+        bulk.insert({x: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Load the routing information on the second mongos before the chunks move.
+    assert.eq(100, mongos1DB.user.find().itcount());
+
+    for (x = 0; x < 100; x += 20) {
+        assert.commandWorked(mongos0DB.adminCommand(
+            {moveChunk: 'test.user', find: {x: x}, to: 'shard0001', _waitForDelete: true}));
+    }
+
+    // Every one of these finds the second mongos stale.
+    var parallelCode = 'var coll = db.getSiblingDB("test").user;' +
+        'for (var i = 0; i < 10; i++) {' +
+        '    var x = (i * 37) % 100;' +
+        '    assert.eq(1, coll.find({x: x}).itcount(), tojson({x: x}));' +
+        '    assert.eq(100, coll.find().itcount());' +
+        '}';
+    var awaitShells = [];
+    for (i = 0; i < 8; i++) {
+        awaitShells.push(startParallelShell(parallelCode, st.s1.port));
+    }
+    awaitShells.forEach(function(awaitShell) {
+        awaitShell();
+    });
+
+    assert.eq(100, mongos1DB.user.find().itcount());
+    for (x = 0; x < 100; x += 10) {
+        assert.eq(10, mongos1DB.user.find({x: {$gte: x, $lt: x + 10}}).itcount());
+    }
+
+    st.stop();
+})();
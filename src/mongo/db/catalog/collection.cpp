@@ -295,12 +295,7 @@ StatusWith<RecordId> Collection::insertDocument(OperationContext* txn,
     // we cannot call into the OpObserver here because the document being written is not present
     // fortunately, this is currently only used for adding entries to the oplog.
 
-    // If there is a notifier object and another thread is waiting on it, then we notify waiters
-    // of this document insert. Waiters keep a shared_ptr to '_cappedNotifier', so there are
-    // waiters if this Collection's shared_ptr is not unique.
-    if (_cappedNotifier && !_cappedNotifier.unique()) {
-        _cappedNotifier->notifyOfInsert();
-    }
+    _notifyCappedWaitersOnCommit(txn);
 
     return StatusWith<RecordId>(loc);
 }
@@ -334,17 +329,49 @@ StatusWith<RecordId> Collection::insertDocument(OperationContext* txn,
     if (res.isOK()) {
         getGlobalServiceContext()->getOpObserver()->onInsert(txn, ns(), docToInsert, fromMigrate);
 
-        // If there is a notifier object and another thread is waiting on it, then we notify
-        // waiters of this document insert. Waiters keep a shared_ptr to '_cappedNotifier', so
-        // there are waiters if this Collection's shared_ptr is not unique.
-        if (_cappedNotifier && !_cappedNotifier.unique()) {
-            _cappedNotifier->notifyOfInsert();
-        }
+        _notifyCappedWaitersOnCommit(txn);
     }
 
     return res;
 }
 
+Status Collection::insertDocuments(OperationContext* txn,
+                                   const vector<BSONObj>::const_iterator begin,
+                                   const vector<BSONObj>::const_iterator end,
+                                   bool enforceQuota,
+                                   bool fromMigrate) {
+    const bool hasIdIndex = _indexCatalog.findIdIndex(txn);
+    for (auto it = begin; it != end; ++it) {
+        if (hasIdIndex && (*it)["_id"].eoo()) {
+            return Status(ErrorCodes::InternalError,
+                          str::stream() << "Collection::insertDocuments got "
+                                           "document without _id for ns:" << _ns.ns());
+        }
+
+        auto status = checkValidation(txn, *it);
+        if (!status.isOK())
+            return status;
+    }
+
+    const SnapshotId sid = txn->recoveryUnit()->getSnapshotId();
+
+    if (_mustTakeCappedLockOnInsert)
+        synchronizeOnCappedInFlightResource(txn->lockState());
+
+    Status status = _insertDocuments(txn, begin, end, enforceQuota);
+    if (!status.isOK())
+        return status;
+    invariant(sid == txn->recoveryUnit()->getSnapshotId());
+
+    for (auto it = begin; it != end; ++it) {
+        getGlobalServiceContext()->getOpObserver()->onInsert(txn, ns(), *it, fromMigrate);
+    }
+
+    _notifyCappedWaitersOnCommit(txn);
+
+    return Status::OK();
+}
+
 StatusWith<RecordId> Collection::insertDocument(OperationContext* txn,
                                                 const BSONObj& doc,
                                                 MultiIndexBlock* indexBlock,
@@ -372,12 +399,7 @@ StatusWith<RecordId> Collection::insertDocument(OperationContext* txn,
 
     getGlobalServiceContext()->getOpObserver()->onInsert(txn, ns(), doc);
 
-    // If there is a notifier object and another thread is waiting on it, then we notify waiters
-    // of this document insert. Waiters keep a shared_ptr to '_cappedNotifier', so there are
-    // waiters if this Collection's shared_ptr is not unique.
-    if (_cappedNotifier && !_cappedNotifier.unique()) {
-        _cappedNotifier->notifyOfInsert();
-    }
+    _notifyCappedWaitersOnCommit(txn);
 
     return loc;
 }
@@ -406,6 +428,46 @@ StatusWith<RecordId> Collection::_insertDocument(OperationContext* txn,
     return loc;
 }
 
+Status Collection::_insertDocuments(OperationContext* txn,
+                                    const vector<BSONObj>::const_iterator begin,
+                                    const vector<BSONObj>::const_iterator end,
+                                    bool enforceQuota) {
+    dassert(txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IX));
+
+    if (isCapped()) {
+        // Making room in a capped collection can delete earlier documents of the batch before
+        // they have been indexed, so capped inserts are done one document at a time.
+        for (auto it = begin; it != end; ++it) {
+            StatusWith<RecordId> loc = _insertDocument(txn, *it, enforceQuota);
+            if (!loc.isOK())
+                return loc.getStatus();
+        }
+        return Status::OK();
+    }
+
+    vector<Record> records;
+    records.reserve(std::distance(begin, end));
+    for (auto it = begin; it != end; ++it) {
+        records.push_back({RecordId(), RecordData(it->objdata(), it->objsize())});
+    }
+
+    Status status = _recordStore->insertRecords(txn, &records, _enforceQuota(enforceQuota));
+    if (!status.isOK())
+        return status;
+
+    vector<BsonRecord> bsonRecords;
+    bsonRecords.reserve(records.size());
+    auto doc = begin;
+    for (const auto& record : records) {
+        invariant(RecordId::min() < record.id);
+        invariant(record.id < RecordId::max());
+        bsonRecords.push_back({record.id, &(*doc)});
+        ++doc;
+    }
+
+    return _indexCatalog.indexRecords(txn, bsonRecords);
+}
+
 Status Collection::aboutToDeleteCapped(OperationContext* txn,
                                        const RecordId& loc,
                                        RecordData data) {
@@ -645,6 +707,45 @@ std::shared_ptr<CappedInsertNotifier> Collection::getCappedInsertNotifier() cons
     return _cappedNotifier;
 }
 
+void Collection::notifyCappedWaitersIfNeeded() {
+    if (_cappedNotifier && !_cappedNotifier.unique()) {
+        _cappedNotifier->notifyOfInsert();
+    }
+}
+
+/**
+ * Wakes awaitData queries once the documents inserted by a unit of work become visible. Storage
+ * engines that hide committed documents behind earlier uncommitted ones (e.g. the WiredTiger
+ * oplog) notify again when those are resolved.
+ *
+ * Holds its own reference to the notifier, since the collection may be dropped before the unit
+ * of work commits.
+ */
+class Collection::CappedInsertCommitChange : public RecoveryUnit::Change {
+public:
+    explicit CappedInsertCommitChange(std::shared_ptr<CappedInsertNotifier> notifier)
+        : _notifier(std::move(notifier)) {}
+
+    void commit() final {
+        // Waiters hold references of their own, so there is someone to wake only if this change
+        // and the collection are not the sole owners.
+        if (_notifier.use_count() > 2) {
+            _notifier->notifyOfInsert();
+        }
+    }
+
+    void rollback() final {}
+
+private:
+    const std::shared_ptr<CappedInsertNotifier> _notifier;
+};
+
+void Collection::_notifyCappedWaitersOnCommit(OperationContext* txn) {
+    if (_cappedNotifier) {
+        txn->recoveryUnit()->registerChange(new CappedInsertCommitChange(_cappedNotifier));
+    }
+}
+
 uint64_t Collection::numRecords(OperationContext* txn) const {
     return _recordStore->numRecords(txn);
 }
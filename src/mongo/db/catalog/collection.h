@@ -33,6 +33,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
@@ -102,7 +103,8 @@ struct CompactStats {
 
 /**
  * Queries with the awaitData option use this notifier object to wait for more data to be
- * inserted into the capped collection.
+ * inserted into the capped collection. Waiters are notified once inserted documents become
+ * visible, that is when the inserting unit of work commits.
  */
 class CappedInsertNotifier {
 public:
@@ -228,6 +230,18 @@ public:
                                         bool enforceQuota,
                                         bool fromMigrate = false);
 
+    /**
+     * Inserts the documents in [begin, end) as insertDocument() would, but through one
+     * RecordStore::insertRecords() call and one pass over each index. Either every document is
+     * inserted or, on failure, the caller must abandon the WriteUnitOfWork; the returned status
+     * does not say which document failed.
+     */
+    Status insertDocuments(OperationContext* txn,
+                           std::vector<BSONObj>::const_iterator begin,
+                           std::vector<BSONObj>::const_iterator end,
+                           bool enforceQuota,
+                           bool fromMigrate = false);
+
     /**
      * Callers must ensure no document validation is performed for this collection when calling
      * this method.
@@ -385,6 +399,21 @@ private:
 
     Status aboutToDeleteCapped(OperationContext* txn, const RecordId& loc, RecordData data);
 
+    /**
+     * If there is a notifier object and another thread is waiting on it, notifies waiters of new
+     * data. Waiters keep a shared_ptr to '_cappedNotifier', so there are waiters if this
+     * Collection's shared_ptr is not unique.
+     */
+    void notifyCappedWaitersIfNeeded();
+
+    class CappedInsertCommitChange;
+
+    /**
+     * Arranges for waiters on '_cappedNotifier' to be notified when the current unit of work
+     * commits. Does nothing unless the collection is capped.
+     */
+    void _notifyCappedWaitersOnCommit(OperationContext* txn);
+
     /**
      * same semantics as insertDocument, but doesn't do:
      *  - some user error checks
@@ -394,6 +423,11 @@ private:
                                          const BSONObj& doc,
                                          bool enforceQuota);
 
+    Status _insertDocuments(OperationContext* txn,
+                            std::vector<BSONObj>::const_iterator begin,
+                            std::vector<BSONObj>::const_iterator end,
+                            bool enforceQuota);
+
     bool _enforceQuota(bool userEnforeQuota) const;
 
     int _magic;
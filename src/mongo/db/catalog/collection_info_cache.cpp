@@ -137,7 +137,26 @@ QuerySettings* CollectionInfoCache::getQuerySettings() const {
     return _querySettings.get();
 }
 
-void CollectionInfoCache::updatePlanCacheIndexEntries(OperationContext* txn) {
+size_t CollectionInfoCache::restorePlanCacheEntries(
+    OperationContext* txn, const std::vector<BSONObj>& serializedEntries) {
+    dassert(txn->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_IS));
+    const std::vector<IndexEntry> indexEntries = getPlanCacheIndexEntries(txn);
+
+    size_t numRestored = 0;
+    for (const BSONObj& serialized : serializedEntries) {
+        Status status = _planCache->restoreEntry(serialized, indexEntries);
+        if (!status.isOK()) {
+            LOG(2) << _collection->ns().ns() << ": not restoring plan cache entry "
+                   << serialized["query"] << ": " << status;
+            continue;
+        }
+        ++numRestored;
+    }
+    return numRestored;
+}
+
+std::vector<IndexEntry> CollectionInfoCache::getPlanCacheIndexEntries(
+    OperationContext* txn) const {
     std::vector<IndexEntry> indexEntries;
 
     // TODO We shouldn't need to include unfinished indexes, but we must here because the index
@@ -158,6 +177,10 @@ void CollectionInfoCache::updatePlanCacheIndexEntries(OperationContext* txn) {
                                   desc->infoObj());
     }
 
-    _planCache->notifyOfIndexEntries(indexEntries);
+    return indexEntries;
+}
+
+void CollectionInfoCache::updatePlanCacheIndexEntries(OperationContext* txn) {
+    _planCache->notifyOfIndexEntries(getPlanCacheIndexEntries(txn));
 }
 }
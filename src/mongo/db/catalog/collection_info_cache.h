@@ -84,6 +84,16 @@ public:
 
     void clearQueryCache();
 
+    /**
+     * Adds the plan cache entries in 'serializedEntries', as produced by
+     * PlanCache::serializeEntries() for a collection with the same index fingerprint, to this
+     * collection's plan cache. Entries which cannot be restored are skipped.
+     *
+     * Returns the number of entries restored. Callers must hold the collection lock.
+     */
+    size_t restorePlanCacheEntries(OperationContext* txn,
+                                   const std::vector<BSONObj>& serializedEntries);
+
 private:
     Collection* _collection;  // not owned
 
@@ -104,6 +114,8 @@ private:
     void computeIndexKeys(OperationContext* txn);
 
     void updatePlanCacheIndexEntries(OperationContext* txn);
+
+    std::vector<IndexEntry> getPlanCacheIndexEntries(OperationContext* txn) const;
 };
 
 }  // namespace mongo
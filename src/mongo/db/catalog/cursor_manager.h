@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <array>
 
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/invalidation_type.h"
@@ -44,6 +45,15 @@ class OperationContext;
 class PseudoRandom;
 class PlanExecutor;
 
+/**
+ * Tracks the ClientCursors and the yielding PlanExecutors of one collection, or of the global
+ * cursor manager.
+ *
+ * Cursors and executors are spread over a fixed number of partitions, each guarded by its own
+ * mutex, so that getMores, killCursors and executor registration on different cursors of a busy
+ * collection don't serialize on a single lock. A cursor's partition is chosen by the random low
+ * bits of its id. Operations that visit every cursor lock the partitions one at a time.
+ */
 class CursorManager {
 public:
     CursorManager(StringData ns);
@@ -56,6 +66,9 @@ public:
     // -----------------
 
     /**
+     * Partitions are invalidated one at a time; callers exclude concurrent registration with the
+     * collection lock.
+     *
      * @param collectionGoingAway Pass as true if the Collection instance is going away.
      *                            This could be because the db is being closed, or the
      *                            collection/db is being dropped.
@@ -143,19 +156,36 @@ public:
     static std::size_t timeoutCursorsGlobal(OperationContext* txn, int millisSinceLastCall);
 
 private:
-    CursorId _allocateCursorId_inlock();
-    void _deregisterCursor_inlock(ClientCursor* cc);
+    typedef unordered_set<PlanExecutor*> ExecSet;
+    typedef std::map<CursorId, ClientCursor*> CursorMap;
+
+    // Must be a power of two.
+    static const size_t kNumPartitions = 16;
+
+    struct Partition {
+        // Guards the members below, and the pinned state of the cursors in 'cursors'.
+        mutable SimpleMutex mutex;
+
+        ExecSet nonCachedExecutors;
+        CursorMap cursors;
+    };
+
+    Partition& _partitionForCursor(CursorId id);
+    const Partition& _partitionForCursor(CursorId id) const;
+    Partition& _partitionForExecutor(PlanExecutor* exec);
+
+    /**
+     * Returns a new random id in this manager's id space. The caller must check that it is not in
+     * use.
+     */
+    CursorId _generateCursorId();
 
     NamespaceString _nss;
     unsigned _collectionCacheRuntimeId;
-    std::unique_ptr<PseudoRandom> _random;
 
-    mutable SimpleMutex _mutex;
-
-    typedef unordered_set<PlanExecutor*> ExecSet;
-    ExecSet _nonCachedExecutors;
+    SimpleMutex _randomMutex;
+    std::unique_ptr<PseudoRandom> _random;
 
-    typedef std::map<CursorId, ClientCursor*> CursorMap;
-    CursorMap _cursors;
+    std::array<Partition, kNumPartitions> _partitions;
 };
 }
@@ -1175,6 +1175,20 @@ Status IndexCatalog::indexRecord(OperationContext* txn, const BSONObj& obj, cons
     return Status::OK();
 }
 
+Status IndexCatalog::indexRecords(OperationContext* txn,
+                                  const std::vector<BsonRecord>& bsonRecords) {
+    for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
+         ++i) {
+        for (const auto& bsonRecord : bsonRecords) {
+            Status s = _indexRecord(txn, *i, *bsonRecord.docPtr, bsonRecord.id);
+            if (!s.isOK())
+                return s;
+        }
+    }
+
+    return Status::OK();
+}
+
 void IndexCatalog::unindexRecord(OperationContext* txn,
                                  const BSONObj& obj,
                                  const RecordId& loc,
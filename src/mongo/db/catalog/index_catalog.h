@@ -46,6 +46,14 @@ class Collection;
 class IndexDescriptor;
 class IndexAccessMethod;
 
+/**
+ * A document and the RecordId it was inserted at, as passed to IndexCatalog::indexRecords().
+ */
+struct BsonRecord {
+    RecordId id;
+    const BSONObj* docPtr;
+};
+
 /**
  * how many: 1 per Collection
  * lifecycle: attached to a Collection
@@ -265,6 +273,13 @@ public:
     // this throws for now
     Status indexRecord(OperationContext* txn, const BSONObj& obj, const RecordId& loc);
 
+    /**
+     * Indexes a batch of newly inserted documents. Each index is updated with the whole batch
+     * before moving to the next one, so consecutive key inserts go to the same index. On failure
+     * the caller must abandon the WriteUnitOfWork, as earlier keys are not removed.
+     */
+    Status indexRecords(OperationContext* txn, const std::vector<BsonRecord>& bsonRecords);
+
     void unindexRecord(OperationContext* txn, const BSONObj& obj, const RecordId& loc, bool noWarn);
 
     // ------- temp internal -------
@@ -47,6 +47,8 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/future.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/processinfo.h"
@@ -58,6 +60,10 @@ using std::unique_ptr;
 using std::string;
 using std::endl;
 
+// Number of threads that generate and sort keys during foreground index builds. Documents are
+// always read by the thread building the indexes. 1 generates keys on that thread as well.
+MONGO_EXPORT_SERVER_PARAMETER(indexBuildKeyGenerationThreads, int, 1);
+
 /**
  * On rollback sets MultiIndexBlock::_needToCleanup to true.
  */
@@ -92,6 +98,129 @@ private:
     MultiIndexBlock* const _indexer;
 };
 
+/**
+ * Generates keys for bulk index builds on several threads.
+ *
+ * Documents are copied into batches, and each batch is handed to the next worker in turn. Every
+ * worker inserts the keys it generates into its own BulkBuilder for each index, so workers share
+ * no mutable state. finish() merges the workers' BulkBuilders into the BulkBuilders of
+ * _indexes, which then merge the workers' sorted keys in commitBulk().
+ */
+class MultiIndexBlock::ParallelKeyGenerator {
+    MONGO_DISALLOW_COPYING(ParallelKeyGenerator);
+
+public:
+    ParallelKeyGenerator(const std::vector<IndexToBuild>* indexes, size_t numWorkers)
+        : _indexes(indexes), _workers(numWorkers) {
+        // Split the memory budget of a single BulkBuilder between the workers.
+        const size_t maxMemoryUsageBytes =
+            IndexAccessMethod::BulkBuilder::kMaxMemoryUsageBytes / numWorkers;
+        for (auto&& worker : _workers) {
+            for (auto&& index : *_indexes) {
+                worker.bulks.push_back(index.real->initiateBulk(maxMemoryUsageBytes));
+            }
+        }
+    }
+
+    /**
+     * Queues 'doc' to have its keys generated. Returns the first error hit by a worker, if any.
+     */
+    Status insert(const BSONObj& doc, const RecordId& loc) {
+        _batch.push_back(std::make_pair(doc.getOwned(), loc));
+        if (_batch.size() < kBatchSize)
+            return Status::OK();
+
+        return dispatch();
+    }
+
+    /**
+     * Waits for all queued documents to be processed and merges the keys generated by the
+     * workers into the BulkBuilders of _indexes.
+     */
+    Status finish() {
+        Status status = dispatch();
+        for (auto&& worker : _workers) {
+            Status workerStatus = wait(&worker);
+            if (status.isOK())
+                status = workerStatus;
+        }
+        if (!status.isOK())
+            return status;
+
+        for (auto&& worker : _workers) {
+            for (size_t i = 0; i < _indexes->size(); i++) {
+                (*_indexes)[i].bulk->mergeFrom(std::move(worker.bulks[i]));
+            }
+        }
+        return Status::OK();
+    }
+
+private:
+    typedef std::vector<std::pair<BSONObj, RecordId>> Batch;
+
+    static const size_t kBatchSize = 1000;
+
+    struct Worker {
+        std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>> bulks;  // parallel to _indexes
+        stdx::future<Status> pending;  // must be destroyed before 'bulks' since it uses them
+    };
+
+    Status dispatch() {
+        if (_batch.empty())
+            return Status::OK();
+
+        Worker* worker = &_workers[_nextWorker];
+        _nextWorker = (_nextWorker + 1) % _workers.size();
+
+        // A worker works on one batch at a time. This also bounds the number of documents that
+        // have been read but not yet indexed.
+        Status status = wait(worker);
+        if (!status.isOK())
+            return status;
+
+        std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+        batch->swap(_batch);
+        const std::vector<IndexToBuild>* indexes = _indexes;
+        worker->pending = stdx::async(stdx::launch::async, [indexes, worker, batch] {
+            return generateKeys(*indexes, worker, *batch);
+        });
+        return Status::OK();
+    }
+
+    static Status wait(Worker* worker) {
+        if (!worker->pending.valid())
+            return Status::OK();
+        return worker->pending.get();
+    }
+
+    static Status generateKeys(const std::vector<IndexToBuild>& indexes,
+                               Worker* worker,
+                               const Batch& batch) {
+        for (auto&& doc : batch) {
+            for (size_t i = 0; i < indexes.size(); i++) {
+                if (indexes[i].filterExpression &&
+                    !indexes[i].filterExpression->matchesBSON(doc.first)) {
+                    continue;
+                }
+
+                // BulkBuilder::insert() only generates keys, so it doesn't need an
+                // OperationContext, which couldn't be used from this thread anyway.
+                int64_t unused;
+                Status status = worker->bulks[i]->insert(
+                    NULL, doc.first, doc.second, indexes[i].options, &unused);
+                if (!status.isOK())
+                    return status;
+            }
+        }
+        return Status::OK();
+    }
+
+    const std::vector<IndexToBuild>* const _indexes;
+    std::vector<Worker> _workers;
+    size_t _nextWorker = 0;
+    Batch _batch;
+};
+
 MultiIndexBlock::MultiIndexBlock(OperationContext* txn, Collection* collection)
     : _collection(collection),
       _txn(txn),
@@ -239,6 +368,14 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
         exec->setYieldPolicy(PlanExecutor::WRITE_CONFLICT_RETRY_ONLY);
     }
 
+    // Bulk builds only need keys generated and sorted until doneInserting(), so that work can be
+    // spread across threads. Background builds write each document's keys to the index as they
+    // go and must stay on this thread.
+    std::unique_ptr<ParallelKeyGenerator> keyGenerator;
+    if (!_buildInBackground && indexBuildKeyGenerationThreads > 1) {
+        keyGenerator.reset(new ParallelKeyGenerator(&_indexes, indexBuildKeyGenerationThreads));
+    }
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -261,7 +398,8 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
             progress->setTotalWhileRunning(_collection->numRecords(_txn));
 
             WriteUnitOfWork wunit(_txn);
-            Status ret = insert(objToIndex.value(), loc);
+            Status ret = keyGenerator ? keyGenerator->insert(objToIndex.value(), loc)
+                                      : insert(objToIndex.value(), loc);
             if (ret.isOK()) {
                 wunit.commit();
             } else if (dupsOut && ret.code() == ErrorCodes::DuplicateKey) {
@@ -300,6 +438,12 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
         uasserted(28550, "Unable to complete index build as the collection is no longer readable");
     }
 
+    if (keyGenerator) {
+        Status status = keyGenerator->finish();
+        if (!status.isOK())
+            return status;
+    }
+
     progress->finished();
 
     Status ret = doneInserting(dupsOut);
@@ -89,6 +89,18 @@ void Client::initThread(const char* desc, ServiceContext* service, AbstractMessa
     *currentClient.get() = service->makeClient(fullDesc, mp);
 }
 
+ServiceContext::UniqueClient Client::releaseCurrent() {
+    invariant(currentClient.getMake()->get());
+    return std::move(*currentClient.get());
+}
+
+void Client::setCurrent(ServiceContext::UniqueClient client) {
+    invariant(client);
+    invariant(currentClient.getMake()->get() == nullptr);
+    setThreadName(client->desc().c_str());
+    *currentClient.get() = std::move(client);
+}
+
 namespace {
 int64_t generateSeed(const std::string& desc) {
     size_t seed = 0;
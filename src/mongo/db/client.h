@@ -75,6 +75,19 @@ public:
      */
     static void initThreadIfNotAlready();
 
+    /**
+     * Detaches the Client bound to the calling thread and returns ownership of it to the caller,
+     * leaving the thread without a Client. Used to move a connection's Client between threads
+     * when connections are multiplexed over a pool of workers.
+     */
+    static ServiceContext::UniqueClient releaseCurrent();
+
+    /**
+     * Binds "client" to the calling thread, which must not already have a Client, and sets the
+     * thread name to the client's description.
+     */
+    static void setCurrent(ServiceContext::UniqueClient client);
+
     std::string clientAddress(bool includePort = false) const;
     const std::string& desc() const {
         return _desc;
@@ -154,8 +154,14 @@ struct Cloner::Fun {
             MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "createCollection", to_collection.ns());
         }
 
+        // Documents read from the current batch that have not been inserted yet. They are
+        // inserted together before yielding, and at the end of the batch.
+        std::vector<BSONObj> docs;
+
         while (i.moreInCurrentBatch()) {
             if (numSeen % 128 == 127) {
+                insertDocuments(collection, &docs);
+
                 time_t now = time(0);
                 if (now - lastLog >= 60) {
                     // report progress
@@ -217,28 +223,40 @@ struct Cloner::Fun {
 
             verify(collection);
             ++numSeen;
-            MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
-                if (_mayBeInterrupted) {
-                    txn->checkForInterrupt();
-                }
-
-                WriteUnitOfWork wunit(txn);
-
-                BSONObj doc = tmp;
-                StatusWith<RecordId> loc = collection->insertDocument(txn, doc, true);
-                if (!loc.isOK()) {
-                    error() << "error: exception cloning object in " << from_collection << ' '
-                            << loc.getStatus() << " obj:" << doc;
-                }
-                uassertStatusOK(loc.getStatus());
-                wunit.commit();
-            }
-            MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "cloner insert", to_collection.ns());
+            docs.push_back(tmp);
             RARELY if (time(0) - saveLast > 60) {
                 log() << numSeen << " objects cloned so far from collection " << from_collection;
                 saveLast = time(0);
             }
         }
+
+        insertDocuments(collection, &docs);
+    }
+
+    // Inserts 'docs' into 'collection' in one WriteUnitOfWork and clears it.
+    void insertDocuments(Collection* collection, std::vector<BSONObj>* docs) {
+        if (docs->empty()) {
+            return;
+        }
+
+        MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+            if (_mayBeInterrupted) {
+                txn->checkForInterrupt();
+            }
+
+            WriteUnitOfWork wunit(txn);
+
+            Status status = collection->insertDocuments(txn, docs->begin(), docs->end(), true);
+            if (!status.isOK()) {
+                error() << "error: exception cloning " << docs->size() << " objects in "
+                        << from_collection << ' ' << status;
+            }
+            uassertStatusOK(status);
+            wunit.commit();
+        }
+        MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "cloner insert", to_collection.ns());
+
+        docs->clear();
     }
 
     time_t lastLog;
@@ -55,7 +55,10 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata.h"
+#include "mongo/executor/network_interface.h"
 #include "mongo/s/client/shard_connection.h"
+#include "mongo/s/client/shard_registry.h"
+#include "mongo/s/grid.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/s/write_ops/wc_error_detail.h"
 #include "mongo/util/log.h"
@@ -558,6 +561,13 @@ public:
         globalConnPool.appendInfo(result);
         result.append("numDBClientConnection", DBClientConnection::getNumConnections());
         result.append("numAScopedConnection", AScopedConnection::getNumConnections());
+
+        // Connections pooled by the network interface behind the sharding task executor.
+        if (auto shardRegistry = grid.shardRegistry()) {
+            BSONObjBuilder shardingBuilder(result.subobjStart("shardingTaskExecutor"));
+            shardRegistry->getNetwork()->appendConnectionStats(&shardingBuilder);
+            shardingBuilder.done();
+        }
         return true;
     }
     virtual bool slaveOk() const {
@@ -313,6 +313,8 @@ public:
         BSONObj obj;
         PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
         long long numResults = 0;
+        cursorExec->setNumResultsWanted(
+            pq.getEffectiveBatchSize().value_or(LiteParsedQuery::kDefaultBatchSize));
         while (!FindCommon::enoughForFirstBatch(pq, numResults, firstBatch.len()) &&
                PlanExecutor::ADVANCED == (state = cursorExec->getNext(&obj, NULL))) {
             // If adding this object will cause us to exceed the BSON size limit, then we stash
@@ -56,6 +56,7 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -286,8 +287,20 @@ public:
         }
 
         // If this is an await data cursor, and we hit EOF without generating any results, then
-        // we block waiting for new data to arrive.
-        if (isCursorAwaitData(cursor) && state == PlanExecutor::IS_EOF && numResults == 0) {
+        // we block waiting for new data to arrive. Waiters are notified when inserts commit, but
+        // an insert may still be hidden behind an earlier uncommitted one, so keep waiting until
+        // there are results or the time runs out.
+        //
+        // The wait is tracked against a local timer rather than by re-reading the remaining max
+        // time, which never drops below one microsecond once the deadline has passed.
+        const Microseconds awaitDataTimeout(CurOp::get(txn)->getRemainingMaxTimeMicros());
+        Timer awaitDataTimer;
+        while (isCursorAwaitData(cursor) && state == PlanExecutor::IS_EOF && numResults == 0) {
+            Microseconds timeout = awaitDataTimeout - Microseconds(awaitDataTimer.micros());
+            if (timeout <= Microseconds(0)) {
+                break;
+            }
+
             // Retrieve the notifier which we will wait on until new data arrives. We make sure
             // to do this in the lock because once we drop the lock it is possible for the
             // collection to become invalid. The notifier itself will outlive the collection if
@@ -299,7 +312,6 @@ public:
             ctx.reset();
 
             // Block waiting for data.
-            Microseconds timeout(CurOp::get(txn)->getRemainingMaxTimeMicros());
             notifier->waitForInsert(lastInsertCount, timeout);
             notifier.reset();
 
@@ -307,7 +319,12 @@ public:
             exec->restoreState();
 
             // We woke up because either the timed_wait expired, or there was more data. Either
-            // way, attempt to generate another batch of results.
+            // way, attempt to generate another batch of results. If the collection has gone away,
+            // the executor has been killed and generating the batch fails.
+            Collection* collection = ctx->getCollection();
+            if (collection && collection->isCapped()) {
+                lastInsertCount = collection->getCappedInsertNotifier()->getCount();
+            }
             batchStatus = generateBatch(cursor, request, &nextBatch, &state, &numResults);
             if (!batchStatus.isOK()) {
                 return appendCommandStatus(result, batchStatus);
@@ -372,6 +389,7 @@ public:
         // an interrupt point, we just continue as normal and return rather than reporting a
         // timeout to the user.
         BSONObj obj;
+        exec->setNumResultsWanted(request.batchSize.value_or(0));
         try {
             while (PlanExecutor::ADVANCED == (*state = exec->getNext(&obj, NULL))) {
                 // If adding this object will cause us to exceed the BSON size limit, then we
@@ -32,6 +32,8 @@
 
 #include "mongo/db/commands/mr.h"
 
+#include <pcrecpp.h>
+
 #include "mongo/client/connpool.h"
 #include "mongo/client/parallel.h"
 #include "mongo/db/auth/authorization_session.h"
@@ -59,6 +61,7 @@
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/chunk_manager.h"
 #include "mongo/s/config.h"
@@ -70,6 +73,7 @@
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/stringutils.h"
 
 namespace mongo {
 
@@ -83,6 +87,10 @@ using std::vector;
 
 namespace mr {
 
+// Whether map and reduce functions of the forms NativeFieldMapper and NativeSumReducer
+// recognize are run natively.
+MONGO_EXPORT_SERVER_PARAMETER(internalMapReduceUseNativeFunctions, bool, true);
+
 AtomicUInt32 Config::JOB_NUMBER;
 
 JSFunction::JSFunction(const std::string& type, const BSONElement& e) {
@@ -260,6 +268,291 @@ void JSReducer::_reduce(const BSONList& tuples, BSONObj& key, int& endSizeEstima
     _reduce(x, key, endSizeEstimate);
 }
 
+namespace {
+
+// A JavaScript identifier, as far as the native functions accept them.
+#define MR_JS_IDENT "[A-Za-z_$][\\w$]*"
+
+// function() { emit(this.<path>, <number or this.<path>>); }
+const pcrecpp::RE kNativeMapRE("\\s*function(?:\\s+" MR_JS_IDENT ")?\\s*\\(\\s*\\)\\s*\\{\\s*"
+                               "emit\\s*\\(\\s*this((?:\\." MR_JS_IDENT ")+)\\s*,\\s*"
+                               "(-?(?:0|[1-9]\\d*)(?:\\.\\d+)?|this(?:\\." MR_JS_IDENT ")+)"
+                               "\\s*\\)\\s*;?\\s*\\}\\s*");
+
+// function(key, values) { return Array.sum(values); }
+const pcrecpp::RE kNativeArraySumRE("\\s*function(?:\\s+" MR_JS_IDENT ")?\\s*\\(\\s*(" MR_JS_IDENT
+                                    ")\\s*,\\s*(" MR_JS_IDENT ")\\s*\\)\\s*\\{\\s*"
+                                    "return\\s+Array\\s*\\.\\s*sum\\s*\\(\\s*\\2\\s*\\)"
+                                    "\\s*;?\\s*\\}\\s*");
+
+// function(key, values) {
+//     var sum = 0;
+//     for (var i = 0; i < values.length; i++) { sum += values[i]; }
+//     return sum;
+// }
+const pcrecpp::RE kNativeLoopSumRE(
+    "\\s*function(?:\\s+" MR_JS_IDENT ")?\\s*\\(\\s*(" MR_JS_IDENT ")\\s*,\\s*(" MR_JS_IDENT
+    ")\\s*\\)\\s*\\{\\s*"
+    "var\\s+(" MR_JS_IDENT ")\\s*=\\s*0\\s*;\\s*"
+    "for\\s*\\(\\s*var\\s+(" MR_JS_IDENT ")\\s*=\\s*0\\s*;\\s*\\4\\s*<\\s*\\2\\s*\\.\\s*length\\s*;"
+    "\\s*(?:\\+\\+\\s*\\4|\\4\\s*\\+\\+)\\s*\\)\\s*"
+    "(?:\\{\\s*\\3\\s*\\+=\\s*\\2\\s*\\[\\s*\\4\\s*\\]\\s*;?\\s*\\}"
+    "|\\3\\s*\\+=\\s*\\2\\s*\\[\\s*\\4\\s*\\]\\s*;)"
+    "\\s*return\\s+\\3\\s*;?\\s*\\}\\s*");
+
+#undef MR_JS_IDENT
+
+/**
+ * Checks the size of the arguments to an emit, whether from JavaScript or a native map.
+ */
+void assertEmitSize(const BSONObj& args) {
+    uassert(13069,
+            "an emit can't be more than half max bson size",
+            args.objsize() < (BSONObjMaxUserSize / 2));
+}
+
+/**
+ * Returns whether 'code' holds a function which the native implementations may stand in for.
+ * Functions with a scope are not, since the scope may redefine emit() or Array.sum().
+ */
+bool isPlainFunction(const BSONElement& code) {
+    return code.type() == Code || code.type() == String;
+}
+
+/**
+ * Splits 'path', of the form ".<name>.<name>...", into 'out'. Returns false if a name is one
+ * which JavaScript would also find on the prototype of every object, rather than only in the
+ * document.
+ */
+bool parseThisPath(const std::string& path, std::vector<std::string>* out) {
+    splitStringDelim(path.substr(1), out, '.');
+    for (const auto& name : *out) {
+        if (StringData(name).startsWith("__") || name == "constructor" ||
+            name == "hasOwnProperty" || name == "isPrototypeOf" ||
+            name == "propertyIsEnumerable" || name == "toLocaleString" || name == "toString" ||
+            name == "valueOf") {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Finds in 'doc' the value of this.<path>. Returns false if the JavaScript expression would
+ * do anything but read a field of a subdocument, such as throw because a part before the last
+ * one is missing.
+ */
+bool lookUpThisPath(const BSONObj& doc, const std::vector<std::string>& path, BSONElement* out) {
+    BSONObj obj = doc;
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        BSONElement elt = obj[path[i]];
+        if (elt.type() != Object) {
+            return false;
+        }
+        obj = elt.embeddedObject();
+    }
+    *out = obj[path.back()];
+    return true;
+}
+
+/**
+ * Appends 'elt' as 'name' the way it comes back out of JavaScript after a round trip through
+ * emit(), where integers become doubles. Returns false, without appending, for a type whose
+ * round trip is not reproduced here.
+ */
+bool appendAsFromJS(BSONObjBuilder* b, StringData name, const BSONElement& elt) {
+    switch (elt.type()) {
+        case NumberInt:
+            b->append(name, static_cast<double>(elt.numberInt()));
+            return true;
+        case NumberDouble:
+        case NumberLong:
+        case String:
+        case Bool:
+        case jstNULL:
+        case Date:
+        case jstOID:
+            b->appendAs(elt, name);
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<NativeFieldMapper> NativeFieldMapper::parse(const BSONElement& code) {
+    if (!isPlainFunction(code)) {
+        return {};
+    }
+
+    std::string keyPath;
+    std::string value;
+    if (!kNativeMapRE.FullMatch(code._asCode(), &keyPath, &value)) {
+        return {};
+    }
+
+    std::vector<std::string> keyNames;
+    if (!parseThisPath(keyPath, &keyNames)) {
+        return {};
+    }
+
+    std::vector<std::string> valueNames;
+    double constant = 0;
+    if (StringData(value).startsWith("this")) {
+        if (!parseThisPath(value.substr(4), &valueNames)) {
+            return {};
+        }
+    } else {
+        constant = strtod(value.c_str(), NULL);
+    }
+
+    return std::unique_ptr<NativeFieldMapper>(
+        new NativeFieldMapper(code, std::move(keyNames), std::move(valueNames), constant));
+}
+
+NativeFieldMapper::NativeFieldMapper(const BSONElement& code,
+                                     std::vector<std::string> keyPath,
+                                     std::vector<std::string> valuePath,
+                                     double value)
+    : _fallback(code),
+      _state(NULL),
+      _keyPath(std::move(keyPath)),
+      _valuePath(std::move(valuePath)),
+      _value(value) {}
+
+void NativeFieldMapper::init(State* state) {
+    _fallback.init(state);
+    _state = state;
+}
+
+void NativeFieldMapper::map(const BSONObj& o) {
+    BSONElement key;
+    BSONElement value;
+    if (!lookUpThisPath(o, _keyPath, &key) ||
+        (!_valuePath.empty() && !lookUpThisPath(o, _valuePath, &value))) {
+        _fallback.map(o);
+        return;
+    }
+
+    BSONObjBuilder b;
+
+    // emit() turns an undefined key, as for a missing field, into null.
+    if (key.eoo() || key.type() == Undefined) {
+        b.appendNull("0");
+    } else if (!appendAsFromJS(&b, "0", key)) {
+        _fallback.map(o);
+        return;
+    }
+
+    if (_valuePath.empty()) {
+        b.append("1", _value);
+    } else if (value.eoo() || !appendAsFromJS(&b, "1", value)) {
+        _fallback.map(o);
+        return;
+    }
+
+    BSONObj tuple = b.obj();
+    assertEmitSize(tuple);
+    _state->emit(tuple);
+}
+
+std::unique_ptr<NativeSumReducer> NativeSumReducer::parse(const BSONElement& code) {
+    if (!isPlainFunction(code)) {
+        return {};
+    }
+
+    const std::string source = code._asCode();
+    std::string key;
+    std::string values;
+    if (kNativeArraySumRE.FullMatch(source, &key, &values)) {
+        return std::unique_ptr<NativeSumReducer>(new NativeSumReducer(code, false));
+    }
+
+    std::string sum;
+    std::string index;
+    if (kNativeLoopSumRE.FullMatch(source, &key, &values, &sum, &index) && sum != index &&
+        sum != values && index != values) {
+        return std::unique_ptr<NativeSumReducer>(new NativeSumReducer(code, true));
+    }
+
+    return {};
+}
+
+NativeSumReducer::NativeSumReducer(const BSONElement& code, bool startAtZero)
+    : _fallback(code), _startAtZero(startAtZero) {}
+
+void NativeSumReducer::init(State* state) {
+    _fallback.init(state);
+}
+
+bool NativeSumReducer::_sum(const BSONList& tuples, double* out) const {
+    double sum = 0;
+    for (size_t i = 0; i < tuples.size(); i++) {
+        BSONObjIterator it(tuples[i]);
+        it.next();
+        BSONElement value = it.next();
+        if (value.type() != NumberDouble) {
+            return false;
+        }
+
+        if (i == 0 && !_startAtZero) {
+            sum = value._numberDouble();
+        } else {
+            sum += value._numberDouble();
+        }
+    }
+
+    *out = sum;
+    return true;
+}
+
+BSONObj NativeSumReducer::reduce(const BSONList& tuples) {
+    if (tuples.size() <= 1)
+        return tuples[0];
+
+    double sum;
+    if (!_sum(tuples, &sum)) {
+        const long long fallbackReduces = _fallback.numReduces;
+        BSONObj res = _fallback.reduce(tuples);
+        numReduces += _fallback.numReduces - fallbackReduces;
+        return res;
+    }
+    ++numReduces;
+
+    BSONObjBuilder b;
+    b.appendAs(tuples[0].firstElement(), "0");
+    b.append("1", sum);
+    return b.obj();
+}
+
+BSONObj NativeSumReducer::finalReduce(const BSONList& tuples, Finalizer* finalizer) {
+    double sum = 0;
+    if (tuples.size() > 1 && !_sum(tuples, &sum)) {
+        const long long fallbackReduces = _fallback.numReduces;
+        BSONObj res = _fallback.finalReduce(tuples, finalizer);
+        numReduces += _fallback.numReduces - fallbackReduces;
+        return res;
+    }
+
+    BSONObjIterator it(tuples[0]);
+    BSONObjBuilder b;
+    b.appendAs(it.next(), "_id");
+    if (tuples.size() == 1) {
+        b.appendAs(it.next(), "value");
+    } else {
+        b.append("value", sum);
+        ++numReduces;
+    }
+
+    BSONObj res = b.obj();
+    if (finalizer) {
+        res = finalizer->finalize(res);
+    }
+
+    return res;
+}
+
 Config::Config(const string& _dbname, const BSONObj& cmdObj) {
     dbname = _dbname;
     ns = dbname + "." + cmdObj.firstElement().valuestrsafe();
@@ -301,14 +594,25 @@ Config::Config(const string& _dbname, const BSONObj& cmdObj) {
         if (cmdObj["scope"].type() == Object)
             scopeSetup = cmdObj["scope"].embeddedObjectUserCheck();
 
-        mapper.reset(new JSMapper(cmdObj["map"]));
-        reducer.reset(new JSReducer(cmdObj["reduce"]));
-        if (cmdObj["finalize"].type() && cmdObj["finalize"].trueValue())
-            finalizer.reset(new JSFinalizer(cmdObj["finalize"]));
-
         if (cmdObj["mapparams"].type() == Array) {
             mapParams = cmdObj["mapparams"].embeddedObjectUserCheck();
         }
+
+        // Common forms of map and reduce functions run natively rather than calling into
+        // JavaScript for each document. In jsMode emit() must stay in JavaScript, and a scope
+        // or map parameters may change what the functions do.
+        if (internalMapReduceUseNativeFunctions && !jsMode && scopeSetup.isEmpty() &&
+            mapParams.isEmpty()) {
+            mapper = NativeFieldMapper::parse(cmdObj["map"]);
+            reducer = NativeSumReducer::parse(cmdObj["reduce"]);
+        }
+
+        if (!mapper)
+            mapper.reset(new JSMapper(cmdObj["map"]));
+        if (!reducer)
+            reducer.reset(new JSReducer(cmdObj["reduce"]));
+        if (cmdObj["finalize"].type() && cmdObj["finalize"].trueValue())
+            finalizer.reset(new JSFinalizer(cmdObj["finalize"]));
     }
 
     {
@@ -1204,9 +1508,7 @@ void State::reduceAndSpillInMemoryStateIfNeeded() {
  */
 BSONObj fast_emit(const BSONObj& args, void* data) {
     uassert(10077, "fast_emit takes 2 args", args.nFields() == 2);
-    uassert(13069,
-            "an emit can't be more than half max bson size",
-            args.objsize() < (BSONObjMaxUserSize / 2));
+    assertEmitSize(args);
 
     State* state = (State*)data;
     if (args.firstElement().type() == Undefined) {
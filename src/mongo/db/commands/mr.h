@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -174,6 +175,81 @@ private:
     JSFunction _func;
 };
 
+// ------------  native function implementations -----------
+
+/**
+ * Runs a map function of the form
+ *
+ *     function() { emit(this.<path>, <value>); }
+ *
+ * where <value> is a number literal or this.<path>, without calling into JavaScript. A document
+ * for which the native emit could differ from the JavaScript one, for example because a path
+ * is missing or leads to an array, is mapped by the JavaScript function instead.
+ */
+class NativeFieldMapper : public Mapper {
+public:
+    /**
+     * Returns a mapper for the map function 'code', or NULL if the function is not of the form
+     * above.
+     */
+    static std::unique_ptr<NativeFieldMapper> parse(const BSONElement& code);
+
+    virtual void map(const BSONObj& o);
+    virtual void init(State* state);
+
+private:
+    NativeFieldMapper(const BSONElement& code,
+                      std::vector<std::string> keyPath,
+                      std::vector<std::string> valuePath,
+                      double value);
+
+    JSMapper _fallback;
+    State* _state;
+
+    std::vector<std::string> _keyPath;
+
+    // The path of the emitted value, or empty if the constant '_value' is emitted.
+    std::vector<std::string> _valuePath;
+    double _value;
+};
+
+/**
+ * Runs a reduce function which sums its values, either as
+ *
+ *     function(key, values) { return Array.sum(values); }
+ *
+ * or with a for loop over the values, without calling into JavaScript. A list of values which
+ * are not all doubles is reduced by the JavaScript function instead.
+ */
+class NativeSumReducer : public Reducer {
+public:
+    /**
+     * Returns a reducer for the reduce function 'code', or NULL if the function is not one of
+     * the forms above.
+     */
+    static std::unique_ptr<NativeSumReducer> parse(const BSONElement& code);
+
+    virtual void init(State* state);
+
+    virtual BSONObj reduce(const BSONList& tuples);
+    virtual BSONObj finalReduce(const BSONList& tuples, Finalizer* finalizer);
+
+private:
+    NativeSumReducer(const BSONElement& code, bool startAtZero);
+
+    /**
+     * Sums the values of 'tuples' into 'out' in the order JavaScript would. Returns false
+     * without summing if any value is not a double.
+     */
+    bool _sum(const BSONList& tuples, double* out) const;
+
+    JSReducer _fallback;
+
+    // Whether the sum starts from 0, as in the for loop, or from the first value, as in
+    // Array.sum(). The two differ only for -0.
+    const bool _startAtZero;
+};
+
 // -----------------
 
 
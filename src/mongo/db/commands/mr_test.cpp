@@ -35,6 +35,7 @@
 #include <string>
 
 #include "mongo/db/json.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 
 using namespace mongo;
@@ -208,4 +209,128 @@ TEST(ConfigOutputOptionsTest, parseOutputOptions) {
                                   mr::Config::INMEMORY);
 }
 
+/**
+ * Tests for the choice of native map and reduce functions in mr::Config.
+ */
+
+/**
+ * Returns the mr::Config for a mapReduce with the given map and reduce functions and the extra
+ * command fields in 'options'.
+ */
+std::unique_ptr<mr::Config> _makeConfig(const std::string& map,
+                                        const std::string& reduce,
+                                        const BSONObj& options = BSONObj()) {
+    BSONObjBuilder cmd;
+    cmd.append("mapreduce", "mycoll");
+    cmd.appendCode("map", map);
+    cmd.appendCode("reduce", reduce);
+    cmd.append("out", BSON("inline" << 1));
+    cmd.appendElements(options);
+    return stdx::make_unique<mr::Config>("mydb", cmd.obj());
+}
+
+bool _hasNativeMapper(const mr::Config& config) {
+    return dynamic_cast<mr::NativeFieldMapper*>(config.mapper.get()) != NULL;
+}
+
+bool _hasNativeReducer(const mr::Config& config) {
+    return dynamic_cast<mr::NativeSumReducer*>(config.reducer.get()) != NULL;
+}
+
+const char* const kArraySum = "function(key, values) { return Array.sum(values); }";
+
+TEST(ConfigNativeFunctionsTest, RecognizesFieldMappers) {
+    ASSERT_TRUE(_hasNativeMapper(*_makeConfig("function() { emit(this.a, 1); }", kArraySum)));
+    ASSERT_TRUE(
+        _hasNativeMapper(*_makeConfig("function m() {emit(this.a.b,this.c.d)}", kArraySum)));
+    ASSERT_TRUE(_hasNativeMapper(
+        *_makeConfig("\n  function ( ) {\n    emit( this._id , -2.5 ) ;\n  }\n", kArraySum)));
+    ASSERT_TRUE(
+        _hasNativeMapper(*_makeConfig("function() { emit(this.$x, this.y_1); }", kArraySum)));
+}
+
+TEST(ConfigNativeFunctionsTest, RejectsOtherMappers) {
+    // Not a single emit of a field.
+    ASSERT_FALSE(_hasNativeMapper(*_makeConfig("function() { emit(this.a, 1); emit(1, 1); }",
+                                               kArraySum)));
+    ASSERT_FALSE(_hasNativeMapper(*_makeConfig("function() { emit(this['a'], 1); }", kArraySum)));
+    ASSERT_FALSE(_hasNativeMapper(*_makeConfig("function() { emit(this.a, 01); }", kArraySum)));
+    ASSERT_FALSE(_hasNativeMapper(*_makeConfig("function(x) { emit(this.a, x); }", kArraySum)));
+    ASSERT_FALSE(_hasNativeMapper(*_makeConfig("function() { emit(this.a); }", kArraySum)));
+
+    // Properties every JavaScript object has.
+    ASSERT_FALSE(
+        _hasNativeMapper(*_makeConfig("function() { emit(this.constructor, 1); }", kArraySum)));
+    ASSERT_FALSE(
+        _hasNativeMapper(*_makeConfig("function() { emit(this.a, this.b.valueOf); }", kArraySum)));
+    ASSERT_FALSE(
+        _hasNativeMapper(*_makeConfig("function() { emit(this.__proto__.a, 1); }", kArraySum)));
+}
+
+TEST(ConfigNativeFunctionsTest, RecognizesSumReducers) {
+    const char* const map = "function() { emit(this.a, 1); }";
+    ASSERT_TRUE(_hasNativeReducer(*_makeConfig(map, kArraySum)));
+    ASSERT_TRUE(_hasNativeReducer(*_makeConfig(map, "function r(k,v){return Array.sum(v)}")));
+    ASSERT_TRUE(_hasNativeReducer(
+        *_makeConfig(map,
+                     "function(key, values) {\n"
+                     "    var sum = 0;\n"
+                     "    for (var i = 0; i < values.length; i++) {\n"
+                     "        sum += values[i];\n"
+                     "    }\n"
+                     "    return sum;\n"
+                     "}")));
+
+    const std::string loop = "for (var j = 0; j < v.length; ++j) s += v[j];";
+    ASSERT_TRUE(_hasNativeReducer(
+        *_makeConfig(map, "function(k, v) { var s = 0; " + loop + " return s }")));
+}
+
+TEST(ConfigNativeFunctionsTest, RejectsOtherReducers) {
+    const char* const map = "function() { emit(this.a, 1); }";
+    ASSERT_FALSE(_hasNativeReducer(*_makeConfig(map, "function(k, v) { return Array.sum(k); }")));
+    ASSERT_FALSE(_hasNativeReducer(*_makeConfig(map, "function(k, v) { return v.length; }")));
+
+    // Starts from 1, or adds the wrong element.
+    const std::string loop = "for (var i = 0; i < v.length; i++) s += v[i];";
+    ASSERT_FALSE(_hasNativeReducer(
+        *_makeConfig(map, "function(k, v) { var s = 1; " + loop + " return s; }")));
+    const std::string wrongElement = "for (var i = 0; i < v.length; i++) s += v[s];";
+    ASSERT_FALSE(_hasNativeReducer(
+        *_makeConfig(map, "function(k, v) { var s = 0; " + wrongElement + " return s; }")));
+
+    // The sum shadows the values.
+    const std::string shadowed = "for (var i = 0; i < v.length; i++) v += v[i];";
+    ASSERT_FALSE(_hasNativeReducer(
+        *_makeConfig(map, "function(k, v) { var v = 0; " + shadowed + " return v; }")));
+}
+
+TEST(ConfigNativeFunctionsTest, KeepsJavaScriptWhenFunctionsMayBehaveDifferently) {
+    const char* const map = "function() { emit(this.a, 1); }";
+
+    // emit() stays in JavaScript in jsMode.
+    auto config = _makeConfig(map, kArraySum, BSON("jsMode" << true));
+    ASSERT_FALSE(_hasNativeMapper(*config));
+    ASSERT_FALSE(_hasNativeReducer(*config));
+
+    // A scope may redefine emit() or Array.sum().
+    config = _makeConfig(map, kArraySum, BSON("scope" << BSON("x" << 1)));
+    ASSERT_FALSE(_hasNativeMapper(*config));
+    ASSERT_FALSE(_hasNativeReducer(*config));
+
+    BSONObjBuilder cmd;
+    cmd.append("mapreduce", "mycoll");
+    cmd.appendCodeWScope("map", map, BSONObj());
+    cmd.appendCodeWScope("reduce", kArraySum, BSONObj());
+    cmd.append("out", BSON("inline" << 1));
+    mr::Config withScope("mydb", cmd.obj());
+    ASSERT_FALSE(_hasNativeMapper(withScope));
+    ASSERT_FALSE(_hasNativeReducer(withScope));
+
+    // The map and reduce functions are chosen independently.
+    config = _makeConfig("function() { emit(this.a, this.b * 2); }", kArraySum);
+    ASSERT_FALSE(_hasNativeMapper(*config));
+    ASSERT_TRUE(_hasNativeReducer(*config));
+}
+
 }  // namespace
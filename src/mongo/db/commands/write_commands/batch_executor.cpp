@@ -32,6 +32,7 @@
 
 #include "mongo/db/commands/write_commands/batch_executor.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/base/error_codes.h"
@@ -222,6 +223,17 @@ bool checkShardVersion(OperationContext* txn,
 // TODO: Determine queueing behavior we want here
 MONGO_EXPORT_SERVER_PARAMETER(queueForMigrationCommit, bool, true);
 
+// The most documents of an insert batch that are inserted in one WriteUnitOfWork. A value of 1
+// inserts every document in its own WriteUnitOfWork.
+MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize, int, 64);
+
+namespace {
+
+// Documents are grouped into a WriteUnitOfWork until they total this many bytes.
+const int kInsertBatchMaxBytes = 256 * 1024;
+
+}  // namespace
+
 WriteBatchExecutor::WriteBatchExecutor(OperationContext* txn, OpCounters* opCounters, LastError* le)
     : _txn(txn), _opCounters(opCounters), _le(le), _stats(new WriteBatchStats) {}
 
@@ -743,6 +755,25 @@ void WriteBatchExecutor::bulkExecute(const BatchedCommandRequest& request,
     }
 }
 
+// Returns the end of the run of inserts, starting at the current one, that can be tried in a
+// single WriteUnitOfWork. Index creation requests and inserts that failed to normalize are never
+// grouped.
+static size_t insertBatchEnd(const WriteBatchExecutor::ExecInsertsState& state) {
+    if (state.request->isInsertIndexRequest()) {
+        return state.currIndex + 1;
+    }
+
+    const size_t maxEnd = std::min(state.normalizedInserts.size(),
+                                   state.currIndex + std::max(internalInsertMaxBatchSize, 1));
+    size_t end = state.currIndex;
+    int bytes = 0;
+    while (end < maxEnd && state.normalizedInserts[end].isOK() && bytes < kInsertBatchMaxBytes) {
+        bytes += state.request->getInsertRequest()->getDocumentsAt(end).objsize();
+        ++end;
+    }
+    return std::max(end, state.currIndex + 1);
+}
+
 // Goes over the request and preprocesses normalized versions of all the inserts in the request
 static void normalizeInserts(const BatchedCommandRequest& request,
                              vector<StatusWith<BSONObj>>* normalizedInserts) {
@@ -792,8 +823,13 @@ void WriteBatchExecutor::execInserts(const BatchedCommandRequest& request,
     // Yield frequency is based on the same constants used by PlanYieldPolicy.
     ElapsedTracker elapsedTracker(internalQueryExecYieldIterations, internalQueryExecYieldPeriodMS);
 
+    // Inserts before this index are done one at a time, after an attempt to insert them in a
+    // single WriteUnitOfWork failed.
+    size_t insertSinglyUntil = 0;
+
     for (state.currIndex = 0; state.currIndex < state.request->sizeWriteOps(); ++state.currIndex) {
-        if (state.currIndex + 1 == state.request->sizeWriteOps()) {
+        const size_t batchEnd = insertBatchEnd(state);
+        if (batchEnd == state.request->sizeWriteOps()) {
             setupSynchronousCommit(_txn);
         }
 
@@ -814,6 +850,15 @@ void WriteBatchExecutor::execInserts(const BatchedCommandRequest& request,
             elapsedTracker.resetLastTime();
         }
 
+        if (state.currIndex >= insertSinglyUntil && batchEnd > state.currIndex + 1) {
+            if (execInsertBatch(&state, batchEnd)) {
+                // The loop increment moves past the last document of the batch.
+                state.currIndex = batchEnd - 1;
+                continue;
+            }
+            insertSinglyUntil = batchEnd;
+        }
+
         WriteErrorDetail* error = NULL;
         execOneInsert(&state, &error);
         if (error) {
@@ -1059,6 +1104,57 @@ void WriteBatchExecutor::execOneInsert(ExecInsertsState* state, WriteErrorDetail
     }
 }
 
+bool WriteBatchExecutor::execInsertBatch(ExecInsertsState* state, size_t end) {
+    invariant(!_txn->lockState()->inAWriteUnitOfWork());
+
+    vector<BSONObj> docs;
+    docs.reserve(end - state->currIndex);
+    for (size_t i = state->currIndex; i < end; ++i) {
+        const BSONObj& normalized = state->normalizedInserts[i].getValue();
+        docs.push_back(normalized.isEmpty() ? state->request->getInsertRequest()->getDocumentsAt(i)
+                                            : normalized);
+    }
+
+    CurOp currentOp(_txn);
+    beginCurrentOp(_txn, BatchItemRef(state->request, state->currIndex));
+
+    bool inserted = false;
+    WriteOpResult result;
+    try {
+        if (state->lockAndCheck(&result)) {
+            WriteUnitOfWork wunit(_txn);
+            Status status =
+                state->getCollection()->insertDocuments(_txn, docs.begin(), docs.end(), true);
+            if (status.isOK()) {
+                wunit.commit();
+                inserted = true;
+            }
+        }
+    } catch (const DBException& ex) {
+        // Write conflicts and stale shard versions are retried and reported by the one at a time
+        // inserts.
+        if (ErrorCodes::isInterruption(ex.toStatus().code()))
+            throw;
+    }
+
+    if (!inserted) {
+        _txn->recoveryUnit()->abandonSnapshot();
+        state->unlock();
+        return false;
+    }
+
+    for (size_t i = state->currIndex; i < end; ++i) {
+        BatchItemRef insertItem(state->request, i);
+        incOpStats(insertItem);
+
+        WriteOpStats stats;
+        stats.n = 1;
+        incWriteStats(insertItem, stats, NULL, &currentOp);
+    }
+    finishCurrentOp(_txn, NULL);
+    return true;
+}
+
 /**
  * Perform a single insert into a collection.  Requires the insert be preprocessed and the
  * collection already has been created.
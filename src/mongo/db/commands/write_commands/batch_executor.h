@@ -97,6 +97,13 @@ private:
      */
     void execOneInsert(ExecInsertsState* state, WriteErrorDetail** error);
 
+    /**
+     * Inserts the documents from the current insert up to, but not including, "end" in a single
+     * WriteUnitOfWork. Returns false without inserting anything if that fails for any reason,
+     * in which case the caller inserts them one at a time to report errors per document.
+     */
+    bool execInsertBatch(ExecInsertsState* state, size_t end);
+
     /**
      * Executes an update item (which may update many documents or upsert), and returns the
      * upserted _id on upsert or error on failure.
@@ -30,12 +30,18 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <vector>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "mongo/db/concurrency/lock_manager.h"
 
 #include "mongo/config.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stringutils.h"
@@ -71,6 +77,43 @@ static const int LockConflictsTable[] = {
 // Mask of modes
 const uint64_t intentModes = (1 << MODE_IS) | (1 << MODE_IX);
 
+// Layout of LockManager::FastPathSlot::state: the number of requests granted in MODE_IS in the
+// lowest bits, followed by those granted in MODE_IX, the epoch of the slot and the disabled bit.
+const unsigned kFastPathCountBits = 24;
+const uint64_t kFastPathCountMask = (1ULL << kFastPathCountBits) - 1;
+const unsigned kFastPathEpochShift = 2 * kFastPathCountBits;
+const uint64_t kFastPathEpochMask = (1ULL << (63 - kFastPathEpochShift)) - 1;
+const uint64_t kFastPathDisabled = 1ULL << 63;
+
+// Only the global and database resources, which every operation locks in an intent mode, use
+// the fast path.
+bool isFastPathResource(ResourceId resId) {
+    return resId.getType() == RESOURCE_GLOBAL || resId.getType() == RESOURCE_DATABASE;
+}
+
+unsigned fastPathCountShift(LockMode mode) {
+    invariant(mode == MODE_IS || mode == MODE_IX);
+    return mode == MODE_IS ? 0 : kFastPathCountBits;
+}
+
+uint64_t fastPathIncrement(LockMode mode) {
+    return 1ULL << fastPathCountShift(mode);
+}
+
+uint32_t fastPathCount(uint64_t state, LockMode mode) {
+    return (state >> fastPathCountShift(mode)) & kFastPathCountMask;
+}
+
+bool fastPathEmpty(uint64_t state) {
+    return fastPathCount(state, MODE_IS) == 0 && fastPathCount(state, MODE_IX) == 0;
+}
+
+// Returns the state of a slot handed to a new resource: enabled, with no requests counted.
+uint64_t fastPathNextEpoch(uint64_t state) {
+    const uint64_t epoch = (state >> kFastPathEpochShift) & kFastPathEpochMask;
+    return ((epoch + 1) & kFastPathEpochMask) << kFastPathEpochShift;
+}
+
 // Ensure we do not add new modes without updating the conflicts table
 static_assert((sizeof(LockConflictsTable) / sizeof(LockConflictsTable[0])) == LockModesCount,
               "(sizeof(LockConflictsTable) / sizeof(LockConflictsTable[0])) == LockModesCount");
@@ -154,6 +197,8 @@ struct LockHead {
 
         conversionsCount = 0;
         compatibleFirstCount = 0;
+
+        memset(fastPathGrantedCounts, 0, sizeof(fastPathGrantedCounts));
     }
 
     /**
@@ -255,6 +300,32 @@ struct LockHead {
         }
     }
 
+    // Accounts for "count" requests granted in "mode" through the fast path, which are not on
+    // the granted queue.
+    void addFastPathGrants(LockMode mode, uint32_t count) {
+        if (count == 0) {
+            return;
+        }
+        fastPathGrantedCounts[mode] += count;
+        grantedCounts[mode] += count;
+        grantedModes |= modeMask(mode);
+    }
+
+    // Stops accounting for the requests granted in "mode" through the fast path, once they are
+    // counted on the fast path again.
+    void removeFastPathGrants(LockMode mode) {
+        invariant(grantedCounts[mode] >= fastPathGrantedCounts[mode]);
+        grantedCounts[mode] -= fastPathGrantedCounts[mode];
+        fastPathGrantedCounts[mode] = 0;
+        if (grantedCounts[mode] == 0) {
+            grantedModes &= ~modeMask(mode);
+        }
+    }
+
+    bool hasFastPathGrants() const {
+        return fastPathGrantedCounts[MODE_IS] || fastPathGrantedCounts[MODE_IX];
+    }
+
     // Methods to maintain the conflict queue
     void incConflictModeCount(LockMode mode) {
         invariant(conflictCounts[mode] >= 0);
@@ -331,6 +402,15 @@ struct LockHead {
     // be switched to compatible-first. As long as this value is > 0, the policy will stay
     // compatible-first.
     uint32_t compatibleFirstCount;
+
+    //
+    // Fast path
+    //
+
+    // Counts, for each intent mode, the requests granted through the fast path when it was
+    // disabled for this resource. They are included in grantedCounts and grantedModes, but are
+    // not on the granted queue. Always matches the counts on the disabled fast path slot.
+    uint32_t fastPathGrantedCounts[LockModesCount];
 };
 
 /**
@@ -418,9 +498,10 @@ const unsigned LockManager::_numLockBuckets(128);
 
 // Balance scalability of intent locks against potential added cost of conflicting locks.
 // The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+const unsigned LockManager::_minPartitions = 32;
 
-LockManager::LockManager() {
+LockManager::LockManager()
+    : _numPartitions(std::max(_minPartitions, stdx::thread::hardware_concurrency())) {
     _lockBuckets = new LockBucket[_numLockBuckets];
     _partitions = new Partition[_numPartitions];
 }
@@ -443,8 +524,17 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     request->partitioned = (mode == MODE_IX || mode == MODE_IS);
 
+    const bool useFastPath =
+        request->partitioned && request->allowFastPath && isFastPathResource(resId);
+
+    // Fastest path for intent locks, which does not take any mutex
+    if (useFastPath && _tryFastPath(_getBucket(resId), resId, request, mode)) {
+        return LOCK_OK;
+    }
+
     // For intent modes, try the PartitionedLockHead
     if (request->partitioned) {
+        request->partitionId = _choosePartition(request);
         Partition* partition = _getPartition(request);
         stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
 
@@ -466,6 +556,13 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     LockHead* lock = bucket->findOrInsert(resId);
 
+    // Re-enable the fast path after conflicting requests are gone, or take it over from another
+    // resource if it is unused
+    if (useFastPath && !(lock->grantedModes & (~intentModes)) && !lock->conflictModes &&
+        _enableFastPath_inlock(bucket, lock) && _tryFastPath(bucket, resId, request, mode)) {
+        return LOCK_OK;
+    }
+
     // Start a partitioned lock if possible
     if (request->partitioned && !(lock->grantedModes & (~intentModes)) && !lock->conflictModes) {
         Partition* partition = _getPartition(request);
@@ -478,9 +575,11 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
     }
 
     // For the first lock with a non-intent mode, migrate requests from partitioned lock heads
+    // and account for those granted through the fast path
     if (lock->partitioned()) {
         lock->migratePartitionedLockHeads();
     }
+    _disableFastPath_inlock(bucket, lock);
 
     request->partitioned = false;
     return lock->newRequest(request, mode);
@@ -512,14 +611,23 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
     LockBucket* bucket = _getBucket(resId);
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
 
-    LockBucket::Map::iterator it = bucket->data.find(resId);
-    invariant(it != bucket->data.end());
-
-    LockHead* const lock = it->second;
+    // A request granted through the fast path may not have a LockHead yet
+    LockHead* lock;
+    if (request->fastPathResId.isValid()) {
+        lock = bucket->findOrInsert(resId);
+    } else {
+        LockBucket::Map::iterator it = bucket->data.find(resId);
+        invariant(it != bucket->data.end());
+        lock = it->second;
+    }
 
     if (lock->partitioned()) {
         lock->migratePartitionedLockHeads();
     }
+    _disableFastPath_inlock(bucket, lock);
+    if (request->fastPathResId.isValid()) {
+        _leaveFastPath_inlock(bucket, lock, request);
+    }
 
     // Construct granted mask without our current mode, so that it is not counted as
     // conflicting
@@ -572,6 +680,44 @@ bool LockManager::unlock(LockRequest* request) {
         return false;
     }
 
+    if (request->fastPathResId.isValid()) {
+        // Unlocking a request granted through the fast path. Its count stays on the slot until
+        // it is unlocked, since the slot is only handed to another resource when it is empty.
+        invariant(request->status == LockRequest::STATUS_GRANTED);
+        const ResourceId resId = request->fastPathResId;
+        const uint64_t increment = fastPathIncrement(request->mode);
+        LockBucket* bucket = _getBucket(resId);
+        FastPathSlot* slot = &bucket->fastPath;
+        request->fastPathResId = ResourceId();
+
+        // Fast path: the slot is still enabled, so nobody waits for this request.
+        uint64_t state = slot->state.load();
+        while (!(state & kFastPathDisabled)) {
+            const uint64_t prev = slot->state.compareAndSwap(state, state - increment);
+            if (prev == state) {
+                return true;
+            }
+            state = prev;
+        }
+
+        // A conflicting request disabled the slot and accounted for this request on the
+        // LockHead. The slot can only be enabled again under the bucket mutex.
+        stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+        state = slot->state.fetchAndSubtract(increment);
+        invariant(fastPathCount(state, request->mode) > 0);
+        if (state & kFastPathDisabled) {
+            LockBucket::Map::iterator it = bucket->data.find(resId);
+            invariant(it != bucket->data.end());
+            LockHead* lock = it->second;
+
+            invariant(lock->fastPathGrantedCounts[request->mode] > 0);
+            lock->fastPathGrantedCounts[request->mode]--;
+            lock->decGrantedModeCount(request->mode);
+            _onLockModeChanged(lock, lock->grantedCounts[request->mode] == 0);
+        }
+        return true;
+    }
+
     if (request->partitioned) {
         // Unlocking a lock that was acquired as partitioned. The lock request may since have
         // moved to the lock head, but there is no safe way to find out without synchronizing
@@ -637,7 +783,6 @@ bool LockManager::unlock(LockRequest* request) {
 }
 
 void LockManager::downgrade(LockRequest* request, LockMode newMode) {
-    invariant(request->lock);
     invariant(request->status == LockRequest::STATUS_GRANTED);
     invariant(request->recursiveCount > 0);
 
@@ -646,6 +791,21 @@ void LockManager::downgrade(LockRequest* request, LockMode newMode) {
     invariant((LockConflictsTable[request->mode] | LockConflictsTable[newMode]) ==
               LockConflictsTable[request->mode]);
 
+    if (request->fastPathResId.isValid()) {
+        // Only IX can be downgraded to another intent mode. Take the request off the fast path,
+        // which is a rare enough operation not to be worth its own fast path.
+        LockBucket* bucket = _getBucket(request->fastPathResId);
+        stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+        LockHead* lock = bucket->findOrInsert(request->fastPathResId);
+        if (lock->partitioned()) {
+            lock->migratePartitionedLockHeads();
+        }
+        _disableFastPath_inlock(bucket, lock);
+        _leaveFastPath_inlock(bucket, lock, request);
+    }
+    invariant(request->lock);
+
     LockHead* lock = request->lock;
 
     LockBucket* bucket = _getBucket(lock->resourceId);
@@ -781,7 +941,8 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
 
     // This is a convenient place to check that the state of the two request queues is in sync
     // with the bitmask on the modes.
-    invariant((lock->grantedModes == 0) ^ (lock->grantedList._front != NULL));
+    invariant((lock->grantedModes == 0) ^
+              (lock->grantedList._front != NULL || lock->hasFastPathGrants()));
     invariant((lock->conflictModes == 0) ^ (lock->conflictList._front != NULL));
 }
 
@@ -789,8 +950,122 @@ LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
     return &_lockBuckets[resId % _numLockBuckets];
 }
 
+bool LockManager::_tryFastPath(LockBucket* bucket,
+                               ResourceId resId,
+                               LockRequest* request,
+                               LockMode mode) {
+    FastPathSlot* slot = &bucket->fastPath;
+    const uint64_t increment = fastPathIncrement(mode);
+
+    uint64_t state = slot->state.load();
+    while (!(state & kFastPathDisabled)) {
+        // The slot is handed to another resource only after it has been disabled, and its
+        // resource is stored before it is enabled with a new epoch. So if the state does not
+        // change until the counter is incremented below, the slot belongs to the resource read
+        // here.
+        if (slot->resId.load() != resId || fastPathCount(state, mode) == kFastPathCountMask) {
+            return false;
+        }
+
+        const uint64_t prev = slot->state.compareAndSwap(state, state + increment);
+        if (prev == state) {
+            request->mode = mode;
+            request->lock = NULL;
+            request->partitionedLock = NULL;
+            request->partitioned = false;
+            request->fastPathResId = resId;
+            request->recursiveCount = 1;
+            request->status = LockRequest::STATUS_GRANTED;
+            return true;
+        }
+        state = prev;
+    }
+    return false;
+}
+
+bool LockManager::_enableFastPath_inlock(LockBucket* bucket, LockHead* lock) {
+    FastPathSlot* slot = &bucket->fastPath;
+    const uint64_t state = slot->state.load();
+
+    if (slot->resId.load() == lock->resourceId) {
+        if (!(state & kFastPathDisabled)) {
+            return true;
+        }
+
+        // No counts change while the slot is disabled, except under the bucket mutex.
+        invariant(fastPathCount(state, MODE_IS) == lock->fastPathGrantedCounts[MODE_IS]);
+        invariant(fastPathCount(state, MODE_IX) == lock->fastPathGrantedCounts[MODE_IX]);
+        lock->removeFastPathGrants(MODE_IS);
+        lock->removeFastPathGrants(MODE_IX);
+        slot->state.store(state & ~kFastPathDisabled);
+        return true;
+    }
+
+    // The slot belongs to another resource of this bucket. Take it over, unless that resource
+    // still has requests counted on it.
+    if (!fastPathEmpty(state)) {
+        return false;
+    }
+    if (!(state & kFastPathDisabled) &&
+        slot->state.compareAndSwap(state, state | kFastPathDisabled) != state) {
+        return false;
+    }
+    slot->resId.store(lock->resourceId);
+    slot->state.store(fastPathNextEpoch(state));
+    return true;
+}
+
+void LockManager::_disableFastPath_inlock(LockBucket* bucket, LockHead* lock) {
+    FastPathSlot* slot = &bucket->fastPath;
+    if (slot->resId.load() != lock->resourceId) {
+        return;
+    }
+
+    uint64_t state = slot->state.load();
+    while (!(state & kFastPathDisabled)) {
+        const uint64_t prev = slot->state.compareAndSwap(state, state | kFastPathDisabled);
+        if (prev == state) {
+            invariant(!lock->hasFastPathGrants());
+            lock->addFastPathGrants(MODE_IS, fastPathCount(state, MODE_IS));
+            lock->addFastPathGrants(MODE_IX, fastPathCount(state, MODE_IX));
+            return;
+        }
+        state = prev;
+    }
+}
+
+void LockManager::_leaveFastPath_inlock(LockBucket* bucket,
+                                        LockHead* lock,
+                                        LockRequest* request) {
+    invariant(request->fastPathResId == lock->resourceId);
+    invariant(request->status == LockRequest::STATUS_GRANTED);
+
+    const uint64_t state = bucket->fastPath.state.fetchAndSubtract(
+        fastPathIncrement(request->mode));
+    invariant(state & kFastPathDisabled);
+    invariant(fastPathCount(state, request->mode) > 0);
+
+    // The request stays counted in grantedCounts, but through the granted queue from now on.
+    invariant(lock->fastPathGrantedCounts[request->mode] > 0);
+    lock->fastPathGrantedCounts[request->mode]--;
+    lock->grantedList.push_back(request);
+
+    request->lock = lock;
+    request->fastPathResId = ResourceId();
+}
+
+unsigned LockManager::_choosePartition(const LockRequest* request) const {
+#if defined(__linux__)
+    const int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return static_cast<unsigned>(cpu) % _numPartitions;
+    }
+#endif
+    return request->locker->getId() % _numPartitions;
+}
+
 LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
-    return &_partitions[request->locker->getId() % _numPartitions];
+    return &_partitions[request->partitionId];
 }
 
 void LockManager::dump() const {
@@ -811,7 +1086,12 @@ void LockManager::_dumpBucket(const LockBucket* bucket) const {
          it++) {
         const LockHead* lock = it->second;
 
-        if (lock->grantedList.empty()) {
+        uint64_t fastPathState = 0;
+        if (bucket->fastPath.resId.load() == lock->resourceId) {
+            fastPathState = bucket->fastPath.state.load();
+        }
+
+        if (lock->grantedList.empty() && fastPathEmpty(fastPathState)) {
             // If there are no granted requests, this lock is empty, so no need to print it
             continue;
         }
@@ -819,6 +1099,11 @@ void LockManager::_dumpBucket(const LockBucket* bucket) const {
         StringBuilder sb;
         sb << "Lock @ " << lock << ": " << lock->resourceId.toString() << '\n';
 
+        sb << "FAST PATH: "
+           << "IS = " << fastPathCount(fastPathState, MODE_IS) << "; "
+           << "IX = " << fastPathCount(fastPathState, MODE_IX) << "; "
+           << "Disabled = " << static_cast<bool>(fastPathState & kFastPathDisabled) << '\n';
+
         sb << "GRANTED:\n";
         for (const LockRequest* iter = lock->grantedList._front; iter != NULL; iter = iter->next) {
             sb << '\t' << "LockRequest " << iter->locker->getId() << " @ " << iter->locker << ": "
@@ -1078,7 +1363,11 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
     prev = NULL;
     next = NULL;
     status = STATUS_NEW;
+    allowFastPath = false;
     partitioned = false;
+    partitionedLock = NULL;
+    fastPathResId = ResourceId();
+    partitionId = 0;
     mode = MODE_NONE;
     convertMode = MODE_NONE;
 }
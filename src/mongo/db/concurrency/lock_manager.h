@@ -130,22 +130,48 @@ private:
 
     // These types describe the locks hash table
 
+    // Grants uncontended intent mode requests on a single global or database resource without
+    // taking any mutex, by atomically counting them per mode. Such requests are not queued on
+    // any lock head. A request in a conflicting mode disables the slot under the bucket mutex
+    // and accounts for the counted requests on the resource's LockHead instead.
+    struct FastPathSlot {
+        // The resource whose requests are counted, or an invalid id. Only changed under the
+        // bucket mutex while no requests are counted and the slot is disabled.
+        AtomicUInt64 resId;
+
+        // The IS and IX request counts, an epoch which changes whenever the slot is handed to
+        // another resource, and whether the slot is disabled. See the layout in
+        // lock_manager.cpp. Counts may only be incremented while the slot is enabled.
+        AtomicUInt64 state;
+
+        // Keep the slot of each bucket on its own cache line.
+        char padding[64];
+    };
+
     struct LockBucket {
         SimpleMutex mutex;
         typedef unordered_map<ResourceId, LockHead*> Map;
         Map data;
         LockHead* findOrInsert(ResourceId resId);
+
+        // Shared by every resource which maps to this bucket, but used by one at a time.
+        FastPathSlot fastPath;
     };
 
-    // Each locker maps to a partition that is used for resources acquired in intent modes
+    // Each CPU maps to a partition that is used for resources acquired in intent modes
     // modes and potentially other modes that don't conflict with themselves. This avoids
-    // contention on the regular LockHead in the lock manager.
+    // contention on the regular LockHead in the lock manager, and on the partitions themselves
+    // between threads running concurrently on different CPUs.
     struct Partition {
         PartitionedLockHead* find(ResourceId resId);
         PartitionedLockHead* findOrInsert(ResourceId resId);
         typedef unordered_map<ResourceId, PartitionedLockHead*> Map;
         SimpleMutex mutex;
         Map data;
+
+        // Partitions are allocated contiguously, so keep the mutexes of neighbouring partitions
+        // on different cache lines.
+        char padding[64];
     };
 
     /**
@@ -155,11 +181,52 @@ private:
     LockBucket* _getBucket(ResourceId resId) const;
 
 
+    /**
+     * Chooses the partition a new intent mode request should use, preferring the partition of
+     * the CPU on which the calling thread is running. There is no need to hold a lock when
+     * calling this function.
+     */
+    unsigned _choosePartition(const LockRequest* request) const;
+
     /**
      * Retrieves the Partition that a particular LockRequest should use for intent locking.
      */
     Partition* _getPartition(LockRequest* request) const;
 
+    /**
+     * Grants "request" in intent mode "mode" by counting it on the fast path slot of "bucket",
+     * if the slot is enabled for "resId". Returns false, without changing anything, otherwise.
+     * There is no need to hold a lock when calling this function.
+     */
+    bool _tryFastPath(LockBucket* bucket, ResourceId resId, LockRequest* request, LockMode mode);
+
+    /**
+     * Makes the fast path slot of "bucket" count requests for "lock", taking it over from
+     * another resource if nothing is counted on it. Requests which "lock" accounts for while the
+     * slot was disabled are moved back to the slot. Returns false if the slot is in use.
+     *
+     * MUST be called under the bucket's mutex, and only if "lock" has neither conflicts nor
+     * non-intent granted modes.
+     */
+    bool _enableFastPath_inlock(LockBucket* bucket, LockHead* lock);
+
+    /**
+     * Stops the fast path slot of "bucket" from granting requests for "lock", if it does. The
+     * requests already counted on the slot are then accounted for as granted on "lock", so
+     * that conflicting requests wait for them.
+     *
+     * MUST be called under the bucket's mutex.
+     */
+    void _disableFastPath_inlock(LockBucket* bucket, LockHead* lock);
+
+    /**
+     * Moves "request", which was granted through the fast path, to the granted queue of "lock",
+     * so that it can be converted or downgraded. The fast path must be disabled for "lock".
+     *
+     * MUST be called under the bucket's mutex.
+     */
+    void _leaveFastPath_inlock(LockBucket* bucket, LockHead* lock, LockRequest* request);
+
     /**
      * Prints the contents of a bucket to the log.
      */
@@ -181,7 +248,9 @@ private:
     static const unsigned _numLockBuckets;
     LockBucket* _lockBuckets;
 
-    static const unsigned _numPartitions;
+    // One partition per CPU, but no fewer than _minPartitions.
+    static const unsigned _minPartitions;
+    const unsigned _numPartitions;
     Partition* _partitions;
 };
 
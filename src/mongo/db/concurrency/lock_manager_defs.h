@@ -356,6 +356,12 @@ struct LockRequest {
     // granted immediately. This effectively turns off fairness.
     bool compatibleFirst;
 
+    // When set, intent mode requests on the global and database resources may be granted on the
+    // lock manager's fast path, where they are counted rather than queued. The deadlock detector
+    // cannot see such requests, so lockers which check for deadlocks must not set it. Default is
+    // FALSE.
+    bool allowFastPath;
+
     // When set, an attempt is made to execute this request using partitioned lockheads.
     // This speeds up the common case where all requested locking modes are compatible with
     // each other, at the cost of extra overhead for conflicting modes.
@@ -371,9 +377,9 @@ struct LockRequest {
 
 
     // Pointer to the lock to which this request belongs, or null if this request has not yet
-    // been assigned to a lock or if it belongs to the PartitionedLockHead for locker. The
-    // LockHead should be alive as long as there are LockRequests on it, so it is safe to have
-    // this pointer hanging around.
+    // been assigned to a lock, if it belongs to the PartitionedLockHead for locker or if it was
+    // granted through the fast path. The LockHead should be alive as long as there are
+    // LockRequests on it, so it is safe to have this pointer hanging around.
     LockHead* lock;
 
     // Pointer to the partitioned lock to which this request belongs, or null if it is not
@@ -381,6 +387,16 @@ struct LockRequest {
     // only transition from 'partitionedLock' to 'lock', never the other way around.
     PartitionedLockHead* partitionedLock;
 
+    // The resource on which this request was granted through the fast path, or an invalid id
+    // if it was not. Such a request is neither on a LockHead nor on a PartitionedLockHead until
+    // it is converted or downgraded, when it moves to the LockHead.
+    ResourceId fastPathResId;
+
+    // Index of the LockManager partition used by this request while it is partitioned. Chosen
+    // when the request is first locked and kept until it is unlocked, because the thread may
+    // since have moved to a different CPU.
+    unsigned partitionId;
+
     // The reason intrusive linked list is used instead of the std::list class is to allow
     // for entries to be removed from the middle of the list in O(1) time, if they are known
     // instead of having to search for them and we cannot persist iterators, because the list
@@ -315,6 +315,135 @@ TEST(LockManager, Conflict) {
     ASSERT(request2.numNotifies == 1);
 }
 
+// Intent mode requests from more lockers than there are partitions must all be released before
+// a conflicting request is granted, and new intent requests must queue behind it.
+TEST(LockManager, ManyPartitionedIntentLocksConflict) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL);
+
+    const int numLockers = 100;
+    std::vector<std::unique_ptr<MMAPV1LockerImpl>> lockers;
+    std::vector<std::unique_ptr<LockRequestCombo>> requests;
+    for (int i = 0; i < numLockers; i++) {
+        lockers.emplace_back(new MMAPV1LockerImpl());
+        requests.emplace_back(new LockRequestCombo(lockers.back().get()));
+        ASSERT(LOCK_OK ==
+               lockMgr.lock(resId, requests.back().get(), (i % 2) ? MODE_IS : MODE_IX));
+        ASSERT(requests.back()->partitioned);
+    }
+
+    MMAPV1LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX, MODE_X));
+
+    MMAPV1LockerImpl lockerLate;
+    LockRequestCombo requestLate(&lockerLate);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestLate, MODE_IS));
+
+    for (int i = 0; i < numLockers; i++) {
+        ASSERT(requestX.numNotifies == 0);
+        ASSERT(lockMgr.unlock(requests[i].get()));
+    }
+
+    ASSERT(requestX.numNotifies == 1);
+    ASSERT(requestX.lastResult == LOCK_OK);
+    ASSERT(requestLate.numNotifies == 0);
+
+    ASSERT(lockMgr.unlock(&requestX));
+    ASSERT(requestLate.numNotifies == 1);
+    ASSERT(requestLate.lastResult == LOCK_OK);
+    ASSERT(lockMgr.unlock(&requestLate));
+}
+
+// Intent requests which allow the fast path are counted rather than queued. A conflicting
+// upgrade makes them count as granted on the LockHead, so that it waits for them, and the fast
+// path is used again once the conflicting requests are gone.
+TEST(LockManager, FastPathConflictAndUpgrade) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_DATABASE, std::string("TestDB"));
+
+    DefaultLockerImpl locker1;
+    LockRequestCombo request1(&locker1);
+    request1.allowFastPath = true;
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IS));
+    ASSERT_EQUALS(resId, request1.fastPathResId);
+    ASSERT(request1.lock == NULL);
+
+    DefaultLockerImpl locker2;
+    LockRequestCombo request2(&locker2);
+    request2.allowFastPath = true;
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IX));
+    ASSERT_EQUALS(resId, request2.fastPathResId);
+
+    DefaultLockerImpl locker3;
+    LockRequestCombo request3(&locker3);
+    request3.allowFastPath = true;
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request3, MODE_IS));
+    ASSERT_EQUALS(resId, request3.fastPathResId);
+
+    // Upgrading to S moves the request to the LockHead, where it waits for the IX request
+    // counted on the fast path.
+    ASSERT(LOCK_WAITING == lockMgr.convert(resId, &request1, MODE_S));
+    ASSERT_FALSE(request1.fastPathResId.isValid());
+    ASSERT(request1.lock != NULL);
+    ASSERT(request1.status == LockRequest::STATUS_CONVERTING);
+
+    // While the fast path is disabled, compatible intent requests are queued on the LockHead and
+    // conflicting ones wait.
+    DefaultLockerImpl locker4;
+    LockRequestCombo request4(&locker4);
+    request4.allowFastPath = true;
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request4, MODE_IS));
+    ASSERT_FALSE(request4.fastPathResId.isValid());
+    ASSERT(request4.lock != NULL);
+
+    DefaultLockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    requestX.allowFastPath = true;
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX, MODE_X));
+
+    // Releasing the IX request, which was granted on the fast path, grants the upgrade.
+    ASSERT(lockMgr.unlock(&request2));
+    ASSERT(request1.numNotifies == 1);
+    ASSERT(request1.lastResult == LOCK_OK);
+    ASSERT(request1.mode == MODE_S);
+
+    // X is granted only once every IS and S request is gone, including the one which is still
+    // counted on the fast path.
+    ASSERT_FALSE(lockMgr.unlock(&request1));
+    ASSERT(lockMgr.unlock(&request1));
+    ASSERT(lockMgr.unlock(&request4));
+    ASSERT(requestX.numNotifies == 0);
+    ASSERT(lockMgr.unlock(&request3));
+    ASSERT(requestX.numNotifies == 1);
+    ASSERT(requestX.lastResult == LOCK_OK);
+
+    // Intent requests wait behind X, and are granted on the LockHead.
+    DefaultLockerImpl locker5;
+    LockRequestCombo request5(&locker5);
+    request5.allowFastPath = true;
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &request5, MODE_IX));
+    ASSERT(lockMgr.unlock(&requestX));
+    ASSERT(request5.numNotifies == 1);
+    ASSERT(request5.lastResult == LOCK_OK);
+    ASSERT(lockMgr.unlock(&request5));
+
+    // Once the conflicting requests are gone, intent requests use the fast path again.
+    DefaultLockerImpl locker6;
+    LockRequestCombo request6(&locker6);
+    request6.allowFastPath = true;
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request6, MODE_IX));
+    ASSERT_EQUALS(resId, request6.fastPathResId);
+    ASSERT(lockMgr.unlock(&request6));
+
+    // Without allowFastPath, requests are never counted on the fast path.
+    DefaultLockerImpl locker7;
+    LockRequestCombo request7(&locker7);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request7, MODE_IS));
+    ASSERT_FALSE(request7.fastPathResId.isValid());
+    ASSERT(lockMgr.unlock(&request7));
+}
+
 TEST(LockManager, MultipleConflict) {
     LockManager lockMgr;
     const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
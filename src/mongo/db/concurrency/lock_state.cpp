@@ -608,6 +608,10 @@ LockResult LockerImpl<IsForMMAPV1>::lockBegin(ResourceId resId, LockMode mode) {
         LockRequestsMap::Iterator itNew = _requests.insert(resId);
         itNew->initNew(this, &_notify);
 
+        // The MMAP V1 flush lock checks for deadlocks, which requires every granted request to
+        // be queued on its lock.
+        itNew->allowFastPath = !IsForMMAPV1;
+
         request = itNew.objAddr();
     } else {
         request = it.objAddr();
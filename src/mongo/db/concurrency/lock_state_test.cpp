@@ -34,6 +34,8 @@
 
 #include "mongo/config.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
 #include "mongo/util/timer.h"
@@ -216,6 +218,115 @@ TEST(LockerImpl, saveAndRestoreDBAndCollection) {
     ASSERT(locker.unlockAll());
 }
 
+namespace {
+
+/**
+ * Returns whether a locker holding "mode" can do so while "holders" lockers hold each mode,
+ * including itself.
+ */
+bool isCompatibleWithHolders(LockMode mode, const AtomicInt32* holders) {
+    switch (mode) {
+        case MODE_IS:
+            return holders[MODE_X].load() == 0;
+        case MODE_IX:
+            return holders[MODE_S].load() == 0 && holders[MODE_X].load() == 0;
+        case MODE_S:
+            return holders[MODE_IX].load() == 0 && holders[MODE_X].load() == 0;
+        case MODE_X:
+            return holders[MODE_IS].load() == 0 && holders[MODE_IX].load() == 0 &&
+                holders[MODE_S].load() == 0 && holders[MODE_X].load() == 1;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+// Intent requests on the global and database resources are counted on the lock manager's fast
+// path. Lockers taking them concurrently with upgrades and conflicting X requests, which fall
+// back to the LockHead, must never hold conflicting modes at the same time, and must leave the
+// counts at zero.
+TEST(LockerImpl, FastPathConcurrentGrantAndRelease) {
+    const ResourceId resId(RESOURCE_DATABASE, std::string("FastPathTestDB"));
+    const int kNumThreads = 8;
+    const int kIterations = 2000;
+
+    AtomicInt32 holders[LockModesCount];
+    AtomicUInt32 failures;
+
+    auto hold = [&](LockMode mode) {
+        holders[mode].fetchAndAdd(1);
+        if (!isCompatibleWithHolders(mode, holders)) {
+            failures.fetchAndAdd(1);
+        }
+    };
+
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < kNumThreads; t++) {
+        threads.emplace_back([&, t] {
+            DefaultLockerImpl locker;
+            for (int i = 0; i < kIterations; i++) {
+                if (locker.lockGlobal(MODE_IX) != LOCK_OK) {
+                    failures.fetchAndAdd(1);
+                    continue;
+                }
+
+                const int op = (i + t) % 8;
+                if (op == 0) {
+                    // Conflicts with every intent request.
+                    if (locker.lock(resId, MODE_X) != LOCK_OK) {
+                        failures.fetchAndAdd(1);
+                    }
+                    hold(MODE_X);
+                    holders[MODE_X].fetchAndSubtract(1);
+                    locker.unlock(resId);
+                } else if (op == 1) {
+                    // Upgrades a request which may have been granted on the fast path.
+                    if (locker.lock(resId, MODE_IS) != LOCK_OK) {
+                        failures.fetchAndAdd(1);
+                    }
+                    hold(MODE_IS);
+                    if (locker.lock(resId, MODE_S) != LOCK_OK) {
+                        failures.fetchAndAdd(1);
+                    }
+                    hold(MODE_S);
+                    holders[MODE_IS].fetchAndSubtract(1);
+                    holders[MODE_S].fetchAndSubtract(1);
+                    if (locker.unlock(resId) || !locker.unlock(resId)) {
+                        failures.fetchAndAdd(1);
+                    }
+                } else {
+                    const LockMode mode = (op % 2) ? MODE_IS : MODE_IX;
+                    if (locker.lock(resId, mode) != LOCK_OK) {
+                        failures.fetchAndAdd(1);
+                    }
+                    hold(mode);
+                    holders[mode].fetchAndSubtract(1);
+                    locker.unlock(resId);
+                }
+
+                if (!locker.unlockAll()) {
+                    failures.fetchAndAdd(1);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQUALS(0U, failures.load());
+
+    // Nothing is left counted on the fast path, so conflicting modes are granted right away.
+    DefaultLockerImpl locker;
+    ASSERT(LOCK_OK == locker.lockGlobal(MODE_X, 0));
+    ASSERT(LOCK_OK == locker.lock(resId, MODE_X, 0));
+    ASSERT(locker.unlockAll());
+
+    ASSERT(LOCK_OK == locker.lockGlobal(MODE_IX, 0));
+    ASSERT(LOCK_OK == locker.lock(resId, MODE_IX, 0));
+    ASSERT(locker.unlockAll());
+}
+
 TEST(LockerImpl, DefaultLocker) {
     const ResourceId resId(RESOURCE_DATABASE, std::string("TestDB"));
 
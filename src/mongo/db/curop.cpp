@@ -406,6 +406,8 @@ void OpDebug::reset() {
     cursorExhausted = false;
     keyUpdates = 0;  // unsigned, so -1 not possible
     writeConflicts = 0;
+    arenaAllocs = -1;
+    arenaBytes = -1;
     planSummary = "";
     execStats.reset();
 
@@ -490,6 +492,8 @@ string OpDebug::report(const CurOp& curop, const SingleThreadedLockStats& lockSt
     OPDEBUG_TOSTRING_HELP_BOOL(cursorExhausted);
     OPDEBUG_TOSTRING_HELP(keyUpdates);
     OPDEBUG_TOSTRING_HELP(writeConflicts);
+    OPDEBUG_TOSTRING_HELP(arenaAllocs);
+    OPDEBUG_TOSTRING_HELP(arenaBytes);
 
     if (!exceptionInfo.empty()) {
         s << " exception: " << exceptionInfo.msg;
@@ -599,6 +603,8 @@ void OpDebug::append(const CurOp& curop,
     OPDEBUG_APPEND_BOOL(cursorExhausted);
     OPDEBUG_APPEND_NUMBER(keyUpdates);
     OPDEBUG_APPEND_NUMBER(writeConflicts);
+    OPDEBUG_APPEND_NUMBER(arenaAllocs);
+    OPDEBUG_APPEND_NUMBER(arenaBytes);
     b.appendNumber("numYield", curop.numYields());
 
     {
@@ -176,6 +176,8 @@ public:
     bool cursorExhausted;  // true if the cursor has been closed at end a find/getMore operation
     int keyUpdates;
     long long writeConflicts;
+    long long arenaAllocs;  // number of allocations from the operation's Arena
+    long long arenaBytes;   // bytes the operation's Arena took from the heap
     ThreadSafeString planSummary;  // a brief std::string describing the query solution
 
     // New Query Framework debugging/profiling info
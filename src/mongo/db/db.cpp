@@ -40,6 +40,7 @@
 #include <signal.h>
 #include <string>
 
+#include "mongo/base/checked_cast.h"
 #include "mongo/base/init.h"
 #include "mongo/base/initializer.h"
 #include "mongo/base/status.h"
@@ -70,6 +71,7 @@
 #include "mongo/db/mongod_options.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/operation_context_impl.h"
+#include "mongo/db/plan_cache_persister.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/range_deleter_service.h"
 #include "mongo/db/repair_database.h"
@@ -152,6 +154,14 @@ public:
         Client::initThread("conn", p);
     }
 
+    virtual std::unique_ptr<ConnectionState> suspend(AbstractMessagingPort* p) {
+        return stdx::make_unique<ClientState>(Client::releaseCurrent());
+    }
+
+    virtual void resume(std::unique_ptr<ConnectionState> state, AbstractMessagingPort* p) {
+        Client::setCurrent(std::move(checked_cast<ClientState*>(state.get())->client));
+    }
+
     virtual void process(Message& m, AbstractMessagingPort* port) {
         while (true) {
             if (inShutdown()) {
@@ -196,6 +206,14 @@ public:
             break;
         }
     }
+
+private:
+    // Carries the connection's Client from one worker thread to the next.
+    struct ClientState : public ConnectionState {
+        explicit ClientState(ServiceContext::UniqueClient c) : client(std::move(c)) {}
+
+        ServiceContext::UniqueClient client;
+    };
 };
 
 static void logStartup() {
@@ -555,7 +573,7 @@ static void _initAndListen(int listenPort) {
             exitCleanly(EXIT_NEED_UPGRADE);
         }
 
-        getDeleter()->startWorkers();
+        getDeleter()->startWorkers(std::max(1, rangeDeleterWorkers));
 
         restartInProgressIndexesFromLastShutdown(&txn);
 
@@ -580,6 +598,8 @@ static void _initAndListen(int listenPort) {
 
     startClientCursorMonitor();
 
+    startPlanCachePersister();
+
     PeriodicTask::startRunningPeriodicTasks();
 
     logStartup();
@@ -61,9 +61,12 @@
 #include "mongo/db/write_concern_options.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -77,6 +80,12 @@ using std::stringstream;
 
 using logger::LogComponent;
 
+// The number of documents Helpers::removeRange deletes under one acquisition of the write lock.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchSize, int, 128);
+
+// After each batch, Helpers::removeRange sleeps for this many times as long as the batch took.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchPacingFactor, double, 0.5);
+
 void Helpers::ensureIndex(OperationContext* txn,
                           Collection* collection,
                           BSONObj keyPattern,
@@ -336,7 +345,15 @@ long long Helpers::removeRange(OperationContext* txn,
 
     Milliseconds millisWaitingForReplication{0};
 
-    while (1) {
+    bool done = false;
+    while (!done) {
+        // Checked here since the index scan below does not yield, and so does not check
+        // for interrupts itself.
+        txn->checkForInterrupt();
+
+        Timer batchTimer;
+        long long numDeletedInBatch = 0;
+
         // Scoping for write lock.
         {
             OldClientWriteContext ctx(txn, ns);
@@ -347,26 +364,25 @@ long long Helpers::removeRange(OperationContext* txn,
             IndexDescriptor* desc =
                 collection->getIndexCatalog()->findIndexByKeyPattern(txn, indexKeyPattern.toBSON());
 
-            unique_ptr<PlanExecutor> exec(
-                InternalPlanner::indexScan(txn,
-                                           collection,
-                                           desc,
-                                           min,
-                                           max,
-                                           maxInclusive,
-                                           PlanExecutor::YIELD_MANUAL,
-                                           InternalPlanner::FORWARD,
-                                           InternalPlanner::IXSCAN_FETCH));
-            exec->setYieldPolicy(PlanExecutor::YIELD_AUTO);
-
+            // Find the next batch of documents from the index keys alone. The scan does not
+            // yield, so that the documents found are still there to be deleted under this lock.
+            unique_ptr<PlanExecutor> exec(InternalPlanner::indexScan(txn,
+                                                                     collection,
+                                                                     desc,
+                                                                     min,
+                                                                     max,
+                                                                     maxInclusive,
+                                                                     PlanExecutor::YIELD_MANUAL,
+                                                                     InternalPlanner::FORWARD));
+
+            const size_t batchSize = std::max(1, rangeDeleterBatchSize);
+            std::vector<RecordId> batch;
             RecordId rloc;
             BSONObj obj;
-            PlanExecutor::ExecState state;
-            // This may yield so we cannot touch nsd after this.
-            state = exec->getNext(&obj, &rloc);
-            exec.reset();
-            if (PlanExecutor::IS_EOF == state) {
-                break;
+            PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+            while (batch.size() < batchSize &&
+                   PlanExecutor::ADVANCED == (state = exec->getNext(&obj, &rloc))) {
+                batch.push_back(rloc);
             }
 
             if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
@@ -379,63 +395,78 @@ long long Helpers::removeRange(OperationContext* txn,
                 break;
             }
 
-            verify(PlanExecutor::ADVANCED == state);
-
-            WriteUnitOfWork wuow(txn);
-
-            if (onlyRemoveOrphanedDocs) {
-                // Do a final check in the write lock to make absolutely sure that our
-                // collection hasn't been modified in a way that invalidates our migration
-                // cleanup.
-
-                // We should never be able to turn off the sharding state once enabled, but
-                // in the future we might want to.
-                verify(ShardingState::get(getGlobalServiceContext())->enabled());
-
-                bool docIsOrphan;
+            // The scan reached the end of the range, so this is the last batch.
+            done = PlanExecutor::IS_EOF == state;
+            exec.reset();
 
-                // In write lock, so will be the most up-to-date version
-                std::shared_ptr<CollectionMetadata> metadataNow =
-                    ShardingState::get(getGlobalServiceContext())->getCollectionMetadata(ns);
-                if (metadataNow) {
-                    ShardKeyPattern kp(metadataNow->getKeyPattern());
-                    BSONObj key = kp.extractShardKeyFromDoc(obj);
-                    docIsOrphan =
-                        !metadataNow->keyBelongsToMe(key) && !metadataNow->keyIsPending(key);
-                } else {
-                    docIsOrphan = false;
+            for (std::vector<RecordId>::const_iterator it = batch.begin(); it != batch.end();
+                 ++it) {
+                Snapshotted<BSONObj> doc;
+                if (!collection->findDoc(txn, *it, &doc)) {
+                    // Deleted by someone else since the index scan saw it.
+                    continue;
                 }
 
-                if (!docIsOrphan) {
-                    warning(LogComponent::kSharding)
-                        << "aborting migration cleanup for chunk " << min << " to " << max
-                        << (metadataNow ? (string) " at document " + obj.toString() : "")
-                        << ", collection " << ns << " has changed " << endl;
-                    break;
+                WriteUnitOfWork wuow(txn);
+
+                if (onlyRemoveOrphanedDocs) {
+                    // Do a final check in the write lock to make absolutely sure that our
+                    // collection hasn't been modified in a way that invalidates our migration
+                    // cleanup.
+
+                    // We should never be able to turn off the sharding state once enabled, but
+                    // in the future we might want to.
+                    verify(ShardingState::get(getGlobalServiceContext())->enabled());
+
+                    bool docIsOrphan;
+
+                    // In write lock, so will be the most up-to-date version
+                    std::shared_ptr<CollectionMetadata> metadataNow =
+                        ShardingState::get(getGlobalServiceContext())->getCollectionMetadata(ns);
+                    if (metadataNow) {
+                        ShardKeyPattern kp(metadataNow->getKeyPattern());
+                        BSONObj key = kp.extractShardKeyFromDoc(doc.value());
+                        docIsOrphan =
+                            !metadataNow->keyBelongsToMe(key) && !metadataNow->keyIsPending(key);
+                    } else {
+                        docIsOrphan = false;
+                    }
+
+                    if (!docIsOrphan) {
+                        warning(LogComponent::kSharding)
+                            << "aborting migration cleanup for chunk " << min << " to " << max
+                            << (metadataNow ? (string) " at document " + doc.value().toString()
+                                            : "")
+                            << ", collection " << ns << " has changed " << endl;
+                        done = true;
+                        break;
+                    }
                 }
-            }
 
-            NamespaceString nss(ns);
-            if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(nss)) {
-                warning() << "stepped down from primary while deleting chunk; "
-                          << "orphaning data in " << ns << " in range [" << min << ", " << max
-                          << ")";
-                return numDeleted;
-            }
+                NamespaceString nss(ns);
+                if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(nss)) {
+                    warning() << "stepped down from primary while deleting chunk; "
+                              << "orphaning data in " << ns << " in range [" << min << ", "
+                              << max << ")";
+                    return numDeleted;
+                }
 
-            if (callback)
-                callback->goingToDelete(obj);
+                if (callback)
+                    callback->goingToDelete(doc.value());
 
-            BSONObj deletedId;
-            collection->deleteDocument(txn, rloc, false, false, &deletedId);
-            wuow.commit();
-            numDeleted++;
+                BSONObj deletedId;
+                collection->deleteDocument(txn, *it, false, false, &deletedId);
+                wuow.commit();
+                numDeleted++;
+                numDeletedInBatch++;
+            }
         }
+        const long long batchMillis = batchTimer.millis();
 
         // TODO remove once the yielding below that references this timer has been removed
         Timer secondaryThrottleTime;
 
-        if (writeConcern.shouldWaitForOtherNodes() && numDeleted > 0) {
+        if (writeConcern.shouldWaitForOtherNodes() && numDeletedInBatch > 0) {
             repl::ReplicationCoordinator::StatusAndDuration replStatus =
                 repl::getGlobalReplicationCoordinator()->awaitReplication(
                     txn,
@@ -449,6 +480,12 @@ long long Helpers::removeRange(OperationContext* txn,
             }
             millisWaitingForReplication += replStatus.duration;
         }
+
+        // Leave the disk idle for a while in proportion to how long the batch held the lock, so
+        // that a batch slowed down by foreground load is followed by a longer pause.
+        if (!done && rangeDeleterBatchPacingFactor > 0) {
+            sleepmillis(static_cast<long long>(batchMillis * rangeDeleterBatchPacingFactor));
+        }
     }
 
     if (writeConcern.shouldWaitForOtherNodes())
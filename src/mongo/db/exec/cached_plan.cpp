@@ -200,6 +200,7 @@ Status CachedPlanStage::replan(PlanYieldPolicy* yieldPolicy, bool shouldCache) {
 
     // Use the query planning module to plan the whole query.
     std::vector<QuerySolution*> rawSolutions;
+    _plannerParams.arena = getOpCtx()->getArena();
     Status status = QueryPlanner::plan(*_canonicalQuery, _plannerParams, &rawSolutions);
     if (!status.isOK()) {
         return Status(ErrorCodes::BadValue,
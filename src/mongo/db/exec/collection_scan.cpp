@@ -38,6 +38,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
@@ -66,6 +67,10 @@ CollectionScan::CollectionScan(OperationContext* txn,
       _wsidForFetch(_workingSet->allocate()) {
     // Explain reports the direction of the collection scan.
     _specificStats.direction = params.direction;
+
+    if (_filter && internalQueryExecCompileFilters) {
+        _compiledFilter = CompiledMatchExpression::compile(_filter);
+    }
 }
 
 PlanStage::StageState CollectionScan::work(WorkingSetID* out) {
@@ -74,6 +79,33 @@ PlanStage::StageState CollectionScan::work(WorkingSetID* out) {
     // Adds the amount of time taken by work() to executionTimeMillis.
     ScopedTimer timer(&_commonStats.executionTimeMillis);
 
+    return doWork(out);
+}
+
+PlanStage::StageState CollectionScan::workBatch(size_t maxWorks,
+                                                vector<WorkingSetID>* results,
+                                                WorkingSetID* out) {
+    // Adds the amount of time taken by workBatch() to executionTimeMillis.
+    ScopedTimer timer(&_commonStats.executionTimeMillis);
+
+    const size_t numResultsBefore = results->size();
+    for (size_t i = 0; i < maxWorks; ++i) {
+        ++_commonStats.works;
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState state = doWork(&id);
+        if (PlanStage::ADVANCED == state) {
+            results->push_back(id);
+        } else if (PlanStage::NEED_TIME != state) {
+            *out = id;
+            return state;
+        }
+    }
+
+    return results->size() > numResultsBefore ? PlanStage::ADVANCED : PlanStage::NEED_TIME;
+}
+
+PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     if (_isDead) {
         Status status(
             ErrorCodes::CappedPositionLost,
@@ -175,7 +207,7 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
         *out = memberID;
         ++_commonStats.advanced;
         return PlanStage::ADVANCED;
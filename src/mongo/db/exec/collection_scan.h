@@ -32,6 +32,7 @@
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 
@@ -55,6 +56,9 @@ public:
                    const MatchExpression* filter);
 
     StageState work(WorkingSetID* out) final;
+    StageState workBatch(size_t maxWorks,
+                         std::vector<WorkingSetID>* results,
+                         WorkingSetID* out) final;
     bool isEOF() final;
 
     void doInvalidate(OperationContext* txn, const RecordId& dl, InvalidationType type) final;
@@ -74,6 +78,12 @@ public:
     static const char* kStageType;
 
 private:
+    /**
+     * Performs one unit of work, without the per-call bookkeeping shared by work() and
+     * workBatch().
+     */
+    StageState doWork(WorkingSetID* out);
+
     /**
      * If the member (with id memberID) passes our filter, set *out to memberID and return that
      * ADVANCED.  Otherwise, free memberID and return NEED_TIME.
@@ -86,6 +96,9 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // '_filter' compiled for evaluation against many documents, or NULL.
+    std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
     std::unique_ptr<RecordCursor> _cursor;
 
     CollectionScanParams _params;
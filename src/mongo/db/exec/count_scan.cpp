@@ -48,7 +48,8 @@ CountScan::CountScan(OperationContext* txn, const CountScanParams& params, Worki
       _descriptor(params.descriptor),
       _iam(params.descriptor->getIndexCatalog()->getIndex(params.descriptor)),
       _shouldDedup(params.descriptor->isMultikey(txn)),
-      _params(params) {
+      _params(params),
+      _needSeek(false) {
     _specificStats.keyPattern = _params.descriptor->keyPattern();
     _specificStats.indexName = _params.descriptor->indexName();
     _specificStats.isMultiKey = _params.descriptor->isMultikey(txn);
@@ -57,6 +58,16 @@ CountScan::CountScan(OperationContext* txn, const CountScanParams& params, Worki
     _specificStats.isPartial = _params.descriptor->isPartial();
     _specificStats.indexVersion = _params.descriptor->version();
 
+    if (!_params.bounds.fields.empty()) {
+        _checker = make_unique<IndexBoundsChecker>(
+            &_params.bounds, _descriptor->keyPattern(), _params.direction);
+        _needSeek = true;
+
+        // If there is no valid data, just mark as EOF.
+        _commonStats.isEOF = !_checker->getStartSeekPoint(&_seekPoint);
+        return;
+    }
+
     // endKey must be after startKey in index order since we only do forward scans.
     dassert(_params.startKey.woCompare(_params.endKey,
                                        Ordering::make(params.descriptor->keyPattern()),
@@ -75,17 +86,22 @@ PlanStage::StageState CountScan::work(WorkingSetID* out) {
     boost::optional<IndexKeyEntry> entry;
     const bool needInit = !_cursor;
     try {
-        // We don't care about the keys.
-        const auto kWantLoc = SortedDataInterface::Cursor::kWantLoc;
-
-        if (needInit) {
-            // First call to work().  Perform cursor init.
+        if (_checker) {
+            // The keys are needed to check them against the bounds.
+            if (needInit)
+                _cursor = _iam->newCursor(getOpCtx(), _params.direction == 1);
+
+            entry = _needSeek ? _cursor->seek(_seekPoint) : _cursor->next();
+        } else if (needInit) {
+            // First call to work().  Perform cursor init.  We don't care about the keys.
             _cursor = _iam->newCursor(getOpCtx());
             _cursor->setEndPosition(_params.endKey, _params.endKeyInclusive);
 
-            entry = _cursor->seek(_params.startKey, _params.startKeyInclusive, kWantLoc);
+            entry = _cursor->seek(_params.startKey,
+                                  _params.startKeyInclusive,
+                                  SortedDataInterface::Cursor::kWantLoc);
         } else {
-            entry = _cursor->next(kWantLoc);
+            entry = _cursor->next(SortedDataInterface::Cursor::kWantLoc);
         }
     } catch (const WriteConflictException& wce) {
         if (needInit) {
@@ -104,6 +120,26 @@ PlanStage::StageState CountScan::work(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_checker) {
+        switch (_checker->checkKey(entry->key, &_seekPoint)) {
+            case IndexBoundsChecker::MUST_ADVANCE:
+                // The checker has set '_seekPoint' to the start of the next interval.
+                _needSeek = true;
+                ++_commonStats.needTime;
+                return PlanStage::NEED_TIME;
+
+            case IndexBoundsChecker::DONE:
+                _commonStats.isEOF = true;
+                _cursor.reset();
+                return PlanStage::IS_EOF;
+
+            case IndexBoundsChecker::VALID:
+                // The adjacent key may be in bounds as well, so step to it next time.
+                _needSeek = false;
+                break;
+        }
+    }
+
     if (_shouldDedup && !_returned.insert(entry->loc).second) {
         // *loc was already in _returned.
         ++_commonStats.needTime;
@@ -120,8 +156,16 @@ bool CountScan::isEOF() {
 }
 
 void CountScan::doSaveState() {
-    if (_cursor)
-        _cursor->savePositioned();
+    if (!_cursor)
+        return;
+
+    // The position only matters if we are going to step from it rather than seek.
+    if (_checker && _needSeek) {
+        _cursor->saveUnpositioned();
+        return;
+    }
+
+    _cursor->savePositioned();
 }
 
 void CountScan::doRestoreState() {
@@ -163,6 +207,10 @@ unique_ptr<PlanStageStats> CountScan::getStats() {
 
     unique_ptr<CountScanStats> countStats = make_unique<CountScanStats>(_specificStats);
     countStats->keyPattern = _specificStats.keyPattern.getOwned();
+    if (_checker) {
+        // Serialized here rather than in the constructor so that only explain pays for it.
+        countStats->indexBounds = _params.bounds.toBSON();
+    }
     ret->specific = std::move(countStats);
 
     return ret;
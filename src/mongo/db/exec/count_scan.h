@@ -34,6 +34,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
 #include "mongo/platform/unordered_set.h"
 
@@ -44,7 +45,7 @@ class IndexDescriptor;
 class WorkingSet;
 
 struct CountScanParams {
-    CountScanParams() : descriptor(NULL) {}
+    CountScanParams() : descriptor(NULL), direction(1) {}
 
     // What index are we traversing?
     const IndexDescriptor* descriptor;
@@ -54,12 +55,19 @@ struct CountScanParams {
 
     BSONObj endKey;
     bool endKeyInclusive;
+
+    // If 'bounds' has any fields, the scan instead counts the keys within these bounds, traversing
+    // the index in 'direction' and seeking over the gaps between intervals. The start and end keys
+    // are then unused.
+    IndexBounds bounds;
+    int direction;
 };
 
 /**
- * Used by the count command.  Scans an index from a start key to an end key.  Does not create
- * any WorkingSetMember(s) for any of the data, instead returning ADVANCED to indicate to the
- * caller that another result should be counted.
+ * Used by the count command.  Scans an index from a start key to an end key, or over a set of
+ * index bounds with several intervals.  Does not create any WorkingSetMember(s) for any of the
+ * data, instead returning ADVANCED to indicate to the caller that another result should be
+ * counted.
  *
  * Only created through the getExecutorCount path, as count is the only operation that doesn't
  * care about its data.
@@ -102,6 +110,15 @@ private:
 
     CountScanParams _params;
 
+    // Only set when counting over '_params.bounds'. Tells us where to seek next and whether we
+    // are still in bounds.
+    std::unique_ptr<IndexBoundsChecker> _checker;
+    IndexSeekPoint _seekPoint;
+
+    // True if the next call to work() repositions the cursor at '_seekPoint' rather than stepping
+    // to the adjacent key. Only used with '_checker'.
+    bool _needSeek;
+
     CountScanStats _specificStats;
 };
 
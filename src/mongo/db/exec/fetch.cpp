@@ -35,6 +35,7 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
@@ -58,8 +59,15 @@ FetchStage::FetchStage(OperationContext* txn,
       _collection(collection),
       _ws(ws),
       _filter(filter),
-      _idRetrying(WorkingSet::INVALID_ID) {
+      _idRetrying(WorkingSet::INVALID_ID),
+      _hasChildBatchEndState(false),
+      _childBatchEndState(PlanStage::NEED_TIME),
+      _childBatchEndId(WorkingSet::INVALID_ID) {
     _children.emplace_back(child);
+
+    if (_filter && internalQueryExecCompileFilters) {
+        _compiledFilter = CompiledMatchExpression::compile(_filter);
+    }
 }
 
 FetchStage::~FetchStage() {}
@@ -71,6 +79,11 @@ bool FetchStage::isEOF() {
         return false;
     }
 
+    if (!_childResults.empty() || _hasChildBatchEndState) {
+        // Our child's last batch still has results or a state for us to pass up.
+        return false;
+    }
+
     return child()->isEOF();
 }
 
@@ -84,17 +97,97 @@ PlanStage::StageState FetchStage::work(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
-    // Either retry the last WSM we worked on or get a new one from our child.
-    WorkingSetID id;
-    StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
-    } else {
-        status = ADVANCED;
-        id = _idRetrying;
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = nextFromChild(&id);
+    return doWork(status, id, out);
+}
+
+PlanStage::StageState FetchStage::workBatch(size_t maxWorks,
+                                            vector<WorkingSetID>* results,
+                                            WorkingSetID* out) {
+    // Adds the amount of time taken by workBatch() to executionTimeMillis.
+    ScopedTimer timer(&_commonStats.executionTimeMillis);
+
+    const size_t numResultsBefore = results->size();
+    size_t numWorks = 0;
+    while (numWorks < maxWorks) {
+        if (isEOF()) {
+            ++_commonStats.works;
+            return PlanStage::IS_EOF;
+        }
+
+        if (WorkingSet::INVALID_ID == _idRetrying && _childResults.empty() &&
+            !_hasChildBatchEndState) {
+            // Take a batch from our child, of at most as many units of work as we have left.
+            const size_t childWorksBefore = child()->getCommonStats()->works;
+            vector<WorkingSetID> childResults;
+            WorkingSetID childId = WorkingSet::INVALID_ID;
+            StageState childStatus =
+                child()->workBatch(maxWorks - numWorks, &childResults, &childId);
+
+            _childResults.insert(_childResults.end(), childResults.begin(), childResults.end());
+            if (PlanStage::ADVANCED != childStatus && PlanStage::NEED_TIME != childStatus) {
+                _hasChildBatchEndState = true;
+                _childBatchEndState = childStatus;
+                _childBatchEndId = childId;
+            }
+
+            // Each unit of work by our child that produced neither a result nor the state
+            // ending its batch would have been a NEED_TIME from us.
+            const size_t numChildWorks = child()->getCommonStats()->works - childWorksBefore;
+            const size_t numProduced = childResults.size() + (_hasChildBatchEndState ? 1 : 0);
+            if (numChildWorks > numProduced) {
+                const size_t numNeedTime = numChildWorks - numProduced;
+                _commonStats.works += numNeedTime;
+                _commonStats.needTime += numNeedTime;
+                numWorks += numNeedTime;
+            }
+            continue;
+        }
+
+        ++_commonStats.works;
+        ++numWorks;
+
+        WorkingSetID childId = WorkingSet::INVALID_ID;
+        StageState childStatus = nextFromChild(&childId);
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState status = doWork(childStatus, childId, &id);
+        if (PlanStage::ADVANCED == status) {
+            results->push_back(id);
+        } else if (PlanStage::NEED_TIME != status) {
+            *out = id;
+            return status;
+        }
+    }
+
+    return results->size() > numResultsBefore ? PlanStage::ADVANCED : PlanStage::NEED_TIME;
+}
+
+PlanStage::StageState FetchStage::nextFromChild(WorkingSetID* id) {
+    // Retry the last WSM we worked on, then drain what is left of our child's last batch, and
+    // only then get something new from our child.
+    if (WorkingSet::INVALID_ID != _idRetrying) {
+        *id = _idRetrying;
         _idRetrying = WorkingSet::INVALID_ID;
+        return PlanStage::ADVANCED;
+    }
+
+    if (!_childResults.empty()) {
+        *id = _childResults.front();
+        _childResults.pop_front();
+        return PlanStage::ADVANCED;
+    }
+
+    if (_hasChildBatchEndState) {
+        _hasChildBatchEndState = false;
+        *id = _childBatchEndId;
+        return _childBatchEndState;
     }
 
+    return child()->work(id);
+}
+
+PlanStage::StageState FetchStage::doWork(StageState status, WorkingSetID id, WorkingSetID* out) {
     if (PlanStage::ADVANCED == status) {
         WorkingSetMember* member = _ws->get(id);
 
@@ -188,6 +281,14 @@ void FetchStage::doInvalidate(OperationContext* txn, const RecordId& dl, Invalid
             WorkingSetCommon::fetchAndInvalidateLoc(txn, member, _collection);
         }
     }
+
+    // The same goes for the results of our child's last batch that we have yet to fetch.
+    for (WorkingSetID id : _childResults) {
+        WorkingSetMember* member = _ws->get(id);
+        if (member->hasLoc() && (member->loc == dl)) {
+            WorkingSetCommon::fetchAndInvalidateLoc(txn, member, _collection);
+        }
+    }
 }
 
 PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
@@ -209,7 +310,7 @@ PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
     // predicate.
     ++_specificStats.docsExamined;
 
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
         *out = memberID;
 
         ++_commonStats.advanced;
@@ -28,10 +28,12 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 
@@ -59,6 +61,9 @@ public:
 
     bool isEOF() final;
     StageState work(WorkingSetID* out) final;
+    StageState workBatch(size_t maxWorks,
+                         std::vector<WorkingSetID>* results,
+                         WorkingSetID* out) final;
 
     void doSaveState() final;
     void doRestoreState() final;
@@ -77,6 +82,19 @@ public:
     static const char* kStageType;
 
 private:
+    /**
+     * Returns what the next call to our child's work() would, taking into account any member
+     * we are retrying and any results left over from a batch of the child's.
+     */
+    StageState nextFromChild(WorkingSetID* id);
+
+    /**
+     * Fetches and filters the result of 'nextFromChild()', or passes up any other state.
+     * Performs one unit of work without the per-call bookkeeping shared by work() and
+     * workBatch().
+     */
+    StageState doWork(StageState childStatus, WorkingSetID id, WorkingSetID* out);
+
     /**
      * If the member (with id memberID) passes our filter, set *out to memberID and return that
      * ADVANCED.  Otherwise, free memberID and return NEED_TIME.
@@ -95,9 +113,22 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // '_filter' compiled for evaluation against many documents, or NULL.
+    std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // Results taken from our child by workBatch() but not yet fetched because a fetch needed
+    // to yield first. These come before anything else from our child.
+    std::deque<WorkingSetID> _childResults;
+
+    // If set, the state other than ADVANCED or NEED_TIME that ended the child's batch, with
+    // its WSID. It is passed up once _childResults is drained.
+    bool _hasChildBatchEndState;
+    StageState _childBatchEndState;
+    WorkingSetID _childBatchEndId;
+
     // Stats
     FetchStats _specificStats;
 };
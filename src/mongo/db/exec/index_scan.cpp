@@ -127,6 +127,33 @@ PlanStage::StageState IndexScan::work(WorkingSetID* out) {
     // Adds the amount of time taken by work() to executionTimeMillis.
     ScopedTimer timer(&_commonStats.executionTimeMillis);
 
+    return doWork(out);
+}
+
+PlanStage::StageState IndexScan::workBatch(size_t maxWorks,
+                                           std::vector<WorkingSetID>* results,
+                                           WorkingSetID* out) {
+    // Adds the amount of time taken by workBatch() to executionTimeMillis.
+    ScopedTimer timer(&_commonStats.executionTimeMillis);
+
+    const size_t numResultsBefore = results->size();
+    for (size_t i = 0; i < maxWorks; ++i) {
+        ++_commonStats.works;
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState state = doWork(&id);
+        if (PlanStage::ADVANCED == state) {
+            results->push_back(id);
+        } else if (PlanStage::NEED_TIME != state) {
+            *out = id;
+            return state;
+        }
+    }
+
+    return results->size() > numResultsBefore ? PlanStage::ADVANCED : PlanStage::NEED_TIME;
+}
+
+PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     // Get the next kv pair from the index, if any.
     boost::optional<IndexKeyEntry> kv;
     try {
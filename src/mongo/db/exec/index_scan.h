@@ -96,6 +96,9 @@ public:
               const MatchExpression* filter);
 
     StageState work(WorkingSetID* out) final;
+    StageState workBatch(size_t maxWorks,
+                         std::vector<WorkingSetID>* results,
+                         WorkingSetID* out) final;
     bool isEOF() final;
     void doSaveState() final;
     void doRestoreState() final;
@@ -114,6 +117,12 @@ public:
     static const char* kStageType;
 
 private:
+    /**
+     * Performs one unit of work, without the per-call bookkeeping shared by work() and
+     * workBatch().
+     */
+    StageState doWork(WorkingSetID* out);
+
     /**
      * Initialize the underlying index Cursor, returning first result if any.
      */
@@ -95,6 +95,50 @@ PlanStage::StageState LimitStage::work(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState LimitStage::workBatch(size_t maxWorks,
+                                            vector<WorkingSetID>* results,
+                                            WorkingSetID* out) {
+    // Adds the amount of time taken by workBatch() to executionTimeMillis.
+    ScopedTimer timer(&_commonStats.executionTimeMillis);
+
+    if (0 == _numToReturn) {
+        // We've returned as many results as we're limited to.
+        ++_commonStats.works;
+        return PlanStage::IS_EOF;
+    }
+
+    // Each unit of work by our child produces at most one result, so limiting the units of
+    // work also keeps the child from producing results beyond our limit.
+    const size_t numChildWorks = static_cast<size_t>(
+        std::min(static_cast<long long>(maxWorks), _numToReturn));
+
+    const size_t firstResult = results->size();
+    const size_t childWorksBefore = child()->getCommonStats()->works;
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = child()->workBatch(numChildWorks, results, &id);
+
+    const size_t numResults = results->size() - firstResult;
+    _numToReturn -= numResults;
+    recordChildBatch(child()->getCommonStats()->works - childWorksBefore, numResults, status);
+
+    if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+        *out = id;
+        // If a stage fails, it may create a status WSM to indicate why it
+        // failed, in which case 'id' is valid.  If ID is invalid, we
+        // create our own error message.
+        if (WorkingSet::INVALID_ID == id) {
+            mongoutils::str::stream ss;
+            ss << "limit stage failed to read in results from child";
+            Status status(ErrorCodes::InternalError, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        }
+    } else if (PlanStage::NEED_YIELD == status) {
+        *out = id;
+    }
+
+    return status;
+}
+
 unique_ptr<PlanStageStats> LimitStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_LIMIT);
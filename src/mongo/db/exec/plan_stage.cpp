@@ -34,6 +34,39 @@
 
 namespace mongo {
 
+PlanStage::StageState PlanStage::workBatch(size_t maxWorks,
+                                           std::vector<WorkingSetID>* results,
+                                           WorkingSetID* out) {
+    const size_t numResultsBefore = results->size();
+    for (size_t i = 0; i < maxWorks; ++i) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState state = work(&id);
+        if (ADVANCED == state) {
+            results->push_back(id);
+        } else if (NEED_TIME != state) {
+            *out = id;
+            return state;
+        }
+    }
+
+    return results->size() > numResultsBefore ? ADVANCED : NEED_TIME;
+}
+
+void PlanStage::recordChildBatch(size_t numChildWorks, size_t numResults, StageState state) {
+    _commonStats.works += numChildWorks;
+    _commonStats.advanced += numResults;
+
+    size_t numNeedTime = numChildWorks - numResults;
+    if (ADVANCED != state && NEED_TIME != state) {
+        // The unit of work that ended the batch returned 'state' rather than NEED_TIME.
+        --numNeedTime;
+        if (NEED_YIELD == state) {
+            ++_commonStats.needYield;
+        }
+    }
+    _commonStats.needTime += numNeedTime;
+}
+
 void PlanStage::saveState() {
     ++_commonStats.yields;
     for (auto&& child : _children) {
@@ -187,6 +187,24 @@ public:
      */
     virtual StageState work(WorkingSetID* out) = 0;
 
+    /**
+     * Performs up to 'maxWorks' units of work, as if by calling work() that many times, and
+     * appends the WorkingSetID of each result produced to 'results'.
+     *
+     * The batch ends early at the first unit of work that returns a state other than ADVANCED
+     * or NEED_TIME. That state is returned, with *out set as work() would have set it. Results
+     * appended before it were produced before it, so the caller must consume them before acting
+     * on the returned state. If all 'maxWorks' units are performed, returns ADVANCED if any
+     * results were appended and NEED_TIME otherwise.
+     *
+     * The default implementation calls work() in a loop. Stages on the path of simple scans
+     * override it to pay their per-call costs, such as the virtual call into their child and
+     * the execution timer, once per batch rather than once per document.
+     */
+    virtual StageState workBatch(size_t maxWorks,
+                                 std::vector<WorkingSetID>* results,
+                                 WorkingSetID* out);
+
     /**
      * Returns true if no more work can be done on the query / out of results.
      */
@@ -356,6 +374,13 @@ protected:
         return _opCtx;
     }
 
+    /**
+     * Updates the common stats of a stage whose every unit of work is one unit of work by its
+     * only child, after a call to the child's workBatch() that performed 'numChildWorks' units
+     * and ended in 'state'. Of those units, 'numResults' produced results this stage returned.
+     */
+    void recordChildBatch(size_t numChildWorks, size_t numResults, StageState state);
+
     Children _children;
     CommonStats _commonStats;
 
@@ -244,6 +244,7 @@ struct CountScanStats : public SpecificStats {
         CountScanStats* specific = new CountScanStats(*this);
         // BSON objects have to be explicitly copied.
         specific->keyPattern = keyPattern.getOwned();
+        specific->indexBounds = indexBounds.getOwned();
         return specific;
     }
 
@@ -251,6 +252,9 @@ struct CountScanStats : public SpecificStats {
 
     BSONObj keyPattern;
 
+    // Empty unless the scan counts over a set of index bounds rather than a single interval.
+    BSONObj indexBounds;
+
     int indexVersion;
 
     bool isMultiKey;
@@ -523,6 +527,45 @@ struct SkipStats : public SpecificStats {
     size_t skip;
 };
 
+struct SkipScanStats : public SpecificStats {
+    SpecificStats* clone() const final {
+        SkipScanStats* specific = new SkipScanStats(*this);
+        // BSON objects have to be explicitly copied.
+        specific->keyPattern = keyPattern.getOwned();
+        specific->indexBounds = indexBounds.getOwned();
+        return specific;
+    }
+
+    // How many keys did we look at?
+    size_t keysExamined = 0;
+
+    // How many times did we reposition the cursor rather than step to the adjacent key?
+    size_t seeks = 0;
+
+    // Number of dup RecordIds we tested and dropped, if the index is multikey.
+    size_t dupsTested = 0;
+    size_t dupsDropped = 0;
+
+    // Number of invalidated RecordIds we saw before returning them again.
+    size_t seenInvalidated = 0;
+
+    BSONObj keyPattern;
+
+    // Properties of the index used for the skip scan.
+    std::string indexName;
+    int indexVersion = 0;
+    bool isMultiKey = false;
+    bool isPartial = false;
+    bool isSparse = false;
+    bool isUnique = false;
+
+    // >1 if we're traversing the index forwards and <1 if we're traversing it backwards.
+    int direction = 1;
+
+    // A BSON representation of the skip scan's index bounds.
+    BSONObj indexBounds;
+};
+
 struct IntervalStats {
     // Number of results found in the covering of this interval.
     long long numResultsBuffered = 0;
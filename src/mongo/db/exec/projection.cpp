@@ -239,6 +239,55 @@ PlanStage::StageState ProjectionStage::work(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState ProjectionStage::workBatch(size_t maxWorks,
+                                                 vector<WorkingSetID>* results,
+                                                 WorkingSetID* out) {
+    // Adds the amount of time taken by workBatch() to executionTimeMillis.
+    ScopedTimer timer(&_commonStats.executionTimeMillis);
+
+    const size_t firstResult = results->size();
+    const size_t childWorksBefore = child()->getCommonStats()->works;
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = child()->workBatch(maxWorks, results, &id);
+    const size_t numChildWorks = child()->getCommonStats()->works - childWorksBefore;
+
+    for (size_t i = firstResult; i < results->size(); ++i) {
+        Status projStatus = transform(_ws->get((*results)[i]));
+        if (!projStatus.isOK()) {
+            warning() << "Couldn't execute projection, status = " << projStatus.toString() << endl;
+
+            // Nothing from the failed result onwards is passed up.
+            for (size_t j = i; j < results->size(); ++j) {
+                _ws->free((*results)[j]);
+            }
+            results->resize(i);
+
+            recordChildBatch(numChildWorks, i - firstResult, PlanStage::FAILURE);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, projStatus);
+            return PlanStage::FAILURE;
+        }
+    }
+
+    recordChildBatch(numChildWorks, results->size() - firstResult, status);
+
+    if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+        *out = id;
+        // If a stage fails, it may create a status WSM to indicate why it
+        // failed, in which case 'id' is valid.  If ID is invalid, we
+        // create our own error message.
+        if (WorkingSet::INVALID_ID == id) {
+            mongoutils::str::stream ss;
+            ss << "projection stage failed to read in results from child";
+            Status status(ErrorCodes::InternalError, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        }
+    } else if (PlanStage::NEED_YIELD == status) {
+        *out = id;
+    }
+
+    return status;
+}
+
 unique_ptr<PlanStageStats> ProjectionStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_PROJECTION);
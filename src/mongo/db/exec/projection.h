@@ -82,6 +82,9 @@ public:
 
     bool isEOF() final;
     StageState work(WorkingSetID* out) final;
+    StageState workBatch(size_t maxWorks,
+                         std::vector<WorkingSetID>* results,
+                         WorkingSetID* out) final;
 
     StageType stageType() const final {
         return STAGE_PROJECTION;
@@ -97,6 +97,52 @@ PlanStage::StageState SkipStage::work(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState SkipStage::workBatch(size_t maxWorks,
+                                           vector<WorkingSetID>* results,
+                                           WorkingSetID* out) {
+    // Adds the amount of time taken by workBatch() to executionTimeMillis.
+    ScopedTimer timer(&_commonStats.executionTimeMillis);
+
+    const size_t firstResult = results->size();
+    const size_t childWorksBefore = child()->getCommonStats()->works;
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = child()->workBatch(maxWorks, results, &id);
+
+    // Drop as many of the results as we still have to skip.
+    const size_t numChildResults = results->size() - firstResult;
+    const size_t numSkipped = static_cast<size_t>(
+        std::min(static_cast<long long>(numChildResults), _toSkip));
+    for (size_t i = firstResult; i < firstResult + numSkipped; ++i) {
+        _ws->free((*results)[i]);
+    }
+    results->erase(results->begin() + firstResult, results->begin() + firstResult + numSkipped);
+    _toSkip -= numSkipped;
+
+    const size_t numResults = numChildResults - numSkipped;
+    recordChildBatch(child()->getCommonStats()->works - childWorksBefore, numResults, status);
+
+    if (PlanStage::ADVANCED == status && 0 == numResults) {
+        return PlanStage::NEED_TIME;
+    }
+
+    if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+        *out = id;
+        // If a stage fails, it may create a status WSM to indicate why it
+        // failed, in which case 'id' is valid.  If ID is invalid, we
+        // create our own error message.
+        if (WorkingSet::INVALID_ID == id) {
+            mongoutils::str::stream ss;
+            ss << "skip stage failed to read in results from child";
+            Status status(ErrorCodes::InternalError, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        }
+    } else if (PlanStage::NEED_YIELD == status) {
+        *out = id;
+    }
+
+    return status;
+}
+
 unique_ptr<PlanStageStats> SkipStage::getStats() {
     _commonStats.isEOF = isEOF();
     _specificStats.skip = _toSkip;
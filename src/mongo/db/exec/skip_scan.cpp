@@ -0,0 +1,214 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/skip_scan.h"
+
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/scoped_timer.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+using stdx::make_unique;
+
+// static
+const char* SkipScan::kStageType = "SKIP_SCAN";
+
+SkipScan::SkipScan(OperationContext* txn, const SkipScanParams& params, WorkingSet* workingSet)
+    : PlanStage(kStageType, txn),
+      _workingSet(workingSet),
+      _descriptor(params.descriptor),
+      _iam(params.descriptor->getIndexCatalog()->getIndex(params.descriptor)),
+      _params(params),
+      _checker(&_params.bounds, _descriptor->keyPattern(), _params.direction),
+      _needSeek(true),
+      _shouldDedup(true) {
+    _specificStats.keyPattern = _params.descriptor->keyPattern();
+    _specificStats.indexName = _params.descriptor->indexName();
+    _specificStats.indexVersion = _params.descriptor->version();
+    _specificStats.isMultiKey = _params.descriptor->isMultikey(getOpCtx());
+    _specificStats.isUnique = _params.descriptor->unique();
+    _specificStats.isSparse = _params.descriptor->isSparse();
+    _specificStats.isPartial = _params.descriptor->isPartial();
+    _specificStats.direction = _params.direction;
+
+    // TODO it is incorrect to rely on this not changing. SERVER-17678
+    _shouldDedup = _specificStats.isMultiKey;
+
+    // Set up our initial seek. If there is no valid data, just mark as EOF.
+    _commonStats.isEOF = !_checker.getStartSeekPoint(&_seekPoint);
+}
+
+PlanStage::StageState SkipScan::work(WorkingSetID* out) {
+    ++_commonStats.works;
+    if (_commonStats.isEOF)
+        return PlanStage::IS_EOF;
+
+    // Adds the amount of time taken by work() to executionTimeMillis.
+    ScopedTimer timer(&_commonStats.executionTimeMillis);
+
+    boost::optional<IndexKeyEntry> kv;
+    try {
+        if (!_cursor)
+            _cursor = _iam->newCursor(getOpCtx(), _params.direction == 1);
+
+        if (_needSeek) {
+            ++_specificStats.seeks;
+            kv = _cursor->seek(_seekPoint);
+        } else {
+            kv = _cursor->next();
+        }
+    } catch (const WriteConflictException& wce) {
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+
+    if (!kv) {
+        _commonStats.isEOF = true;
+        _cursor.reset();
+        return PlanStage::IS_EOF;
+    }
+
+    ++_specificStats.keysExamined;
+
+    switch (_checker.checkKey(kv->key, &_seekPoint)) {
+        case IndexBoundsChecker::MUST_ADVANCE:
+            // The key is out of bounds. The checker has adjusted the _seekPoint to skip past it,
+            // and past every other key sharing its out-of-bounds prefix.
+            _needSeek = true;
+            ++_commonStats.needTime;
+            return PlanStage::NEED_TIME;
+
+        case IndexBoundsChecker::DONE:
+            // There won't be a next time.
+            _commonStats.isEOF = true;
+            _cursor.reset();
+            return PlanStage::IS_EOF;
+
+        case IndexBoundsChecker::VALID:
+            // The adjacent key may be in bounds as well, so step to it next time.
+            _needSeek = false;
+
+            if (_shouldDedup) {
+                ++_specificStats.dupsTested;
+                if (!_returned.insert(kv->loc).second) {
+                    // We've seen this RecordId before. Skip it this time.
+                    ++_specificStats.dupsDropped;
+                    ++_commonStats.needTime;
+                    return PlanStage::NEED_TIME;
+                }
+            }
+
+            if (!kv->key.isOwned())
+                kv->key = kv->key.getOwned();
+
+            // Package up the result for the caller.
+            WorkingSetID id = _workingSet->allocate();
+            WorkingSetMember* member = _workingSet->get(id);
+            member->loc = kv->loc;
+            member->keyData.push_back(IndexKeyDatum(_descriptor->keyPattern(), kv->key, _iam));
+            _workingSet->transitionToLocAndIdx(id);
+
+            *out = id;
+            ++_commonStats.advanced;
+            return PlanStage::ADVANCED;
+    }
+    invariant(false);
+}
+
+bool SkipScan::isEOF() {
+    return _commonStats.isEOF;
+}
+
+void SkipScan::doSaveState() {
+    if (!_cursor)
+        return;
+
+    // The position only matters if we are going to step from it rather than seek.
+    if (_needSeek) {
+        _cursor->saveUnpositioned();
+        return;
+    }
+
+    _cursor->savePositioned();
+}
+
+void SkipScan::doRestoreState() {
+    if (_cursor)
+        _cursor->restore();
+}
+
+void SkipScan::doDetachFromOperationContext() {
+    if (_cursor)
+        _cursor->detachFromOperationContext();
+}
+
+void SkipScan::doReattachToOperationContext() {
+    if (_cursor)
+        _cursor->reattachToOperationContext(getOpCtx());
+}
+
+void SkipScan::doInvalidate(OperationContext* txn, const RecordId& dl, InvalidationType type) {
+    // The only state we're responsible for holding is what RecordIds to drop.  If a document
+    // mutates the underlying index cursor will deal with it.
+    if (INVALIDATION_MUTATION == type) {
+        return;
+    }
+
+    // If we see this RecordId again, it may not be the same document it was before, so we want
+    // to return it if we see it again.
+    auto it = _returned.find(dl);
+    if (it != _returned.end()) {
+        ++_specificStats.seenInvalidated;
+        _returned.erase(it);
+    }
+}
+
+unique_ptr<PlanStageStats> SkipScan::getStats() {
+    // Serialize the bounds to BSON if we have not done so already. This is done here rather than in
+    // the constructor in order to avoid the expensive serialization operation unless the query is
+    // being explained.
+    if (_specificStats.indexBounds.isEmpty()) {
+        _specificStats.indexBounds = _params.bounds.toBSON();
+    }
+
+    unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_SKIP_SCAN);
+    ret->specific = make_unique<SkipScanStats>(_specificStats);
+    return ret;
+}
+
+const SpecificStats* SkipScan::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/unordered_set.h"
+
+namespace mongo {
+
+class IndexAccessMethod;
+class IndexDescriptor;
+class WorkingSet;
+
+struct SkipScanParams {
+    SkipScanParams() : descriptor(NULL), direction(1) {}
+
+    // What index are we traversing?
+    const IndexDescriptor* descriptor;
+
+    // And in what direction?
+    int direction;
+
+    // What are the bounds? The leading fields are typically unconstrained, with the predicates
+    // on later fields giving their bounds.
+    IndexBounds bounds;
+};
+
+/**
+ * Answers predicates over the trailing fields of a compound index whose leading fields are not
+ * constrained. For example, given the index {a: 1, b: 1} and the query {b: 5}, rather than
+ * examining every key, the scan seeks to {a: <first value>, b: 5}, reads the keys which match,
+ * and then seeks past every other key sharing that value of 'a' straight to
+ * {a: <next value>, b: 5}. This is cheap when the leading fields have few distinct values.
+ *
+ * The seeks are computed by an IndexBoundsChecker. The stage only steps to the adjacent key
+ * while the keys it reads stay within the bounds.
+ *
+ * The planner only skip-scans indexes which are not multikey, but an index may become multikey
+ * after the plan is made, so RecordIds are deduplicated as in IndexScan when it is.
+ */
+class SkipScan final : public PlanStage {
+public:
+    SkipScan(OperationContext* txn, const SkipScanParams& params, WorkingSet* workingSet);
+
+    StageState work(WorkingSetID* out) final;
+    bool isEOF() final;
+    void doSaveState() final;
+    void doRestoreState() final;
+    void doDetachFromOperationContext() final;
+    void doReattachToOperationContext() final;
+    void doInvalidate(OperationContext* txn, const RecordId& dl, InvalidationType type) final;
+
+    StageType stageType() const final {
+        return STAGE_SKIP_SCAN;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kStageType;
+
+private:
+    // The WorkingSet we annotate with results.  Not owned by us.
+    WorkingSet* _workingSet;
+
+    // Index access.
+    const IndexDescriptor* _descriptor;  // owned by Collection -> IndexCatalog
+    const IndexAccessMethod* _iam;       // owned by Collection -> IndexCatalog
+
+    // The cursor we use to navigate the tree.
+    std::unique_ptr<SortedDataInterface::Cursor> _cursor;
+
+    SkipScanParams _params;
+
+    // _checker gives us our start key, tells us where to seek next, and ensures we stay in
+    // bounds.
+    IndexBoundsChecker _checker;
+    IndexSeekPoint _seekPoint;
+
+    // True if the next call to work() repositions the cursor at '_seekPoint' rather than
+    // stepping to the adjacent key.
+    bool _needSeek;
+
+    // Could our index have duplicates?  If so, we use _returned to dedup.
+    bool _shouldDedup;
+    unordered_set<RecordId, RecordId::Hasher> _returned;
+
+    // Stats
+    SkipScanStats _specificStats;
+};
+
+}  // namespace mongo
@@ -42,6 +42,7 @@
 #include "mongo/db/query/lite_parsed_query.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -52,6 +53,84 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+// KeyString::TypeBits can only describe keys up to about this size, so larger sort keys are
+// compared as BSON.
+const int kMaxKeyStringSortKeyBytes = 1024;
+
+// Ranges smaller than this are sorted with std::sort rather than by another radix pass.
+const size_t kRadixSortMinItems = 64;
+
+// Bounds the recursion of radixSortByKeyString(). Ranges that still share a prefix this long
+// are sorted with std::sort.
+const size_t kRadixSortMaxDepth = 16;
+
+/**
+ * Sorts the items in [begin, end), which must all have a non-empty sortKeyString and share its
+ * first 'depth' bytes, in sortKeyString order.
+ *
+ * This is a most significant byte first radix sort that permutes items into buckets in place.
+ * Items whose key has no byte at 'depth' are equal to each other and come first.
+ */
+template <typename Iterator>
+void radixSortByKeyString(Iterator begin, Iterator end, size_t depth) {
+    typedef typename std::iterator_traits<Iterator>::value_type Item;
+
+    const size_t numItems = end - begin;
+    if (numItems < kRadixSortMinItems || depth >= kRadixSortMaxDepth) {
+        std::sort(begin, end, [depth](const Item& lhs, const Item& rhs) {
+            return lhs.sortKeyString.compare(depth, std::string::npos, rhs.sortKeyString, depth,
+                                             std::string::npos) < 0;
+        });
+        return;
+    }
+
+    const size_t kNumBuckets = 257;
+    const auto bucketOf = [depth](const Item& item) -> size_t {
+        return depth < item.sortKeyString.size()
+            ? 1 + static_cast<unsigned char>(item.sortKeyString[depth])
+            : 0;
+    };
+
+    size_t bucketEnd[kNumBuckets] = {};
+    for (Iterator it = begin; it != end; ++it) {
+        bucketEnd[bucketOf(*it)]++;
+    }
+
+    // Turn the counts into the end offset of each bucket, and remember where each bucket starts.
+    size_t bucketNext[kNumBuckets];
+    size_t offset = 0;
+    for (size_t bucket = 0; bucket < kNumBuckets; bucket++) {
+        bucketNext[bucket] = offset;
+        offset += bucketEnd[bucket];
+        bucketEnd[bucket] = offset;
+    }
+
+    // Swap each item into its bucket. Everything before bucketNext[bucket] is already in place.
+    for (size_t bucket = 0; bucket < kNumBuckets; bucket++) {
+        while (bucketNext[bucket] < bucketEnd[bucket]) {
+            Iterator item = begin + bucketNext[bucket];
+            const size_t target = bucketOf(*item);
+            if (target == bucket) {
+                bucketNext[bucket]++;
+            } else {
+                std::swap(*item, *(begin + bucketNext[target]++));
+            }
+        }
+    }
+
+    // Bucket 0 holds keys that ended at 'depth' which are all equal.
+    for (size_t bucket = 1; bucket < kNumBuckets; bucket++) {
+        const size_t bucketBegin = bucketEnd[bucket - 1];
+        if (bucketEnd[bucket] - bucketBegin > 1) {
+            radixSortByKeyString(begin + bucketBegin, begin + bucketEnd[bucket], depth + 1);
+        }
+    }
+}
+
+}  // namespace
+
 // static
 const char* SortStage::kStageType = "SORT";
 
@@ -59,6 +138,11 @@ SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
                                                  const SortableDataItem& rhs) const {
+    // KeyStrings include the RecordId, so they break ties the same way as the code below.
+    if (!lhs.sortKeyString.empty() && !rhs.sortKeyString.empty()) {
+        return lhs.sortKeyString < rhs.sortKeyString;
+    }
+
     // False means ignore field names.
     int result = lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
     if (0 != result) {
@@ -77,6 +161,8 @@ SortStage::SortStage(OperationContext* opCtx,
       _ws(ws),
       _pattern(params.pattern),
       _limit(params.limit),
+      _useKeyString(false),
+      _sortKeyOrdering(Ordering::make(BSONObj())),
       _sorted(false),
       _resultIterator(_data.end()),
       _memUsage(0) {
@@ -85,6 +171,12 @@ SortStage::SortStage(OperationContext* opCtx,
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
     _sortKeyComparator = stdx::make_unique<WorkingSetComparator>(sortComparator);
 
+    // An Ordering can describe at most 32 fields.
+    if (internalQueryExecSortUseKeyString && sortComparator.nFields() <= 32) {
+        _useKeyString = true;
+        _sortKeyOrdering = Ordering::make(sortComparator);
+    }
+
     // If limit > 1, we need to initialize _dataSet here to maintain ordered set of data items while
     // fetching from the child stage.
     if (_limit > 1) {
@@ -154,6 +246,7 @@ PlanStage::StageState SortStage::work(WorkingSetID* out) {
                 item.loc = member->loc;
             }
 
+            encodeSortKey(&item);
             addToBuffer(item);
 
             ++_commonStats.needTime;
@@ -247,6 +340,22 @@ const SpecificStats* SortStage::getSpecificStats() const {
     return &_specificStats;
 }
 
+void SortStage::encodeSortKey(SortableDataItem* item) const {
+    // KeyString only encodes non-negative RecordIds. Those are the only ones a collection
+    // produces, but we needn't rely on that.
+    if (!_useKeyString || item->sortKey.objsize() > kMaxKeyStringSortKeyBytes ||
+        item->loc.repr() < 0) {
+        return;
+    }
+
+    KeyString keyString(item->sortKey, _sortKeyOrdering, item->loc);
+    item->sortKeyString.assign(keyString.getBuffer(), keyString.getSize());
+}
+
+size_t SortStage::getMemUsage(const SortableDataItem& item) const {
+    return _ws->get(item.wsid)->getMemUsage() + item.sortKeyString.size();
+}
+
 /**
  * addToBuffer() and sortBuffer() work differently based on the
  * configured limit. addToBuffer() is also responsible for
@@ -273,11 +382,11 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
 
     if (_limit == 0) {
         _data.push_back(item);
-        _memUsage += _ws->get(item.wsid)->getMemUsage();
+        _memUsage += getMemUsage(item);
     } else if (_limit == 1) {
         if (_data.empty()) {
             _data.push_back(item);
-            _memUsage = _ws->get(item.wsid)->getMemUsage();
+            _memUsage = getMemUsage(item);
             return;
         }
         wsidToFree = item.wsid;
@@ -286,7 +395,7 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
         if (cmp(item, _data[0])) {
             wsidToFree = _data[0].wsid;
             _data[0] = item;
-            _memUsage = _ws->get(item.wsid)->getMemUsage();
+            _memUsage = getMemUsage(item);
         }
     } else {
         // Update data item set instead of vector
@@ -294,7 +403,7 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
         vector<SortableDataItem>::size_type limit(_limit);
         if (_dataSet->size() < limit) {
             _dataSet->insert(item);
-            _memUsage += _ws->get(item.wsid)->getMemUsage();
+            _memUsage += getMemUsage(item);
             return;
         }
         // Limit will be exceeded - compare with item with lowest key
@@ -305,8 +414,8 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
         const SortableDataItem& lastItem = *lastItemIt;
         const WorkingSetComparator& cmp = *_sortKeyComparator;
         if (cmp(item, lastItem)) {
-            _memUsage -= _ws->get(lastItem.wsid)->getMemUsage();
-            _memUsage += _ws->get(item.wsid)->getMemUsage();
+            _memUsage -= getMemUsage(lastItem);
+            _memUsage += getMemUsage(item);
             wsidToFree = lastItem.wsid;
             // According to std::set iterator validity rules,
             // it does not matter which of erase()/insert() happens first.
@@ -330,8 +439,16 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
 
 void SortStage::sortBuffer() {
     if (_limit == 0) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        std::sort(_data.begin(), _data.end(), cmp);
+        const bool allEncoded =
+            std::none_of(_data.begin(), _data.end(), [](const SortableDataItem& item) {
+                return item.sortKeyString.empty();
+            });
+        if (allEncoded) {
+            radixSortByKeyString(_data.begin(), _data.end(), 0);
+        } else {
+            const WorkingSetComparator& cmp = *_sortKeyComparator;
+            std::sort(_data.begin(), _data.end(), cmp);
+        }
     } else if (_limit == 1) {
         // Buffer contains either 0 or 1 item so it is already in a sorted state.
         return;
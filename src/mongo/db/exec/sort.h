@@ -106,6 +106,10 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    // Whether sort keys are encoded as KeyStrings, and the Ordering used to encode them.
+    bool _useKeyString;
+    Ordering _sortKeyOrdering;
+
     //
     // Data storage
     //
@@ -122,12 +126,16 @@ private:
         // RecordId to break sortKey ties.
         // See sorta.js.
         RecordId loc;
+        // (sortKey, loc) encoded as a KeyString, which orders the same way under memcmp. Empty
+        // if the key wasn't encoded, in which case sortKey and loc are compared instead.
+        std::string sortKeyString;
     };
 
     // Comparison object for data buffers (vector and set).
     // Items are compared on (sortKey, loc). This is also how the items are
     // ordered in the indices.
-    // Keys are compared using BSONObj::woCompare() with RecordId as a tie-breaker.
+    // Keys are compared using BSONObj::woCompare() with RecordId as a tie-breaker, or by their
+    // KeyString encodings if both items have one.
     struct WorkingSetComparator {
         explicit WorkingSetComparator(BSONObj p);
 
@@ -136,6 +144,16 @@ private:
         BSONObj pattern;
     };
 
+    /**
+     * Fills in item->sortKeyString if the sort key can be encoded as a KeyString.
+     */
+    void encodeSortKey(SortableDataItem* item) const;
+
+    /**
+     * Returns the memory used by 'item' and the working set member it refers to.
+     */
+    size_t getMemUsage(const SortableDataItem& item) const;
+
     /**
      * Inserts one item into data buffer (vector or set).
      * If limit is exceeded, remove item with lowest key.
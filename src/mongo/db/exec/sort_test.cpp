@@ -34,6 +34,7 @@
 
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/json.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 
@@ -78,11 +79,11 @@ TEST(SortStageTest, SortEmptyWorkingSet) {
  * expectedStr represents the expected sorted data set.
  *     {output: [docA, docB, docC, ...]}
  */
-void testWork(const char* patternStr,
-              const char* queryStr,
-              int limit,
-              const char* inputStr,
-              const char* expectedStr) {
+void testWorkOnce(const char* patternStr,
+                  const char* queryStr,
+                  int limit,
+                  const char* inputStr,
+                  const char* expectedStr) {
     // WorkingSet is not owned by stages
     // so it's fine to declare
     WorkingSet ws;
@@ -153,13 +154,29 @@ void testWork(const char* patternStr,
         // Even though we have the original string representation of the expected output,
         // we invoke BSONObj::toString() to get a format consistent with outputObj.
         ss << "Unexpected sort result with query=" << queryStr << "; pattern=" << patternStr
-           << "; limit=" << limit << ":\n"
+           << "; limit=" << limit << "; keyString=" << internalQueryExecSortUseKeyString << ":\n"
            << "Expected: " << expectedObj.toString() << "\n"
            << "Actual:   " << outputObj.toString() << "\n";
         FAIL(ss);
     }
 }
 
+/**
+ * Runs testWorkOnce() with sort keys compared both as KeyStrings and as BSON.
+ */
+void testWork(const char* patternStr,
+              const char* queryStr,
+              int limit,
+              const char* inputStr,
+              const char* expectedStr) {
+    const bool oldUseKeyString = internalQueryExecSortUseKeyString;
+    for (bool useKeyString : {true, false}) {
+        internalQueryExecSortUseKeyString = useKeyString;
+        testWorkOnce(patternStr, queryStr, limit, inputStr, expectedStr);
+    }
+    internalQueryExecSortUseKeyString = oldUseKeyString;
+}
+
 //
 // Limit values
 // The server interprets limit values from the user as follows:
@@ -246,4 +263,79 @@ TEST(SortStageTest, SortDescendingWithLimitOfOne) {
     testWork("{a: -1}", "{}", 1, "{input: [{a: 2}, {a: 1}, {a: 3}]}", "{output: [{a: 3}]}");
 }
 
+//
+// Sort keys of different types and sizes
+// KeyString encodings must order the same way as BSON comparison.
+//
+
+TEST(SortStageTest, SortMixedTypes) {
+    testWork("{a: 1}",
+             "{}",
+             0,
+             "{input: [{a: 'b'}, {a: 2.5}, {a: {b: 1}}, {a: null}, {a: -3}, {a: 'a'}, "
+             "{a: true}, {a: NumberLong(2)}, {a: {$minKey: 1}}, {a: [4, 5]}]}",
+             "{output: [{a: {$minKey: 1}}, {a: null}, {a: -3}, {a: NumberLong(2)}, {a: 2.5}, "
+             "{a: [4, 5]}, {a: 'a'}, {a: 'b'}, {a: {b: 1}}, {a: true}]}");
+}
+
+TEST(SortStageTest, SortCompoundMixedDirections) {
+    testWork("{a: 1, b: -1}",
+             "{}",
+             0,
+             "{input: [{a: 1, b: 'x'}, {a: 2, b: 1}, {a: 1, b: 'y'}, {a: 2, b: 3}, {a: 0}]}",
+             "{output: [{a: 0}, {a: 1, b: 'y'}, {a: 1, b: 'x'}, {a: 2, b: 3}, {a: 2, b: 1}]}");
+}
+
+TEST(SortStageTest, SortCompoundMixedDirectionsWithLimit) {
+    testWork("{a: -1, b: 1}",
+             "{}",
+             3,
+             "{input: [{a: 1, b: 'x'}, {a: 2, b: 1}, {a: 1, b: 'y'}, {a: 2, b: 3}, {a: 0}]}",
+             "{output: [{a: 2, b: 1}, {a: 2, b: 3}, {a: 1, b: 'x'}]}");
+}
+
+TEST(SortStageTest, SortKeysTooLargeForKeyString) {
+    // Keys over 1KB are compared as BSON, both with each other and with encoded keys.
+    const std::string big(2000, 'b');
+    const std::string bigger = big + 'b';
+    const std::string input = "{input: [{a: '" + bigger + "'}, {a: 'c'}, {a: '" + big +
+        "'}, {a: 'a'}]}";
+    const std::string expected = "{output: [{a: 'a'}, {a: '" + big + "'}, {a: '" + bigger +
+        "'}, {a: 'c'}]}";
+    testWork("{a: 1}", "{}", 0, input.c_str(), expected.c_str());
+
+    const std::string expectedWithLimit = "{output: [{a: 'c'}, {a: '" + bigger + "'}]}";
+    testWork("{a: -1}", "{}", 2, input.c_str(), expectedWithLimit.c_str());
+}
+
+TEST(SortStageTest, SortManyKeysWithSharedPrefixes) {
+    // Enough keys to be radix sorted, most of them sharing long prefixes.
+    const std::string prefix(40, 'p');
+    std::vector<std::string> values;
+    for (int i = 0; i < 500; i++) {
+        values.push_back(prefix + std::to_string((i * 7919) % 500));
+    }
+
+    std::string input = "{input: [";
+    for (size_t i = 0; i < values.size(); i++) {
+        input += (i ? ", {a: " : "{a: ") + std::to_string(i % 3) + ", b: '" + values[i] + "'}";
+    }
+    input += "]}";
+
+    std::vector<std::pair<int, std::string>> sorted;
+    for (size_t i = 0; i < values.size(); i++) {
+        sorted.push_back(std::make_pair(i % 3, values[i]));
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    std::string expected = "{output: [";
+    for (size_t i = 0; i < sorted.size(); i++) {
+        expected += (i ? ", {a: " : "{a: ") + std::to_string(sorted[i].first) + ", b: '" +
+            sorted[i].second + "'}";
+    }
+    expected += "]}";
+
+    testWork("{a: 1, b: 1}", "{}", 0, input.c_str(), expected.c_str());
+}
+
 }  // namespace
@@ -224,6 +224,7 @@ Status SubplanStage::planSubqueries() {
 
             // We don't set NO_TABLE_SCAN because peeking at the cache data will keep us from
             // considering any plan that's a collscan.
+            _plannerParams.arena = getOpCtx()->getArena();
             Status status = QueryPlanner::plan(*branchResult->canonicalQuery,
                                                _plannerParams,
                                                &branchResult->solutions.mutableVector());
@@ -426,6 +427,7 @@ Status SubplanStage::choosePlanWholeQuery(PlanYieldPolicy* yieldPolicy) {
 
     // Use the query planning module to plan the whole query.
     std::vector<QuerySolution*> rawSolutions;
+    _plannerParams.arena = getOpCtx()->getArena();
     Status status = QueryPlanner::plan(*_query, _plannerParams, &rawSolutions);
     if (!status.isOK()) {
         return Status(ErrorCodes::BadValue,
@@ -55,6 +55,25 @@ using std::vector;
 
 MONGO_EXPORT_SERVER_PARAMETER(failIndexKeyTooLong, bool, true);
 
+// Number of threads an index build's external sort may use to sort, spill and merge keys.
+// 1 does everything on the thread building the index.
+MONGO_EXPORT_SERVER_PARAMETER(indexBuildSorterParallelism, int, 1);
+
+namespace {
+// When sorting in parallel, never merge more than this many spilled runs at once.
+const unsigned kIndexBuildMaxMergeFanIn = 64;
+
+SortOptions makeBulkBuilderSortOptions(size_t maxMemoryUsageBytes) {
+    const unsigned parallelism = std::max(indexBuildSorterParallelism, 1);
+    return SortOptions()
+        .TempDir(storageGlobalParams.dbpath + "/_tmp")
+        .ExtSortAllowed()
+        .MaxMemoryUsageBytes(maxMemoryUsageBytes)
+        .Parallelism(parallelism)
+        .MaxMergeFanIn(parallelism > 1 ? kIndexBuildMaxMergeFanIn : 0);
+}
+}  // namespace
+
 //
 // Comparison for external sorter interface
 //
@@ -318,19 +337,19 @@ Status IndexAccessMethod::update(OperationContext* txn,
     return Status::OK();
 }
 
-std::unique_ptr<IndexAccessMethod::BulkBuilder> IndexAccessMethod::initiateBulk() {
-    return std::unique_ptr<BulkBuilder>(new BulkBuilder(this, _descriptor));
+std::unique_ptr<IndexAccessMethod::BulkBuilder> IndexAccessMethod::initiateBulk(
+    size_t maxMemoryUsageBytes) {
+    return std::unique_ptr<BulkBuilder>(new BulkBuilder(this, _descriptor, maxMemoryUsageBytes));
 }
 
 IndexAccessMethod::BulkBuilder::BulkBuilder(const IndexAccessMethod* index,
-                                            const IndexDescriptor* descriptor)
+                                            const IndexDescriptor* descriptor,
+                                            size_t maxMemoryUsageBytes)
     : _sorter(Sorter::make(
-          SortOptions()
-              .TempDir(storageGlobalParams.dbpath + "/_tmp")
-              .ExtSortAllowed()
-              .MaxMemoryUsageBytes(100 * 1024 * 1024),
+          makeBulkBuilderSortOptions(maxMemoryUsageBytes),
           BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
-      _real(index) {}
+      _real(index),
+      _descriptor(descriptor) {}
 
 Status IndexAccessMethod::BulkBuilder::insert(OperationContext* txn,
                                               const BSONObj& obj,
@@ -354,6 +373,33 @@ Status IndexAccessMethod::BulkBuilder::insert(OperationContext* txn,
     return Status::OK();
 }
 
+void IndexAccessMethod::BulkBuilder::mergeFrom(std::unique_ptr<BulkBuilder> other) {
+    invariant(other->_real == _real);
+
+    _mergedSorters.push_back(std::move(other->_sorter));
+    for (auto&& sorter : other->_mergedSorters) {
+        _mergedSorters.push_back(std::move(sorter));
+    }
+
+    _keysInserted += other->_keysInserted;
+    _isMultiKey = _isMultiKey || other->_isMultiKey;
+}
+
+IndexAccessMethod::BulkBuilder::Sorter::Iterator* IndexAccessMethod::BulkBuilder::done() {
+    if (_mergedSorters.empty())
+        return _sorter->done();
+
+    std::vector<std::shared_ptr<Sorter::Iterator>> iters;
+    iters.push_back(std::shared_ptr<Sorter::Iterator>(_sorter->done()));
+    for (auto&& sorter : _mergedSorters) {
+        iters.push_back(std::shared_ptr<Sorter::Iterator>(sorter->done()));
+    }
+
+    return Sorter::Iterator::merge(
+        iters,
+        SortOptions(),
+        BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version()));
+}
 
 Status IndexAccessMethod::commitBulk(OperationContext* txn,
                                      std::unique_ptr<BulkBuilder> bulk,
@@ -362,7 +408,7 @@ Status IndexAccessMethod::commitBulk(OperationContext* txn,
                                      set<RecordId>* dupsToDrop) {
     Timer timer;
 
-    std::unique_ptr<BulkBuilder::Sorter::Iterator> i(bulk->_sorter->done());
+    std::unique_ptr<BulkBuilder::Sorter::Iterator> i(bulk->done());
 
     stdx::unique_lock<Client> lk(*txn->getClient());
     ProgressMeterHolder pm(*txn->setMessage_inlock("Index Bulk Build: (2/3) btree bottom up",
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -184,6 +185,11 @@ public:
 
     class BulkBuilder {
     public:
+        /**
+         * Default bound on the memory used to sort keys before spilling them to disk.
+         */
+        static const size_t kMaxMemoryUsageBytes = 100 * 1024 * 1024;
+
         /**
          * Insert into the BulkBuilder as-if inserting into an IndexAccessMethod.
          */
@@ -193,15 +199,32 @@ public:
                       const InsertDeleteOptions& options,
                       int64_t* numInserted);
 
+        /**
+         * Takes over the keys inserted into 'other', which must have been initiated by the same
+         * IndexAccessMethod. They are merged with the keys of this BulkBuilder by commitBulk().
+         *
+         * This lets several threads insert into their own BulkBuilders for the same index.
+         */
+        void mergeFrom(std::unique_ptr<BulkBuilder> other);
+
     private:
         friend class IndexAccessMethod;
 
         using Sorter = mongo::Sorter<BSONObj, RecordId>;
 
-        BulkBuilder(const IndexAccessMethod* index, const IndexDescriptor* descriptor);
+        BulkBuilder(const IndexAccessMethod* index,
+                    const IndexDescriptor* descriptor,
+                    size_t maxMemoryUsageBytes);
+
+        /**
+         * Returns all keys inserted into this BulkBuilder or merged into it, in sorted order.
+         */
+        Sorter::Iterator* done();
 
         std::unique_ptr<Sorter> _sorter;
+        std::vector<std::unique_ptr<Sorter>> _mergedSorters;  // from mergeFrom()
         const IndexAccessMethod* _real;
+        const IndexDescriptor* _descriptor;
         int64_t _keysInserted = 0;
         bool _isMultiKey = false;
     };
@@ -211,9 +234,12 @@ public:
      * You work on the returned BulkBuilder and then call commitBulk.
      * This can return NULL, meaning bulk mode is not available.
      *
+     * 'maxMemoryUsageBytes' bounds the memory used to sort keys before spilling to disk.
+     *
      * It is only legal to initiate bulk when the index is new and empty.
      */
-    std::unique_ptr<BulkBuilder> initiateBulk();
+    std::unique_ptr<BulkBuilder> initiateBulk(
+        size_t maxMemoryUsageBytes = BulkBuilder::kMaxMemoryUsageBytes);
 
     /**
      * Call this when you are ready to finish your bulk work.
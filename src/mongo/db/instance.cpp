@@ -579,6 +579,12 @@ void assembleResponse(OperationContext* txn,
     currentOp.done();
     debug.executionTime = currentOp.totalTimeMillis();
 
+    const Arena::Stats& arenaStats = txn->getArena()->stats();
+    if (arenaStats.allocations > 0) {
+        debug.arenaAllocs = arenaStats.allocations;
+        debug.arenaBytes = arenaStats.bytesReserved;
+    }
+
     logThreshold += currentOp.getExpectedLatencyMs();
 
     if (shouldLog || debug.executionTime > logThreshold) {
@@ -0,0 +1,231 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include "mongo/db/field_ref.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_leaf.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+
+// static
+const size_t CompiledMatchExpression::kMaxTopLevelFields;
+
+CompiledMatchExpression::CompiledMatchExpression(const MatchExpression* expr) : _expr(expr) {}
+
+// static
+unique_ptr<CompiledMatchExpression> CompiledMatchExpression::compile(const MatchExpression* expr) {
+    unique_ptr<CompiledMatchExpression> compiled(new CompiledMatchExpression(expr));
+    compiled->compileNode(expr);
+
+    if (compiled->_leaves.empty()) {
+        // Everything would be interpreted anyway.
+        return {};
+    }
+    return compiled;
+}
+
+void CompiledMatchExpression::compileNode(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+        case MatchExpression::NOR: {
+            const size_t numChildren = expr->numChildren();
+            if (0 == numChildren) {
+                // An empty $and or $nor matches everything and an empty $or matches nothing.
+                _program.emplace_back(Instruction::kConstant,
+                                      MatchExpression::OR != expr->matchType());
+                return;
+            }
+
+            // Skip the remaining children as soon as one of them decides the result.
+            const Instruction::Op shortCircuit = MatchExpression::AND == expr->matchType()
+                ? Instruction::kJumpIfFalse
+                : Instruction::kJumpIfTrue;
+            std::vector<size_t> jumps;
+            for (size_t i = 0; i < numChildren; ++i) {
+                compileNode(expr->getChild(i));
+                if (i + 1 < numChildren) {
+                    jumps.push_back(_program.size());
+                    _program.emplace_back(shortCircuit, 0);
+                }
+            }
+            for (size_t jump : jumps) {
+                _program[jump].arg = _program.size();
+            }
+
+            if (MatchExpression::NOR == expr->matchType()) {
+                _program.emplace_back(Instruction::kNot, 0);
+            }
+            return;
+        }
+
+        case MatchExpression::NOT:
+            compileNode(expr->getChild(0));
+            _program.emplace_back(Instruction::kNot, 0);
+            return;
+
+        // These leaves all match a document by matching any element their path resolves to,
+        // which is the only element when the path does not run into an array.
+        case MatchExpression::EQ:
+        case MatchExpression::LTE:
+        case MatchExpression::LT:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::REGEX:
+        case MatchExpression::MOD:
+        case MatchExpression::EXISTS:
+        case MatchExpression::MATCH_IN:
+        case MatchExpression::BITS_ALL_SET:
+        case MatchExpression::BITS_ALL_CLEAR:
+        case MatchExpression::BITS_ANY_SET:
+        case MatchExpression::BITS_ANY_CLEAR: {
+            const LeafMatchExpression* leafExpr = static_cast<const LeafMatchExpression*>(expr);
+            FieldRef path(leafExpr->path());
+            if (0 == path.numParts()) {
+                break;
+            }
+
+            const std::string firstPart = path.getPart(0).toString();
+            size_t topLevelField = 0;
+            while (topLevelField < _topLevelFields.size() &&
+                   _topLevelFields[topLevelField] != firstPart) {
+                ++topLevelField;
+            }
+            if (topLevelField == _topLevelFields.size()) {
+                if (_topLevelFields.size() == kMaxTopLevelFields) {
+                    break;
+                }
+                _topLevelFields.push_back(firstPart);
+            }
+
+            Leaf leaf;
+            leaf.expr = leafExpr;
+            leaf.topLevelField = topLevelField;
+            for (size_t i = 1; i < path.numParts(); ++i) {
+                leaf.restOfPath.push_back(path.getPart(i).toString());
+            }
+            _leaves.push_back(std::move(leaf));
+            _program.emplace_back(Instruction::kTestLeaf, _leaves.size() - 1);
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    _interpreted.push_back(expr);
+    _program.emplace_back(Instruction::kInterpret, _interpreted.size() - 1);
+}
+
+bool CompiledMatchExpression::matchesBSON(const BSONObj& doc) const {
+    // Find the first occurrence of each top-level field, as BSONObj::getField() would, in a
+    // single pass over the document.
+    BSONElement topLevelElements[kMaxTopLevelFields];
+    const size_t numTopLevelFields = _topLevelFields.size();
+    size_t numFound = 0;
+    BSONObjIterator it(doc);
+    while (numFound < numTopLevelFields && it.more()) {
+        BSONElement elem = it.next();
+        const char* fieldName = elem.fieldName();
+        for (size_t i = 0; i < numTopLevelFields; ++i) {
+            if (topLevelElements[i].eoo() && _topLevelFields[i] == fieldName) {
+                topLevelElements[i] = elem;
+                ++numFound;
+                break;
+            }
+        }
+    }
+
+    bool result = true;
+    size_t pc = 0;
+    while (pc < _program.size()) {
+        const Instruction& instruction = _program[pc++];
+        switch (instruction.op) {
+            case Instruction::kTestLeaf: {
+                const Leaf& leaf = _leaves[instruction.arg];
+
+                // Resolve the rest of the path the way getFieldDottedOrArray() does: a missing
+                // field or a non-object before the end of the path resolves to EOO.
+                BSONElement elem = topLevelElements[leaf.topLevelField];
+                for (const std::string& part : leaf.restOfPath) {
+                    if (Array == elem.type()) {
+                        break;
+                    }
+                    if (Object != elem.type()) {
+                        elem = BSONElement();
+                        break;
+                    }
+                    elem = elem.embeddedObject().getField(part);
+                }
+
+                if (Array == elem.type()) {
+                    // Matching against arrays has rules of its own, which the interpreter
+                    // implements.
+                    return _expr->matchesBSON(doc);
+                }
+
+                result = leaf.expr->matchesSingleElement(elem);
+                break;
+            }
+
+            case Instruction::kInterpret:
+                result = _interpreted[instruction.arg]->matchesBSON(doc);
+                break;
+
+            case Instruction::kConstant:
+                result = instruction.arg != 0;
+                break;
+
+            case Instruction::kNot:
+                result = !result;
+                break;
+
+            case Instruction::kJumpIfFalse:
+                if (!result) {
+                    pc = instruction.arg;
+                }
+                break;
+
+            case Instruction::kJumpIfTrue:
+                if (result) {
+                    pc = instruction.arg;
+                }
+                break;
+        }
+    }
+
+    return result;
+}
+
+}  // namespace mongo
@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+class LeafMatchExpression;
+class MatchExpression;
+
+/**
+ * A MatchExpression flattened into a linear program, for filters that are applied to many
+ * documents.
+ *
+ * The interpreter (MatchExpression::matchesBSON) walks the expression tree for every document,
+ * and each leaf resolves its path from the top of the document with a BSONElementIterator. The
+ * compiled form instead finds every top-level field named by a leaf in one pass over the
+ * document, follows any remaining path components with plain field lookups, and evaluates the
+ * leaves and their AND/OR/NOR/NOT structure as a sequence of instructions with short-circuit
+ * jumps.
+ *
+ * Only the common case is compiled: a leaf path that runs into an array anywhere makes the
+ * document fall back to the interpreter, which implements the array matching rules. Nodes
+ * other than tree nodes and simple leaves (e.g. $elemMatch, $where, geo predicates) are kept
+ * as single instructions that call the interpreter on their subtree.
+ */
+class CompiledMatchExpression {
+    MONGO_DISALLOW_COPYING(CompiledMatchExpression);
+
+public:
+    /**
+     * Compiles 'expr', which must outlive the result. Returns nullptr if compiling would not
+     * help, because 'expr' has no leaves that can be compiled or names too many top-level
+     * fields.
+     */
+    static std::unique_ptr<CompiledMatchExpression> compile(const MatchExpression* expr);
+
+    /**
+     * Returns the same result as 'expr->matchesBSON(doc)' for the expression this was compiled
+     * from.
+     */
+    bool matchesBSON(const BSONObj& doc) const;
+
+    /**
+     * The maximum number of distinct top-level fields an expression can name and be compiled.
+     */
+    static const size_t kMaxTopLevelFields = 32;
+
+private:
+    struct Instruction {
+        enum Op {
+            // Sets the result to leaf 'arg' applied to the document.
+            kTestLeaf,
+
+            // Sets the result to interpreting expression 'arg' against the document.
+            kInterpret,
+
+            // Sets the result to 'arg' != 0.
+            kConstant,
+
+            // Negates the result.
+            kNot,
+
+            // Continues at instruction 'arg' if the result is false, or true, respectively.
+            kJumpIfFalse,
+            kJumpIfTrue,
+        };
+
+        Instruction(Op op, size_t arg) : op(op), arg(arg) {}
+
+        Op op;
+        size_t arg;
+    };
+
+    struct Leaf {
+        const LeafMatchExpression* expr;
+
+        // Index into '_topLevelFields' of the first component of the leaf's path.
+        size_t topLevelField;
+
+        // The components of the leaf's path after the first.
+        std::vector<std::string> restOfPath;
+    };
+
+    explicit CompiledMatchExpression(const MatchExpression* expr);
+
+    void compileNode(const MatchExpression* expr);
+
+    const MatchExpression* const _expr;
+
+    std::vector<Instruction> _program;
+    std::vector<Leaf> _leaves;
+    std::vector<const MatchExpression*> _interpreted;
+
+    // The distinct first components of the leaves' paths.
+    std::vector<std::string> _topLevelFields;
+};
+
+}  // namespace mongo
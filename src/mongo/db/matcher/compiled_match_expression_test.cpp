@@ -0,0 +1,210 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/** Unit tests for CompiledMatchExpression. */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+using std::unique_ptr;
+
+unique_ptr<MatchExpression> parse(const BSONObj& filter) {
+    StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(filter);
+    ASSERT_OK(statusWithMatcher.getStatus());
+    return std::move(statusWithMatcher.getValue());
+}
+
+const char* kFilters[] = {
+    "{a: 1}",
+    "{a: 1, b: 3}",
+    "{a: {$gt: 1}, b: {$lte: 5}}",
+    "{a: null}",
+    "{a: {$exists: false}}",
+    "{a: {$exists: true}, b: {$exists: false}}",
+    "{a: {$in: [1, 'xyz', null]}}",
+    "{a: /^x/}",
+    "{a: {$mod: [2, 0]}}",
+    "{a: [1, 2]}",
+    "{a: {b: 1}}",
+    "{'a.b': 1}",
+    "{'a.b': null}",
+    "{'a.b.c': {$gte: 0}}",
+    "{'a.0': 1}",
+    "{$or: [{a: 1}, {b: 2}]}",
+    "{$or: [{a: 1}, {'a.b': 1}], b: {$ne: 2}}",
+    "{$nor: [{a: 1}, {b: 2}]}",
+    "{$and: []}",
+    "{$or: []}",
+    "{a: {$not: {$gt: 2}}}",
+    "{a: {$nin: [1, 2]}}",
+    "{a: {$size: 2}, b: 1}",
+    "{a: {$elemMatch: {$gt: 1}}, b: {$exists: true}}",
+    "{$and: [{a: 1}, {a: {$type: 1}}]}",
+    "{a: {$bitsAllSet: [0]}}",
+};
+
+const char* kDocs[] = {
+    "{}",
+    "{a: 1}",
+    "{a: 1, b: 3}",
+    "{a: 2, b: 3}",
+    "{a: 3, b: 2}",
+    "{a: null}",
+    "{b: 2}",
+    "{a: 'xyz'}",
+    "{a: [1, 2]}",
+    "{a: [1, 2], b: 1}",
+    "{a: [3]}",
+    "{a: {b: 1}}",
+    "{a: {b: [1]}}",
+    "{a: [{b: 1}]}",
+    "{a: {b: {c: 4}}}",
+    "{a: {b: 'x'}}",
+    "{a: {'0': 1}}",
+    "{a: 4, b: 1, a: 1}",
+    "{a: 1.0, b: 3.0}",
+};
+
+/**
+ * Checks that the compiled form of every filter above agrees with the interpreter on every
+ * document above.
+ */
+TEST(CompiledMatchExpressionTest, AgreesWithInterpreter) {
+    for (const char* filterJson : kFilters) {
+        unique_ptr<MatchExpression> expr = parse(fromjson(filterJson));
+        unique_ptr<CompiledMatchExpression> compiled = CompiledMatchExpression::compile(expr.get());
+        if (!compiled) {
+            continue;
+        }
+
+        for (const char* docJson : kDocs) {
+            BSONObj doc = fromjson(docJson);
+            ASSERT_EQUALS(expr->matchesBSON(doc), compiled->matchesBSON(doc))
+                << "filter: " << filterJson << ", document: " << docJson;
+        }
+    }
+}
+
+TEST(CompiledMatchExpressionTest, NotCompiledWithoutSimpleLeaves) {
+    unique_ptr<MatchExpression> expr = parse(fromjson("{a: {$elemMatch: {b: 1}}}"));
+    ASSERT(!CompiledMatchExpression::compile(expr.get()));
+
+    expr = parse(fromjson("{$or: [{a: {$size: 1}}, {b: {$type: 2}}]}"));
+    ASSERT(!CompiledMatchExpression::compile(expr.get()));
+
+    expr = parse(fromjson("{a: 1, b: {$elemMatch: {$gt: 1}}}"));
+    ASSERT(CompiledMatchExpression::compile(expr.get()));
+}
+
+TEST(CompiledMatchExpressionTest, ManyTopLevelFields) {
+    // Leaves beyond the limit on top-level fields are interpreted instead.
+    BSONObjBuilder filter;
+    BSONObjBuilder matching;
+    const size_t numFields = CompiledMatchExpression::kMaxTopLevelFields + 8;
+    for (size_t i = 0; i < numFields; ++i) {
+        const std::string field = str::stream() << "f" << i;
+        filter.append(field, static_cast<int>(i));
+        matching.append(field, static_cast<int>(i));
+    }
+    BSONObj matchingDoc = matching.obj();
+    BSONObj otherDoc = BSON("f0" << 0);
+
+    unique_ptr<MatchExpression> expr = parse(filter.obj());
+    unique_ptr<CompiledMatchExpression> compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+    ASSERT(compiled->matchesBSON(matchingDoc));
+    ASSERT(!compiled->matchesBSON(otherDoc));
+}
+
+/**
+ * Compares the time taken by the interpreter and by the compiled form to apply a typical
+ * conjunctive filter to wide documents. Timings are logged rather than asserted on.
+ */
+TEST(CompiledMatchExpressionTest, Microbenchmark) {
+    const int kNumDocs = 2000;
+    const int kNumPasses = 20;
+
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < kNumDocs; ++i) {
+        BSONObjBuilder bob;
+        for (int j = 0; j < 20; ++j) {
+            bob.append(std::string(str::stream() << "pad" << j), j);
+        }
+        bob.append("a", i);
+        bob.append("b", BSON("c" << i % 7 << "d" << "x"));
+        bob.append("status", i % 3 ? "active" : "inactive");
+        docs.push_back(bob.obj());
+    }
+
+    unique_ptr<MatchExpression> expr = parse(
+        fromjson("{a: {$gte: 100}, 'b.c': {$in: [1, 2, 3]}, status: 'active', missing: null}"));
+    unique_ptr<CompiledMatchExpression> compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+
+    size_t interpretedMatches = 0;
+    Timer interpretedTimer;
+    for (int pass = 0; pass < kNumPasses; ++pass) {
+        for (const BSONObj& doc : docs) {
+            interpretedMatches += expr->matchesBSON(doc);
+        }
+    }
+    const long long interpretedMicros = interpretedTimer.micros();
+
+    size_t compiledMatches = 0;
+    Timer compiledTimer;
+    for (int pass = 0; pass < kNumPasses; ++pass) {
+        for (const BSONObj& doc : docs) {
+            compiledMatches += compiled->matchesBSON(doc);
+        }
+    }
+    const long long compiledMicros = compiledTimer.micros();
+
+    ASSERT_EQUALS(interpretedMatches, compiledMatches);
+
+    const long long numEvaluations = static_cast<long long>(kNumDocs) * kNumPasses;
+    log() << "matching " << numEvaluations << " documents: interpreted "
+          << (interpretedMicros * 1000) / numEvaluations << "ns per document, compiled "
+          << (compiledMicros * 1000) / numEvaluations << "ns per document";
+}
+
+}  // namespace
+}  // namespace mongo
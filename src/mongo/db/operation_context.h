@@ -34,6 +34,7 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/arena.h"
 #include "mongo/util/decorable.h"
 
 namespace mongo {
@@ -172,6 +173,15 @@ public:
         _writeConcern = writeConcern;
     }
 
+    /**
+     * Returns an Arena for short-lived objects, such as those built while planning a query. The
+     * Arena and everything in it are freed in one shot when the operation ends. Users which
+     * allocate repeatedly during an operation should do so within an Arena::Scope.
+     */
+    Arena* getArena() {
+        return &_arena;
+    }
+
     /**
      * Set whether or not operations should generate oplog entries.
      */
@@ -217,6 +227,7 @@ private:
 
     AtomicInt32 _killPending{0};
     WriteConcernOptions _writeConcern;
+    Arena _arena;
 };
 
 class WriteUnitOfWork {
@@ -189,6 +189,8 @@ Status userAllowedCreateNS(StringData db, StringData coll) {
         if (db == "local") {
             if (coll == "system.replset")
                 return Status::OK();
+            if (coll == "system.plancache")
+                return Status::OK();
         }
         return Status(ErrorCodes::BadValue,
                       str::stream() << "cannot write to '" << db << "." << coll << "'");
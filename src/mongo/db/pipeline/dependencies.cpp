@@ -35,6 +35,7 @@
 
 namespace mongo {
 
+using std::pair;
 using std::set;
 using std::string;
 using std::vector;
@@ -141,6 +142,26 @@ Value arrayHelper(const BSONObj& bson, const Document& neededFields) {
     return Value(std::move(values));
 }
 
+// Returns the part of 'bsonElement' described by 'isNeeded', its entry in the look-up table, or a
+// missing Value if none of it is needed.
+Value neededValue(const BSONElement& bsonElement, const Value& isNeeded) {
+    if (isNeeded.missing())
+        return Value();
+
+    if (isNeeded.getType() == Bool)
+        return Value(bsonElement);
+
+    dassert(isNeeded.getType() == Object);
+
+    if (bsonElement.type() == Object)
+        return Value(documentHelper(bsonElement.embeddedObject(), isNeeded.getDocument()));
+
+    if (bsonElement.type() == Array)
+        return arrayHelper(bsonElement.embeddedObject(), isNeeded.getDocument());
+
+    return Value();
+}
+
 // Handles object-typed values including the top-level for ParsedDeps::extractFields
 Document documentHelper(const BSONObj& bson, const Document& neededFields) {
     MutableDocument md(neededFields.size());
@@ -149,27 +170,9 @@ Document documentHelper(const BSONObj& bson, const Document& neededFields) {
     while (it.more()) {
         BSONElement bsonElement(it.next());
         StringData fieldName = bsonElement.fieldNameStringData();
-        Value isNeeded = neededFields[fieldName];
-
-        if (isNeeded.missing())
-            continue;
-
-        if (isNeeded.getType() == Bool) {
-            md.addField(fieldName, Value(bsonElement));
-            continue;
-        }
-
-        dassert(isNeeded.getType() == Object);
-
-        if (bsonElement.type() == Object) {
-            Document sub = documentHelper(bsonElement.embeddedObject(), isNeeded.getDocument());
-            md.addField(fieldName, Value(sub));
-        }
-
-        if (bsonElement.type() == Array) {
-            md.addField(fieldName,
-                        arrayHelper(bsonElement.embeddedObject(), isNeeded.getDocument()));
-        }
+        Value value = neededValue(bsonElement, neededFields[fieldName]);
+        if (!value.missing())
+            md.addField(fieldName, value);
     }
 
     return md.freeze();
@@ -179,4 +182,32 @@ Document documentHelper(const BSONObj& bson, const Document& neededFields) {
 Document ParsedDeps::extractFields(const BSONObj& input) const {
     return documentHelper(input, _fields);
 }
+
+Document ParsedDeps::extractFields(const BSONObj& input,
+                                  const Document& layout,
+                                  bool* usedLayout) const {
+    vector<pair<StringData, Value>> fields;
+    fields.reserve(_fields.size());
+
+    BSONObjIterator it(input);
+    while (it.more()) {
+        BSONElement bsonElement(it.next());
+        StringData fieldName = bsonElement.fieldNameStringData();
+        Value value = neededValue(bsonElement, _fields[fieldName]);
+        if (!value.missing())
+            fields.push_back(std::make_pair(fieldName, std::move(value)));
+    }
+
+    if (auto document = Document::fromFieldsWithLayout(fields, layout)) {
+        *usedLayout = true;
+        return *document;
+    }
+
+    *usedLayout = false;
+    MutableDocument md(fields.size());
+    for (size_t i = 0; i < fields.size(); ++i) {
+        md.addField(fields[i].first, fields[i].second);
+    }
+    return md.freeze();
+}
 }
@@ -63,6 +63,13 @@ class ParsedDeps {
 public:
     Document extractFields(const BSONObj& input) const;
 
+    /**
+     * Like extractFields(input), but if the extracted fields are those of 'layout' in the same
+     * order, builds the result on a copy of the layout of 'layout' rather than adding each field
+     * in turn. Sets '*usedLayout' to whether it did.
+     */
+    Document extractFields(const BSONObj& input, const Document& layout, bool* usedLayout) const;
+
 private:
     friend struct DepsTracker;  // so it can call constructor
     explicit ParsedDeps(const Document& fields) : _fields(fields) {}
@@ -205,6 +205,84 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
     return out;
 }
 
+intrusive_ptr<DocumentStorage> DocumentStorage::cloneLayoutWithValues(const BSONObj& bson) const {
+    if (!_buffer) {
+        return NULL;
+    }
+
+    // Check that the shapes match before copying anything.
+    BSONObjIterator bsonIt(bson);
+    for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+        if (!bsonIt.more()) {
+            return NULL;
+        }
+        const StringData fieldName = bsonIt.next().fieldNameStringData();
+        if (fieldName != it->nameSD() || fieldName.startsWith("$")) {
+            return NULL;
+        }
+    }
+    if (bsonIt.more()) {
+        return NULL;
+    }
+
+    intrusive_ptr<DocumentStorage> out = cloneLayout();
+    BSONObjIterator valueIt(bson);
+    for (DocumentStorageIterator it = out->iteratorAll(); !it.atEnd(); it.advance()) {
+        out->getField(it.position()).val = Value(valueIt.next());
+    }
+
+    return out;
+}
+
+intrusive_ptr<DocumentStorage> DocumentStorage::cloneLayoutWithValues(
+    const std::vector<std::pair<StringData, Value>>& fields) const {
+    if (!_buffer) {
+        return NULL;
+    }
+
+    auto field = fields.begin();
+    for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance(), ++field) {
+        if (field == fields.end() || field->first != it->nameSD() ||
+            field->first.startsWith("$")) {
+            return NULL;
+        }
+    }
+    if (field != fields.end()) {
+        return NULL;
+    }
+
+    intrusive_ptr<DocumentStorage> out = cloneLayout();
+    field = fields.begin();
+    for (DocumentStorageIterator it = out->iteratorAll(); !it.atEnd(); it.advance(), ++field) {
+        out->getField(it.position()).val = field->second;
+    }
+
+    return out;
+}
+
+intrusive_ptr<DocumentStorage> DocumentStorage::cloneLayout() const {
+    intrusive_ptr<DocumentStorage> out(new DocumentStorage());
+
+    // Copy the buffer as clone() does, so the names, positions and hash table all carry over.
+    const size_t bufferBytes = (_bufferEnd + hashTabBytes()) - _buffer;
+    out->_buffer = new char[bufferBytes];
+    out->_bufferEnd = out->_buffer + (_bufferEnd - _buffer);
+    memcpy(out->_buffer, _buffer, bufferBytes);
+
+    out->_usedBytes = _usedBytes;
+    out->_numFields = _numFields;
+    out->_hashTabMask = _hashTabMask;
+
+    // The copied values are still owned by this storage. Clear them all before converting any new
+    // value, so that 'out' never releases a reference it does not hold if a conversion throws.
+    const Value missing;
+    for (DocumentStorageIterator it = out->iteratorAll(); !it.atEnd(); it.advance()) {
+        memcpy(&out->getField(it.position()).val, &missing, sizeof(Value));
+    }
+
+    return out;
+}
+
 DocumentStorage::~DocumentStorage() {
     std::unique_ptr<char[]> deleteBufferAtScopeEnd(_buffer);
 
@@ -281,6 +359,33 @@ Document Document::fromBsonWithMetaData(const BSONObj& bson) {
     return md.freeze();
 }
 
+Document Document::fromBsonWithMetaData(const BSONObj& bson, const Document& layout) {
+    if (auto document = fromBsonWithLayout(bson, layout)) {
+        return *document;
+    }
+    return fromBsonWithMetaData(bson);
+}
+
+boost::optional<Document> Document::fromBsonWithLayout(const BSONObj& bson,
+                                                       const Document& layout) {
+    if (layout._storage) {
+        if (auto storage = layout._storage->cloneLayoutWithValues(bson)) {
+            return Document(storage.get());
+        }
+    }
+    return boost::none;
+}
+
+boost::optional<Document> Document::fromFieldsWithLayout(
+    const std::vector<std::pair<StringData, Value>>& fields, const Document& layout) {
+    if (layout._storage) {
+        if (auto storage = layout._storage->cloneLayoutWithValues(fields)) {
+            return Document(storage.get());
+        }
+    }
+    return boost::none;
+}
+
 MutableDocument::MutableDocument(size_t expectedFields)
     : _storageHolder(NULL), _storage(_storageHolder) {
     if (expectedFields) {
@@ -32,6 +32,7 @@
 
 #include <boost/functional/hash.hpp>
 #include <boost/intrusive_ptr.hpp>
+#include <boost/optional.hpp>
 
 #include "mongo/bson/util/builder.h"
 
@@ -171,6 +172,27 @@ public:
      */
     static Document fromBsonWithMetaData(const BSONObj& bson);
 
+    /**
+     * Like fromBsonWithMetaData(bson), but if 'bson' has the same fields in the same order as
+     * 'layout', builds the new document on a copy of the layout of 'layout' rather than adding each
+     * field in turn. Useful when converting many documents that are likely to share one shape.
+     */
+    static Document fromBsonWithMetaData(const BSONObj& bson, const Document& layout);
+
+    /**
+     * Returns the Document that fromBsonWithMetaData(bson, layout) builds on the layout of
+     * 'layout', or boost::none if 'bson' doesn't have its shape.
+     */
+    static boost::optional<Document> fromBsonWithLayout(const BSONObj& bson,
+                                                        const Document& layout);
+
+    /**
+     * Returns a Document of the named values in 'fields', in order, built on a copy of the layout
+     * of 'layout', or boost::none if the names aren't exactly the field names of 'layout'.
+     */
+    static boost::optional<Document> fromFieldsWithLayout(
+        const std::vector<std::pair<StringData, Value>>& fields, const Document& layout);
+
     // Support BSONObjBuilder and BSONArrayBuilder "stream" API
     friend BSONObjBuilder& operator<<(BSONObjBuilderValueStream& builder, const Document& d);
 
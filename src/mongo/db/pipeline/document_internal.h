@@ -32,6 +32,8 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <bitset>
+#include <utility>
+#include <vector>
 
 #include "mongo/util/intrusive_counter.h"
 #include "mongo/db/pipeline/value.h"
@@ -266,6 +268,21 @@ public:
     /// Shallow copy of this. Caller owns memory.
     boost::intrusive_ptr<DocumentStorage> clone() const;
 
+    /**
+     * Returns new storage holding the values of 'bson' in a copy of this storage's buffer, or NULL
+     * if 'bson' does not have exactly this storage's field names in the same order. This skips
+     * hashing and appending each field name, which dominates building small documents that all
+     * share one shape. Never matches field names starting with '$', so metadata fields are left
+     * for the caller to parse. The new storage has no metadata.
+     */
+    boost::intrusive_ptr<DocumentStorage> cloneLayoutWithValues(const BSONObj& bson) const;
+
+    /**
+     * Like cloneLayoutWithValues(bson), for named values which need not come from one BSONObj.
+     */
+    boost::intrusive_ptr<DocumentStorage> cloneLayoutWithValues(
+        const std::vector<std::pair<StringData, Value>>& fields) const;
+
     size_t allocatedBytes() const {
         return !_buffer ? 0 : (_bufferEnd - _buffer + hashTabBytes());
     }
@@ -306,6 +323,9 @@ public:
     }
 
 private:
+    /// Copy of this storage's buffer with every value missing and no metadata.
+    boost::intrusive_ptr<DocumentStorage> cloneLayout() const;
+
     /// Same as lastElement->next() or firstElement() if empty.
     const ValueElement* end() const {
         return _firstElement->plusBytes(_usedBytes);
@@ -60,6 +60,7 @@ class Document;
 class Expression;
 class ExpressionFieldPath;
 class ExpressionObject;
+class DocumentSourceGroup;
 class DocumentSourceLimit;
 class PlanExecutor;
 
@@ -372,9 +373,24 @@ public:
      */
     void setProjection(const BSONObj& projection, const boost::optional<ParsedDeps>& deps);
 
+    /**
+     * Replaces the output of the PlanExecutor with the output of 'group' given the documents it
+     * returns. The PlanExecutor must be a count, as built by getExecutorCount(), and the group
+     * must be count only.
+     */
+    void setCountGroup(const boost::intrusive_ptr<DocumentSourceGroup>& group);
+
     /// returns -1 for no limit
     long long getLimit() const;
 
+    /**
+     * Returns how many documents were built on the layout of the document before them rather
+     * than field by field.
+     */
+    long long getDocsBuiltOnLayout() const {
+        return _docsBuiltOnLayout;
+    }
+
 private:
     DocumentSourceCursor(const std::string& ns,
                          const std::shared_ptr<PlanExecutor>& exec,
@@ -391,6 +407,8 @@ private:
     boost::optional<ParsedDeps> _dependencies;
     boost::intrusive_ptr<DocumentSourceLimit> _limit;
     long long _docsAddedToBatches;  // for _limit enforcement
+    long long _docsBuiltOnLayout;
+    boost::intrusive_ptr<DocumentSourceGroup> _countGroup;
 
     const std::string _ns;
     std::shared_ptr<PlanExecutor> _exec;  // PipelineProxyStage holds a weak_ptr to this.
@@ -431,6 +449,46 @@ public:
         _doingMerge = doingMerge;
     }
 
+    /**
+     * Returns true if input sorted by "sortPattern", a sort specification such as {a: 1, b: -1},
+     * delivers all the documents of each group next to each other. That is the case when every
+     * non-constant part of the group key is a field path, and together they name a prefix of the
+     * fields in "sortPattern".
+     */
+    bool groupsAreContiguousWhenSortedBy(const BSONObj& sortPattern) const;
+
+    /**
+     * Returns true if the group key is constant and every accumulator is a $sum of a constant
+     * integer, as in {$group: {_id: null, n: {$sum: 1}}}. The output of such a group depends only
+     * on how many documents it is given, so they can be counted rather than read.
+     */
+    bool isCountOnly() const;
+
+    /**
+     * Returns the document this group produces from 'nDocs' input documents, which is none at all
+     * if 'nDocs' is 0. Only valid if isCountOnly().
+     */
+    boost::optional<Document> countOnlyResult(long long nDocs);
+
+    /**
+     * If the group key is a single field path and there are no accumulators, as in
+     * {$group: {_id: "$a.b"}}, returns that path ("a.b"). Otherwise returns the empty string.
+     */
+    std::string distinctFieldPath() const;
+
+    /**
+     * In streaming mode, each group is returned as soon as the group key of the input changes,
+     * rather than after consuming the whole input into a hash table. This takes constant memory
+     * regardless of the number of groups, but is only correct if the input delivers all the
+     * documents of each group contiguously.
+     */
+    void setStreaming(bool streaming) {
+        _streaming = streaming;
+    }
+    bool isStreaming() const {
+        return _streaming;
+    }
+
     /**
       Create a grouping DocumentSource from BSON.
 
@@ -467,6 +525,18 @@ private:
     void populate();
     bool populated;
 
+    /**
+     * Implementation of getNext() in streaming mode: consumes input until the group key changes
+     * and returns the finished group.
+     */
+    boost::optional<Document> getNextStreaming();
+
+    /**
+     * Abandons streaming after finding a group key containing an array, and groups the rest of
+     * the input in the hash table instead.
+     */
+    boost::optional<Document> stopStreaming(bool haveCurrentGroup);
+
     /**
      * Parses the raw id expression into _idExpressions and possibly _idFieldNames.
      */
@@ -508,6 +578,7 @@ private:
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     bool _doingMerge;
+    bool _streaming;
     bool _spilled;
     const bool _extSortAllowed;
     const int _maxMemoryUsageBytes;
@@ -523,9 +594,141 @@ private:
     std::pair<Value, Value> _firstPartOfNextGroup;
     Value _currentId;
     Accumulators _currentAccumulators;
+
+    // only used when _streaming: the input document read past the end of the current group, and
+    // its group key.
+    boost::optional<Document> _firstDocOfNextGroup;
+    Value _firstIdOfNextGroup;
+    bool _streamingInputExhausted;
 };
 
 
+/**
+ * Joins each input document with the documents of another unsharded collection in the same
+ * database whose 'foreignField' equals the input's 'localField', adding them as an array under
+ * 'as'. For example {$lookup: {from: "b", localField: "x", foreignField: "y", as: "z"}} sets the
+ * field z of each document to the documents of b matching {y: {$eq: <value of x>}}.
+ *
+ * If the foreign field leads an index, each input document is joined by querying that index.
+ * Otherwise the foreign collection is read once into a hash table keyed by the values of the
+ * foreign field, which is probed for each input document. Should the table outgrow the memory
+ * limit, the join falls back to querying the foreign collection for each input document.
+ */
+class DocumentSourceLookUp final : public DocumentSource,
+                                   public SplittableDocumentSource,
+                                   public DocumentSourceNeedsMongod {
+public:
+    // virtuals from DocumentSource
+    boost::optional<Document> getNext() final;
+    const char* getSourceName() const final;
+    Value serialize(bool explain = false) const final;
+    GetDepsReturn getDependencies(DepsTracker* deps) const final;
+    void dispose() final;
+    bool needsPrimaryShard() const final {
+        return true;
+    }
+
+    // Virtuals for SplittableDocumentSource
+    boost::intrusive_ptr<DocumentSource> getShardSource() final {
+        return NULL;
+    }
+    boost::intrusive_ptr<DocumentSource> getMergeSource() final {
+        return this;
+    }
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+private:
+    enum class JoinStrategy {
+        kUndecided,
+        kIndexedLoop,  // query the foreign collection for each input, through an index
+        kHashJoin,     // probe a hash table holding the foreign collection
+        kSortMerge,    // merge the input and the foreign collection, both sorted by join value
+        kNestedLoop,   // query the foreign collection for each input, without an index
+    };
+
+    typedef Sorter<Value, Document> JoinSorter;
+
+    static const char* getStrategyName(JoinStrategy strategy);
+
+    DocumentSourceLookUp(NamespaceString fromNs,
+                         std::string as,
+                         std::string localField,
+                         std::string foreignField,
+                         const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+    /**
+     * Returns the value of the local field of 'input' which the foreign field must equal, null if
+     * it is missing.
+     */
+    Value getLookupValue(const Document& input) const;
+
+    /**
+     * Returns the {<foreignField>: {$eq: <lookupValue>}} predicate a foreign document must match.
+     */
+    BSONObj makeQuery(const Value& lookupValue) const;
+
+    bool foreignFieldIsIndexed() const;
+
+    /**
+     * Picks the join strategy, building the hash table if that is the one picked. If the hash
+     * table doesn't fit in memory, sorts to disk when allowed to.
+     */
+    void chooseStrategy();
+
+    /**
+     * Returns the values of the foreign field of 'foreignDoc' under which it is joined.
+     */
+    BSONElementSet getJoinKeys(const BSONObj& foreignDoc) const;
+
+    /**
+     * Reads the foreign collection into '_foreignDocs' and '_hashTable'. Returns false, leaving
+     * both empty, if they would take more than the memory limit.
+     */
+    bool buildHashTable();
+
+    /**
+     * Returns a sorter of pairs by their keys, which spills to disk past the memory limit.
+     */
+    JoinSorter* makeSorter() const;
+
+    /**
+     * Joins 'firstInput' and the rest of the input with the foreign collection by sorting both by
+     * join value, spilling to disk as needed, and merging them. Leaves the joined documents, in
+     * input order, in '_sortMergeOutput'.
+     */
+    void sortMergeJoin(Document firstInput);
+
+    /**
+     * Returns the foreign documents which match 'query', a {<foreignField>: {$eq: <value>}}
+     * predicate on the value 'lookupValue'.
+     */
+    std::vector<Value> probeHashTable(const Value& lookupValue, const BSONObj& query);
+
+    std::vector<Value> queryForeignCollection(const BSONObj& query);
+
+    const NamespaceString _fromNs;
+    const FieldPath _as;
+    const FieldPath _localField;
+    const FieldPath _foreignField;
+    const std::string _foreignFieldName;  // _foreignField as a dotted path
+
+    JoinStrategy _strategy;
+
+    // Only used by the hash join. The table maps each value of the foreign field in the foreign
+    // documents, and each element of those values that are arrays, to the positions in
+    // '_foreignDocs' of the documents holding it. The documents found there are only candidates
+    // which the query must still match.
+    typedef std::unordered_map<Value, std::vector<size_t>, Value::Hash> HashTable;
+    std::vector<BSONObj> _foreignDocs;
+    HashTable _hashTable;
+    size_t _memoryUsageBytes;
+
+    // Only used by the sort-merge join, once it has consumed the input.
+    std::unique_ptr<JoinSorter::Iterator> _sortMergeOutput;
+};
+
 class DocumentSourceMatch final : public DocumentSource {
 public:
     // virtuals from DocumentSource
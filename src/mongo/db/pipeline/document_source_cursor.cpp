@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/instance.h"
 #include "mongo/db/pipeline/document.h"
@@ -93,12 +94,36 @@ void DocumentSourceCursor::loadBatch() {
     int memUsageBytes = 0;
     BSONObj obj;
     PlanExecutor::ExecState state;
-    while ((state = _exec->getNext(&obj, NULL)) == PlanExecutor::ADVANCED) {
-        if (_dependencies) {
-            _currentBatch.push_back(_dependencies->extractFields(obj));
+    if (_countGroup) {
+        // The count stage does all of its work before reporting EOF, without returning anything.
+        state = _exec->getNext(&obj, NULL);
+        if (state == PlanExecutor::IS_EOF) {
+            const CountStats* stats =
+                static_cast<const CountStats*>(_exec->getRootStage()->getSpecificStats());
+            if (auto doc = _countGroup->countOnlyResult(stats->nCounted)) {
+                _currentBatch.push_back(*doc);
+            }
+        }
+    }
+    while (!_countGroup && (state = _exec->getNext(&obj, NULL)) == PlanExecutor::ADVANCED) {
+        // Documents in a collection usually share one shape, so try to build each on the layout
+        // of the one before it.
+        bool usedLayout = false;
+        if (_currentBatch.empty()) {
+            _currentBatch.push_back(_dependencies ? _dependencies->extractFields(obj)
+                                                  : Document::fromBsonWithMetaData(obj));
+        } else if (_dependencies) {
+            _currentBatch.push_back(
+                _dependencies->extractFields(obj, _currentBatch.back(), &usedLayout));
+        } else if (auto doc = Document::fromBsonWithLayout(obj, _currentBatch.back())) {
+            usedLayout = true;
+            _currentBatch.push_back(*doc);
         } else {
             _currentBatch.push_back(Document::fromBsonWithMetaData(obj));
         }
+        if (usedLayout) {
+            ++_docsBuiltOnLayout;
+        }
 
         if (_limit) {
             if (++_docsAddedToBatches == _limit->getLimit()) {
@@ -189,6 +214,9 @@ Value DocumentSourceCursor::serialize(bool explain) const {
     if (!_projection.isEmpty())
         out["fields"] = Value(_projection);
 
+    if (_countGroup)
+        out["countGroup"] = _countGroup->serialize(explain);
+
     // Add explain results from the query system into the agg explain output.
     BSONObj explainObj = explainBuilder.obj();
     invariant(explainObj.hasField("queryPlanner"));
@@ -200,7 +228,11 @@ Value DocumentSourceCursor::serialize(bool explain) const {
 DocumentSourceCursor::DocumentSourceCursor(const string& ns,
                                            const std::shared_ptr<PlanExecutor>& exec,
                                            const intrusive_ptr<ExpressionContext>& pCtx)
-    : DocumentSource(pCtx), _docsAddedToBatches(0), _ns(ns), _exec(exec) {}
+    : DocumentSource(pCtx),
+      _docsAddedToBatches(0),
+      _docsBuiltOnLayout(0),
+      _ns(ns),
+      _exec(exec) {}
 
 intrusive_ptr<DocumentSourceCursor> DocumentSourceCursor::create(
     const string& ns,
@@ -214,4 +246,9 @@ void DocumentSourceCursor::setProjection(const BSONObj& projection,
     _projection = projection;
     _dependencies = deps;
 }
+
+void DocumentSourceCursor::setCountGroup(const intrusive_ptr<DocumentSourceGroup>& group) {
+    invariant(group->isCountOnly());
+    _countGroup = group;
+}
 }
@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <set>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/accumulator.h"
@@ -46,6 +47,66 @@ using std::vector;
 
 REGISTER_DOCUMENT_SOURCE(group, DocumentSourceGroup::createFromBson);
 
+namespace {
+/**
+ * Returns true if 'id' is or contains an array. $sort orders an array by its smallest (or
+ * largest) element, so documents whose group key is an array need not be adjacent after a sort.
+ */
+bool containsArray(const Value& id) {
+    if (id.getType() == Array)
+        return true;
+
+    if (id.getType() == Object) {
+        FieldIterator it = id.getDocument().fieldIterator();
+        while (it.more()) {
+            if (containsArray(it.next().second))
+                return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns true if 'id' is or contains null or undefined. A missing group key becomes null, so
+ * missing and null values share a group, but $sort orders missing values together with undefined
+ * ones and before null ones. Documents whose group key is or contains null need not be adjacent
+ * after a sort.
+ */
+bool containsNullish(const Value& id) {
+    if (id.nullish())
+        return true;
+
+    if (id.getType() == Object) {
+        FieldIterator it = id.getDocument().fieldIterator();
+        while (it.more()) {
+            if (containsNullish(it.next().second))
+                return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * If 'expression' is a field path into the input document, such as "$a.b", returns that path
+ * ("a.b"). Otherwise returns the empty string.
+ */
+std::string inputFieldPath(Expression* expression) {
+    ExpressionFieldPath* fieldPath = dynamic_cast<ExpressionFieldPath*>(expression);
+    if (!fieldPath)
+        return "";
+
+    // Field paths are rooted at either CURRENT or ROOT, which are the same document here.
+    const FieldPath& path = fieldPath->getFieldPath();
+    if (path.getPathLength() < 2)
+        return "";
+    const std::string& root = path.getFieldName(0);
+    if (root != "CURRENT" && root != "ROOT")
+        return "";
+
+    return path.tail().getPath(false);
+}
+}  // namespace
+
 const char* DocumentSourceGroup::getSourceName() const {
     return "$group";
 }
@@ -53,6 +114,9 @@ const char* DocumentSourceGroup::getSourceName() const {
 boost::optional<Document> DocumentSourceGroup::getNext() {
     pExpCtx->checkForInterrupt();
 
+    if (_streaming)
+        return getNextStreaming();
+
     if (!populated)
         populate();
 
@@ -114,6 +178,115 @@ boost::optional<Document> DocumentSourceGroup::getNext() {
     }
 }
 
+boost::optional<Document> DocumentSourceGroup::getNextStreaming() {
+    if (_streamingInputExhausted)
+        return boost::none;
+
+    if (!_firstDocOfNextGroup) {
+        // Only the very first call gets here: later groups start with the document that ended
+        // the previous one.
+        _firstDocOfNextGroup = pSource->getNext();
+        if (!_firstDocOfNextGroup) {
+            _streamingInputExhausted = true;
+            dispose();
+            return boost::none;
+        }
+
+        _variables->setRoot(*_firstDocOfNextGroup);
+        _firstIdOfNextGroup = computeId(_variables.get());
+        _variables->clearRoot();
+
+        /* treat missing values the same as NULL SERVER-4674 */
+        if (_firstIdOfNextGroup.missing())
+            _firstIdOfNextGroup = Value(BSONNULL);
+
+        if (containsArray(_firstIdOfNextGroup))
+            return stopStreaming(false);
+
+        const size_t numAccumulators = vpAccumulatorFactory.size();
+        _currentAccumulators.reserve(numAccumulators);
+        for (size_t i = 0; i < numAccumulators; i++) {
+            _currentAccumulators.push_back(vpAccumulatorFactory[i]());
+        }
+    }
+
+    const size_t numAccumulators = vpAccumulatorFactory.size();
+    for (size_t i = 0; i < numAccumulators; i++) {
+        _currentAccumulators[i]->reset();  // prep accumulators for a new group
+    }
+
+    _currentId = _firstIdOfNextGroup;
+    Document input = *_firstDocOfNextGroup;
+    while (true) {
+        _variables->setRoot(input);
+        int memoryUsageBytes = _currentId.getApproximateSize();
+        for (size_t i = 0; i < numAccumulators; i++) {
+            _currentAccumulators[i]->process(vpExpression[i]->evaluate(_variables.get()),
+                                             _doingMerge);
+            memoryUsageBytes += _currentAccumulators[i]->memUsageForSorter();
+        }
+        _variables->clearRoot();
+
+        // Only the current group is held in memory, and it cannot be spilled, so allowDiskUse
+        // does not help.
+        uassert(28801,
+                str::stream() << "Exceeded memory limit for $group: a single group used "
+                              << memoryUsageBytes << " bytes, more than the limit of "
+                              << _maxMemoryUsageBytes << " bytes, and cannot be spilled to disk",
+                memoryUsageBytes <= _maxMemoryUsageBytes);
+
+        _firstDocOfNextGroup = pSource->getNext();
+        if (!_firstDocOfNextGroup) {
+            _streamingInputExhausted = true;
+            break;
+        }
+
+        input = *_firstDocOfNextGroup;
+        _variables->setRoot(input);
+        _firstIdOfNextGroup = computeId(_variables.get());
+        _variables->clearRoot();
+
+        if (_firstIdOfNextGroup.missing())
+            _firstIdOfNextGroup = Value(BSONNULL);
+
+        if (containsArray(_firstIdOfNextGroup))
+            return stopStreaming(true);
+
+        if (Value::compare(_firstIdOfNextGroup, _currentId) != 0) {
+            // A group whose key is or contains null may have more documents after some other
+            // group, and so may a group next to it, so from here on we group by hashing.
+            if (containsNullish(_currentId) || containsNullish(_firstIdOfNextGroup))
+                return stopStreaming(true);
+            break;
+        }
+
+        pExpCtx->checkForInterrupt();
+    }
+
+    Document out = makeDocument(_currentId, _currentAccumulators, pExpCtx->inShard);
+
+    if (_streamingInputExhausted)
+        dispose();
+
+    return out;
+}
+
+boost::optional<Document> DocumentSourceGroup::stopStreaming(bool haveCurrentGroup) {
+    _streaming = false;
+
+    // Groups already returned had scalar keys that sort before every remaining document, so
+    // no later document can belong to them. The group in progress has not been returned yet and
+    // later documents may still join it, so it moves into the hash table. populate() picks up
+    // _firstDocOfNextGroup before reading any further input.
+    if (haveCurrentGroup) {
+        groups[_currentId] = _currentAccumulators;
+        _currentAccumulators.clear();
+    }
+
+    populate();
+    return getNext();
+}
+
 void DocumentSourceGroup::dispose() {
     // free our resources
     GroupsMap().swap(groups);
@@ -121,19 +294,23 @@ void DocumentSourceGroup::dispose() {
 
     // make us look done
     groupsIterator = groups.end();
+    _firstDocOfNextGroup = boost::none;
 
     // free our source's resources
     pSource->dispose();
 }
 
 intrusive_ptr<DocumentSource> DocumentSourceGroup::optimize() {
-    // TODO if all _idExpressions are ExpressionConstants after optimization, then we know there
-    // will only be one group. We should take advantage of that to avoid going through the hash
-    // table.
+    bool constantId = true;
     for (size_t i = 0; i < _idExpressions.size(); i++) {
         _idExpressions[i] = _idExpressions[i]->optimize();
+        constantId = constantId && dynamic_cast<ExpressionConstant*>(_idExpressions[i].get());
     }
 
+    // If the group key is constant there is only one group, which needs no hash table.
+    if (constantId)
+        _streaming = true;
+
     for (size_t i = 0; i < vFieldName.size(); i++) {
         vpExpression[i] = vpExpression[i]->optimize();
     }
@@ -173,9 +350,102 @@ Value DocumentSourceGroup::serialize(bool explain) const {
         insides["$doingMerge"] = Value(true);
     }
 
+    if (explain && _streaming) {
+        // Only reported by explain, since the stage is not re-parsed from its explain output.
+        insides["$streaming"] = Value(true);
+    }
+
     return Value(DOC(getSourceName() << insides.freeze()));
 }
 
+bool DocumentSourceGroup::groupsAreContiguousWhenSortedBy(const BSONObj& sortPattern) const {
+    std::set<std::string> groupPaths;
+    for (size_t i = 0; i < _idExpressions.size(); i++) {
+        if (dynamic_cast<ExpressionConstant*>(_idExpressions[i].get()))
+            continue;
+
+        const std::string path = inputFieldPath(_idExpressions[i].get());
+        if (path.empty())
+            return false;
+
+        groupPaths.insert(path);
+    }
+
+    // Each group path must be one of the leading fields of the sort pattern, and together they
+    // must cover those leading fields exactly.
+    size_t numMatched = 0;
+    BSONForEach(elem, sortPattern) {
+        if (numMatched == groupPaths.size())
+            break;
+        if (!elem.isNumber() || !groupPaths.count(elem.fieldName()))
+            return false;
+        ++numMatched;
+    }
+    return numMatched == groupPaths.size();
+}
+
+bool DocumentSourceGroup::isCountOnly() const {
+    if (_doingMerge)
+        return false;
+
+    for (size_t i = 0; i < _idExpressions.size(); i++) {
+        if (!dynamic_cast<ExpressionConstant*>(_idExpressions[i].get()))
+            return false;
+    }
+
+    for (size_t i = 0; i < vFieldName.size(); i++) {
+        if (vpAccumulatorFactory[i] != &AccumulatorSum::create)
+            return false;
+
+        ExpressionConstant* constant = dynamic_cast<ExpressionConstant*>(vpExpression[i].get());
+        if (!constant)
+            return false;
+
+        const BSONType type = constant->getValue().getType();
+        if (type != NumberInt && type != NumberLong)
+            return false;
+    }
+    return true;
+}
+
+boost::optional<Document> DocumentSourceGroup::countOnlyResult(long long nDocs) {
+    invariant(isCountOnly());
+    if (nDocs == 0)
+        return boost::none;
+
+    vector<Value> idVals;
+    for (size_t i = 0; i < _idExpressions.size(); i++) {
+        idVals.push_back(static_cast<ExpressionConstant*>(_idExpressions[i].get())->getValue());
+    }
+    const Value id = idVals.size() == 1 ? idVals[0] : Value(std::move(idVals));
+
+    // Summing the constant over 'nDocs' documents is the same as adding up their product once,
+    // provided the product has the type, and wraps around the way, the sum of the individual
+    // values would have. AccumulatorSum adds ints and longs as longs which wrap on overflow, so
+    // the product is taken modulo 2^64 too.
+    Accumulators accums;
+    for (size_t i = 0; i < vFieldName.size(); i++) {
+        const Value constant = static_cast<ExpressionConstant*>(vpExpression[i].get())->getValue();
+        const long long total = static_cast<long long>(
+            static_cast<unsigned long long>(nDocs) *
+            static_cast<unsigned long long>(constant.coerceToLong()));
+
+        accums.push_back(vpAccumulatorFactory[i]());
+        accums.back()->process(constant.getType() == NumberInt ? Value::createIntOrLong(total)
+                                                               : Value(total),
+                               false);
+    }
+
+    return makeDocument(id, accums, false);
+}
+
+std::string DocumentSourceGroup::distinctFieldPath() const {
+    if (_doingMerge || !vFieldName.empty() || !_idFieldNames.empty() || _idExpressions.size() != 1)
+        return "";
+
+    return inputFieldPath(_idExpressions[0].get());
+}
+
 DocumentSource::GetDepsReturn DocumentSourceGroup::getDependencies(DepsTracker* deps) const {
     // add the _id
     for (size_t i = 0; i < _idExpressions.size(); i++) {
@@ -201,9 +471,11 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
     : DocumentSource(pExpCtx),
       populated(false),
       _doingMerge(false),
+      _streaming(false),
       _spilled(false),
       _extSortAllowed(pExpCtx->extSortAllowed && !pExpCtx->inRouter),
-      _maxMemoryUsageBytes(100 * 1024 * 1024) {}
+      _maxMemoryUsageBytes(100 * 1024 * 1024),
+      _streamingInputExhausted(false) {}
 
 void DocumentSourceGroup::addAccumulator(const std::string& fieldName,
                                          Accumulator::Factory accumulatorFactory,
@@ -313,8 +585,14 @@ void DocumentSourceGroup::populate() {
     vector<shared_ptr<Sorter<Value, Value>::Iterator>> sortedFiles;
     int memoryUsageBytes = 0;
 
+    // A streaming $group that gave up on streaming hands over the document it already read.
+    boost::optional<Document> input = _firstDocOfNextGroup;
+    _firstDocOfNextGroup = boost::none;
+    if (!input)
+        input = pSource->getNext();
+
     // This loop consumes all input from pSource and buckets it based on pIdExpression.
-    while (boost::optional<Document> input = pSource->getNext()) {
+    for (; input; input = pSource->getNext()) {
         if (memoryUsageBytes > _maxMemoryUsageBytes) {
             uassert(16945,
                     "Exceeded memory limit for $group, but didn't allow external sort."
@@ -0,0 +1,429 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source.h"
+
+#include "mongo/client/dbclientcursor.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/matcher.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/server_parameters.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+using std::string;
+using std::vector;
+
+// The most memory the hash table of a $lookup may take before the join falls back to sorting
+// both sides by the join value, and the most each of those sorts holds before spilling to disk.
+MONGO_EXPORT_SERVER_PARAMETER(internalLookupHashJoinMaxMemoryBytes, int, 100 * 1024 * 1024);
+
+namespace {
+class JoinComparator {
+public:
+    typedef std::pair<Value, Document> Data;
+    int operator()(const Data& lhs, const Data& rhs) const {
+        return Value::compare(lhs.first, rhs.first);
+    }
+};
+
+// Approximate bytes an unordered_map node takes beyond its value: the link to the next node and
+// the cached hash.
+const size_t kHashTableNodeOverheadBytes = 2 * sizeof(void*);
+}  // namespace
+
+REGISTER_DOCUMENT_SOURCE(lookup, DocumentSourceLookUp::createFromBson);
+
+DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
+                                           string as,
+                                           string localField,
+                                           string foreignField,
+                                           const intrusive_ptr<ExpressionContext>& pExpCtx)
+    : DocumentSource(pExpCtx),
+      _fromNs(std::move(fromNs)),
+      _as(std::move(as)),
+      _localField(std::move(localField)),
+      _foreignField(foreignField),
+      _foreignFieldName(std::move(foreignField)),
+      _strategy(JoinStrategy::kUndecided),
+      _memoryUsageBytes(0) {}
+
+const char* DocumentSourceLookUp::getSourceName() const {
+    return "$lookup";
+}
+
+boost::optional<Document> DocumentSourceLookUp::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (_sortMergeOutput) {
+        if (!_sortMergeOutput->more())
+            return boost::none;
+        return _sortMergeOutput->next().second;
+    }
+
+    boost::optional<Document> input = pSource->getNext();
+    if (!input)
+        return boost::none;
+
+    if (_strategy == JoinStrategy::kUndecided)
+        chooseStrategy();
+
+    if (_strategy == JoinStrategy::kSortMerge) {
+        sortMergeJoin(std::move(*input));
+        return getNext();
+    }
+
+    const Value lookupValue = getLookupValue(*input);
+    const BSONObj query = makeQuery(lookupValue);
+
+    vector<Value> results = _strategy == JoinStrategy::kHashJoin
+        ? probeHashTable(lookupValue, query)
+        : queryForeignCollection(query);
+
+    MutableDocument output(std::move(*input));
+    output.setNestedField(_as, Value(std::move(results)));
+    return output.freeze();
+}
+
+Value DocumentSourceLookUp::getLookupValue(const Document& input) const {
+    Value lookupValue = input.getNestedField(_localField);
+    if (lookupValue.missing()) {
+        lookupValue = Value(BSONNULL);
+    }
+    return lookupValue;
+}
+
+BSONObj DocumentSourceLookUp::makeQuery(const Value& lookupValue) const {
+    BSONObjBuilder queryBuilder;
+    {
+        BSONObjBuilder predicate(queryBuilder.subobjStart(_foreignFieldName));
+        lookupValue.addToBsonObj(&predicate, "$eq");
+    }
+    return queryBuilder.obj();
+}
+
+bool DocumentSourceLookUp::foreignFieldIsIndexed() const {
+    // Any index led by the foreign field answers the equality predicate of each query.
+    const std::list<BSONObj> indexes = _mongod->directClient()->getIndexSpecs(_fromNs.ns());
+    for (auto&& index : indexes) {
+        BSONElement firstField = index["key"].Obj().firstElement();
+        if (_foreignFieldName == firstField.fieldName() &&
+            !index.hasField("partialFilterExpression")) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DocumentSourceLookUp::chooseStrategy() {
+    uassert(28795,
+            str::stream() << "from collection '" << _fromNs.ns() << "' cannot be sharded",
+            !_mongod->isSharded(_fromNs));
+
+    if (foreignFieldIsIndexed()) {
+        _strategy = JoinStrategy::kIndexedLoop;
+    } else if (buildHashTable()) {
+        _strategy = JoinStrategy::kHashJoin;
+    } else if (pExpCtx->extSortAllowed && !pExpCtx->inRouter) {
+        _strategy = JoinStrategy::kSortMerge;
+    } else {
+        // Without permission to spill to disk, as for $sort and $group, the join can only be done
+        // in bounded memory by querying the foreign collection for each input document.
+        _strategy = JoinStrategy::kNestedLoop;
+    }
+}
+
+BSONElementSet DocumentSourceLookUp::getJoinKeys(const BSONObj& foreignDoc) const {
+    // The values of the foreign field both as a whole and, where they are arrays, element by
+    // element, the same values an equality predicate compares against.
+    BSONElementSet keys;
+    foreignDoc.getFieldsDotted(_foreignFieldName, keys, true);
+    foreignDoc.getFieldsDotted(_foreignFieldName, keys, false);
+    return keys;
+}
+
+bool DocumentSourceLookUp::buildHashTable() {
+    std::unique_ptr<DBClientCursor> cursor =
+        _mongod->directClient()->query(_fromNs.ns(), Query());
+    while (cursor->more()) {
+        BSONObj doc = cursor->nextSafe().getOwned();
+        _memoryUsageBytes += doc.objsize();
+
+        const size_t position = _foreignDocs.size();
+        for (auto&& key : getJoinKeys(doc)) {
+            Value keyValue(key);
+            HashTable::iterator it = _hashTable.find(keyValue);
+            if (it == _hashTable.end()) {
+                _memoryUsageBytes += sizeof(HashTable::value_type) + kHashTableNodeOverheadBytes +
+                    keyValue.getApproximateSize() - sizeof(Value);
+                it = _hashTable.emplace(std::move(keyValue), vector<size_t>()).first;
+            }
+
+            vector<size_t>& positions = it->second;
+            if (positions.empty() || positions.back() != position) {
+                const size_t oldCapacity = positions.capacity();
+                positions.push_back(position);
+                _memoryUsageBytes += (positions.capacity() - oldCapacity) * sizeof(size_t);
+            }
+        }
+        _foreignDocs.push_back(std::move(doc));
+
+        const size_t containerBytes = _hashTable.bucket_count() * sizeof(void*) +
+            _foreignDocs.capacity() * sizeof(BSONObj);
+        if (_memoryUsageBytes + containerBytes >
+            static_cast<size_t>(internalLookupHashJoinMaxMemoryBytes)) {
+            _foreignDocs.clear();
+            _hashTable.clear();
+            _memoryUsageBytes = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+vector<Value> DocumentSourceLookUp::probeHashTable(const Value& lookupValue,
+                                                   const BSONObj& query) {
+    vector<Value> results;
+
+    // Documents lacking the foreign field hold no key in the table, so if they may match, every
+    // document is a candidate.
+    const bool checkAll = lookupValue.nullish();
+    const vector<size_t>* candidates = nullptr;
+    if (!checkAll) {
+        HashTable::const_iterator it = _hashTable.find(lookupValue);
+        if (it == _hashTable.end())
+            return results;
+        candidates = &it->second;
+    }
+
+    const Matcher matcher(query);
+    const size_t nCandidates = checkAll ? _foreignDocs.size() : candidates->size();
+    for (size_t i = 0; i < nCandidates; i++) {
+        const BSONObj& doc = _foreignDocs[checkAll ? i : (*candidates)[i]];
+        if (matcher.matches(doc)) {
+            results.push_back(Value(doc));
+        }
+    }
+    return results;
+}
+
+DocumentSourceLookUp::JoinSorter* DocumentSourceLookUp::makeSorter() const {
+    const SortOptions opts = SortOptions()
+                                 .MaxMemoryUsageBytes(internalLookupHashJoinMaxMemoryBytes)
+                                 .ExtSortAllowed()
+                                 .TempDir(pExpCtx->tempDir);
+    return JoinSorter::make(opts, JoinComparator());
+}
+
+void DocumentSourceLookUp::sortMergeJoin(Document firstInput) {
+    // Sort the foreign documents by each value the hash table would hold them under. A document
+    // which matches a null lookup value, by lacking the foreign field or otherwise, is also held
+    // under null.
+    std::unique_ptr<JoinSorter> foreignSorter(makeSorter());
+    const Matcher nullMatcher(makeQuery(Value(BSONNULL)));
+    const Value nullKey(BSONNULL);
+    std::unique_ptr<DBClientCursor> cursor =
+        _mongod->directClient()->query(_fromNs.ns(), Query());
+    while (cursor->more()) {
+        pExpCtx->checkForInterrupt();
+        const BSONObj doc = cursor->nextSafe();
+        const Document foreignDoc(doc);
+
+        bool heldUnderNull = false;
+        for (auto&& key : getJoinKeys(doc)) {
+            Value keyValue(key);
+            heldUnderNull = heldUnderNull || Value::compare(keyValue, nullKey) == 0;
+            foreignSorter->add(keyValue, foreignDoc);
+        }
+        if (!heldUnderNull && nullMatcher.matches(doc)) {
+            foreignSorter->add(nullKey, foreignDoc);
+        }
+    }
+
+    // Sort the input by its lookup values, numbering the documents so that their order can be
+    // restored afterwards.
+    std::unique_ptr<JoinSorter> inputSorter(makeSorter());
+    long long inputPosition = 0;
+    for (boost::optional<Document> input = std::move(firstInput); input;
+         input = pSource->getNext()) {
+        pExpCtx->checkForInterrupt();
+        inputSorter->add(Value(vector<Value>{getLookupValue(*input), Value(inputPosition++)}),
+                         *input);
+    }
+
+    // Merge the two, collecting the foreign documents with each lookup value once for all of the
+    // input documents with that value.
+    std::unique_ptr<JoinSorter::Iterator> inputIt(inputSorter->done());
+    std::unique_ptr<JoinSorter::Iterator> foreignIt(foreignSorter->done());
+    std::unique_ptr<JoinSorter> outputSorter(makeSorter());
+
+    boost::optional<JoinSorter::Data> nextForeign;
+    if (foreignIt->more())
+        nextForeign = foreignIt->next();
+
+    boost::optional<Value> candidatesKey;
+    vector<BSONObj> candidates;
+    while (inputIt->more()) {
+        pExpCtx->checkForInterrupt();
+        JoinSorter::Data input = inputIt->next();
+        const Value& lookupValue = input.first[0];
+
+        if (!candidatesKey || Value::compare(*candidatesKey, lookupValue) != 0) {
+            candidates.clear();
+            while (nextForeign && Value::compare(nextForeign->first, lookupValue) <= 0) {
+                if (Value::compare(nextForeign->first, lookupValue) == 0)
+                    candidates.push_back(nextForeign->second.toBson());
+                if (foreignIt->more())
+                    nextForeign = foreignIt->next();
+                else
+                    nextForeign = boost::none;
+            }
+            candidatesKey = lookupValue;
+        }
+
+        vector<Value> results;
+        const Matcher matcher(makeQuery(lookupValue));
+        for (auto&& doc : candidates) {
+            if (matcher.matches(doc)) {
+                results.push_back(Value(doc));
+            }
+        }
+
+        MutableDocument output(std::move(input.second));
+        output.setNestedField(_as, Value(std::move(results)));
+        outputSorter->add(input.first[1], output.freeze());
+    }
+
+    _sortMergeOutput.reset(outputSorter->done());
+}
+
+vector<Value> DocumentSourceLookUp::queryForeignCollection(const BSONObj& query) {
+    vector<Value> results;
+    std::unique_ptr<DBClientCursor> cursor =
+        _mongod->directClient()->query(_fromNs.ns(), Query(query));
+    while (cursor->more()) {
+        results.push_back(Value(cursor->nextSafe().getOwned()));
+    }
+    return results;
+}
+
+void DocumentSourceLookUp::dispose() {
+    _foreignDocs.clear();
+    _hashTable.clear();
+    _memoryUsageBytes = 0;
+    _sortMergeOutput.reset();
+    pSource->dispose();
+}
+
+const char* DocumentSourceLookUp::getStrategyName(JoinStrategy strategy) {
+    switch (strategy) {
+        case JoinStrategy::kUndecided:
+            return "undecided";
+        case JoinStrategy::kIndexedLoop:
+            return "indexedLoop";
+        case JoinStrategy::kHashJoin:
+            return "hashJoin";
+        case JoinStrategy::kSortMerge:
+            return "sortMerge";
+        case JoinStrategy::kNestedLoop:
+            return "nestedLoop";
+    }
+    MONGO_UNREACHABLE;
+}
+
+Value DocumentSourceLookUp::serialize(bool explain) const {
+    MutableDocument spec(DOC("from" << _fromNs.coll() << "as" << _as.getPath(false)
+                                    << "localField" << _localField.getPath(false)
+                                    << "foreignField" << _foreignFieldName));
+
+    if (explain) {
+        // Until the first input document arrives, report the strategy the join would start with.
+        // A hash join may still become a sort-merge or nested loop join once the foreign
+        // collection turns out not to fit in memory.
+        JoinStrategy strategy = _strategy;
+        if (strategy == JoinStrategy::kUndecided && _mongod) {
+            strategy =
+                foreignFieldIsIndexed() ? JoinStrategy::kIndexedLoop : JoinStrategy::kHashJoin;
+        }
+        spec["strategy"] = Value(StringData(getStrategyName(strategy)));
+    }
+
+    return Value(DOC(getSourceName() << spec.freeze()));
+}
+
+DocumentSource::GetDepsReturn DocumentSourceLookUp::getDependencies(DepsTracker* deps) const {
+    deps->fields.insert(_localField.getPath(false));
+    return SEE_NEXT;
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceLookUp::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(28796, "the $lookup specification must be an Object", elem.type() == Object);
+
+    NamespaceString fromNs;
+    string as;
+    string localField;
+    string foreignField;
+
+    for (auto&& argument : elem.Obj()) {
+        uassert(28797,
+                str::stream() << "arguments to $lookup must be strings, " << argument << " is type "
+                              << typeName(argument.type()),
+                argument.type() == String);
+
+        const StringData argName = argument.fieldNameStringData();
+        if (argName == "from") {
+            fromNs = NamespaceString(pExpCtx->ns.db(), argument.valueStringData());
+        } else if (argName == "as") {
+            as = argument.String();
+        } else if (argName == "localField") {
+            localField = argument.String();
+        } else if (argName == "foreignField") {
+            foreignField = argument.String();
+        } else {
+            uasserted(28798, str::stream() << "unknown argument to $lookup: " << argName);
+        }
+    }
+
+    uassert(28799,
+            "need to specify fields from, as, localField, and foreignField for a $lookup",
+            !fromNs.ns().empty() && !as.empty() && !localField.empty() && !foreignField.empty());
+    uassert(28800, "invalid $lookup from collection: " + fromNs.ns(), fromNs.isValid());
+
+    return new DocumentSourceLookUp(
+        std::move(fromNs), std::move(as), std::move(localField), std::move(foreignField), pExpCtx);
+}
+}
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -30,12 +30,14 @@
 
 #include "mongo/db/pipeline/document_source.h"
 
+#include <algorithm>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/server_parameters.h"
 
 namespace mongo {
 
@@ -45,6 +47,15 @@ using std::make_pair;
 using std::string;
 using std::vector;
 
+// Number of threads a $sort which may spill to disk uses to sort, spill, merge and read ahead its
+// runs. 1 does everything on the thread running the aggregation.
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceSortParallelism, int, 1);
+
+namespace {
+// When sorting in parallel, never merge more than this many spilled runs at once.
+const unsigned kSortMaxMergeFanIn = 64;
+}  // namespace
+
 DocumentSourceSort::DocumentSourceSort(const intrusive_ptr<ExpressionContext>& pExpCtx)
     : DocumentSource(pExpCtx), populated(false), _mergingPresorted(false) {}
 
@@ -221,6 +232,10 @@ SortOptions DocumentSourceSort::makeSortOptions() const {
     if (pExpCtx->extSortAllowed && !pExpCtx->inRouter) {
         opts.extSortAllowed = true;
         opts.tempDir = pExpCtx->tempDir;
+
+        const unsigned parallelism = std::max(internalDocumentSourceSortParallelism, 1);
+        opts.parallelism = parallelism;
+        opts.maxMergeFanIn = parallelism > 1 ? kSortMaxMergeFanIn : 0;
     }
 
     return opts;
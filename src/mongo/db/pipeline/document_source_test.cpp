@@ -877,6 +877,220 @@ public:
     }
 };
 
+/**
+ * Runs the $group in streaming mode over input that is already sorted by the group key, checking
+ * that each group is returned exactly once and in input order.
+ */
+class StreamingBase : public CheckResultsBase {
+public:
+    void run() {
+        createGroup(groupSpec());
+        DocumentSourceGroup* streamingGroup = dynamic_cast<DocumentSourceGroup*>(group());
+        ASSERT(streamingGroup);
+        streamingGroup->setStreaming(true);
+
+        auto source = DocumentSourceMock::create(inputData());
+        group()->setSource(source.get());
+
+        BSONArrayBuilder bsonResultSet;
+        while (boost::optional<Document> current = group()->getNext()) {
+            bsonResultSet << *current;
+        }
+        assertExhausted(group());
+        ASSERT_EQUALS(expectedResultSet(), bsonResultSet.arr());
+    }
+};
+
+/** Each run of equal keys in the input becomes one group. */
+class StreamingSortedInput : public StreamingBase {
+    std::deque<Document> inputData() {
+        return {DOC("id" << 0 << "a" << 1),
+                DOC("id" << 0 << "a" << 2),
+                DOC("id" << 1 << "a" << 3),
+                DOC("id" << 2 << "a" << 4),
+                DOC("id" << 2 << "a" << 5)};
+    }
+    BSONObj groupSpec() {
+        return BSON("_id"
+                    << "$id"
+                    << "list" << BSON("$push"
+                                      << "$a") << "sum" << BSON("$sum"
+                                                                << "$a"));
+    }
+    string expectedResultSetString() {
+        return "[{_id:0,list:[1,2],sum:3},{_id:1,list:[3],sum:3},{_id:2,list:[4,5],sum:9}]";
+    }
+};
+
+/** Missing and null keys sort together and form a single group. */
+class StreamingNullAndMissingIds : public StreamingBase {
+    std::deque<Document> inputData() {
+        return {DOC("b" << 1), DOC("a" << BSONNULL << "b" << 2), DOC("a" << 1 << "b" << 4)};
+    }
+    BSONObj groupSpec() {
+        return BSON("_id"
+                    << "$a"
+                    << "sum" << BSON("$sum"
+                                     << "$b"));
+    }
+    string expectedResultSetString() {
+        return "[{_id:null,sum:3},{_id:1,sum:4}]";
+    }
+};
+
+/** Streaming over no input produces no groups. */
+class StreamingEmptyInput : public StreamingBase {
+    BSONObj groupSpec() {
+        return BSON("_id"
+                    << "$a");
+    }
+};
+
+/**
+ * Arrays sort by their smallest element, so equal array keys need not be adjacent. The $group
+ * stops streaming when it sees one and still returns every group once.
+ */
+class StreamingArrayIdFallsBackToHashing : public CheckResultsBase {
+public:
+    void run() {
+        createGroup(groupSpec());
+        dynamic_cast<DocumentSourceGroup*>(group())->setStreaming(true);
+        auto source = DocumentSourceMock::create(inputData());
+        group()->setSource(source.get());
+        checkResultSet(group());
+    }
+    std::deque<Document> inputData() {
+        return {DOC("a" << 0),
+                DOC("a" << 1),
+                DOC("a" << BSON_ARRAY(1 << 5)),
+                DOC("a" << 1),
+                DOC("a" << BSON_ARRAY(1 << 5)),
+                DOC("a" << 2)};
+    }
+    BSONObj groupSpec() {
+        return BSON("_id"
+                    << "$a"
+                    << "n" << BSON("$sum" << 1));
+    }
+    string expectedResultSetString() {
+        return "[{_id:0,n:1},{_id:1,n:2},{_id:2,n:1},{_id:[1,5],n:2}]";
+    }
+};
+
+/** A constant group key needs no hash table, so optimize() enables streaming. */
+class ConstantIdStreamsAfterOptimize : public Base {
+public:
+    void run() {
+        createGroup(fromjson("{_id:null,n:{$sum:1}}"));
+        DocumentSourceGroup* constantGroup = dynamic_cast<DocumentSourceGroup*>(group());
+        ASSERT(!constantGroup->isStreaming());
+        constantGroup->optimize();
+        ASSERT(constantGroup->isStreaming());
+
+        createGroup(fromjson("{_id:'$a',n:{$sum:1}}"));
+        DocumentSourceGroup* fieldGroup = dynamic_cast<DocumentSourceGroup*>(group());
+        fieldGroup->optimize();
+        ASSERT(!fieldGroup->isStreaming());
+    }
+};
+
+/** Which sort patterns keep the documents of each group together. */
+class GroupsAreContiguousWhenSortedBy : public Base {
+public:
+    void run() {
+        createGroup(fromjson("{_id:{x:'$a',y:'$$ROOT.b.c',z:{$const:1}}}"));
+        DocumentSourceGroup* compound = dynamic_cast<DocumentSourceGroup*>(group());
+        ASSERT(compound->groupsAreContiguousWhenSortedBy(fromjson("{a:1,'b.c':-1}")));
+        ASSERT(compound->groupsAreContiguousWhenSortedBy(fromjson("{'b.c':1,a:1,d:1}")));
+        ASSERT(!compound->groupsAreContiguousWhenSortedBy(fromjson("{a:1}")));
+        ASSERT(!compound->groupsAreContiguousWhenSortedBy(fromjson("{a:1,d:1,'b.c':1}")));
+        ASSERT(!compound->groupsAreContiguousWhenSortedBy(fromjson("{a:1,b:1}")));
+        ASSERT(!compound->groupsAreContiguousWhenSortedBy(BSONObj()));
+
+        createGroup(fromjson("{_id:{$add:['$a',1]}}"));
+        DocumentSourceGroup* computed = dynamic_cast<DocumentSourceGroup*>(group());
+        ASSERT(!computed->groupsAreContiguousWhenSortedBy(fromjson("{a:1}")));
+
+        createGroup(fromjson("{_id:'$a'}"));
+        DocumentSourceGroup* single = dynamic_cast<DocumentSourceGroup*>(group());
+        ASSERT(!single->groupsAreContiguousWhenSortedBy(fromjson("{a:{$meta:'textScore'}}")));
+
+        createGroup(fromjson("{_id:null}"));
+        DocumentSourceGroup* constant = dynamic_cast<DocumentSourceGroup*>(group());
+        ASSERT(constant->groupsAreContiguousWhenSortedBy(BSONObj()));
+        ASSERT(constant->groupsAreContiguousWhenSortedBy(fromjson("{a:1}")));
+    }
+};
+
+/** Groups whose output depends only on the number of input documents. */
+class CountOnly : public Base {
+public:
+    void run() {
+        createGroup(fromjson("{_id:{x:null,y:'z'},n:{$sum:1},m:{$sum:{$const:NumberLong(3)}}}"));
+        DocumentSourceGroup* counting = dynamic_cast<DocumentSourceGroup*>(group());
+        ASSERT(counting->isCountOnly());
+        ASSERT(!counting->countOnlyResult(0));
+        boost::optional<Document> result = counting->countOnlyResult(5);
+        ASSERT(result);
+        ASSERT_EQUALS(Document(fromjson("{_id:{x:null,y:'z'},n:5,m:NumberLong(15)}")), *result);
+        ASSERT_EQUALS(NumberLong, result->getField("m").getType());
+
+        // An int sum which overflows becomes a long, as it would adding up one document at a time.
+        result = counting->countOnlyResult(3LL * std::numeric_limits<int>::max());
+        ASSERT(result);
+        ASSERT_EQUALS(NumberLong, result->getField("n").getType());
+        ASSERT_EQUALS(3LL * std::numeric_limits<int>::max(), result->getField("n").getLong());
+
+        // A long sum which overflows wraps around, as it does in $sum.
+        createGroup(fromjson("{_id:null,n:{$sum:{$const:NumberLong(4611686018427387904)}}}"));
+        counting = dynamic_cast<DocumentSourceGroup*>(group());
+        ASSERT(counting->isCountOnly());
+        result = counting->countOnlyResult(3);
+        ASSERT(result);
+        intrusive_ptr<Accumulator> sum = AccumulatorSum::create();
+        for (int i = 0; i < 3; i++) {
+            sum->process(Value(4611686018427387904LL), false);
+        }
+        ASSERT_EQUALS(NumberLong, result->getField("n").getType());
+        ASSERT_EQUALS(sum->getValue(false).getLong(), result->getField("n").getLong());
+        ASSERT_EQUALS(-4611686018427387904LL, result->getField("n").getLong());
+        result = counting->countOnlyResult(1);
+        ASSERT(result);
+        ASSERT_EQUALS(NumberLong, result->getField("n").getType());
+        ASSERT_EQUALS(4611686018427387904LL, result->getField("n").getLong());
+
+        createGroup(fromjson("{_id:null}"));
+        ASSERT(dynamic_cast<DocumentSourceGroup*>(group())->isCountOnly());
+
+        createGroup(fromjson("{_id:'$a',n:{$sum:1}}"));
+        ASSERT(!dynamic_cast<DocumentSourceGroup*>(group())->isCountOnly());
+        createGroup(fromjson("{_id:null,n:{$sum:'$a'}}"));
+        ASSERT(!dynamic_cast<DocumentSourceGroup*>(group())->isCountOnly());
+        createGroup(fromjson("{_id:null,n:{$sum:1.5}}"));
+        ASSERT(!dynamic_cast<DocumentSourceGroup*>(group())->isCountOnly());
+        createGroup(fromjson("{_id:null,n:{$max:1}}"));
+        ASSERT(!dynamic_cast<DocumentSourceGroup*>(group())->isCountOnly());
+    }
+};
+
+/** Groups which only find the distinct values of one field. */
+class DistinctFieldPath : public Base {
+public:
+    void run() {
+        createGroup(fromjson("{_id:'$a.b'}"));
+        ASSERT_EQUALS("a.b", dynamic_cast<DocumentSourceGroup*>(group())->distinctFieldPath());
+        createGroup(fromjson("{_id:'$$ROOT.a'}"));
+        ASSERT_EQUALS("a", dynamic_cast<DocumentSourceGroup*>(group())->distinctFieldPath());
+
+        createGroup(fromjson("{_id:'$a',n:{$sum:1}}"));
+        ASSERT_EQUALS("", dynamic_cast<DocumentSourceGroup*>(group())->distinctFieldPath());
+        createGroup(fromjson("{_id:{x:'$a'}}"));
+        ASSERT_EQUALS("", dynamic_cast<DocumentSourceGroup*>(group())->distinctFieldPath());
+        createGroup(fromjson("{_id:null}"));
+        ASSERT_EQUALS("", dynamic_cast<DocumentSourceGroup*>(group())->distinctFieldPath());
+    }
+};
+
 }  // namespace DocumentSourceGroup
 
 namespace DocumentSourceProject {
@@ -1891,6 +2105,60 @@ public:
 };
 }  // namespace DocumentSourceGeoNear
 
+namespace DocumentSourceLookUp {
+using mongo::DocumentSourceLookUp;
+
+class LookUpBasics : public Mock::Base, public unittest::Test {
+protected:
+    intrusive_ptr<DocumentSource> createLookUp(const BSONObj& spec) {
+        return DocumentSourceLookUp::createFromBson(spec.firstElement(), ctx());
+    }
+};
+
+TEST_F(LookUpBasics, SerializesItsSpecification) {
+    BSONObj spec =
+        fromjson("{$lookup: {from: 'coll', as: 'joined', localField: 'a.b', foreignField: 'c'}}");
+    ASSERT_EQUALS(spec, toBson(createLookUp(spec)));
+}
+
+TEST_F(LookUpBasics, DependsOnLocalField) {
+    auto lookUp = createLookUp(
+        fromjson("{$lookup: {from: 'coll', as: 'joined', localField: 'a.b', foreignField: 'c'}}"));
+    DepsTracker dependencies;
+    ASSERT_EQUALS(DocumentSource::SEE_NEXT, lookUp->getDependencies(&dependencies));
+    ASSERT_EQUALS(1U, dependencies.fields.size());
+    ASSERT_EQUALS(1U, dependencies.fields.count("a.b"));
+    ASSERT_EQUALS(false, dependencies.needWholeDocument);
+}
+
+TEST_F(LookUpBasics, RejectsInvalidSpecifications) {
+    ASSERT_THROWS_CODE(createLookUp(fromjson("{$lookup: 'coll'}")), UserException, 28796);
+
+    BSONObj nonString =
+        fromjson("{$lookup: {from: 'coll', as: 1, localField: 'a', foreignField: 'b'}}");
+    ASSERT_THROWS_CODE(createLookUp(nonString), UserException, 28797);
+
+    BSONObj unknown = fromjson(
+        "{$lookup: {from: 'coll', as: 'x', localField: 'a', foreignField: 'b', extra: 'c'}}");
+    ASSERT_THROWS_CODE(createLookUp(unknown), UserException, 28798);
+
+    BSONObj missing = fromjson("{$lookup: {from: 'coll', as: 'x', localField: 'a'}}");
+    ASSERT_THROWS_CODE(createLookUp(missing), UserException, 28799);
+}
+
+TEST_F(LookUpBasics, ExplainsItsStrategy) {
+    auto lookUp = createLookUp(
+        fromjson("{$lookup: {from: 'coll', as: 'joined', localField: 'a', foreignField: 'b'}}"));
+    vector<Value> explained;
+    lookUp->serializeToArray(explained, true);
+    ASSERT_EQUALS(1U, explained.size());
+
+    // Without a mongod to look at the foreign collection through, nothing has been decided yet.
+    ASSERT_EQUALS("undecided", explained[0]["$lookup"]["strategy"].getString());
+}
+
+}  // namespace DocumentSourceLookUp
+
 namespace DocumentSourceMatch {
 using mongo::DocumentSourceMatch;
 
@@ -2106,6 +2374,14 @@ public:
         add<DocumentSourceGroup::Dependencies>();
         add<DocumentSourceGroup::StringConstantIdAndAccumulatorExpressions>();
         add<DocumentSourceGroup::ArrayConstantAccumulatorExpression>();
+        add<DocumentSourceGroup::StreamingSortedInput>();
+        add<DocumentSourceGroup::StreamingNullAndMissingIds>();
+        add<DocumentSourceGroup::StreamingEmptyInput>();
+        add<DocumentSourceGroup::StreamingArrayIdFallsBackToHashing>();
+        add<DocumentSourceGroup::ConstantIdStreamsAfterOptimize>();
+        add<DocumentSourceGroup::GroupsAreContiguousWhenSortedBy>();
+        add<DocumentSourceGroup::CountOnly>();
+        add<DocumentSourceGroup::DistinctFieldPath>();
 
         add<DocumentSourceProject::Inclusion>();
         add<DocumentSourceProject::Optimize>();
@@ -301,6 +301,55 @@ public:
     }
 };
 
+/** Build Documents on the layout of another Document with the same shape. */
+class FromBsonWithLayout {
+public:
+    void run() {
+        // Enough fields that lookups go through the hash table.
+        const BSONObj layoutObj = fromjson("{a:1,b:'x',c:{z:1},d:[1,2],e:true}");
+        const BSONObj obj = fromjson("{a:2,b:'y',c:{z:2},d:[3],e:false}");
+
+        Document document;
+        {
+            const Document layout = Document::fromBsonWithMetaData(layoutObj);
+            document = Document::fromBsonWithMetaData(obj, layout);
+            ASSERT_NOT_EQUALS(layout.getPtr(), document.getPtr());
+        }
+        // The values must not depend on the layout document, which is gone.
+        ASSERT_EQUALS(fromBson(obj), document);
+        ASSERT_EQUALS(obj, toBson(document));
+        ASSERT_EQUALS("y", document["b"].getString());
+        ASSERT_EQUALS(2, document.getNestedField(FieldPath("c.z")).getInt());
+        ASSERT(document["f"].missing());
+
+        // Adding to a Document built this way doesn't disturb its layout.
+        MutableDocument md(document);
+        md.addField("f", mongo::Value(3));
+        ASSERT_EQUALS(3, md.peek()["f"].getInt());
+        ASSERT_EQUALS(2, md.peek()["a"].getInt());
+
+        // Differently shaped documents are built from scratch.
+        const Document layout = fromBson(layoutObj);
+        assertBuiltFromLayout(fromjson("{a:2,b:'y',c:{z:2},d:[3]}"), layout);
+        assertBuiltFromLayout(fromjson("{a:2,b:'y',c:{z:2},d:[3],e:false,f:1}"), layout);
+        assertBuiltFromLayout(fromjson("{b:'y',a:2,c:{z:2},d:[3],e:false}"), layout);
+        assertBuiltFromLayout(BSONObj(), layout);
+        assertBuiltFromLayout(obj, Document());
+
+        // Metadata is still parsed.
+        const Document withScore = Document::fromBsonWithMetaData(
+            BSON("a" << 1 << Document::metaFieldTextScore << 2.0), fromBson(BSON("a" << 0)));
+        ASSERT_EQUALS(DOC("a" << 1), withScore);
+        ASSERT(withScore.hasTextScore());
+        ASSERT_EQUALS(2.0, withScore.getTextScore());
+    }
+
+private:
+    void assertBuiltFromLayout(const BSONObj& obj, const Document& layout) {
+        ASSERT_EQUALS(fromBson(obj), Document::fromBsonWithMetaData(obj, layout));
+    }
+};
+
 /** FieldIterator for an empty Document. */
 class FieldIteratorEmpty {
 public:
@@ -1670,6 +1719,7 @@ public:
         add<Document::Compare>();
         add<Document::Clone>();
         add<Document::CloneMultipleFields>();
+        add<Document::FromBsonWithLayout>();
         add<Document::FieldIteratorEmpty>();
         add<Document::FieldIteratorSingle>();
         add<Document::FieldIteratorMultiple>();
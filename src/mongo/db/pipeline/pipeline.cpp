@@ -166,6 +166,7 @@ intrusive_ptr<Pipeline> Pipeline::parseCommand(string& errmsg,
     Optimizations::Local::coalesceAdjacent(pPipeline.get());
     Optimizations::Local::optimizeEachDocumentSource(pPipeline.get());
     Optimizations::Local::duplicateMatchBeforeInitalRedact(pPipeline.get());
+    Optimizations::Local::streamGroupsAfterSort(pPipeline.get());
 
     return pPipeline;
 }
@@ -292,6 +293,18 @@ void Pipeline::Optimizations::Local::optimizeEachDocumentSource(Pipeline* pipeli
     pipeline->sources = std::move(newSources);
 }
 
+void Pipeline::Optimizations::Local::streamGroupsAfterSort(Pipeline* pipeline) {
+    SourceContainer& sources = pipeline->sources;
+    for (size_t srcn = sources.size(), srci = 1; srci < srcn; ++srci) {
+        DocumentSourceGroup* group = dynamic_cast<DocumentSourceGroup*>(sources[srci].get());
+        DocumentSourceSort* sort = dynamic_cast<DocumentSourceSort*>(sources[srci - 1].get());
+        if (group && sort &&
+            group->groupsAreContiguousWhenSortedBy(sort->serializeSortKey(false).toBson())) {
+            group->setStreaming(true);
+        }
+    }
+}
+
 void Pipeline::Optimizations::Local::duplicateMatchBeforeInitalRedact(Pipeline* pipeline) {
     SourceContainer& sources = pipeline->sources;
     if (sources.size() >= 2 && dynamic_cast<DocumentSourceRedact*>(sources[0].get())) {
@@ -336,7 +349,7 @@ Status Pipeline::checkAuthForCommand(ClientBasic* client,
             }
             Privilege::addPrivilegeToPrivilegeVector(
                 &privileges, Privilege(ResourcePattern::forExactNamespace(outputNs), actions));
-        } else if (stageName == "$lookUp" && stage.firstElementType() == Object) {
+        } else if (stageName == "$lookup" && stage.firstElementType() == Object) {
             NamespaceString fromNs(db, stage.firstElement()["from"].str());
             Privilege::addPrivilegeToPrivilegeVector(
                 &privileges,
@@ -362,6 +375,15 @@ intrusive_ptr<Pipeline> Pipeline::splitForSharded() {
     Optimizations::Sharded::moveFinalUnwindFromShardsToMerger(shardPipeline.get(), this);
     Optimizations::Sharded::limitFieldsSentFromShardsToMerger(shardPipeline.get(), this);
 
+    // The shards may satisfy a $sort with a multikey index, whose order the merger can't rely on
+    // to deliver groups contiguously. Only single-group $groups keep streaming in the merger.
+    for (auto&& source : sources) {
+        if (auto group = dynamic_cast<DocumentSourceGroup*>(source.get())) {
+            group->setStreaming(group->isStreaming() &&
+                                group->groupsAreContiguousWhenSortedBy(BSONObj()));
+        }
+    }
+
     return shardPipeline;
 }
 
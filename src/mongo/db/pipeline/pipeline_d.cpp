@@ -36,8 +36,11 @@
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/plan_stats.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/count_request.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/service_context.h"
@@ -91,6 +94,40 @@ private:
     intrusive_ptr<ExpressionContext> _ctx;
     DBDirectClient _client;
 };
+
+/**
+ * Returns true if any index scan in the plan rooted at "root" reads a multikey index.
+ */
+bool usesMultikeyIndex(PlanStage* root) {
+    if (root->stageType() == STAGE_IXSCAN &&
+        static_cast<const IndexScanStats*>(root->getSpecificStats())->isMultiKey) {
+        return true;
+    }
+    for (auto&& child : root->getChildren()) {
+        if (usesMultikeyIndex(child.get())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns true if the plan rooted at "root" reads the distinct values of a field from an index
+ * which holds exactly one key for every document, as a $group on that field would see them.
+ */
+bool usesDistinctScanOverEveryDocument(PlanStage* root) {
+    if (root->stageType() == STAGE_DISTINCT_SCAN) {
+        const DistinctScanStats* stats =
+            static_cast<const DistinctScanStats*>(root->getSpecificStats());
+        return !stats->isMultiKey && !stats->isSparse;
+    }
+    for (auto&& child : root->getChildren()) {
+        if (usesDistinctScanOverEveryDocument(child.get())) {
+            return true;
+        }
+    }
+    return false;
+}
 }
 
 shared_ptr<PlanExecutor> PipelineD::prepareCursorSource(
@@ -182,6 +219,54 @@ shared_ptr<PlanExecutor> PipelineD::prepareCursorSource(
     std::shared_ptr<PlanExecutor> exec;
     bool sortInRunner = false;
 
+    // A $group straight after the $match which only counts its input needs nothing but the number
+    // of matching documents, and a count plan can often find that from an index without fetching
+    // them. Likewise a $group on a single field without accumulators needs only the distinct
+    // values of that field, which a distinct scan reads from an index by skipping over the
+    // duplicates. Neither plan filters out orphaned documents, so they are not used on sharded
+    // collections.
+    intrusive_ptr<DocumentSourceGroup> countGroup;
+    intrusive_ptr<DocumentSourceGroup> group =
+        sources.empty() ? nullptr : dynamic_cast<DocumentSourceGroup*>(sources.front().get());
+    if (group &&
+        !ShardingState::get(getGlobalServiceContext())->getCollectionMetadata(fullName)) {
+        const std::string distinctField = group->distinctFieldPath();
+
+        if (group->isCountOnly()) {
+            // An empty query would be answered from the record count of the collection, which
+            // need not be exact. Counting the keys of the _id index is.
+            CountRequest request(fullName, queryObj);
+            const IndexDescriptor* idIndex =
+                collection ? collection->getIndexCatalog()->findIdIndex(txn) : nullptr;
+            if (queryObj.isEmpty() && idIndex) {
+                request.setHint(idIndex->keyPattern());
+            }
+
+            if (!queryObj.isEmpty() || idIndex || !collection) {
+                exec = uassertStatusOK(getExecutorCount(
+                    txn, collection, request, false /* explain */, PlanExecutor::YIELD_AUTO));
+                countGroup = group;
+                sources.pop_front();
+            }
+        } else if (collection && !distinctField.empty()) {
+            auto statusWithPlanExecutor = getExecutorDistinct(txn,
+                                                              collection,
+                                                              fullName,
+                                                              queryObj,
+                                                              distinctField,
+                                                              false /* explain */,
+                                                              PlanExecutor::YIELD_AUTO);
+
+            // The $group still removes the duplicates if the plan isn't a distinct scan, but then
+            // the ordinary plan is at least as good.
+            if (statusWithPlanExecutor.isOK() &&
+                usesDistinctScanOverEveryDocument(
+                    statusWithPlanExecutor.getValue()->getRootStage())) {
+                exec = std::move(statusWithPlanExecutor.getValue());
+            }
+        }
+    }
+
     const WhereCallbackReal whereCallback(pExpCtx->opCtx, pExpCtx->ns.db());
 
     if (sortStage) {
@@ -204,6 +289,21 @@ shared_ptr<PlanExecutor> PipelineD::prepareCursorSource(
                     // need to reinsert coalesced $limit after removing $sort
                     sources.push_front(sortStage->getLimitSrc());
                 }
+
+                // A multikey index returns each document at the position of its first matching
+                // key, so documents with equal array values need not be adjacent. A $group
+                // streaming over the output of the $sort can't rely on that order.
+                if (usesMultikeyIndex(exec->getRootStage())) {
+                    for (auto&& source : sources) {
+                        if (auto group = dynamic_cast<DocumentSourceGroup*>(source.get())) {
+                            group->setStreaming(group->groupsAreContiguousWhenSortedBy(BSONObj()));
+                            break;
+                        }
+                        if (!dynamic_cast<DocumentSourceLimit*>(source.get())) {
+                            break;
+                        }
+                    }
+                }
             }
         }
     }
@@ -237,6 +337,8 @@ shared_ptr<PlanExecutor> PipelineD::prepareCursorSource(
         pSource->setSort(sortObj);
 
     pSource->setProjection(deps.toProjection(), deps.toParsedDeps());
+    if (countGroup)
+        pSource->setCountGroup(countGroup);
 
     while (!sources.empty() && pSource->coalesce(sources.front())) {
         sources.pop_front();
@@ -95,6 +95,14 @@ public:
      * BSONObjs converted to Documents.
      */
     static void duplicateMatchBeforeInitalRedact(Pipeline* pipeline);
+
+    /**
+     * Switches a $group immediately following a $sort into streaming mode if the sort delivers
+     * the documents of each group contiguously, e.g. [{$sort: {a: 1}}, {$group: {_id: "$a"}}].
+     *
+     * The $group then needs memory for a single group at a time and never spills to disk.
+     */
+    static void streamGroupsAfterSort(Pipeline* pipeline);
 };
 
 /**
@@ -179,6 +179,58 @@ class DoNotRemoveNonEmptyMatch : public Base {
     }
 };
 
+class StreamGroupAfterSortOnGroupKey : public Base {
+    string inputPipeJson() override {
+        return "[{$sort: {a: 1, b: -1}}, {$group: {_id: {b: '$b', a: '$a'}}}]";
+    }
+
+    string outputPipeJson() override {
+        return "[{$sort: {sortKey: {a: 1, b: -1}}}"
+               ",{$group: {_id: {b: '$b', a: '$a'}, $streaming: true}}"
+               "]";
+    }
+};
+
+class StreamGroupAfterSortOnLongerKey : public Base {
+    string inputPipeJson() override {
+        return "[{$sort: {a: 1, b: 1}}, {$group: {_id: '$a'}}]";
+    }
+
+    string outputPipeJson() override {
+        return "[{$sort: {sortKey: {a: 1, b: 1}}}, {$group: {_id: '$a', $streaming: true}}]";
+    }
+};
+
+class DoNotStreamGroupAfterSortOnOtherKey : public Base {
+    string inputPipeJson() override {
+        return "[{$sort: {a: 1, b: 1}}, {$group: {_id: '$b'}}]";
+    }
+
+    string outputPipeJson() override {
+        return "[{$sort: {sortKey: {a: 1, b: 1}}}, {$group: {_id: '$b'}}]";
+    }
+};
+
+class DoNotStreamGroupOnComputedKey : public Base {
+    string inputPipeJson() override {
+        return "[{$sort: {a: 1}}, {$group: {_id: {$add: ['$a', 1]}}}]";
+    }
+
+    string outputPipeJson() override {
+        return "[{$sort: {sortKey: {a: 1}}}, {$group: {_id: {$add: ['$a', {$const: 1}]}}}]";
+    }
+};
+
+class StreamGroupOnConstantKey : public Base {
+    string inputPipeJson() override {
+        return "[{$group: {_id: null, n: {$sum: 1}}}]";
+    }
+
+    string outputPipeJson() override {
+        return "[{$group: {_id: {$const: null}, n: {$sum: {$const: 1}}, $streaming: true}}]";
+    }
+};
+
 }  // namespace Local
 
 namespace Sharded {
@@ -339,7 +391,7 @@ class NothingNeeded : public Base {
     }
     string mergePipeJson() {
         return "[{$limit:1}"
-               ",{$group: {_id: {$const: null}, count: {$sum: {$const: 1}}}}"
+               ",{$group: {_id: {$const: null}, count: {$sum: {$const: 1}}, $streaming: true}}"
                "]";
     }
 };
@@ -464,6 +516,11 @@ public:
         add<Optimizations::Local::RemoveEmptyMatch>();
         add<Optimizations::Local::RemoveMultipleEmptyMatches>();
         add<Optimizations::Local::DoNotRemoveNonEmptyMatch>();
+        add<Optimizations::Local::StreamGroupAfterSortOnGroupKey>();
+        add<Optimizations::Local::StreamGroupAfterSortOnLongerKey>();
+        add<Optimizations::Local::DoNotStreamGroupAfterSortOnOtherKey>();
+        add<Optimizations::Local::DoNotStreamGroupOnComputedKey>();
+        add<Optimizations::Local::StreamGroupOnConstantKey>();
         add<Optimizations::Sharded::Empty>();
         add<Optimizations::Sharded::moveFinalUnwindFromShardsToMerger::OneUnwind>();
         add<Optimizations::Sharded::moveFinalUnwindFromShardsToMerger::TwoUnwind>();
@@ -0,0 +1,211 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/plan_cache_persister.h"
+
+#include <map>
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_catalog_entry.h"
+#include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/fsync.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/operation_context_impl.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/background.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(planCachePersistenceEnabled, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(planCachePersistenceIntervalSecs, int, 60);
+
+namespace {
+
+const char kPlanCacheNamespace[] = "local.system.plancache";
+
+// Fields of the documents in local.system.plancache.
+const char kFingerprintField[] = "fingerprint";
+const char kEntryField[] = "entry";
+
+/**
+ * Calls 'fn' on every collection of every open database, with the collection locked in MODE_IS.
+ */
+void forEachCollection(OperationContext* txn, stdx::function<void(Collection*)> fn) {
+    std::set<std::string> dbNames;
+    dbHolder().getAllShortNames(dbNames);
+
+    for (const std::string& dbName : dbNames) {
+        ScopedTransaction transaction(txn, MODE_IS);
+        Lock::DBLock dbLock(txn->lockState(), dbName, MODE_IS);
+
+        Database* db = dbHolder().get(txn, dbName);
+        if (!db) {
+            continue;  // skip since database no longer exists
+        }
+
+        std::list<std::string> namespaces;
+        db->getDatabaseCatalogEntry()->getCollectionNamespaces(&namespaces);
+
+        for (const std::string& ns : namespaces) {
+            if (ns == kPlanCacheNamespace) {
+                continue;
+            }
+
+            Lock::CollectionLock collLock(txn->lockState(), ns, MODE_IS);
+            Collection* collection = db->getCollection(ns);
+            if (!collection) {
+                continue;  // skip since collection no longer exists
+            }
+
+            fn(collection);
+        }
+    }
+}
+
+/**
+ * Adds the entries saved in local.system.plancache to the plan cache of every collection whose
+ * index fingerprint matches the one they were saved with.
+ */
+void restorePlanCaches(OperationContext* txn) {
+    std::map<std::string, std::vector<BSONObj>> entriesByFingerprint;
+    {
+        DBDirectClient client(txn);
+        std::unique_ptr<DBClientCursor> cursor = client.query(kPlanCacheNamespace, Query());
+        while (cursor->more()) {
+            BSONObj doc = cursor->nextSafe();
+            if (doc[kFingerprintField].type() != String || doc[kEntryField].type() != Object) {
+                continue;
+            }
+            entriesByFingerprint[doc[kFingerprintField].String()].push_back(
+                doc[kEntryField].Obj().getOwned());
+        }
+    }
+
+    if (entriesByFingerprint.empty()) {
+        return;
+    }
+
+    size_t numRestored = 0;
+    forEachCollection(txn,
+                      [&](Collection* collection) {
+                          CollectionInfoCache* infoCache = collection->infoCache();
+                          auto it = entriesByFingerprint.find(
+                              infoCache->getPlanCache()->getIndexFingerprint());
+                          if (it != entriesByFingerprint.end()) {
+                              numRestored += infoCache->restorePlanCacheEntries(txn, it->second);
+                          }
+                      });
+
+    log() << "restored " << numRestored << " plan cache entries from " << kPlanCacheNamespace;
+}
+
+/**
+ * Replaces the contents of local.system.plancache with the plan cache entries of every
+ * collection. Collections with the same index fingerprint share a single set of entries.
+ */
+void savePlanCaches(OperationContext* txn) {
+    std::map<std::string, std::map<std::string, BSONObj>> entriesByFingerprint;
+    forEachCollection(txn,
+                      [&](Collection* collection) {
+                          const PlanCache* planCache = collection->infoCache()->getPlanCache();
+                          auto& entries = entriesByFingerprint[planCache->getIndexFingerprint()];
+                          for (const BSONObj& entry : planCache->serializeEntries()) {
+                              entries.emplace(entry["key"].String(), entry);
+                          }
+                      });
+
+    DBDirectClient client(txn);
+    client.remove(kPlanCacheNamespace, Query());
+
+    size_t numSaved = 0;
+    for (const auto& fingerprintAndEntries : entriesByFingerprint) {
+        for (const auto& keyAndEntry : fingerprintAndEntries.second) {
+            client.insert(kPlanCacheNamespace,
+                          BSON(kFingerprintField << fingerprintAndEntries.first << kEntryField
+                                                 << keyAndEntry.second));
+            ++numSaved;
+        }
+    }
+
+    LOG(1) << "saved " << numSaved << " plan cache entries to " << kPlanCacheNamespace;
+}
+
+class PlanCachePersister : public BackgroundJob {
+public:
+    virtual std::string name() const {
+        return "PlanCachePersister";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+
+        // The saved entries are restored the first time the job runs with persistence enabled,
+        // which is normally at startup. Until then, saving would discard them.
+        bool restored = false;
+
+        while (!inShutdown()) {
+            if (planCachePersistenceEnabled && !lockedForWriting()) {
+                try {
+                    OperationContextImpl txn;
+                    if (!restored) {
+                        restored = true;
+                        restorePlanCaches(&txn);
+                    } else {
+                        savePlanCaches(&txn);
+                    }
+                } catch (const DBException& ex) {
+                    warning() << "error persisting plan cache: " << ex.toString();
+                }
+            }
+
+            sleepsecs(planCachePersistenceIntervalSecs);
+        }
+    }
+};
+
+}  // namespace
+
+void startPlanCachePersister() {
+    PlanCachePersister* persister = new PlanCachePersister();
+    persister->go();
+}
+
+}  // namespace mongo
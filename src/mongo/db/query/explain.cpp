@@ -115,6 +115,9 @@ size_t getKeysExamined(StageType type, const SpecificStats* specific) {
     } else if (STAGE_DISTINCT_SCAN == type) {
         const DistinctScanStats* spec = static_cast<const DistinctScanStats*>(specific);
         return spec->keysExamined;
+    } else if (STAGE_SKIP_SCAN == type) {
+        const SkipScanStats* spec = static_cast<const SkipScanStats*>(specific);
+        return spec->keysExamined;
     }
 
     return 0;
@@ -172,6 +175,9 @@ void addStageSummaryStr(const PlanStage* stage, mongoutils::str::stream& ss) {
     } else if (STAGE_IXSCAN == stage->stageType()) {
         const IndexScanStats* spec = static_cast<const IndexScanStats*>(specific);
         ss << " " << spec->keyPattern;
+    } else if (STAGE_SKIP_SCAN == stage->stageType()) {
+        const SkipScanStats* spec = static_cast<const SkipScanStats*>(specific);
+        ss << " " << spec->keyPattern;
     } else if (STAGE_TEXT == stage->stageType()) {
         const TextStats* spec = static_cast<const TextStats*>(specific);
         ss << " " << spec->indexPrefix;
@@ -272,6 +278,10 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         bob->appendBool("isSparse", spec->isSparse);
         bob->appendBool("isPartial", spec->isPartial);
         bob->append("indexVersion", spec->indexVersion);
+
+        if (!spec->indexBounds.isEmpty()) {
+            bob->append("indexBounds", spec->indexBounds);
+        }
     } else if (STAGE_DELETE == stats.stageType) {
         DeleteStats* spec = static_cast<DeleteStats*>(stats.specific.get());
 
@@ -384,6 +394,31 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     } else if (STAGE_SKIP == stats.stageType) {
         SkipStats* spec = static_cast<SkipStats*>(stats.specific.get());
         bob->appendNumber("skipAmount", spec->skip);
+    } else if (STAGE_SKIP_SCAN == stats.stageType) {
+        SkipScanStats* spec = static_cast<SkipScanStats*>(stats.specific.get());
+
+        bob->append("keyPattern", spec->keyPattern);
+        bob->append("indexName", spec->indexName);
+        bob->appendBool("isMultiKey", spec->isMultiKey);
+        bob->appendBool("isUnique", spec->isUnique);
+        bob->appendBool("isSparse", spec->isSparse);
+        bob->appendBool("isPartial", spec->isPartial);
+        bob->append("indexVersion", spec->indexVersion);
+        bob->append("direction", spec->direction > 0 ? "forward" : "backward");
+
+        if ((topLevelBob->len() + spec->indexBounds.objsize()) > kMaxStatsBSONSize) {
+            bob->append("warning", "index bounds omitted due to BSON size limit");
+        } else {
+            bob->append("indexBounds", spec->indexBounds);
+        }
+
+        if (verbosity >= ExplainCommon::EXEC_STATS) {
+            bob->appendNumber("keysExamined", spec->keysExamined);
+            bob->appendNumber("seeks", spec->seeks);
+            bob->appendNumber("dupsTested", spec->dupsTested);
+            bob->appendNumber("dupsDropped", spec->dupsDropped);
+            bob->appendNumber("seenInvalidated", spec->seenInvalidated);
+        }
     } else if (STAGE_SORT == stats.stageType) {
         SortStats* spec = static_cast<SortStats*>(stats.specific.get());
         bob->append("sortPattern", spec->sortPattern);
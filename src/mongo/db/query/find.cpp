@@ -60,6 +60,7 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -206,6 +207,7 @@ void generateBatch(int ntoreturn,
     PlanExecutor* exec = cursor->getExecutor();
 
     BSONObj obj;
+    exec->setNumResultsWanted(ntoreturn);
     while (PlanExecutor::ADVANCED == (*state = exec->getNext(&obj, NULL))) {
         // Add result to output buffer.
         bb->appendBuf((void*)obj.objdata(), obj.objsize());
@@ -367,11 +369,29 @@ QueryResult::View getMore(OperationContext* txn,
 
         PlanExecutor::ExecState state;
 
+        // If we're tailing a capped collection, retrieve a monotonically increasing insert
+        // counter before looking for results, so that no insert committed after the search is
+        // missed.
+        uint64_t lastInsertCount = 0;
+        if (isCursorAwaitData(cc)) {
+            invariant(ctx->getCollection()->isCapped());
+            lastInsertCount = ctx->getCollection()->getCappedInsertNotifier()->getCount();
+        }
+
         generateBatch(ntoreturn, cc, &bb, &numResults, &slaveReadTill, &state);
 
         // If this is an await data cursor, and we hit EOF without generating any results, then
-        // we block waiting for new data to arrive.
-        if (isCursorAwaitData(cc) && state == PlanExecutor::IS_EOF && numResults == 0) {
+        // we block waiting for new data to arrive, for up to 1 second. Waiters are notified when
+        // inserts commit, but an insert may still be hidden behind an earlier uncommitted one, so
+        // keep waiting until there are results or the time runs out.
+        const Microseconds awaitDataTimeout = Seconds(1);
+        Timer awaitDataTimer;
+        while (isCursorAwaitData(cc) && state == PlanExecutor::IS_EOF && numResults == 0) {
+            Microseconds timeout = awaitDataTimeout - Microseconds(awaitDataTimer.micros());
+            if (timeout <= Microseconds(0)) {
+                break;
+            }
+
             // Retrieve the notifier which we will wait on until new data arrives. We make sure
             // to do this in the lock because once we drop the lock it is possible for the
             // collection to become invalid. The notifier itself will outlive the collection if
@@ -382,9 +402,6 @@ QueryResult::View getMore(OperationContext* txn,
             exec->saveState();
             ctx.reset();
 
-            // Block waiting for data for up to 1 second.
-            Seconds timeout(1);
-            uint64_t lastInsertCount = notifier->getCount();
             notifier->waitForInsert(lastInsertCount, timeout);
             notifier.reset();
 
@@ -393,7 +410,12 @@ QueryResult::View getMore(OperationContext* txn,
             exec->restoreState();
 
             // We woke up because either the timed_wait expired, or there was more data. Either
-            // way, attempt to generate another batch of results.
+            // way, attempt to generate another batch of results. If the collection has gone away,
+            // the executor has been killed and the batch ends in DEAD.
+            Collection* collection = ctx->getCollection();
+            if (collection && collection->isCapped()) {
+                lastInsertCount = collection->getCappedInsertNotifier()->getCount();
+            }
             generateBatch(ntoreturn, cc, &bb, &numResults, &slaveReadTill, &state);
         }
 
@@ -564,6 +586,8 @@ std::string runQuery(OperationContext* txn,
     // Get summary info about which plan the executor is using.
     curop.debug().planSummary = Explain::getPlanSummary(exec.get());
 
+    exec->setNumResultsWanted(
+        pq.getEffectiveBatchSize().value_or(LiteParsedQuery::kDefaultBatchSize));
     while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
         // Add result to output buffer.
         bb.appendBuf((void*)obj.objdata(), obj.objsize());
@@ -340,6 +340,7 @@ Status prepareExecution(OperationContext* opCtx,
     }
 
     vector<QuerySolution*> solutions;
+    plannerParams.arena = opCtx->getArena();
     Status status = QueryPlanner::plan(*canonicalQuery, plannerParams, &solutions);
     if (!status.isOK()) {
         return Status(ErrorCodes::BadValue,
@@ -1033,24 +1034,20 @@ bool turnIxscanIntoCount(QuerySolution* soln) {
         return false;
     }
 
-    // Make sure the bounds are OK.
-    BSONObj startKey;
-    bool startKeyInclusive;
-    BSONObj endKey;
-    bool endKeyInclusive;
-
-    if (!IndexBoundsBuilder::isSingleInterval(
-            isn->bounds, &startKey, &startKeyInclusive, &endKey, &endKeyInclusive)) {
-        return false;
-    }
-
     // Make the count node that we replace the fetch + ixscan with.
     CountNode* cn = new CountNode();
     cn->indexKeyPattern = isn->indexKeyPattern;
-    cn->startKey = startKey;
-    cn->startKeyInclusive = startKeyInclusive;
-    cn->endKey = endKey;
-    cn->endKeyInclusive = endKeyInclusive;
+
+    // A single interval is counted by scanning from its start to its end key. Otherwise the
+    // count scan walks the bounds themselves, seeking from one interval to the next.
+    if (!IndexBoundsBuilder::isSingleInterval(isn->bounds,
+                                              &cn->startKey,
+                                              &cn->startKeyInclusive,
+                                              &cn->endKey,
+                                              &cn->endKeyInclusive)) {
+        cn->bounds = isn->bounds;
+        cn->direction = isn->direction;
+    }
     // Takes ownership of 'cn' and deletes the old root.
     soln->root.reset(cn);
     return true;
@@ -1427,6 +1424,7 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorDistinct(OperationContext* txn,
 
     // See if we can answer the query in a fast-distinct compatible fashion.
     vector<QuerySolution*> solutions;
+    plannerParams.arena = txn->getArena();
     Status status = QueryPlanner::plan(*cq, plannerParams, &solutions);
     if (!status.isOK()) {
         return getExecutor(txn, collection, std::move(cq), yieldPolicy);
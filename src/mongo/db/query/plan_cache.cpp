@@ -44,6 +44,7 @@
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
+#include "mongo/util/md5.hpp"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
@@ -246,6 +247,160 @@ void encodeGeoNearMatchExpression(const GeoNearMatchExpression* tree, StringBuil
     }
 }
 
+// Field names used by PlanCache::serializeEntries() and PlanCache::restoreEntry().
+const char kSerializedKeyField[] = "key";
+const char kSerializedQueryField[] = "query";
+const char kSerializedSortField[] = "sort";
+const char kSerializedProjectionField[] = "projection";
+const char kSerializedSolutionsField[] = "solutions";
+const char kSerializedTypeField[] = "type";
+const char kSerializedDirectionField[] = "direction";
+const char kSerializedIndexFilterAppliedField[] = "indexFilterApplied";
+const char kSerializedScoreField[] = "score";
+const char kSerializedWorksField[] = "works";
+const char kSerializedTreeField[] = "tree";
+const char kSerializedIndexField[] = "index";
+const char kSerializedPositionField[] = "pos";
+const char kSerializedChildrenField[] = "children";
+
+// Stage type reported for the ranking stats of restored entries, for which the trial period
+// stats are not available.
+const char kRestoredStatsStageType[] = "RESTORED_PLAN";
+
+void serializeIndexTree(const PlanCacheIndexTree& tree, BSONObjBuilder* builder) {
+    if (tree.entry.get()) {
+        builder->append(kSerializedIndexField, tree.entry->keyPattern);
+        builder->append(kSerializedPositionField, static_cast<int>(tree.index_pos));
+    }
+
+    BSONArrayBuilder childrenBuilder(builder->subarrayStart(kSerializedChildrenField));
+    for (const PlanCacheIndexTree* child : tree.children) {
+        BSONObjBuilder childBuilder(childrenBuilder.subobjStart());
+        serializeIndexTree(*child, &childBuilder);
+    }
+}
+
+Status parseIndexTree(const BSONObj& serialized,
+                      const std::vector<IndexEntry>& indexEntries,
+                      PlanCacheIndexTree* tree) {
+    BSONElement indexElt = serialized[kSerializedIndexField];
+    if (!indexElt.eoo()) {
+        if (indexElt.type() != Object) {
+            return Status(ErrorCodes::BadValue, "serialized index tree has an invalid index");
+        }
+
+        const BSONObj keyPattern = indexElt.Obj();
+        auto it = std::find_if(indexEntries.begin(),
+                               indexEntries.end(),
+                               [&keyPattern](const IndexEntry& indexEntry) {
+                                   return indexEntry.keyPattern == keyPattern;
+                               });
+        if (it == indexEntries.end()) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "no index with key pattern " << keyPattern);
+        }
+
+        tree->setIndexEntry(*it);
+        tree->index_pos = serialized[kSerializedPositionField].numberInt();
+    }
+
+    BSONElement childrenElt = serialized[kSerializedChildrenField];
+    if (childrenElt.type() != Array) {
+        return Status(ErrorCodes::BadValue, "serialized index tree has no children array");
+    }
+
+    for (const BSONElement& childElt : childrenElt.Obj()) {
+        if (childElt.type() != Object) {
+            return Status(ErrorCodes::BadValue, "serialized index tree has an invalid child");
+        }
+        tree->children.push_back(new PlanCacheIndexTree());
+        Status status = parseIndexTree(childElt.Obj(), indexEntries, tree->children.back());
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    return Status::OK();
+}
+
+Status parseSolutionCacheData(const BSONObj& serialized,
+                              const std::vector<IndexEntry>& indexEntries,
+                              SolutionCacheData* data) {
+    const int type = serialized[kSerializedTypeField].numberInt();
+    switch (type) {
+        case SolutionCacheData::WHOLE_IXSCAN_SOLN:
+        case SolutionCacheData::USE_INDEX_TAGS_SOLN:
+        case SolutionCacheData::COLLSCAN_SOLN:
+        case SolutionCacheData::SKIP_SCAN_SOLN:
+            data->solnType = static_cast<SolutionCacheData::SolutionType>(type);
+            break;
+        default:
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "unknown serialized solution type " << type);
+    }
+
+    data->wholeIXSolnDir = serialized[kSerializedDirectionField].numberInt();
+    data->indexFilterApplied = serialized[kSerializedIndexFilterAppliedField].trueValue();
+
+    BSONElement treeElt = serialized[kSerializedTreeField];
+    if (treeElt.eoo()) {
+        if (data->solnType != SolutionCacheData::COLLSCAN_SOLN) {
+            return Status(ErrorCodes::BadValue, "serialized solution has no index tree");
+        }
+        return Status::OK();
+    }
+
+    if (treeElt.type() != Object) {
+        return Status(ErrorCodes::BadValue, "serialized solution has an invalid index tree");
+    }
+
+    data->tree.reset(new PlanCacheIndexTree());
+    Status status = parseIndexTree(treeElt.Obj(), indexEntries, data->tree.get());
+    if (!status.isOK()) {
+        return status;
+    }
+
+    if (data->solnType == SolutionCacheData::WHOLE_IXSCAN_SOLN && !data->tree->entry.get()) {
+        return Status(ErrorCodes::BadValue, "serialized whole index scan solution has no index");
+    }
+
+    if (data->solnType == SolutionCacheData::SKIP_SCAN_SOLN && !data->tree->entry.get()) {
+        return Status(ErrorCodes::BadValue, "serialized skip scan solution has no index");
+    }
+
+    return Status::OK();
+}
+
+/**
+ * Returns a digest of the index specifications in 'indexEntries', ignoring their order and the
+ * namespace of the collection they belong to.
+ */
+std::string computeIndexFingerprint(const std::vector<IndexEntry>& indexEntries) {
+    std::vector<std::pair<std::string, BSONObj>> specs;
+    for (const IndexEntry& indexEntry : indexEntries) {
+        BSONObjBuilder specBuilder;
+        specBuilder.append("key", indexEntry.keyPattern);
+        specBuilder.append("spec", indexEntry.infoObj.removeField("ns"));
+        specs.emplace_back(indexEntry.name, specBuilder.obj());
+    }
+    std::sort(specs.begin(),
+              specs.end(),
+              [](const std::pair<std::string, BSONObj>& lhs,
+                 const std::pair<std::string, BSONObj>& rhs) {
+                  if (lhs.first != rhs.first) {
+                      return lhs.first < rhs.first;
+                  }
+                  return lhs.second.woCompare(rhs.second) < 0;
+              });
+
+    std::string buf;
+    for (const auto& spec : specs) {
+        buf.append(spec.first);
+        buf.append(spec.second.objdata(), spec.second.objsize());
+    }
+    return md5simpledigest(buf);
+}
+
 }  // namespace
 
 //
@@ -468,6 +623,10 @@ std::string SolutionCacheData::toString() const {
             verify(this->tree.get());
             return str::stream() << "(index-tagged expression tree: "
                                  << "tree=" << this->tree->toString() << ")";
+        case SKIP_SCAN_SOLN:
+            verify(this->tree.get());
+            return str::stream() << "(skip scan solution: "
+                                 << "tree=" << this->tree->toString() << ")";
     }
     MONGO_UNREACHABLE;
 }
@@ -748,6 +907,106 @@ size_t PlanCache::size() const {
 
 void PlanCache::notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries) {
     _indexabilityState.updateDiscriminators(indexEntries);
+    _indexFingerprint = computeIndexFingerprint(indexEntries);
+}
+
+const std::string& PlanCache::getIndexFingerprint() const {
+    return _indexFingerprint;
+}
+
+std::vector<BSONObj> PlanCache::serializeEntries() const {
+    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    std::vector<BSONObj> serialized;
+    typedef std::list<std::pair<PlanCacheKey, PlanCacheEntry*>>::const_iterator ConstIterator;
+    for (ConstIterator i = _cache.begin(); i != _cache.end(); i++) {
+        const PlanCacheEntry* entry = i->second;
+
+        BSONObjBuilder builder;
+        builder.append(kSerializedKeyField, i->first);
+        builder.append(kSerializedQueryField, entry->query);
+        builder.append(kSerializedSortField, entry->sort);
+        builder.append(kSerializedProjectionField, entry->projection);
+
+        BSONArrayBuilder solutionsBuilder(builder.subarrayStart(kSerializedSolutionsField));
+        for (size_t j = 0; j < entry->plannerData.size(); ++j) {
+            const SolutionCacheData* data = entry->plannerData[j];
+            BSONObjBuilder solutionBuilder(solutionsBuilder.subobjStart());
+            solutionBuilder.append(kSerializedTypeField, static_cast<int>(data->solnType));
+            solutionBuilder.append(kSerializedDirectionField, data->wholeIXSolnDir);
+            solutionBuilder.append(kSerializedIndexFilterAppliedField, data->indexFilterApplied);
+            solutionBuilder.append(kSerializedScoreField, entry->decision->scores[j]);
+            solutionBuilder.append(
+                kSerializedWorksField,
+                static_cast<long long>(entry->decision->stats.vector()[j]->common.works));
+            if (data->tree.get()) {
+                BSONObjBuilder treeBuilder(solutionBuilder.subobjStart(kSerializedTreeField));
+                serializeIndexTree(*data->tree, &treeBuilder);
+            }
+        }
+        solutionsBuilder.doneFast();
+
+        serialized.push_back(builder.obj());
+    }
+
+    return serialized;
+}
+
+Status PlanCache::restoreEntry(const BSONObj& serialized,
+                               const std::vector<IndexEntry>& indexEntries) {
+    BSONElement keyElt = serialized[kSerializedKeyField];
+    BSONElement solutionsElt = serialized[kSerializedSolutionsField];
+    if (keyElt.type() != String || solutionsElt.type() != Array ||
+        serialized[kSerializedQueryField].type() != Object ||
+        serialized[kSerializedSortField].type() != Object ||
+        serialized[kSerializedProjectionField].type() != Object) {
+        return Status(ErrorCodes::BadValue, "serialized plan cache entry is missing fields");
+    }
+
+    OwnedPointerVector<QuerySolution> solutions;
+    std::unique_ptr<PlanRankingDecision> decision(new PlanRankingDecision());
+    for (const BSONElement& solutionElt : solutionsElt.Obj()) {
+        if (solutionElt.type() != Object) {
+            return Status(ErrorCodes::BadValue, "serialized plan cache entry has bad solution");
+        }
+        const BSONObj solutionObj = solutionElt.Obj();
+
+        std::unique_ptr<SolutionCacheData> data(new SolutionCacheData());
+        Status status = parseSolutionCacheData(solutionObj, indexEntries, data.get());
+        if (!status.isOK()) {
+            return status;
+        }
+
+        QuerySolution* qs = new QuerySolution();
+        qs->cacheData.reset(data.release());
+        solutions.mutableVector().push_back(qs);
+
+        // Only the number of works is needed to decide when to replan; the rest of the trial
+        // period stats are not kept.
+        CommonStats common(kRestoredStatsStageType);
+        common.works = solutionObj[kSerializedWorksField].numberLong();
+        decision->stats.mutableVector().push_back(new PlanStageStats(common, STAGE_UNKNOWN));
+        decision->scores.push_back(solutionObj[kSerializedScoreField].numberDouble());
+        decision->candidateOrder.push_back(decision->candidateOrder.size());
+    }
+
+    if (solutions.empty()) {
+        return Status(ErrorCodes::BadValue, "serialized plan cache entry has no solutions");
+    }
+
+    std::unique_ptr<PlanCacheEntry> entry(
+        new PlanCacheEntry(solutions.vector(), decision.release()));
+    entry->query = serialized[kSerializedQueryField].Obj().getOwned();
+    entry->sort = serialized[kSerializedSortField].Obj().getOwned();
+    entry->projection = serialized[kSerializedProjectionField].Obj().getOwned();
+
+    const PlanCacheKey key = keyElt.String();
+    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    if (_cache.hasKey(key)) {
+        return Status(ErrorCodes::BadValue, "plan cache already has an entry for this query");
+    }
+    _cache.add(key, entry.release());
+
+    return Status::OK();
 }
 
 }  // namespace mongo
@@ -141,7 +141,8 @@ struct SolutionCacheData {
 
     // Owned here. If 'wholeIXSoln' is false, then 'tree'
     // can be used to tag an isomorphic match expression. If 'wholeIXSoln'
-    // is true, then 'tree' is used to store the relevant IndexEntry.
+    // is true, or this is a skip scan solution, then 'tree' is used to store
+    // the relevant IndexEntry.
     // If 'collscanSoln' is true, then 'tree' should be NULL.
     std::unique_ptr<PlanCacheIndexTree> tree;
 
@@ -156,7 +157,11 @@ struct SolutionCacheData {
 
         // Build the solution by using 'tree'
         // to tag the match expression.
-        USE_INDEX_TAGS_SOLN
+        USE_INDEX_TAGS_SOLN,
+
+        // The plan skip-scans the compound index
+        // stored in 'tree'.
+        SKIP_SCAN_SOLN
     } solnType;
 
     // The direction of the index scan used as
@@ -388,6 +393,34 @@ public:
      */
     void notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries);
 
+    /**
+     * Returns a digest of the specifications of the collection's indexes, as last passed to
+     * notifyOfIndexEntries(). The digest does not depend on the collection's namespace, so
+     * collections with identically specified indexes have the same fingerprint and can share
+     * serialized cache entries.
+     */
+    const std::string& getIndexFingerprint() const;
+
+    /**
+     * Returns one document per cache entry describing the cached plans for its query shape.
+     * Indexes are identified by key pattern. The documents can be passed to restoreEntry() on
+     * any plan cache with the same index fingerprint, for example after a restart.
+     */
+    std::vector<BSONObj> serializeEntries() const;
+
+    /**
+     * Adds the entry described by 'serialized', a document produced by serializeEntries(),
+     * resolving its key patterns against 'indexEntries'. An existing entry for the same query
+     * shape is left in place.
+     *
+     * Restored entries are validated lazily: the CachedPlanStage evicts the entry and
+     * replans if the cached plan no longer performs as well as when it was cached.
+     *
+     * Returns an error Status if 'serialized' is malformed, refers to an index which is not in
+     * 'indexEntries', or if an entry for the same query shape already exists.
+     */
+    Status restoreEntry(const BSONObj& serialized, const std::vector<IndexEntry>& indexEntries);
+
 private:
     void encodeKeyForMatch(const MatchExpression* tree, StringBuilder* keyBuilder) const;
     void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
@@ -411,6 +444,10 @@ private:
     // Concurrent access is synchronized by the collection lock.  Multiple concurrent readers
     // are allowed.
     PlanCacheIndexabilityState _indexabilityState;
+
+    // Digest of the index specifications last passed to notifyOfIndexEntries(). Synchronized
+    // in the same way as '_indexabilityState'.
+    std::string _indexFingerprint;
 };
 
 }  // namespace mongo
@@ -697,6 +697,68 @@ protected:
 
 const PlanCacheKey CachePlanSelectionTest::ck = "mock_cache_key";
 
+//
+// Serialization
+//
+
+TEST_F(CachePlanSelectionTest, RestoreSerializedEntry) {
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1));
+    BSONObj query = fromjson("{a: 1, b: {$gt: 2}}");
+    runQuery(query);
+
+    const char* solnJson = "{fetch: {filter: {b: {$gt: 2}}, node: {ixscan: {pattern: {a: 1}}}}}";
+    QuerySolution* bestSoln = firstMatchingSolution(solnJson);
+    unique_ptr<CanonicalQuery> cq(canonicalize(query));
+
+    PlanCache original;
+    original.notifyOfIndexEntries(params.indices);
+    ASSERT_OK(original.add(*cq, {bestSoln}, createDecision(1U)));
+    std::vector<BSONObj> serialized = original.serializeEntries();
+    ASSERT_EQUALS(serialized.size(), 1U);
+
+    PlanCache restored;
+    restored.notifyOfIndexEntries(params.indices);
+    ASSERT_EQUALS(original.getIndexFingerprint(), restored.getIndexFingerprint());
+    ASSERT_OK(restored.restoreEntry(serialized[0], params.indices));
+
+    // An existing entry is not replaced.
+    ASSERT_NOT_OK(restored.restoreEntry(serialized[0], params.indices));
+
+    CachedSolution* rawCachedSoln;
+    ASSERT_OK(restored.get(*cq, &rawCachedSoln));
+    unique_ptr<CachedSolution> cachedSoln(rawCachedSoln);
+    ASSERT_EQUALS(original.computeKey(*cq), cachedSoln->key);
+
+    QuerySolution* rawOut;
+    ASSERT_OK(QueryPlanner::planFromCache(*cq, params, *cachedSoln, &rawOut));
+    unique_ptr<QuerySolution> out(rawOut);
+    assertSolutionMatches(out.get(), solnJson);
+
+    // The entry cannot be restored if the index it uses does not exist.
+    PlanCache withoutIndex;
+    ASSERT_NOT_OK(withoutIndex.restoreEntry(serialized[0], {params.indices[0]}));
+    ASSERT_EQUALS(withoutIndex.size(), 0U);
+}
+
+TEST_F(CachePlanSelectionTest, RestoreSerializedCollscanEntry) {
+    BSONObj query = fromjson("{a: 1}");
+    runQuery(query);
+
+    QuerySolution* bestSoln = firstMatchingSolution("{cscan: {dir: 1, filter: {a: 1}}}");
+    ASSERT(bestSoln->cacheData.get());
+    unique_ptr<CanonicalQuery> cq(canonicalize(query));
+
+    PlanCache original;
+    ASSERT_OK(original.add(*cq, {bestSoln}, createDecision(1U)));
+    std::vector<BSONObj> serialized = original.serializeEntries();
+    ASSERT_EQUALS(serialized.size(), 1U);
+
+    PlanCache restored;
+    ASSERT_OK(restored.restoreEntry(serialized[0], {}));
+    ASSERT(restored.contains(*cq));
+}
+
 //
 // Equality
 //
@@ -1150,6 +1212,35 @@ TEST(PlanCacheTest, ComputeKeyGeoNear) {
         "gnanrsp");
 }
 
+// The index fingerprint should depend on the index specifications but not on the namespace of
+// the collection they belong to.
+TEST(PlanCacheTest, IndexFingerprint) {
+    auto makeIndexEntry = [](const char* ns, bool sparse) {
+        return IndexEntry(BSON("a" << 1),
+                          false,  // multikey
+                          sparse,
+                          false,  // unique
+                          "a_1",  // name
+                          nullptr,
+                          BSON("key" << BSON("a" << 1) << "name"
+                                     << "a_1"
+                                     << "ns" << ns << "sparse" << sparse));
+    };
+
+    PlanCache first;
+    first.notifyOfIndexEntries({makeIndexEntry("test.first", false)});
+    PlanCache second;
+    second.notifyOfIndexEntries({makeIndexEntry("test.second", false)});
+    PlanCache sparse;
+    sparse.notifyOfIndexEntries({makeIndexEntry("test.first", true)});
+    PlanCache noIndexes;
+    noIndexes.notifyOfIndexEntries({});
+
+    ASSERT_EQUALS(first.getIndexFingerprint(), second.getIndexFingerprint());
+    ASSERT_NOT_EQUALS(first.getIndexFingerprint(), sparse.getIndexFingerprint());
+    ASSERT_NOT_EQUALS(first.getIndexFingerprint(), noIndexes.getIndexFingerprint());
+}
+
 // When a sparse index is present, computeKey() should generate different keys depending on
 // whether or not the predicates in the given query can use the index.
 TEST(PlanCacheTest, ComputeKeySparseIndex) {
@@ -39,7 +39,6 @@
 namespace {
 
 using namespace mongo;
-using std::unique_ptr;
 using std::endl;
 using std::set;
 using std::string;
@@ -68,18 +67,23 @@ bool expressionRequiresIndex(const MatchExpression* node) {
 namespace mongo {
 
 PlanEnumerator::PlanEnumerator(const PlanEnumeratorParams& params)
-    : _root(params.root),
+    : _arena(params.arena ? params.arena : &_ownArena),
+      _arenaScope(_arena),
+      _nodeToId(0,
+                std::hash<MatchExpression*>(),
+                std::equal_to<MatchExpression*>(),
+                ArenaAllocator<std::pair<MatchExpression* const, MemoID>>(_arena)),
+      _memo(0,
+            std::hash<MemoID>(),
+            std::equal_to<MemoID>(),
+            ArenaAllocator<std::pair<const MemoID, NodeAssignment*>>(_arena)),
+      _root(params.root),
       _indices(params.indices),
       _ixisect(params.intersect),
       _orLimit(params.maxSolutionsPerOr),
       _intersectLimit(params.maxIntersectPerAnd) {}
 
-PlanEnumerator::~PlanEnumerator() {
-    typedef unordered_map<MemoID, NodeAssignment*> MemoMap;
-    for (MemoMap::iterator it = _memo.begin(); it != _memo.end(); ++it) {
-        delete it->second;
-    }
-}
+PlanEnumerator::~PlanEnumerator() {}
 
 Status PlanEnumerator::init() {
     // Fill out our memo structure from the tagged _root.
@@ -201,7 +205,7 @@ void PlanEnumerator::allocateAssignment(MatchExpression* expr,
     verify(_nodeToId.end() == _nodeToId.find(expr));
     _nodeToId[expr] = newID;
     verify(_memo.end() == _memo.find(newID));
-    NodeAssignment* newAssignment = new NodeAssignment();
+    NodeAssignment* newAssignment = _arena->make<NodeAssignment>();
     _memo[newID] = newAssignment;
     *assign = newAssignment;
     *id = newID;
@@ -232,7 +236,7 @@ bool PlanEnumerator::prepMemo(MatchExpression* node, PrepMemoContext context) {
         NodeAssignment* assign;
         allocateAssignment(node, &assign, &myMemoID);
 
-        assign->pred.reset(new PredicateAssignment());
+        assign->pred = _arena->make<PredicateAssignment>();
         assign->pred->expr = node;
         assign->pred->first.swap(rt->first);
         return true;
@@ -249,9 +253,9 @@ bool PlanEnumerator::prepMemo(MatchExpression* node, PrepMemoContext context) {
         size_t myMemoID;
         NodeAssignment* assign;
         allocateAssignment(node, &assign, &myMemoID);
-        OrAssignment* orAssignment = new OrAssignment();
+        OrAssignment* orAssignment = _arena->make<OrAssignment>();
         orAssignment->subnodes.push_back(memoIDForNode(node->getChild(0)));
-        assign->orAssignment.reset(orAssignment);
+        assign->orAssignment = orAssignment;
         return true;
     } else if (MatchExpression::OR == node->matchType()) {
         // For an OR to be indexed, all its children must be indexed.
@@ -266,16 +270,16 @@ bool PlanEnumerator::prepMemo(MatchExpression* node, PrepMemoContext context) {
         NodeAssignment* assign;
         allocateAssignment(node, &assign, &myMemoID);
 
-        OrAssignment* orAssignment = new OrAssignment();
+        OrAssignment* orAssignment = _arena->make<OrAssignment>();
         for (size_t i = 0; i < node->numChildren(); ++i) {
             orAssignment->subnodes.push_back(memoIDForNode(node->getChild(i)));
         }
-        assign->orAssignment.reset(orAssignment);
+        assign->orAssignment = orAssignment;
         return true;
     } else if (Indexability::arrayUsesIndexOnChildren(node)) {
         // Add each of our children as a subnode.  We enumerate through each subnode one at a
         // time until it's exhausted then we move on.
-        unique_ptr<ArrayAssignment> aa(new ArrayAssignment());
+        ArrayAssignment* aa = _arena->make<ArrayAssignment>();
 
         if (MatchExpression::ELEM_MATCH_OBJECT == node->matchType()) {
             childContext.elemMatchExpr = node;
@@ -296,7 +300,7 @@ bool PlanEnumerator::prepMemo(MatchExpression* node, PrepMemoContext context) {
         NodeAssignment* assign;
         allocateAssignment(node, &assign, &myMemoID);
 
-        assign->arrayAssignment.reset(aa.release());
+        assign->arrayAssignment = aa;
         return true;
     } else if (MatchExpression::AND == node->matchType()) {
         // Map from idx id to children that have a pred over it.
@@ -392,13 +396,12 @@ bool PlanEnumerator::prepMemo(MatchExpression* node, PrepMemoContext context) {
         }
 
         // At least one child can use an index, so we can create a memo entry.
-        AndAssignment* andAssignment = new AndAssignment();
+        AndAssignment* andAssignment = _arena->make<AndAssignment>();
 
         size_t myMemoID;
         NodeAssignment* nodeAssignment;
         allocateAssignment(node, &nodeAssignment, &myMemoID);
-        // Takes ownership.
-        nodeAssignment->andAssignment.reset(andAssignment);
+        nodeAssignment->andAssignment = andAssignment;
 
         // Predicates which must use an index might be buried inside
         // a subnode. Handle that case here.
@@ -1133,20 +1136,20 @@ void PlanEnumerator::tagMemo(size_t id) {
     verify(NULL != assign);
 
     if (NULL != assign->pred) {
-        PredicateAssignment* pa = assign->pred.get();
+        PredicateAssignment* pa = assign->pred;
         verify(NULL == pa->expr->getTag());
         verify(pa->indexToAssign < pa->first.size());
         pa->expr->setTag(new IndexTag(pa->first[pa->indexToAssign]));
     } else if (NULL != assign->orAssignment) {
-        OrAssignment* oa = assign->orAssignment.get();
+        OrAssignment* oa = assign->orAssignment;
         for (size_t i = 0; i < oa->subnodes.size(); ++i) {
             tagMemo(oa->subnodes[i]);
         }
     } else if (NULL != assign->arrayAssignment) {
-        ArrayAssignment* aa = assign->arrayAssignment.get();
+        ArrayAssignment* aa = assign->arrayAssignment;
         tagMemo(aa->subnodes[aa->counter]);
     } else if (NULL != assign->andAssignment) {
-        AndAssignment* aa = assign->andAssignment.get();
+        AndAssignment* aa = assign->andAssignment;
         verify(aa->counter < aa->choices.size());
 
         const AndEnumerableState& aes = aa->choices[aa->counter];
@@ -1174,7 +1177,7 @@ bool PlanEnumerator::nextMemo(size_t id) {
     verify(NULL != assign);
 
     if (NULL != assign->pred) {
-        PredicateAssignment* pa = assign->pred.get();
+        PredicateAssignment* pa = assign->pred;
         pa->indexToAssign++;
         if (pa->indexToAssign >= pa->first.size()) {
             pa->indexToAssign = 0;
@@ -1182,7 +1185,7 @@ bool PlanEnumerator::nextMemo(size_t id) {
         }
         return false;
     } else if (NULL != assign->orAssignment) {
-        OrAssignment* oa = assign->orAssignment.get();
+        OrAssignment* oa = assign->orAssignment;
 
         // Limit the number of OR enumerations
         oa->counter++;
@@ -1202,7 +1205,7 @@ bool PlanEnumerator::nextMemo(size_t id) {
         // If we're here, the last subnode had a carry, therefore the OR has a carry.
         return true;
     } else if (NULL != assign->arrayAssignment) {
-        ArrayAssignment* aa = assign->arrayAssignment.get();
+        ArrayAssignment* aa = assign->arrayAssignment;
         // moving to next on current subnode is OK
         if (!nextMemo(aa->subnodes[aa->counter])) {
             return false;
@@ -1215,7 +1218,7 @@ bool PlanEnumerator::nextMemo(size_t id) {
         aa->counter = 0;
         return true;
     } else if (NULL != assign->andAssignment) {
-        AndAssignment* aa = assign->andAssignment.get();
+        AndAssignment* aa = assign->andAssignment;
 
         // One of our subnodes might have to move on to its next enumeration state.
         const AndEnumerableState& aes = aa->choices[aa->counter];
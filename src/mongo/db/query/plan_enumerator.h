@@ -36,6 +36,8 @@
 #include "mongo/db/query/index_entry.h"
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/query_knobs.h"
+#include "mongo/platform/unordered_map.h"
+#include "mongo/util/arena.h"
 
 namespace mongo {
 
@@ -43,7 +45,8 @@ struct PlanEnumeratorParams {
     PlanEnumeratorParams()
         : intersect(false),
           maxSolutionsPerOr(internalQueryEnumerationMaxOrSolutions),
-          maxIntersectPerAnd(internalQueryEnumerationMaxIntersectPerAnd) {}
+          maxIntersectPerAnd(internalQueryEnumerationMaxIntersectPerAnd),
+          arena(NULL) {}
 
     // Do we provide solutions that use more indices than the minimum required to provide
     // an indexed solution?
@@ -64,6 +67,10 @@ struct PlanEnumeratorParams {
     // all-pairs approach, we could wind up creating a lot of enumeration possibilities for
     // certain inputs.
     size_t maxIntersectPerAnd;
+
+    // If not NULL, the enumerator builds its memo in this arena, within a scope that ends when
+    // the enumerator is destroyed. Otherwise it uses an arena of its own. Not owned here.
+    Arena* arena;
 };
 
 /**
@@ -228,13 +235,14 @@ private:
     };
 
     /**
-     * Associates indices with predicates.
+     * Associates indices with predicates. At most one of the assignments is set. All of them
+     * live in '_arena'.
      */
     struct NodeAssignment {
-        std::unique_ptr<PredicateAssignment> pred;
-        std::unique_ptr<OrAssignment> orAssignment;
-        std::unique_ptr<AndAssignment> andAssignment;
-        std::unique_ptr<ArrayAssignment> arrayAssignment;
+        PredicateAssignment* pred = nullptr;
+        OrAssignment* orAssignment = nullptr;
+        AndAssignment* andAssignment = nullptr;
+        ArrayAssignment* arrayAssignment = nullptr;
         std::string toString() const;
     };
 
@@ -414,11 +422,26 @@ private:
 
     std::string dumpMemo();
 
+    template <typename Key, typename Value>
+    using ArenaMap = unordered_map<Key,
+                                   Value,
+                                   std::hash<Key>,
+                                   std::equal_to<Key>,
+                                   ArenaAllocator<std::pair<const Key, Value>>>;
+
+    // Used if the caller does not provide an arena.
+    Arena _ownArena;
+
+    // Holds the memo. Everything allocated in it by this enumerator is released when
+    // '_arenaScope' ends.
+    Arena* const _arena;
+    Arena::Scope _arenaScope;
+
     // Map from expression to its MemoID.
-    unordered_map<MatchExpression*, MemoID> _nodeToId;
+    ArenaMap<MatchExpression*, MemoID> _nodeToId;
 
     // Map from MemoID to its precomputed solution info.
-    unordered_map<MemoID, NodeAssignment*> _memo;
+    ArenaMap<MemoID, NodeAssignment*> _memo;
 
     // If true, there are no further enumeration states, and getNext should return false.
     // We could be _done immediately after init if we're unable to output an indexed plan.
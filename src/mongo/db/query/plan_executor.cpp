@@ -28,6 +28,7 @@
 
 #include "mongo/db/query/plan_executor.h"
 
+#include <algorithm>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -40,8 +41,10 @@
 #include "mongo/db/exec/subplan.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/query/plan_yield_policy.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 
@@ -163,6 +166,9 @@ PlanExecutor::PlanExecutor(OperationContext* opCtx,
       _root(std::move(rt)),
       _ns(ns),
       _yieldPolicy(new PlanYieldPolicy(this, YIELD_MANUAL)) {
+    _isReadOnly = !getStageByType(_root.get(), STAGE_UPDATE) &&
+        !getStageByType(_root.get(), STAGE_DELETE);
+
     // We may still need to initialize _ns from either _collection or _cq.
     if (!_ns.empty()) {
         // We already have an _ns set, so there's nothing more to do.
@@ -286,6 +292,12 @@ bool PlanExecutor::restoreStateWithoutRetrying() {
 
     if (!killed()) {
         _root->restoreState();
+
+        // The index entries behind results of the last batch we have yet to return may have
+        // changed while we were yielded.
+        if (supportsDocLocking()) {
+            recheckBatchedResults();
+        }
     }
 
     _currentState = kUsable;
@@ -315,6 +327,27 @@ void PlanExecutor::reattachToOperationContext(OperationContext* txn) {
 void PlanExecutor::invalidate(OperationContext* txn, const RecordId& dl, InvalidationType type) {
     if (!killed()) {
         _root->invalidate(txn, dl, type);
+
+        // Results of the last batch that we have yet to return no longer belong to any stage,
+        // so we deal with any whose RecordId is being invalidated ourselves. Index-only results
+        // are dropped, since the index entry they came from may be gone, and the others are
+        // force-fetched.
+        size_t numKept = _batchedResultsPos;
+        for (size_t i = _batchedResultsPos; i < _batchedResults.size(); ++i) {
+            WorkingSetID id = _batchedResults[i];
+            if (WorkingSet::INVALID_ID != id) {
+                WorkingSetMember* member = _workingSet->get(id);
+                if (member->hasLoc() && (member->loc == dl)) {
+                    if (WorkingSetMember::LOC_AND_IDX == member->getState()) {
+                        _workingSet->free(id);
+                        continue;
+                    }
+                    WorkingSetCommon::fetchAndInvalidateLoc(txn, member, _collection);
+                }
+            }
+            _batchedResults[numKept++] = id;
+        }
+        _batchedResults.resize(numKept);
     }
 }
 
@@ -361,7 +394,7 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
     // just pass a NULL fetcher.
     unique_ptr<RecordFetcher> fetcher;
 
-    // Incremented on every writeConflict, reset to 0 on any successful call to _root->work.
+    // Incremented on every writeConflict, reset to 0 on any successful call to workRoot().
     size_t writeConflictsInARow = 0;
 
     for (;;) {
@@ -389,7 +422,7 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
         fetcher.reset();
 
         WorkingSetID id = WorkingSet::INVALID_ID;
-        PlanStage::StageState code = _root->work(&id);
+        PlanStage::StageState code = workRoot(&id);
 
         if (code != PlanStage::NEED_YIELD)
             writeConflictsInARow = 0;
@@ -475,9 +508,116 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
     }
 }
 
+void PlanExecutor::setNumResultsWanted(long long numResults) {
+    if (numResults <= 0) {
+        _numResultsWanted = boost::none;
+    } else {
+        _numResultsWanted = numResults;
+    }
+}
+
+size_t PlanExecutor::workBatchSize() const {
+    if (!_isReadOnly || internalQueryExecWorkBatchSize <= 1) {
+        return 1;
+    }
+
+    // Each unit of work produces at most one result, so a batch no larger than the number of
+    // results still wanted cannot produce more than that.
+    long long batchSize = internalQueryExecWorkBatchSize;
+    if (_numResultsWanted) {
+        batchSize = std::min(batchSize, *_numResultsWanted);
+    }
+    return std::max(batchSize, 1LL);
+}
+
+void PlanExecutor::recheckBatchedResults() {
+    if (!_collection) {
+        return;
+    }
+
+    unique_ptr<SeekableRecordCursor> cursor;
+    size_t numKept = _batchedResultsPos;
+    for (size_t i = _batchedResultsPos; i < _batchedResults.size(); ++i) {
+        WorkingSetID id = _batchedResults[i];
+        if (WorkingSet::INVALID_ID != id) {
+            WorkingSetMember* member = _workingSet->get(id);
+            if (WorkingSetMember::LOC_AND_IDX == member->getState()) {
+                if (!cursor) {
+                    cursor = _collection->getCursor(_opCtx);
+                }
+
+                // The result stays index-only: it only has to still describe the document.
+                bool keysStillMatch = false;
+                if (auto record = cursor->seekExact(member->loc)) {
+                    BSONObj doc = record->data.releaseToBson();
+                    keysStillMatch = true;
+                    for (auto&& keyData : member->keyData) {
+                        BSONObjSet keys;
+                        keyData.index->getKeys(doc, &keys);
+                        if (!keys.count(keyData.keyData)) {
+                            keysStillMatch = false;
+                            break;
+                        }
+                    }
+                }
+
+                if (!keysStillMatch) {
+                    _workingSet->free(id);
+                    continue;
+                }
+                member->isSuspicious = false;
+            }
+        }
+        _batchedResults[numKept++] = id;
+    }
+    _batchedResults.resize(numKept);
+}
+
+PlanStage::StageState PlanExecutor::workRoot(WorkingSetID* out) {
+    if (!hasBatchedWork()) {
+        const size_t batchSize = workBatchSize();
+        if (batchSize <= 1) {
+            PlanStage::StageState state = _root->work(out);
+            if (PlanStage::ADVANCED == state && _numResultsWanted && *_numResultsWanted > 0) {
+                --*_numResultsWanted;
+            }
+            return state;
+        }
+
+        // Results are appended to '_batchedResults' as they are produced, so none are lost if
+        // the batch throws part way through.
+        _batchedResults.clear();
+        _batchedResultsPos = 0;
+        WorkingSetID endId = WorkingSet::INVALID_ID;
+        PlanStage::StageState state = _root->workBatch(batchSize, &_batchedResults, &endId);
+        if (PlanStage::ADVANCED != state && PlanStage::NEED_TIME != state) {
+            _hasBatchEndState = true;
+            _batchEndState = state;
+            _batchEndId = endId;
+        } else if (_batchedResults.empty()) {
+            // Every unit of work in the batch was a NEED_TIME. Give the caller a chance to
+            // yield before asking for more.
+            return PlanStage::NEED_TIME;
+        }
+    }
+
+    if (_batchedResultsPos < _batchedResults.size()) {
+        *out = _batchedResults[_batchedResultsPos++];
+        if (_numResultsWanted && *_numResultsWanted > 0) {
+            --*_numResultsWanted;
+        }
+        return PlanStage::ADVANCED;
+    }
+
+    invariant(_hasBatchEndState);
+    _hasBatchEndState = false;
+    *out = _batchEndId;
+    return _batchEndState;
+}
+
 bool PlanExecutor::isEOF() {
     invariant(_currentState == kUsable);
-    return killed() || (_stash.empty() && _root->isEOF());
+    return killed() || (_stash.empty() && !hasBatchedWork() && _root->isEOF());
 }
 
 void PlanExecutor::registerExec() {
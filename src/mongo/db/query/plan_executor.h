@@ -30,8 +30,10 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <vector>
 
 #include "mongo/base/status.h"
+#include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/invalidation_type.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/storage/snapshot.h"
@@ -41,11 +43,9 @@ namespace mongo {
 class BSONObj;
 class Collection;
 class RecordId;
-class PlanStage;
 class PlanExecutor;
 struct PlanStageStats;
 class PlanYieldPolicy;
-class WorkingSet;
 
 /**
  * A PlanExecutor is the abstraction that knows how to crank a tree of stages into execution.
@@ -296,6 +296,15 @@ public:
      */
     bool isEOF();
 
+    /**
+     * Tells the executor that its caller will stop calling getNext() once it has been given
+     * 'numResults' more results, or, if 'numResults' is 0 or less, that the caller does not know
+     * how many results it wants. The executor never works its plan stage tree in batches larger
+     * than the number of results still wanted, so that it does not produce results which
+     * would have to be kept across the end of the caller's batch.
+     */
+    void setNumResultsWanted(long long numResults);
+
     /**
      * Execute the plan to completion, throwing out the results.  Used when you want to work the
      * underlying tree without getting results back.
@@ -371,6 +380,35 @@ public:
 private:
     ExecState getNextImpl(Snapshotted<BSONObj>* objOut, RecordId* dlOut);
 
+    /**
+     * Returns the next unit of work from the plan stage tree, as _root->work() would. Work is
+     * requested from the tree in batches of up to internalQueryExecWorkBatchSize units through
+     * PlanStage::workBatch(), and the results are handed out one at a time from
+     * '_batchedResults' before the state which ended the batch, if any, is returned.
+     */
+    PlanStage::StageState workRoot(WorkingSetID* out);
+
+    /**
+     * Returns true if results of the last call to _root->workBatch(), or the state which ended
+     * it, have yet to be returned by workRoot().
+     */
+    bool hasBatchedWork() const {
+        return _batchedResultsPos < _batchedResults.size() || _hasBatchEndState;
+    }
+
+    /**
+     * Returns how many units of work workRoot() asks of the plan stage tree at a time. Batches
+     * of 1 mean the tree is worked through work() rather than workBatch().
+     */
+    size_t workBatchSize() const;
+
+    /**
+     * Checks the index-only results of the last batch that have yet to be returned against the
+     * current version of their documents, after a yield may have changed them. Results whose
+     * index keys no longer match are dropped, as FetchStage drops suspicious members.
+     */
+    void recheckBatchedResults();
+
     /**
      * RAII approach to ensuring that plan executors are deregistered.
      *
@@ -462,6 +500,27 @@ private:
     // stages.
     std::queue<BSONObj> _stash;
 
+    // Only trees which do not write are worked in batches. A write stage must not get ahead of
+    // the results its caller has seen.
+    bool _isReadOnly = true;
+
+    // How many more results the caller wants, or boost::none if it did not say.
+    boost::optional<long long> _numResultsWanted;
+
+    // Results produced by the last call to _root->workBatch(). Those at '_batchedResultsPos' and
+    // after have not yet been returned. They stay valid across yields: prepareForSnapshotChange()
+    // makes their documents owned, recheckBatchedResults() drops index-only results which no
+    // longer match their documents, and invalidate() force-fetches, or drops if index-only, any
+    // whose RecordId goes away.
+    std::vector<WorkingSetID> _batchedResults;
+    size_t _batchedResultsPos = 0;
+
+    // The state other than ADVANCED or NEED_TIME that ended the last batch, and the id it came
+    // with, to be returned once '_batchedResults' is drained.
+    bool _hasBatchEndState = false;
+    PlanStage::StageState _batchEndState = PlanStage::NEED_TIME;
+    WorkingSetID _batchEndId = WorkingSet::INVALID_ID;
+
     enum { kUsable, kSaved, kDetached } _currentState = kUsable;
 
     bool _everDetachedFromOperationContext = false;
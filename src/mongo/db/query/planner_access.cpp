@@ -42,6 +42,7 @@
 #include "mongo/db/query/indexability.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/index_tag.h"
+#include "mongo/db/query/planner_ixselect.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
@@ -104,6 +105,20 @@ bool scansAreEquivalent(const QuerySolutionNode* lhs, const QuerySolutionNode* r
     return *leftIxscan == *rightIxscan;
 }
 
+/**
+ * Returns true if 'node' is a predicate over a single field which a skip scan can turn into
+ * index bounds.
+ */
+bool isSkipScanPredicate(const MatchExpression* node) {
+    if (!Indexability::nodeCanUseIndexOnOwnField(node) || node->isArray()) {
+        return false;
+    }
+
+    const MatchExpression::MatchType type = node->matchType();
+    return MatchExpression::GEO != type && MatchExpression::GEO_NEAR != type &&
+        MatchExpression::TEXT != type;
+}
+
 }  // namespace
 
 namespace mongo {
@@ -1266,6 +1281,82 @@ QuerySolutionNode* QueryPlannerAccess::scanWholeIndex(const IndexEntry& index,
     return solnRoot;
 }
 
+// static
+QuerySolutionNode* QueryPlannerAccess::skipScanIndex(const IndexEntry& index,
+                                                     const CanonicalQuery& query,
+                                                     const QueryPlannerParams& params) {
+    // Multikey indexes would need their RecordIds deduplicated, and sparse or partial indexes
+    // could be missing documents the query matches.
+    if (INDEX_BTREE != index.type || index.multikey || index.sparse || index.filterExpr ||
+        index.keyPattern.nFields() < 2) {
+        return NULL;
+    }
+
+    // The candidate predicates are the root itself or the children of a rooted $and. The whole
+    // query is applied as a filter on top of the scan, so these only have to narrow its bounds.
+    vector<MatchExpression*> predicates;
+    MatchExpression* root = query.root();
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            predicates.push_back(root->getChild(i));
+        }
+    } else {
+        predicates.push_back(root);
+    }
+
+    unique_ptr<SkipScanNode> ssn = make_unique<SkipScanNode>();
+    ssn->indexKeyPattern = index.keyPattern;
+    ssn->bounds.fields.resize(index.keyPattern.nFields());
+
+    size_t fieldNo = 0;
+    bool leadingFieldConstrained = false;
+    bool trailingFieldConstrained = false;
+    BSONObjIterator it(index.keyPattern);
+    while (it.more()) {
+        BSONElement elt = it.next();
+        OrderedIntervalList* oil = &ssn->bounds.fields[fieldNo];
+
+        bool constrained = false;
+        for (size_t i = 0; i < predicates.size(); ++i) {
+            MatchExpression* pred = predicates[i];
+            if (!isSkipScanPredicate(pred) || pred->path() != elt.fieldNameStringData() ||
+                !QueryPlannerIXSelect::compatible(elt, index, pred)) {
+                continue;
+            }
+
+            IndexBoundsBuilder::BoundsTightness tightness;
+            if (constrained) {
+                IndexBoundsBuilder::translateAndIntersect(pred, elt, index, oil, &tightness);
+            } else {
+                IndexBoundsBuilder::translate(pred, elt, index, oil, &tightness);
+                constrained = true;
+            }
+        }
+
+        if (!constrained) {
+            IndexBoundsBuilder::allValuesForField(elt, oil);
+        } else if (0 == fieldNo) {
+            leadingFieldConstrained = true;
+        } else {
+            trailingFieldConstrained = true;
+        }
+        ++fieldNo;
+    }
+
+    // With a predicate on the leading field this is an ordinary index scan, and without one on
+    // any other field there is nothing to skip to.
+    if (leadingFieldConstrained || !trailingFieldConstrained) {
+        return NULL;
+    }
+
+    IndexBoundsBuilder::alignBounds(&ssn->bounds, index.keyPattern);
+
+    unique_ptr<FetchNode> fetch = make_unique<FetchNode>();
+    fetch->filter = std::move(root->shallowClone());
+    fetch->children.push_back(ssn.release());
+    return fetch.release();
+}
+
 // static
 void QueryPlannerAccess::addFilterToSolutionNode(QuerySolutionNode* node,
                                                  MatchExpression* match,
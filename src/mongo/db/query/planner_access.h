@@ -197,6 +197,15 @@ public:
                                              const QueryPlannerParams& params,
                                              int direction = 1);
 
+    /**
+     * Return a plan that skip-scans the provided compound index, which the query constrains on
+     * some field other than the leading one, and then fetches and filters the documents.
+     * Returns NULL if the index can't be skip-scanned for 'query'.
+     */
+    static QuerySolutionNode* skipScanIndex(const IndexEntry& index,
+                                            const CanonicalQuery& query,
+                                            const QueryPlannerParams& params);
+
     /**
      * Return a plan that scans the provided index from [startKey to endKey).
      */
@@ -56,12 +56,20 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableIndexIntersection, bool,
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableHashIntersection, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableSkipScan, bool, true);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanOrChildrenIndependently, bool, true);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxScansToExplode, int, 200);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecCompileFilters, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecSortUseKeyString, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecWorkBatchSize, int, 1);
+
 // Yield every 128 cycles or 10ms.
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
@@ -54,6 +54,10 @@ extern bool internalQueryPlannerEnableIndexIntersection;
 // Do we use hash-based intersection for rooted $and queries?
 extern bool internalQueryPlannerEnableHashIntersection;
 
+// When no index can otherwise answer a query, do we try skip scans over compound indexes whose
+// leading fields the query does not constrain?
+extern bool internalQueryPlannerEnableSkipScan;
+
 //
 // plan cache
 //
@@ -95,6 +99,16 @@ extern int internalQueryMaxScansToExplode;
 
 extern int internalQueryExecMaxBlockingSortBytes;
 
+// Do collection scans and fetches compile their filters (see CompiledMatchExpression)?
+extern bool internalQueryExecCompileFilters;
+
+// Does the SORT stage compare sort keys by their KeyString encodings?
+extern bool internalQueryExecSortUseKeyString;
+
+// How many units of work does PlanExecutor ask of a read-only plan stage tree at a time? A value
+// of 1 or less, the default, makes it call work() once per unit instead of workBatch().
+extern int internalQueryExecWorkBatchSize;
+
 // Yield after this many "should yield?" checks.
 extern int internalQueryExecYieldIterations;
 
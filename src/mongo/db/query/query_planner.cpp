@@ -44,6 +44,7 @@
 #include "mongo/db/query/planner_analysis.h"
 #include "mongo/db/query/planner_ixselect.h"
 #include "mongo/db/query/plan_enumerator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/util/log.h"
@@ -228,6 +229,64 @@ QuerySolution* buildWholeIXSoln(const IndexEntry& index,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, solnRoot);
 }
 
+QuerySolution* buildSkipScanSoln(const IndexEntry& index,
+                                 const CanonicalQuery& query,
+                                 const QueryPlannerParams& params) {
+    QuerySolutionNode* solnRoot = QueryPlannerAccess::skipScanIndex(index, query, params);
+    if (NULL == solnRoot) {
+        return NULL;
+    }
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, solnRoot);
+}
+
+/**
+ * Returns a skip scan of 'index' carrying the cache data needed to rebuild it, or NULL if the
+ * index can't be skip-scanned for 'query'.
+ */
+QuerySolution* buildCacheableSkipScanSoln(const IndexEntry& index,
+                                          const CanonicalQuery& query,
+                                          const QueryPlannerParams& params) {
+    if (!internalQueryPlannerEnableSkipScan || !query.getParsed().getMin().isEmpty() ||
+        !query.getParsed().getMax().isEmpty() ||
+        QueryPlannerCommon::hasNode(query.root(), MatchExpression::GEO_NEAR) ||
+        QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT)) {
+        return NULL;
+    }
+
+    QuerySolution* soln = buildSkipScanSoln(index, query, params);
+    if (NULL == soln) {
+        return NULL;
+    }
+
+    PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+    indexTree->setIndexEntry(index);
+    SolutionCacheData* scd = new SolutionCacheData();
+    scd->tree.reset(indexTree);
+    scd->solnType = SolutionCacheData::SKIP_SCAN_SOLN;
+    soln->cacheData.reset(scd);
+
+    LOG(5) << "Planner: outputting a skip scan:" << endl
+           << soln->toString();
+    return soln;
+}
+
+/**
+ * A skip scan of an index provides the same sorts as scanning all of it, so when the whole index
+ * is scanned to provide the sort, a skip scan of it competes with that scan.
+ */
+void addSortedSkipScanSoln(const IndexEntry& index,
+                           const CanonicalQuery& query,
+                           const QueryPlannerParams& params,
+                           std::vector<QuerySolution*>* out) {
+    if (out->size() >= params.maxIndexedSolutions) {
+        return;
+    }
+    QuerySolution* soln = buildCacheableSkipScanSoln(index, query, params);
+    if (NULL != soln) {
+        out->push_back(soln);
+    }
+}
+
 bool providesSort(const CanonicalQuery& query, const BSONObj& kp) {
     return query.getParsed().getSort().isPrefixOf(kp);
 }
@@ -354,6 +413,15 @@ Status QueryPlanner::planFromCache(const CanonicalQuery& query,
             *out = soln;
             return Status::OK();
         }
+    } else if (SolutionCacheData::SKIP_SCAN_SOLN == winnerCacheData.solnType) {
+        // The solution skip-scans a compound index.
+        QuerySolution* soln = buildSkipScanSoln(*winnerCacheData.tree->entry, query, params);
+        if (soln == NULL) {
+            return Status(ErrorCodes::BadValue, "plan cache error: skip scan soln");
+        } else {
+            *out = soln;
+            return Status::OK();
+        }
     } else if (SolutionCacheData::COLLSCAN_SOLN == winnerCacheData.solnType) {
         // The cached solution is a collection scan. We don't cache collscans
         // with tailable==true, hence the false below.
@@ -736,6 +804,7 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         enumParams.intersect = params.options & QueryPlannerParams::INDEX_INTERSECTION;
         enumParams.root = query.root();
         enumParams.indices = &relevantIndices;
+        enumParams.arena = params.arena;
 
         PlanEnumerator isp(enumParams);
         isp.init();
@@ -873,6 +942,7 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
 
                         soln->cacheData.reset(scd);
                         out->push_back(soln);
+                        addSortedSkipScanSoln(params.indices[i], query, params, out);
                         break;
                     }
                 }
@@ -890,6 +960,7 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
 
                         soln->cacheData.reset(scd);
                         out->push_back(soln);
+                        addSortedSkipScanSoln(params.indices[i], query, params, out);
                         break;
                     }
                 }
@@ -897,6 +968,21 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         }
     }
 
+    // If no index can be used in the usual way, a compound index which the query constrains on
+    // some field other than the leading one can still be skip-scanned. These plans compete with
+    // the collection scan, which wins if the leading fields have too many distinct values.
+    size_t numSkipScanSolns = 0;
+    if (0 == out->size()) {
+        for (size_t i = 0; i < params.indices.size() && out->size() < params.maxIndexedSolutions;
+             ++i) {
+            QuerySolution* soln = buildCacheableSkipScanSoln(params.indices[i], query, params);
+            if (NULL != soln) {
+                out->push_back(soln);
+                ++numSkipScanSolns;
+            }
+        }
+    }
+
     // geoNear and text queries *require* an index.
     // Also, if a hint is specified it indicates that we MUST use it.
     bool possibleToCollscan =
@@ -907,7 +993,7 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
     bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN);
 
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
-    bool collscanNeeded = (0 == out->size() && canTableScan);
+    bool collscanNeeded = (numSkipScanSolns == out->size() && canTableScan);
 
     if (possibleToCollscan && (collscanRequested || collscanNeeded)) {
         QuerySolution* collscan = buildCollscanSoln(query, isTailable, params);
@@ -67,6 +67,25 @@ void QueryPlannerCommon::reverseScans(QuerySolutionNode* node) {
 
         // TODO: we can just negate every value in the already computed properties.
         isn->computeProperties();
+    } else if (STAGE_SKIP_SCAN == type) {
+        SkipScanNode* ssn = static_cast<SkipScanNode*>(node);
+        ssn->direction *= -1;
+
+        // A skip scan's bounds are never a simple range, so reverse them as for an ixscan.
+        for (size_t i = 0; i < ssn->bounds.fields.size(); ++i) {
+            std::vector<Interval>& iv = ssn->bounds.fields[i].intervals;
+            std::reverse(iv.begin(), iv.end());
+            for (size_t j = 0; j < iv.size(); ++j) {
+                iv[j].reverse();
+            }
+        }
+
+        if (!ssn->bounds.isValidFor(ssn->indexKeyPattern, ssn->direction)) {
+            LOG(5) << "Invalid bounds: " << ssn->bounds.toString() << std::endl;
+            invariant(0);
+        }
+
+        ssn->computeProperties();
     } else if (STAGE_SORT_MERGE == type) {
         // reverse direction of comparison for merge
         MergeSortNode* msn = static_cast<MergeSortNode*>(node);
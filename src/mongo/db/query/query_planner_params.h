@@ -33,6 +33,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_entry.h"
 #include "mongo/db/query/query_knobs.h"
+#include "mongo/util/arena.h"
 
 namespace mongo {
 
@@ -40,7 +41,8 @@ struct QueryPlannerParams {
     QueryPlannerParams()
         : options(DEFAULT),
           indexFiltersApplied(false),
-          maxIndexedSolutions(internalQueryPlannerMaxIndexedSolutions) {}
+          maxIndexedSolutions(internalQueryPlannerMaxIndexedSolutions),
+          arena(NULL) {}
 
     enum Options {
         // You probably want to set this.
@@ -112,6 +114,11 @@ struct QueryPlannerParams {
     // plans via the MultiPlanStage, and the set of possible plans is very large for certain
     // index+query combinations.
     size_t maxIndexedSolutions;
+
+    // Where the planner keeps its scratch state, usually the arena of the planning operation. Set
+    // it just before planning, since it must outlive the call to QueryPlanner::plan(). If NULL,
+    // the planner uses an arena of its own. Not owned here.
+    Arena* arena;
 };
 
 }  // namespace mongo
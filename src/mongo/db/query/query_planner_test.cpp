@@ -36,6 +36,8 @@
 #include "mongo/db/json.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_test_fixture.h"
+#include "mongo/util/arena.h"
+#include "mongo/util/timer.h"
 
 namespace {
 
@@ -1563,13 +1565,109 @@ TEST_F(QueryPlannerTest, CompoundFieldsOrder) {
 }
 
 TEST_F(QueryPlannerTest, CantUseCompound) {
+    // A multikey index can't be skip-scanned.
+    addIndex(BSON("x" << 1 << "y" << 1), true);
+    runQuery(fromjson("{ y: 10}"));
+
+    ASSERT_EQUALS(getNumSolutions(), 1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {y: 10}}}");
+}
+
+//
+// Skip scans
+//
+
+TEST_F(QueryPlannerTest, SkipScanCompoundNonPrefix) {
     addIndex(BSON("x" << 1 << "y" << 1));
     runQuery(fromjson("{ y: 10}"));
 
+    ASSERT_EQUALS(getNumSolutions(), 2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {y: 10}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {y: 10}, node: {skipScan: {pattern: {x: 1, y: 1}, bounds: "
+        "{x: [['MinKey','MaxKey',true,true]], y: [[10,10,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanProvidesSort) {
+    addIndex(BSON("x" << 1 << "y" << 1));
+    runQuerySortProj(fromjson("{y: 10}"), fromjson("{x: 1}"), BSONObj());
+
+    ASSERT_EQUALS(getNumSolutions(), 3U);
+    assertSolutionExists(
+        "{sort: {pattern: {x: 1}, limit: 0, node: {sortKeyGen: {node: "
+        "{cscan: {dir: 1, filter: {y: 10}}}}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {y: 10}, node: {ixscan: {pattern: {x: 1, y: 1}, dir: 1}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {y: 10}, node: {skipScan: {pattern: {x: 1, y: 1}, dir: 1, bounds: "
+        "{x: [['MinKey','MaxKey',true,true]], y: [[10,10,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanReversedForDescendingSort) {
+    addIndex(BSON("x" << 1 << "y" << 1));
+    runQuerySortProj(fromjson("{y: 10}"), fromjson("{x: -1}"), BSONObj());
+
+    ASSERT_EQUALS(getNumSolutions(), 3U);
+    assertSolutionExists(
+        "{sort: {pattern: {x: -1}, limit: 0, node: {sortKeyGen: {node: "
+        "{cscan: {dir: 1, filter: {y: 10}}}}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {y: 10}, node: {ixscan: {pattern: {x: 1, y: 1}, dir: -1}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {y: 10}, node: {skipScan: {pattern: {x: 1, y: 1}, dir: -1, bounds: "
+        "{x: [['MaxKey','MinKey',true,true]], y: [[10,10,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanIntersectsTrailingBounds) {
+    addIndex(BSON("x" << 1 << "y" << 1 << "z" << -1));
+    runQuery(fromjson("{y: {$gt: 3, $lte: 8}, z: {$in: [1, 2]}, w: 4}"));
+
+    ASSERT_EQUALS(getNumSolutions(), 2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: {y: {$gt: 3, $lte: 8}, z: {$in: [1, 2]}, w: 4}, node: "
+        "{skipScan: {pattern: {x: 1, y: 1, z: -1}, bounds: "
+        "{x: [['MinKey','MaxKey',true,true]], y: [[3,8,false,true]], "
+        "z: [[2,2,true,true],[1,1,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanWithoutTableScan) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    addIndex(BSON("x" << 1 << "y" << 1));
+    runQuery(fromjson("{ y: 10}"));
+
+    ASSERT_EQUALS(getNumSolutions(), 1U);
+    assertSolutionExists(
+        "{fetch: {filter: {y: 10}, node: {skipScan: {pattern: {x: 1, y: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedWithIndexedSolution) {
+    addIndex(BSON("x" << 1 << "y" << 1));
+    addIndex(BSON("y" << 1));
+    runQuery(fromjson("{ y: 10}"));
+
+    ASSERT_EQUALS(getNumSolutions(), 2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {y: 10}}}");
+    assertSolutionExists("{fetch: {filter: null, node: {ixscan: {pattern: {y: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedWithSparseIndex) {
+    // false means not multikey, true means sparse
+    addIndex(BSON("x" << 1 << "y" << 1), false, true);
+    runQuery(fromjson("{ y: 10}"));
+
     ASSERT_EQUALS(getNumSolutions(), 1U);
     assertSolutionExists("{cscan: {dir: 1, filter: {y: 10}}}");
 }
 
+TEST_F(QueryPlannerTest, SkipScanNotUsedWithoutTrailingPredicate) {
+    addIndex(BSON("x" << 1 << "y" << 1));
+    runQuery(fromjson("{ z: 10}"));
+
+    ASSERT_EQUALS(getNumSolutions(), 1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {z: 10}}}");
+}
+
 //
 // $in
 //
@@ -4016,4 +4114,57 @@ TEST_F(QueryPlannerTest, NToReturnHackWithSingleBatch) {
         "{cscan: {dir:1, filter: {}}}}}}}");
 }
 
+//
+// Planning with an arena
+//
+
+TEST_F(QueryPlannerTest, PlanningReusesArenaMemory) {
+    params.options = QueryPlannerParams::INDEX_INTERSECTION;
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("a" << 1 << "b" << 1));
+    addIndex(BSON("b" << 1));
+    addIndex(BSON("c" << 1));
+    addIndex(BSON("d" << 1 << "e" << 1));
+
+    const std::vector<BSONObj> queries = {
+        fromjson("{a: 1}"),
+        fromjson("{a: 1, b: {$gt: 2}}"),
+        fromjson("{$or: [{a: 1}, {b: 2}, {c: {$in: [3, 4]}}]}"),
+        fromjson("{a: {$elemMatch: {b: 1, c: 2}}, d: 3, e: {$lt: 4}}"),
+        fromjson("{$and: [{a: 1}, {$or: [{b: 1}, {c: 2}]}, {d: {$exists: true}}]}"),
+    };
+    const int kRounds = 200;
+
+    auto planAll = [&]() {
+        Timer timer;
+        for (int round = 0; round < kRounds; ++round) {
+            for (const auto& query : queries) {
+                runQuery(query);
+                ASSERT_GREATER_THAN(getNumSolutions(), 0U);
+            }
+        }
+        return timer.micros();
+    };
+
+    const long long heapMicros = planAll();
+
+    Arena arena;
+    params.arena = &arena;
+    for (const auto& query : queries) {
+        runQuery(query);
+    }
+    const Arena::Stats firstRound = arena.stats();
+    ASSERT_GREATER_THAN(firstRound.allocations, 0U);
+
+    // Later plans reuse the memory released by earlier ones rather than taking more.
+    const long long arenaMicros = planAll();
+    ASSERT_EQUALS(firstRound.chunksAllocated, arena.stats().chunksAllocated);
+    ASSERT_EQUALS(firstRound.bytesReserved, arena.stats().bytesReserved);
+
+    unittest::log() << "planned " << kRounds * queries.size() << " queries in " << heapMicros
+                    << "us without an operation arena, " << arenaMicros << "us with one ("
+                    << arena.stats().allocations << " arena allocations, "
+                    << arena.stats().bytesReserved << " bytes reserved)";
+}
+
 }  // namespace
@@ -270,6 +270,38 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
             return false;
         }
         return filterMatches(filter.Obj(), trueSoln);
+    } else if (STAGE_SKIP_SCAN == trueSoln->getType()) {
+        const SkipScanNode* ssn = static_cast<const SkipScanNode*>(trueSoln);
+        BSONElement el = testSoln["skipScan"];
+        if (el.eoo() || !el.isABSONObj()) {
+            return false;
+        }
+        BSONObj skipScanObj = el.Obj();
+
+        BSONElement pattern = skipScanObj["pattern"];
+        if (pattern.eoo() || !pattern.isABSONObj()) {
+            return false;
+        }
+        if (pattern.Obj() != ssn->indexKeyPattern) {
+            return false;
+        }
+
+        BSONElement bounds = skipScanObj["bounds"];
+        if (!bounds.eoo()) {
+            if (!bounds.isABSONObj()) {
+                return false;
+            } else if (!boundsMatch(bounds.Obj(), ssn->bounds)) {
+                return false;
+            }
+        }
+
+        BSONElement dir = skipScanObj["dir"];
+        if (!dir.eoo() && NumberInt == dir.type()) {
+            if (dir.numberInt() != ssn->direction) {
+                return false;
+            }
+        }
+        return true;
     } else if (STAGE_GEO_NEAR_2D == trueSoln->getType()) {
         const GeoNear2DNode* node = static_cast<const GeoNear2DNode*>(trueSoln);
         BSONElement el = testSoln["geoNear2d"];
@@ -890,6 +890,56 @@ QuerySolutionNode* DistinctNode::clone() const {
     return copy;
 }
 
+//
+// SkipScanNode
+//
+
+void SkipScanNode::computeProperties() {
+    sorts.clear();
+
+    // Keys come back in index order, so the output is sorted by the key pattern and each of its
+    // prefixes.
+    BSONObj sortPattern = QueryPlannerAnalysis::getSortPattern(indexKeyPattern);
+    if (direction == -1) {
+        sortPattern = QueryPlannerCommon::reverseSortObj(sortPattern);
+    }
+
+    const int nFields = sortPattern.nFields();
+    for (int i = 0; i < nFields; ++i) {
+        // Make obj out of fields [0,i]
+        BSONObjIterator it(sortPattern);
+        BSONObjBuilder prefixBob;
+        for (int j = 0; j <= i; ++j) {
+            prefixBob.append(it.next());
+        }
+        sorts.insert(prefixBob.obj());
+    }
+}
+
+void SkipScanNode::appendToString(mongoutils::str::stream* ss, int indent) const {
+    addIndent(ss, indent);
+    *ss << "SKIP_SCAN\n";
+    addIndent(ss, indent + 1);
+    *ss << "keyPattern = " << indexKeyPattern << '\n';
+    addIndent(ss, indent + 1);
+    *ss << "direction = " << direction << '\n';
+    addIndent(ss, indent + 1);
+    *ss << "bounds = " << bounds.toString() << '\n';
+    addCommon(ss, indent);
+}
+
+QuerySolutionNode* SkipScanNode::clone() const {
+    SkipScanNode* copy = new SkipScanNode();
+    cloneBaseData(copy);
+
+    copy->sorts = this->sorts;
+    copy->indexKeyPattern = this->indexKeyPattern;
+    copy->direction = this->direction;
+    copy->bounds = this->bounds;
+
+    return copy;
+}
+
 //
 // CountNode
 //
@@ -899,6 +949,11 @@ void CountNode::appendToString(mongoutils::str::stream* ss, int indent) const {
     *ss << "COUNT\n";
     addIndent(ss, indent + 1);
     *ss << "keyPattern = " << indexKeyPattern << '\n';
+    if (!bounds.fields.empty()) {
+        addIndent(ss, indent + 1);
+        *ss << "bounds = " << bounds.toString() << '\n';
+        return;
+    }
     addIndent(ss, indent + 1);
     *ss << "startKey = " << startKey << '\n';
     addIndent(ss, indent + 1);
@@ -915,6 +970,8 @@ QuerySolutionNode* CountNode::clone() const {
     copy->startKeyInclusive = this->startKeyInclusive;
     copy->endKey = this->endKey;
     copy->endKeyInclusive = this->endKeyInclusive;
+    copy->bounds = this->bounds;
+    copy->direction = this->direction;
 
     return copy;
 }
@@ -876,12 +876,51 @@ struct DistinctNode : public QuerySolutionNode {
     int fieldNo;
 };
 
+/**
+ * Scans a compound index whose leading fields are unconstrained, seeking from each value of
+ * those fields to the range of keys matching the predicates on the later fields.
+ */
+struct SkipScanNode : public QuerySolutionNode {
+    SkipScanNode() : direction(1) {}
+    virtual ~SkipScanNode() {}
+
+    virtual void computeProperties();
+
+    virtual StageType getType() const {
+        return STAGE_SKIP_SCAN;
+    }
+    virtual void appendToString(mongoutils::str::stream* ss, int indent) const;
+
+    // The planner always puts a FETCH with the full query filter above this node, so we don't
+    // try to provide covered key data.
+    bool fetched() const {
+        return false;
+    }
+    bool hasField(const std::string& field) const {
+        return false;
+    }
+    bool sortedByDiskLoc() const {
+        return false;
+    }
+    const BSONObjSet& getSort() const {
+        return sorts;
+    }
+
+    QuerySolutionNode* clone() const;
+
+    BSONObjSet sorts;
+
+    BSONObj indexKeyPattern;
+    int direction;
+    IndexBounds bounds;
+};
+
 /**
  * Some count queries reduce to counting how many keys are between two entries in a
  * Btree.
  */
 struct CountNode : public QuerySolutionNode {
-    CountNode() {}
+    CountNode() : direction(1) {}
     virtual ~CountNode() {}
 
     virtual StageType getType() const {
@@ -913,6 +952,10 @@ struct CountNode : public QuerySolutionNode {
 
     BSONObj endKey;
     bool endKeyInclusive;
+
+    // Set instead of the start and end keys when the count spans more than one interval.
+    IndexBounds bounds;
+    int direction;
 };
 
 }  // namespace mongo
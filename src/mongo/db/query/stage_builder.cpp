@@ -50,6 +50,7 @@
 #include "mongo/db/exec/sort.h"
 #include "mongo/db/exec/sort_key_generator.h"
 #include "mongo/db/exec/skip.h"
+#include "mongo/db/exec/skip_scan.h"
 #include "mongo/db/exec/text.h"
 #include "mongo/db/index/fts_access_method.h"
 #include "mongo/db/catalog/collection.h"
@@ -324,6 +325,26 @@ PlanStage* buildStages(OperationContext* txn,
         params.bounds = dn->bounds;
         params.fieldNo = dn->fieldNo;
         return new DistinctScan(txn, params, ws);
+    } else if (STAGE_SKIP_SCAN == root->getType()) {
+        const SkipScanNode* ssn = static_cast<const SkipScanNode*>(root);
+
+        if (NULL == collection) {
+            warning() << "Can't skip-scan null namespace";
+            return NULL;
+        }
+
+        SkipScanParams params;
+
+        params.descriptor =
+            collection->getIndexCatalog()->findIndexByKeyPattern(txn, ssn->indexKeyPattern);
+        if (params.descriptor == NULL) {
+            warning() << "Can't find index " << ssn->indexKeyPattern.toString() << "in namespace "
+                      << collection->ns() << endl;
+            return NULL;
+        }
+        params.direction = ssn->direction;
+        params.bounds = ssn->bounds;
+        return new SkipScan(txn, params, ws);
     } else if (STAGE_COUNT_SCAN == root->getType()) {
         const CountNode* cn = static_cast<const CountNode*>(root);
 
@@ -340,6 +361,8 @@ PlanStage* buildStages(OperationContext* txn,
         params.startKeyInclusive = cn->startKeyInclusive;
         params.endKey = cn->endKey;
         params.endKeyInclusive = cn->endKeyInclusive;
+        params.bounds = cn->bounds;
+        params.direction = cn->direction;
 
         return new CountScan(txn, params, ws);
     } else {
@@ -89,6 +89,11 @@ enum StageType {
     STAGE_QUEUED_DATA,
     STAGE_SHARDING_FILTER,
     STAGE_SKIP,
+
+    // Scans a compound index whose leading fields are unconstrained, seeking from one value of
+    // those fields to the next rather than examining every key.
+    STAGE_SKIP_SCAN,
+
     STAGE_SORT,
     STAGE_SORT_KEY_GENERATOR,
     STAGE_SORT_MERGE,
@@ -179,9 +179,13 @@ RangeDeleter::~RangeDeleter() {
     }
 }
 
-void RangeDeleter::startWorkers() {
-    if (!_worker) {
-        _worker.reset(new stdx::thread(stdx::bind(&RangeDeleter::doWork, this)));
+void RangeDeleter::startWorkers(size_t numWorkers) {
+    if (!_workers.empty()) {
+        return;
+    }
+
+    for (size_t i = 0; i < numWorkers; i++) {
+        _workers.emplace_back(new stdx::thread(stdx::bind(&RangeDeleter::doWork, this, i)));
     }
 }
 
@@ -191,8 +195,8 @@ void RangeDeleter::stopWorkers() {
         _stopRequested = true;
     }
 
-    if (_worker) {
-        _worker->join();
+    for (auto& worker : _workers) {
+        worker->join();
     }
 
     stdx::unique_lock<stdx::mutex> sl(_queueMutex);
@@ -424,8 +428,9 @@ BSONObj RangeDeleter::toBSON() const {
     return builder.obj();
 }
 
-void RangeDeleter::doWork() {
-    Client::initThreadIfNotAlready("RangeDeleter");
+void RangeDeleter::doWork(size_t workerNum) {
+    const string threadName = str::stream() << "RangeDeleter-" << workerNum;
+    Client::initThreadIfNotAlready(threadName.c_str());
     Client* client = &cc();
 
     while (!inShutdown() && !stopRequested()) {
@@ -435,7 +440,7 @@ void RangeDeleter::doWork() {
 
         {
             stdx::unique_lock<stdx::mutex> sl(_queueMutex);
-            while (_taskQueue.empty()) {
+            while (!(nextTask = takeNextTask_inlock())) {
                 _taskQueueNotEmptyCV.wait_for(sl,
                                               stdx::chrono::milliseconds(kNotEmptyTimeoutMillis));
 
@@ -444,50 +449,47 @@ void RangeDeleter::doWork() {
                     return;
                 }
 
-                if (_taskQueue.empty()) {
-                    // Try to check if some deletes are ready and move them to the
-                    // ready queue.
-
-                    TaskList::iterator iter = _notReadyQueue.begin();
-                    while (iter != _notReadyQueue.end()) {
-                        RangeDeleteEntry* entry = *iter;
-
-                        set<CursorId> cursorsNow;
-                        if (entry->options.waitForOpenCursors) {
-                            auto txn = client->makeOperationContext();
-                            _env->getCursorIds(txn.get(), entry->options.range.ns, &cursorsNow);
-                        }
-
-                        set<CursorId> cursorsLeft;
-                        std::set_intersection(entry->cursorsToWait.begin(),
-                                              entry->cursorsToWait.end(),
-                                              cursorsNow.begin(),
-                                              cursorsNow.end(),
-                                              std::inserter(cursorsLeft, cursorsLeft.end()));
-
-                        entry->cursorsToWait.swap(cursorsLeft);
-
-                        if (entry->cursorsToWait.empty()) {
-                            (*iter)->stats.queueEndTS = jsTime();
-                            _taskQueue.push_back(*iter);
-                            _taskQueueNotEmptyCV.notify_one();
-                            iter = _notReadyQueue.erase(iter);
-                        } else {
-                            logCursorsWaiting(entry);
-                            ++iter;
-                        }
+                // Try to check if some deletes are ready and move them to the
+                // ready queue.
+
+                TaskList::iterator iter = _notReadyQueue.begin();
+                while (iter != _notReadyQueue.end()) {
+                    RangeDeleteEntry* entry = *iter;
+
+                    set<CursorId> cursorsNow;
+                    if (entry->options.waitForOpenCursors) {
+                        auto txn = client->makeOperationContext();
+                        _env->getCursorIds(txn.get(), entry->options.range.ns, &cursorsNow);
+                    }
+
+                    set<CursorId> cursorsLeft;
+                    std::set_intersection(entry->cursorsToWait.begin(),
+                                          entry->cursorsToWait.end(),
+                                          cursorsNow.begin(),
+                                          cursorsNow.end(),
+                                          std::inserter(cursorsLeft, cursorsLeft.end()));
+
+                    entry->cursorsToWait.swap(cursorsLeft);
+
+                    if (entry->cursorsToWait.empty()) {
+                        (*iter)->stats.queueEndTS = jsTime();
+                        _taskQueue.push_back(*iter);
+                        _taskQueueNotEmptyCV.notify_one();
+                        iter = _notReadyQueue.erase(iter);
+                    } else {
+                        logCursorsWaiting(entry);
+                        ++iter;
                     }
                 }
             }
 
             if (stopRequested()) {
+                _taskQueue.push_front(nextTask);
+                _workerNamespaces.erase(nextTask->options.range.ns);
                 log() << "stopping range deleter worker" << endl;
                 return;
             }
 
-            nextTask = _taskQueue.front();
-            _taskQueue.pop_front();
-
             _deletesInProgress++;
         }
 
@@ -518,8 +520,12 @@ void RangeDeleter::doWork() {
                               nextTask->options.range.minKey,
                               nextTask->options.range.maxKey);
             deletePtrElement(&_deleteSet, &setEntry);
+            _workerNamespaces.erase(nextTask->options.range.ns);
             _deletesInProgress--;
 
+            // Another worker may be waiting for a task on the namespace this one is done with.
+            _taskQueueNotEmptyCV.notify_all();
+
             if (nextTask->notifyDone) {
                 nextTask->notifyDone->notifyOne();
             }
@@ -531,6 +537,22 @@ void RangeDeleter::doWork() {
     }
 }
 
+RangeDeleteEntry* RangeDeleter::takeNextTask_inlock() {
+    for (TaskList::iterator it = _taskQueue.begin(); it != _taskQueue.end(); ++it) {
+        const string& ns = (*it)->options.range.ns;
+        if (_workerNamespaces.count(ns) > 0) {
+            continue;
+        }
+
+        RangeDeleteEntry* task = *it;
+        _taskQueue.erase(it);
+        _workerNamespaces.insert(ns);
+        return task;
+    }
+
+    return NULL;
+}
+
 bool RangeDeleter::canEnqueue_inlock(StringData ns,
                                      const BSONObj& min,
                                      const BSONObj& max,
@@ -61,9 +61,11 @@ struct RangeDeleterOptions;
  *
  * Threading assumptions:
  *
- *   This class has (currently) one worker thread attacking the queue, one
- *   job at a time. If we want an immediate deletion, that job is going to
- *   be performed on the thread that is requesting it.
+ *   This class has a configurable number of worker threads attacking the queue,
+ *   each one job at a time. Two workers never delete from the same namespace at
+ *   the same time, so a worker skips over queued jobs for a namespace that is
+ *   already being worked on. If we want an immediate deletion, that job is going
+ *   to be performed on the thread that is requesting it.
  *
  *   All calls regarding deletion are synchronized.
  *
@@ -96,15 +98,15 @@ public:
     //
 
     /**
-     * Starts the background thread to work on this queue. Does nothing if the worker
-     * thread is already active.
+     * Starts 'numWorkers' background threads to work on this queue. Does nothing if the
+     * worker threads are already active.
      *
      * This call is _not_ thread safe and must be issued before any other call.
      */
-    void startWorkers();
+    void startWorkers(size_t numWorkers = 1);
 
     /**
-     * Stops the background thread working on this queue. This will block if there are
+     * Stops the background threads working on this queue. This will block if there are
      * tasks that are being deleted, but will leave the pending tasks in the queue.
      *
      * Steps:
@@ -184,8 +186,14 @@ private:
 
     typedef std::set<NSMinMax*, NSMinMaxCmp> NSMinMaxSet;  // owned here
 
-    /** Body of the worker thread */
-    void doWork();
+    /** Body of the worker threads */
+    void doWork(size_t workerNum);
+
+    /**
+     * Removes from _taskQueue and returns the first task whose namespace no other worker
+     * is deleting from, or returns NULL if there is none.
+     */
+    RangeDeleteEntry* takeNextTask_inlock();
 
     /** Returns true if the range doesn't intersect with one other range */
     bool canEnqueue_inlock(StringData ns,
@@ -199,7 +207,7 @@ private:
     std::unique_ptr<RangeDeleterEnv> _env;
 
     // Initially not active. Must be started explicitly.
-    std::unique_ptr<stdx::thread> _worker;
+    std::vector<std::unique_ptr<stdx::thread>> _workers;
 
     // Protects _stopRequested.
     mutable stdx::mutex _stopMutex;
@@ -238,6 +246,10 @@ private:
     // Keeps track of number of tasks that are in progress, including the inline deletes.
     size_t _deletesInProgress;
 
+    // Namespaces that a worker thread is currently deleting from. Does not include the
+    // inline deletes.
+    std::set<std::string> _workerNamespaces;
+
     // Protects _statsHistory
     mutable stdx::mutex _statsHistoryMutex;
     std::deque<DeleteJobStats*> _statsHistory;
@@ -32,6 +32,9 @@
 
 namespace mongo {
 
+// The number of worker threads the global deleter is started with.
+extern int rangeDeleterWorkers;
+
 /**
  * Gets the global instance of the deleter and starts it.
  */
@@ -40,6 +40,7 @@
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -362,5 +363,100 @@ TEST(MixedDeletes, MultipleDeletes) {
     deleter.stopWorkers();
 }
 
+// Workers should delete ranges from different namespaces at the same time.
+TEST(MultipleWorkers, DeleteDifferentNamespacesConcurrently) {
+    const string ns1("test.user1");
+    const string ns2("test.user2");
+
+    RangeDeleterMockEnv* env = new RangeDeleterMockEnv();
+    RangeDeleter deleter(env);
+
+    std::unique_ptr<mongo::repl::ReplicationCoordinatorMock> mock(
+        new mongo::repl::ReplicationCoordinatorMock(replSettings));
+
+    mongo::repl::ReplicationCoordinator::set(mongo::getGlobalServiceContext(), std::move(mock));
+
+    deleter.startWorkers(2);
+    env->pauseDeletes();
+
+    Notification notifyDone1;
+    RangeDeleterOptions deleterOption1(
+        KeyRange(ns1, BSON("x" << 0), BSON("x" << 10), BSON("x" << 1)));
+    ASSERT_TRUE(
+        deleter.queueDelete(noTxn, deleterOption1, &notifyDone1, NULL /* don't care errMsg */));
+
+    Notification notifyDone2;
+    RangeDeleterOptions deleterOption2(
+        KeyRange(ns2, BSON("x" << 0), BSON("x" << 10), BSON("x" << 1)));
+    ASSERT_TRUE(
+        deleter.queueDelete(noTxn, deleterOption2, &notifyDone2, NULL /* don't care errMsg */));
+
+    // Both deletes are paused inside the environment at the same time.
+    env->waitForNthPausedDelete(2u);
+    ASSERT_EQUALS(2U, deleter.getDeletesInProgress());
+    ASSERT_EQUALS(0U, deleter.getPendingDeletes());
+
+    // Let one delete finish before resuming the other, since a resume wakes only one of the
+    // paused deletes and the woken one pauses the environment again.
+    env->resumeOneDelete();
+    while (!env->deleteOccured()) {
+        sleepmillis(1);
+    }
+    env->resumeOneDelete();
+    notifyDone1.waitToBeNotified();
+    notifyDone2.waitToBeNotified();
+
+    deleter.stopWorkers();
+}
+
+// Workers should not delete two ranges from the same namespace at the same time.
+TEST(MultipleWorkers, DeleteSameNamespaceInTurn) {
+    const string ns("test.user");
+
+    RangeDeleterMockEnv* env = new RangeDeleterMockEnv();
+    RangeDeleter deleter(env);
+
+    std::unique_ptr<mongo::repl::ReplicationCoordinatorMock> mock(
+        new mongo::repl::ReplicationCoordinatorMock(replSettings));
+
+    mongo::repl::ReplicationCoordinator::set(mongo::getGlobalServiceContext(), std::move(mock));
+
+    deleter.startWorkers(2);
+    env->pauseDeletes();
+
+    Notification notifyDone1;
+    RangeDeleterOptions deleterOption1(
+        KeyRange(ns, BSON("x" << 0), BSON("x" << 10), BSON("x" << 1)));
+    ASSERT_TRUE(
+        deleter.queueDelete(noTxn, deleterOption1, &notifyDone1, NULL /* don't care errMsg */));
+
+    env->waitForNthPausedDelete(1u);
+
+    Notification notifyDone2;
+    RangeDeleterOptions deleterOption2(
+        KeyRange(ns, BSON("x" << 10), BSON("x" << 20), BSON("x" << 1)));
+    ASSERT_TRUE(
+        deleter.queueDelete(noTxn, deleterOption2, &notifyDone2, NULL /* don't care errMsg */));
+
+    // The idle worker must leave the second range queued while the first is in progress.
+    ASSERT_EQUALS(1U, deleter.getDeletesInProgress());
+    ASSERT_EQUALS(1U, deleter.getPendingDeletes());
+
+    env->resumeOneDelete();
+    notifyDone1.waitToBeNotified();
+
+    env->waitForNthPausedDelete(2u);
+    DeletedRange deleted1(env->getLastDelete());
+    ASSERT_TRUE(deleted1.min.equal(BSON("x" << 0)));
+
+    env->resumeOneDelete();
+    notifyDone2.waitToBeNotified();
+
+    DeletedRange deleted2(env->getLastDelete());
+    ASSERT_TRUE(deleted2.min.equal(BSON("x" << 10)));
+
+    deleter.stopWorkers();
+}
+
 }  // unnamed namespace
 }  // namespace mongo
@@ -35,6 +35,8 @@
 
 #include <boost/functional/hash.hpp>
 #include <memory>
+#include <queue>
+#include <set>
 #include "third_party/murmurhash3/MurmurHash3.h"
 
 #include "mongo/base/counter.h"
@@ -45,6 +47,7 @@
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/commands/fsync.h"
 #include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
@@ -60,6 +63,7 @@
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
+#include "mongo/platform/unordered_map.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -315,8 +319,47 @@ void applyOps(const std::vector<std::vector<BSONObj>>& writerVectors,
     writerPool->join();
 }
 
+/**
+ * Returns the namespaces among those written by "ops" which are capped collections.
+ */
+std::set<std::string> getCappedNamespaces(OperationContext* txn, const std::deque<BSONObj>& ops) {
+    std::set<std::string> namespaces;
+    for (std::deque<BSONObj>::const_iterator it = ops.begin(); it != ops.end(); ++it) {
+        namespaces.insert(it->getField("ns").str());
+    }
+
+    std::set<std::string> cappedNamespaces;
+    ScopedTransaction transaction(txn, MODE_IS);
+    for (std::set<std::string>::const_iterator it = namespaces.begin(); it != namespaces.end();
+         ++it) {
+        const std::string& ns = *it;
+        if (ns.empty()) {
+            continue;
+        }
+        Lock::DBLock dbLock(txn->lockState(), nsToDatabaseSubstring(ns), MODE_IS);
+        Lock::CollectionLock collLock(txn->lockState(), ns, MODE_IS);
+        Database* db = dbHolder().get(txn, ns);
+        Collection* collection = db ? db->getCollection(ns) : nullptr;
+        if (collection && collection->isCapped()) {
+            cappedNamespaces.insert(ns);
+        }
+    }
+    return cappedNamespaces;
+}
+
+}  // namespace
+
 void fillWriterVectors(const std::deque<BSONObj>& ops,
+                       bool supportsDocLocking,
+                       const std::set<std::string>& cappedNamespaces,
                        std::vector<std::vector<BSONObj>>* writerVectors) {
+    invariant(!writerVectors->empty());
+
+    // Group the ops into chains of ops that must be applied in order relative to each other,
+    // keeping oplog order within each chain. Ops sharing a key, including ones whose keys merely
+    // collide, end up in the same chain, which is always safe.
+    unordered_map<uint32_t, size_t> chainForKey;
+    std::vector<std::vector<BSONObj>> chains;
     for (std::deque<BSONObj>::const_iterator it = ops.begin(); it != ops.end(); ++it) {
         const BSONElement e = it->getField("ns");
         verify(e.type() == String);
@@ -327,8 +370,9 @@ void fillWriterVectors(const std::deque<BSONObj>& ops,
 
         const char* opType = it->getField("op").valuestrsafe();
 
-        if (getGlobalServiceContext()->getGlobalStorageEngine()->supportsDocLocking() &&
-            isCrudOpType(opType)) {
+        // Inserts into a capped collection must be applied in oplog order, so that its natural
+        // order and the documents it rolls over match the primary.
+        if (supportsDocLocking && isCrudOpType(opType) && !cappedNamespaces.count(e.str())) {
             BSONElement id;
             switch (opType[0]) {
                 case 'u':
@@ -344,11 +388,45 @@ void fillWriterVectors(const std::deque<BSONObj>& ops,
             MurmurHash3_x86_32(&idHash, sizeof(idHash), hash, &hash);
         }
 
-        (*writerVectors)[hash % writerVectors->size()].push_back(*it);
+        auto chain = chainForKey.find(hash);
+        if (chain == chainForKey.end()) {
+            chain = chainForKey.insert(std::make_pair(hash, chains.size())).first;
+            chains.emplace_back();
+        }
+        chains[chain->second].push_back(*it);
     }
-}
 
-}  // namespace
+    // Hand out the longest chains first, each to the writer with the fewest ops so far, so that
+    // independent ops on a single hot collection keep every writer equally busy.
+    std::vector<size_t> order(chains.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(),
+                     order.end(),
+                     [&chains](size_t lhs, size_t rhs) {
+                         return chains[lhs].size() > chains[rhs].size();
+                     });
+
+    // Pairs of (number of ops assigned, writer index), least loaded writer on top.
+    typedef std::pair<size_t, size_t> WriterLoad;
+    std::priority_queue<WriterLoad, std::vector<WriterLoad>, std::greater<WriterLoad>> writers;
+    for (size_t i = 0; i < writerVectors->size(); ++i) {
+        writers.push(WriterLoad(0, i));
+    }
+
+    for (std::vector<size_t>::const_iterator it = order.begin(); it != order.end(); ++it) {
+        std::vector<BSONObj>& chain = chains[*it];
+        WriterLoad writer = writers.top();
+        writers.pop();
+
+        std::vector<BSONObj>& writerVector = (*writerVectors)[writer.second];
+        writerVector.insert(writerVector.end(), chain.begin(), chain.end());
+
+        writer.first += chain.size();
+        writers.push(writer);
+    }
+}
 
 // Doles out all the work to the writer pool threads and waits for them to complete
 // static
@@ -371,7 +449,14 @@ OpTime SyncTail::multiApply(OperationContext* txn,
 
     std::vector<std::vector<BSONObj>> writerVectors(replWriterThreadCount);
 
-    fillWriterVectors(ops.getDeque(), &writerVectors);
+    const bool supportsDocLocking =
+        getGlobalServiceContext()->getGlobalStorageEngine()->supportsDocLocking();
+    std::set<std::string> cappedNamespaces;
+    if (supportsDocLocking) {
+        cappedNamespaces = getCappedNamespaces(txn, ops.getDeque());
+    }
+
+    fillWriterVectors(ops.getDeque(), supportsDocLocking, cappedNamespaces, &writerVectors);
     LOG(2) << "replication batch size is " << ops.getDeque().size() << endl;
     // We must grab this because we're going to grab write locks later.
     // We hold this mutex the entire time we're writing; it doesn't matter
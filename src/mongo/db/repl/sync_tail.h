@@ -29,6 +29,9 @@
 #pragma once
 
 #include <deque>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobj.h"
@@ -202,5 +205,21 @@ private:
 void multiSyncApply(const std::vector<BSONObj>& ops, SyncTail* st);
 void multiInitialSyncApply(const std::vector<BSONObj>& ops, SyncTail* st);
 
+/**
+ * Distributes a batch of ops among "writerVectors", one vector per writer thread.
+ *
+ * Ops which must be applied in order relative to each other always go to the same writer, in
+ * oplog order: ops on the same namespace and _id if the storage engine supports document
+ * locking, and any ops on the same namespace otherwise or if the namespace is in
+ * "cappedNamespaces". Independent chains of ops are balanced across the writers by op count.
+ *
+ * Commands and index builds are not scheduled here; they are always applied in a batch of
+ * their own.
+ */
+void fillWriterVectors(const std::deque<BSONObj>& ops,
+                       bool supportsDocLocking,
+                       const std::set<std::string>& cappedNamespaces,
+                       std::vector<std::vector<BSONObj>>* writerVectors);
+
 }  // namespace repl
 }  // namespace mongo
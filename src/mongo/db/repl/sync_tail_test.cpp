@@ -357,4 +357,110 @@ TEST_F(SyncTailTest, SyncApplyCommandThrowsException) {
     ASSERT_EQUALS(1U, _opsApplied);
 }
 
+BSONObj makeInsertOp(StringData ns, int id) {
+    return BSON("op"
+                << "i"
+                << "ns" << ns << "o" << BSON("_id" << id));
+}
+
+BSONObj makeUpdateOp(StringData ns, int id) {
+    return BSON("op"
+                << "u"
+                << "ns" << ns << "o2" << BSON("_id" << id) << "o"
+                << BSON("$set" << BSON("x" << 1)));
+}
+
+// Returns the index of the writer vector holding "op", failing if it is not in exactly one.
+size_t findWriter(const std::vector<std::vector<BSONObj>>& writerVectors, const BSONObj& op) {
+    size_t found = writerVectors.size();
+    for (size_t i = 0; i < writerVectors.size(); ++i) {
+        for (const BSONObj& scheduled : writerVectors[i]) {
+            if (scheduled.objdata() == op.objdata()) {
+                ASSERT_EQUALS(writerVectors.size(), found);
+                found = i;
+            }
+        }
+    }
+    ASSERT_NOT_EQUALS(writerVectors.size(), found);
+    return found;
+}
+
+TEST(SyncTailFillWriterVectorsTest, IndependentInsertsOnOneCollectionAreBalanced) {
+    std::deque<BSONObj> ops;
+    for (int i = 0; i < 64; ++i) {
+        ops.push_back(makeInsertOp("test.t", i));
+    }
+    std::vector<std::vector<BSONObj>> writerVectors(8);
+    fillWriterVectors(ops, true, std::set<std::string>(), &writerVectors);
+    for (const auto& writerVector : writerVectors) {
+        ASSERT_EQUALS(8U, writerVector.size());
+    }
+}
+
+TEST(SyncTailFillWriterVectorsTest, OpsOnSameDocumentStayOrderedOnOneWriter) {
+    std::deque<BSONObj> ops;
+    for (int i = 0; i < 10; ++i) {
+        ops.push_back(makeInsertOp("test.t", i));
+    }
+    ops.push_back(makeUpdateOp("test.t", 3));
+    ops.push_back(makeUpdateOp("test.t", 3));
+
+    std::vector<std::vector<BSONObj>> writerVectors(4);
+    fillWriterVectors(ops, true, std::set<std::string>(), &writerVectors);
+
+    const size_t writer = findWriter(writerVectors, ops[3]);
+    ASSERT_EQUALS(writer, findWriter(writerVectors, ops[10]));
+    ASSERT_EQUALS(writer, findWriter(writerVectors, ops[11]));
+
+    std::vector<const char*> chain;
+    for (const BSONObj& op : writerVectors[writer]) {
+        if (op.objdata() == ops[3].objdata() || op.objdata() == ops[10].objdata() ||
+            op.objdata() == ops[11].objdata()) {
+            chain.push_back(op.objdata());
+        }
+    }
+    ASSERT_EQUALS(3U, chain.size());
+    ASSERT_EQUALS(ops[3].objdata(), chain[0]);
+    ASSERT_EQUALS(ops[10].objdata(), chain[1]);
+    ASSERT_EQUALS(ops[11].objdata(), chain[2]);
+}
+
+TEST(SyncTailFillWriterVectorsTest, CappedCollectionOpsAreSerialized) {
+    std::deque<BSONObj> ops;
+    for (int i = 0; i < 20; ++i) {
+        ops.push_back(makeInsertOp("test.capped", i));
+        ops.push_back(makeInsertOp("test.t", i));
+    }
+    std::set<std::string> cappedNamespaces;
+    cappedNamespaces.insert("test.capped");
+
+    std::vector<std::vector<BSONObj>> writerVectors(4);
+    fillWriterVectors(ops, true, cappedNamespaces, &writerVectors);
+
+    const size_t writer = findWriter(writerVectors, ops[0]);
+    int nextId = 0;
+    for (const BSONObj& op : writerVectors[writer]) {
+        if (op["ns"].String() == "test.capped") {
+            ASSERT_EQUALS(nextId++, op["o"]["_id"].numberInt());
+        }
+    }
+    ASSERT_EQUALS(20, nextId);
+}
+
+TEST(SyncTailFillWriterVectorsTest, WithoutDocLockingOpsAreGroupedByNamespace) {
+    std::deque<BSONObj> ops;
+    for (int i = 0; i < 10; ++i) {
+        ops.push_back(makeInsertOp("test.a", i));
+        ops.push_back(makeInsertOp("test.b", i));
+    }
+    std::vector<std::vector<BSONObj>> writerVectors(4);
+    fillWriterVectors(ops, false, std::set<std::string>(), &writerVectors);
+
+    const size_t writerA = findWriter(writerVectors, ops[0]);
+    const size_t writerB = findWriter(writerVectors, ops[1]);
+    ASSERT_NOT_EQUALS(writerA, writerB);
+    ASSERT_EQUALS(10U, writerVectors[writerA].size());
+    ASSERT_EQUALS(10U, writerVectors[writerB].size());
+}
+
 }  // namespace
@@ -47,6 +47,7 @@
 
 #include "mongo/db/sorter/sorter.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <snappy.h>
 
@@ -56,8 +57,11 @@
 #include "mongo/db/storage_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/s/mongos_options.h"
+#include "mongo/stdx/future.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/print.h"
 #include "mongo/util/unowned_ptr.h"
@@ -116,6 +120,39 @@ void dassertCompIsSane(const Comparator& comp, const Data& lhs, const Data& rhs)
 #endif
 }
 
+/**
+ * Returns the pool that all FileIterators read ahead on, so that the number of reader threads
+ * stays bounded however many runs are being merged. Reading ahead mostly waits on the disk, so
+ * the pool has at least two threads even on a single core. Idle threads are reaped. The pool is
+ * never destroyed, as iterators may be reading ahead until the process exits.
+ */
+inline ThreadPool* readAheadPool() {
+    static ThreadPool* const pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "SorterReadAhead";
+        options.minThreads = 0;
+        options.maxThreads = std::max(2u, stdx::thread::hardware_concurrency());
+        ThreadPool* pool = new ThreadPool(options);
+        pool->startup();
+        return pool;
+    }();
+    return pool;
+}
+
+/**
+ * Counts the reads ahead done on readAheadPool() by every sorter in the process.
+ */
+struct ReadAheadStats {
+    AtomicUInt64 numReads;        // Reads ahead run on the pool so far.
+    AtomicUInt64 numActive;       // Reads ahead running on the pool right now.
+    AtomicUInt64 maxNumActive;    // The most reads ahead ever running on the pool at once.
+};
+
+inline ReadAheadStats& readAheadStats() {
+    static ReadAheadStats stats;
+    return stats;
+}
+
 /** Ensures a named file is deleted when this object goes out of scope */
 class FileDeleter {
 public:
@@ -166,10 +203,16 @@ public:
                       typename Value::SorterDeserializeSettings> Settings;
     typedef std::pair<Key, Value> Data;
 
+    /**
+     * If readAhead is true, the next batch of blocks is read and decompressed on the shared
+     * readAheadPool() while the current batch is being consumed.
+     */
     FileIterator(const std::string& fileName,
                  const Settings& settings,
-                 std::shared_ptr<FileDeleter> fileDeleter)
+                 std::shared_ptr<FileDeleter> fileDeleter,
+                 bool readAhead = false)
         : _settings(settings),
+          _readAhead(readAhead),
           _done(false),
           _fileName(fileName),
           _fileDeleter(fileDeleter),
@@ -184,6 +227,12 @@ public:
                 boost::filesystem::file_size(_fileName) != 0);
     }
 
+    ~FileIterator() {
+        // An outstanding read ahead uses _file, so it must finish first.
+        if (_nextBlocks.valid())
+            _nextBlocks.wait();
+    }
+
     bool more() {
         if (!_done)
             fillIfNeeded();  // may change _done
@@ -202,6 +251,9 @@ public:
     }
 
 private:
+    // How many bytes of uncompressed blocks to read at once when reading ahead.
+    static const size_t kReadAheadBytes = 1024 * 1024;
+
     void fillIfNeeded() {
         verify(!_done);
 
@@ -210,64 +262,130 @@ private:
     }
 
     void fill() {
-        int32_t rawSize;
-        read(&rawSize, sizeof(rawSize));
-        if (_done)
+        if (_blocks.empty()) {
+            if (!_readAhead) {
+                std::string block;
+                if (readBlock(&block))
+                    _blocks.push_back(std::move(block));
+            } else {
+                _blocks = _nextBlocks.valid() ? _nextBlocks.get() : readBlocks();
+
+                // An empty batch means we hit EOF so there is nothing more to read ahead.
+                if (!_blocks.empty()) {
+                    _nextBlocks = scheduleReadBlocks();
+                }
+            }
+        }
+
+        if (_blocks.empty()) {
+            _done = true;
             return;
+        }
+
+        _buffer.swap(_blocks.front());
+        _blocks.pop_front();
+        _reader.reset(new BufReader(_buffer.data(), _buffer.size()));
+    }
+
+    // Runs readBlocks() on the read ahead pool, or on this thread if the pool will not take it.
+    stdx::future<std::deque<std::string>> scheduleReadBlocks() {
+        auto task = std::make_shared<stdx::packaged_task<std::deque<std::string>()>>(
+            [this] { return readBlocks(); });
+        stdx::future<std::deque<std::string>> result = task->get_future();
+        auto runOnPool = [task] {
+            ReadAheadStats& stats = readAheadStats();
+            stats.numReads.fetchAndAdd(1);
+            const unsigned long long numActive = stats.numActive.addAndFetch(1);
+            unsigned long long maxNumActive = stats.maxNumActive.load();
+            while (numActive > maxNumActive) {
+                const unsigned long long seen =
+                    stats.maxNumActive.compareAndSwap(maxNumActive, numActive);
+                if (seen == maxNumActive)
+                    break;
+                maxNumActive = seen;
+            }
+
+            (*task)();
+            stats.numActive.subtractAndFetch(1);
+        };
+        if (!readAheadPool()->schedule(runOnPool).isOK())
+            (*task)();
+        return result;
+    }
+
+    // Reads blocks until at least kReadAheadBytes have been read or EOF is hit.
+    // Only touches _file so it may run on another thread while _blocks is being consumed.
+    std::deque<std::string> readBlocks() {
+        std::deque<std::string> blocks;
+        size_t bytesRead = 0;
+        std::string block;
+        while (bytesRead < kReadAheadBytes && readBlock(&block)) {
+            bytesRead += block.size();
+            blocks.push_back(std::move(block));
+            block.clear();
+        }
+        return blocks;
+    }
+
+    // Reads and decompresses a single block into out. Returns false on EOF.
+    bool readBlock(std::string* out) {
+        int32_t rawSize;
+        if (!read(&rawSize, sizeof(rawSize)))
+            return false;
 
         // negative size means compressed
         const bool compressed = rawSize < 0;
         const int32_t blockSize = std::abs(rawSize);
 
-        _buffer.reset(new char[blockSize]);
-        read(_buffer.get(), blockSize);
-        massert(16816, "file too short?", !_done);
+        std::unique_ptr<char[]> rawBuffer(new char[blockSize]);
+        massert(16816, "file too short?", read(rawBuffer.get(), blockSize));
 
         if (!compressed) {
-            _reader.reset(new BufReader(_buffer.get(), blockSize));
-            return;
+            out->assign(rawBuffer.get(), blockSize);
+            return true;
         }
 
-        dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
+        dassert(snappy::IsValidCompressedBuffer(rawBuffer.get(), blockSize));
 
         size_t uncompressedSize;
         massert(17061,
                 "couldn't get uncompressed length",
-                snappy::GetUncompressedLength(_buffer.get(), blockSize, &uncompressedSize));
+                snappy::GetUncompressedLength(rawBuffer.get(), blockSize, &uncompressedSize));
 
-        std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
+        out->resize(uncompressedSize);
         massert(17062,
                 "decompression failed",
-                snappy::RawUncompress(_buffer.get(), blockSize, decompressionBuffer.get()));
-
-        // hold on to decompressed data and throw out compressed data at block exit
-        _buffer.swap(decompressionBuffer);
-        _reader.reset(new BufReader(_buffer.get(), uncompressedSize));
+                snappy::RawUncompress(rawBuffer.get(), blockSize, &(*out)[0]));
+        return true;
     }
 
-    // sets _done to true on EOF - asserts on any other error
-    void read(void* out, size_t size) {
+    // returns false on EOF - asserts on any other error
+    bool read(void* out, size_t size) {
         _file.read(reinterpret_cast<char*>(out), size);
         if (!_file.good()) {
-            if (_file.eof()) {
-                _done = true;
-                return;
-            }
+            if (_file.eof())
+                return false;
 
             msgasserted(16817,
                         str::stream() << "error reading file \"" << _fileName
                                       << "\": " << myErrnoWithDescription());
         }
         verify(_file.gcount() == static_cast<std::streamsize>(size));
+        return true;
     }
 
     const Settings _settings;
+    const bool _readAhead;
     bool _done;
-    std::unique_ptr<char[]> _buffer;
+    std::string _buffer;
     std::unique_ptr<BufReader> _reader;
+    std::deque<std::string> _blocks;  // decompressed blocks not yet handed to _reader
     std::string _fileName;
     std::shared_ptr<FileDeleter> _fileDeleter;  // Must outlive _file
     std::ifstream _file;
+
+    // The read ahead in progress, if any. Waited on by the destructor before _file is closed.
+    stdx::future<std::deque<std::string>> _nextBlocks;
 };
 
 /** Merge-sorts results from 0 or more FileIterators */
@@ -394,6 +512,73 @@ private:
     STLComparator _greater;                      // named so calls make sense
 };
 
+/**
+ * Merges iters, which are spilled runs in the order they were written, into a single Iterator.
+ *
+ * If there are more than opts.maxMergeFanIn runs, consecutive groups of maxMergeFanIn runs are
+ * first merged into intermediate files until few enough remain for the final merge. Up to
+ * opts.parallelism groups are merged concurrently. Since groups are consecutive and keep their
+ * relative order, equal elements still come out in the order they were added.
+ */
+template <typename Key, typename Value, typename Comparator>
+SortIteratorInterface<Key, Value>* mergeSpilledRuns(
+    std::vector<std::shared_ptr<SortIteratorInterface<Key, Value>>> iters,
+    const SortOptions& opts,
+    const Comparator& comp,
+    const typename Sorter<Key, Value>::Settings& settings) {
+    typedef SortIteratorInterface<Key, Value> Iterator;
+    typedef std::vector<std::shared_ptr<Iterator>> Runs;
+
+    const size_t fanIn = opts.maxMergeFanIn;
+    const size_t parallelism = std::max(opts.parallelism, 1u);
+
+    // Merging fewer than two runs at a time would never finish.
+    while (fanIn >= 2 && iters.size() > fanIn) {
+        std::vector<std::shared_ptr<Runs>> groups;
+        for (size_t i = 0; i < iters.size(); i += fanIn) {
+            const size_t end = std::min(i + fanIn, iters.size());
+            groups.push_back(std::make_shared<Runs>(iters.begin() + i, iters.begin() + end));
+        }
+        iters.clear();
+
+        // Merges a group into a new file. Clears the group so its input files are deleted as
+        // soon as they have been consumed.
+        const auto mergeGroup = [opts, comp, settings](std::shared_ptr<Runs> group)
+            -> std::shared_ptr<Iterator> {
+            if (group->size() == 1)
+                return group->front();
+
+            std::unique_ptr<Iterator> merged(Iterator::merge(*group, opts, comp));
+            SortedFileWriter<Key, Value> writer(opts, settings);
+            while (merged->more()) {
+                const typename Iterator::Data data = merged->next();
+                writer.addAlreadySorted(data.first, data.second);
+            }
+            merged.reset();
+            group->clear();
+            return std::shared_ptr<Iterator>(writer.done());
+        };
+
+        for (size_t wave = 0; wave < groups.size(); wave += parallelism) {
+            const size_t end = std::min(wave + parallelism, groups.size());
+            if (parallelism == 1) {
+                iters.push_back(mergeGroup(groups[wave]));
+                continue;
+            }
+
+            std::vector<stdx::future<std::shared_ptr<Iterator>>> merges;
+            for (size_t i = wave; i < end; i++) {
+                merges.push_back(stdx::async(stdx::launch::async, mergeGroup, groups[i]));
+            }
+            for (size_t i = 0; i < merges.size(); i++) {
+                iters.push_back(merges[i].get());
+            }
+        }
+    }
+
+    return Iterator::merge(iters, opts, comp);
+}
+
 template <typename Key, typename Value, typename Comparator>
 class NoLimitSorter : public Sorter<Key, Value> {
 public:
@@ -405,7 +590,11 @@ public:
     NoLimitSorter(const SortOptions& opts,
                   const Comparator& comp,
                   const Settings& settings = Settings())
-        : _comp(comp), _settings(settings), _opts(opts), _memUsed(0) {
+        : _comp(comp),
+          _settings(settings),
+          _opts(opts),
+          _spillThreshold(opts.maxMemoryUsageBytes / std::max(opts.parallelism, 1u)),
+          _memUsed(0) {
         verify(_opts.limit == 0);
     }
 
@@ -415,23 +604,26 @@ public:
         _memUsed += key.memUsageForSorter();
         _memUsed += val.memUsageForSorter();
 
-        if (_memUsed > _opts.maxMemoryUsageBytes)
+        if (_memUsed > _spillThreshold)
             spill();
     }
 
     Iterator* done() {
-        if (_iters.empty()) {
+        if (_iters.empty() && _pendingSpills.empty()) {
             sort();
             return new InMemIterator<Key, Value>(_data);
         }
 
         spill();
-        return Iterator::merge(_iters, _opts, _comp);
+        while (!_pendingSpills.empty()) {
+            finishOldestSpill();
+        }
+        return mergeSpilledRuns(_iters, _opts, _comp, _settings);
     }
 
     // TEMP these are here for compatibility. Will be replaced with a general stats API
     int numFiles() const {
-        return _iters.size();
+        return _iters.size() + _pendingSpills.size();
     }
     size_t memUsed() const {
         return _memUsed;
@@ -459,6 +651,23 @@ private:
         // std::sort(_data.begin(), _data.end(), comp);
     }
 
+    // Sorts data and writes it to a new file, leaving data empty. Doesn't touch any members so
+    // that it can run on another thread.
+    static std::shared_ptr<Iterator> sortAndWrite(std::deque<Data>* data,
+                                                  const Comparator& comp,
+                                                  const SortOptions& opts,
+                                                  const Settings& settings) {
+        STLComparator less(comp);
+        std::stable_sort(data->begin(), data->end(), less);
+
+        SortedFileWriter<Key, Value> writer(opts, settings);
+        for (; !data->empty(); data->pop_front()) {
+            writer.addAlreadySorted(data->front().first, data->front().second);
+        }
+
+        return std::shared_ptr<Iterator>(writer.done());
+    }
+
     void spill() {
         if (_data.empty())
             return;
@@ -475,24 +684,52 @@ private:
                           << " Pass allowDiskUse:true to opt in.");
         }
 
-        sort();
-
-        SortedFileWriter<Key, Value> writer(_opts, _settings);
-        for (; !_data.empty(); _data.pop_front()) {
-            writer.addAlreadySorted(_data.front().first, _data.front().second);
+        if (_opts.parallelism <= 1) {
+            _iters.push_back(sortAndWrite(&_data, _comp, _opts, _settings));
+            _memUsed = 0;
+            return;
         }
 
-        _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
-
+        // Hand the batch off to another thread and keep accepting data. Each batch is limited
+        // to _spillThreshold, so bounding the number of batches in flight keeps the total
+        // memory used close to _opts.maxMemoryUsageBytes.
+        std::shared_ptr<std::deque<Data>> batch = std::make_shared<std::deque<Data>>();
+        batch->swap(_data);
         _memUsed = 0;
+
+        const Comparator comp = _comp;
+        const SortOptions opts = _opts;
+        const Settings settings = _settings;
+        _pendingSpills.push_back(stdx::async(stdx::launch::async,
+                                             [batch, comp, opts, settings] {
+                                                 return sortAndWrite(
+                                                     batch.get(), comp, opts, settings);
+                                             }));
+
+        while (_pendingSpills.size() >= _opts.parallelism) {
+            finishOldestSpill();
+        }
+    }
+
+    // Spills are finished in the order they were started so that _iters stays in input order,
+    // which the MergeIterator relies on for stability.
+    void finishOldestSpill() {
+        stdx::future<std::shared_ptr<Iterator>> spill = std::move(_pendingSpills.front());
+        _pendingSpills.pop_front();
+        _iters.push_back(spill.get());
     }
 
     const Comparator _comp;
     const Settings _settings;
     SortOptions _opts;
+    const size_t _spillThreshold;  // _opts.maxMemoryUsageBytes split across parallel spills
     size_t _memUsed;
     std::deque<Data> _data;                         // the "current" data
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
+
+    // Spills running on other threads, oldest first. Destroying these waits for the spills
+    // to finish, which only touch state owned by the spill itself.
+    std::deque<stdx::future<std::shared_ptr<Iterator>>> _pendingSpills;
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -623,7 +860,7 @@ public:
         }
 
         spill();
-        return Iterator::merge(_iters, _opts, _comp);
+        return mergeSpilledRuns(_iters, _opts, _comp, _settings);
     }
 
     // TEMP these are here for compatibility. Will be replaced with a general stats API
@@ -797,7 +1034,7 @@ inline unsigned nextFileNumber() {
 
 template <typename Key, typename Value>
 SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts, const Settings& settings)
-    : _settings(settings) {
+    : _settings(settings), _readAhead(opts.parallelism > 1) {
     namespace str = mongoutils::str;
 
     // This should be checked by consumers, but if we get here don't allow writes.
@@ -871,7 +1108,7 @@ template <typename Key, typename Value>
 SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     spill();
     _file.close();
-    return new sorter::FileIterator<Key, Value>(_fileName, _settings, _fileDeleter);
+    return new sorter::FileIterator<Key, Value>(_fileName, _settings, _fileDeleter, _readAhead);
 }
 
 //
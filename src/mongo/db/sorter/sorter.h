@@ -97,8 +97,17 @@ struct SortOptions {
     bool extSortAllowed;         /// If false, uassert if more mem needed than allowed.
     std::string tempDir;         /// Directory to directly place files in.
                                  /// Must be explicitly set if extSortAllowed is true.
-
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    unsigned parallelism;        /// Max background threads used to sort, spill and merge runs.
+                                 /// 1 (the default) does all of the work on the caller's thread.
+    unsigned maxMergeFanIn;      /// Max runs merged at once. Runs beyond this are first merged
+                                 /// into intermediate files. 0 for no limit.
+
+    SortOptions()
+        : limit(0),
+          maxMemoryUsageBytes(64 * 1024 * 1024),
+          extSortAllowed(false),
+          parallelism(1),
+          maxMergeFanIn(0) {}
 
     /// Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -121,6 +130,16 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& Parallelism(unsigned newParallelism) {
+        parallelism = newParallelism;
+        return *this;
+    }
+
+    SortOptions& MaxMergeFanIn(unsigned newMaxMergeFanIn) {
+        maxMergeFanIn = newMaxMergeFanIn;
+        return *this;
+    }
 };
 
 /// This is the output from the sorting framework
@@ -197,6 +216,7 @@ private:
     void spill();
 
     const Settings _settings;
+    const bool _readAhead;  // whether the returned Iterator reads ahead on another thread
     std::string _fileName;
     std::shared_ptr<sorter::FileDeleter> _fileDeleter;  // Must outlive _file
     std::ofstream _file;
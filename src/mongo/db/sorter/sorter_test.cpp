@@ -262,11 +262,91 @@ public:
             ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
                                         make_shared<IntIterator>(0, 10 * 1000 * 1000));
         }
+        {  // big, reading ahead on another thread
+            SortedFileWriter<IntWrapper, IntWrapper> sorter(SortOptions(opts).Parallelism(2));
+            for (int i = 0; i < 10 * 1000 * 1000; i++)
+                sorter.addAlreadySorted(i, -i);
+
+            ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
+                                        make_shared<IntIterator>(0, 10 * 1000 * 1000));
+        }
 
         ASSERT(boost::filesystem::is_empty(tempDir.path()));
     }
 };
 
+/**
+ * Runs read ahead on the shared readAheadPool(), which has more than one thread.
+ */
+class ReadAheadTests {
+public:
+    static const int kNumRuns = 8;
+
+    /**
+     * Spills kNumRuns runs, run 'r' holding every number from 0 to kNumRuns * numPerRun which
+     * is 'r' modulo kNumRuns, and merges them with read ahead. Returns true if the merge
+     * produces every number in order.
+     */
+    static bool mergeRunsInOrder(const std::string& tempDir, int numPerRun) {
+        const SortOptions opts = SortOptions().TempDir(tempDir).Parallelism(2);
+        std::vector<std::shared_ptr<IWIterator>> runs;
+        for (int r = 0; r < kNumRuns; r++) {
+            SortedFileWriter<IntWrapper, IntWrapper> writer(opts);
+            for (int i = r; i < kNumRuns * numPerRun; i += kNumRuns)
+                writer.addAlreadySorted(i, -i);
+            runs.push_back(std::shared_ptr<IWIterator>(writer.done()));
+        }
+
+        std::unique_ptr<IWIterator> merged(IWIterator::merge(runs, opts, IWComparator()));
+        for (int i = 0; i < kNumRuns * numPerRun; i++) {
+            if (!merged->more())
+                return false;
+            const IWPair pair = merged->next();
+            if (pair.first != i || pair.second != -i)
+                return false;
+        }
+        return !merged->more();
+    }
+
+    void run() {
+        const ThreadPool::Stats poolStats = readAheadPool()->getStats();
+        ASSERT_GREATER_THAN(poolStats.options.maxThreads, 1U);
+
+        ReadAheadStats& stats = readAheadStats();
+        {  // a merge of runs read ahead on the pool is complete and in order
+            unittest::TempDir tempDir("readAheadMergeTests");
+            const unsigned long long numReadsBefore = stats.numReads.load();
+            ASSERT(mergeRunsInOrder(tempDir.path(), 500 * 1000));
+
+            // Each run is read ahead at least once as the merge starts.
+            ASSERT_GREATER_THAN_OR_EQUALS(stats.numReads.load() - numReadsBefore,
+                                          static_cast<unsigned long long>(kNumRuns));
+            ASSERT(boost::filesystem::is_empty(tempDir.path()));
+        }
+        {  // concurrent merges never read ahead on more threads than the pool has
+            const size_t kNumSorters = std::min(4 * poolStats.options.maxThreads, size_t(16));
+            unittest::TempDir tempDir("readAheadConcurrentTests");
+            AtomicUInt32 numInOrder;
+            std::vector<stdx::thread> sorters;
+            for (size_t i = 0; i < kNumSorters; i++) {
+                sorters.emplace_back([&] {
+                    if (mergeRunsInOrder(tempDir.path(), 100 * 1000))
+                        numInOrder.fetchAndAdd(1);
+                });
+            }
+            for (auto& sorter : sorters)
+                sorter.join();
+
+            ASSERT_EQUALS(numInOrder.load(), static_cast<unsigned>(kNumSorters));
+            ASSERT_GREATER_THAN_OR_EQUALS(stats.maxNumActive.load(), 1ULL);
+            ASSERT_LESS_THAN_OR_EQUALS(stats.maxNumActive.load(),
+                                       static_cast<unsigned long long>(
+                                           poolStats.options.maxThreads));
+            ASSERT_EQUALS(stats.numActive.load(), 0ULL);
+            ASSERT(boost::filesystem::is_empty(tempDir.path()));
+        }
+    }
+};
 
 class MergeIteratorTests {
 public:
@@ -464,7 +544,9 @@ class Dupes : public Basic {
     }
 };
 
-template <bool Random = true>
+// If Parallel is true, spills, merges and reads happen on background threads and spilled runs
+// are merged in several passes.
+template <bool Random = true, bool Parallel = false>
 class LotsOfDataLittleMemory : public Basic {
 public:
     LotsOfDataLittleMemory() : _array(new int[NUM_ITEMS]) {
@@ -482,6 +564,9 @@ public:
         static_assert((NUM_ITEMS * sizeof(IWPair)) / MEM_LIMIT < 500,
                       "(NUM_ITEMS * sizeof(IWPair)) / MEM_LIMIT < 500");
 
+        if (Parallel)
+            opts.Parallelism(4).MaxMergeFanIn(16);
+
         return opts.MaxMemoryUsageBytes(MEM_LIMIT).ExtSortAllowed();
     }
 
@@ -511,9 +596,9 @@ public:
 };
 
 
-template <long long Limit, bool Random = true>
-class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
-    typedef LotsOfDataLittleMemory<Random> Parent;
+template <long long Limit, bool Random = true, bool Parallel = false>
+class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random, Parallel> {
+    typedef LotsOfDataLittleMemory<Random, Parallel> Parent;
     SortOptions adjustSortOptions(SortOptions opts) {
         // Make sure our tests will spill or not as desired
         static_assert(MEM_LIMIT / 2 > (100 * sizeof(IWPair)),
@@ -528,6 +613,9 @@ class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
         static_assert((Parent::NUM_ITEMS * sizeof(IWPair)) / MEM_LIMIT < 500,
                       "(Parent::NUM_ITEMS * sizeof(IWPair)) / MEM_LIMIT < 500");
 
+        if (Parallel)
+            opts.Parallelism(4).MaxMergeFanIn(16);
+
         return opts.MaxMemoryUsageBytes(MEM_LIMIT).ExtSortAllowed().Limit(Limit);
     }
     virtual std::shared_ptr<IWIterator> correct() {
@@ -547,6 +635,7 @@ public:
     void setupTests() {
         add<InMemIterTests>();
         add<SortedFileWriterAndFileIteratorTests>();
+        add<ReadAheadTests>();
         add<MergeIteratorTests>();
         add<SorterTests::Basic>();
         add<SorterTests::Limit>();
@@ -559,6 +648,9 @@ public:
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/true>>();    // fits in mem
         add<SorterTests::LotsOfDataWithLimit<5000, /*random=*/false>>();  // spills
         add<SorterTests::LotsOfDataWithLimit<5000, /*random=*/true>>();   // spills
+        add<SorterTests::LotsOfDataLittleMemory</*random=*/false, /*parallel=*/true>>();
+        add<SorterTests::LotsOfDataLittleMemory</*random=*/true, /*parallel=*/true>>();
+        add<SorterTests::LotsOfDataWithLimit<5000, /*random=*/true, /*parallel=*/true>>();
     }
 };
 
@@ -54,5 +54,11 @@ public:
     virtual Status aboutToDeleteCapped(OperationContext* txn,
                                        const RecordId& loc,
                                        RecordData data) = 0;
+
+    /**
+     * Called when documents inserted into the capped collection may have just become visible to
+     * readers, so that anyone waiting for new data can look again.
+     */
+    virtual void notifyCappedWaitersIfNeeded() {}
 };
 }
@@ -367,6 +367,34 @@ StatusWith<RecordId> InMemoryRecordStore::insertRecord(OperationContext* txn,
                                                        const char* data,
                                                        int len,
                                                        bool enforceQuota) {
+    StatusWith<RecordId> loc = _insertRecord(txn, data, len);
+    if (!loc.isOK())
+        return loc;
+
+    cappedDeleteAsNeeded(txn);
+
+    return loc;
+}
+
+Status InMemoryRecordStore::insertRecords(OperationContext* txn,
+                                          std::vector<Record>* records,
+                                          bool enforceQuota) {
+    for (auto& record : *records) {
+        StatusWith<RecordId> loc = _insertRecord(txn, record.data.data(), record.data.size());
+        if (!loc.isOK())
+            return loc.getStatus();
+        record.id = loc.getValue();
+    }
+
+    // Make room for the whole batch at once.
+    cappedDeleteAsNeeded(txn);
+
+    return Status::OK();
+}
+
+StatusWith<RecordId> InMemoryRecordStore::_insertRecord(OperationContext* txn,
+                                                        const char* data,
+                                                        int len) {
     if (_isCapped && len > _cappedMaxSize) {
         // We use dataSize for capped rollover and we don't want to delete everything if we know
         // this won't fit.
@@ -390,8 +418,6 @@ StatusWith<RecordId> InMemoryRecordStore::insertRecord(OperationContext* txn,
     _data->dataSize += len;
     _data->records[loc] = rec;
 
-    cappedDeleteAsNeeded(txn);
-
     return StatusWith<RecordId>(loc);
 }
 
@@ -69,6 +69,10 @@ public:
                                               const DocWriter* doc,
                                               bool enforceQuota);
 
+    virtual Status insertRecords(OperationContext* txn,
+                                 std::vector<Record>* records,
+                                 bool enforceQuota);
+
     virtual StatusWith<RecordId> updateRecord(OperationContext* txn,
                                               const RecordId& oldLocation,
                                               const char* data,
@@ -179,6 +183,9 @@ private:
     bool cappedAndNeedDelete(OperationContext* txn) const;
     void cappedDeleteAsNeeded(OperationContext* txn);
 
+    // Inserts one record without deleting from a capped collection to make room for it.
+    StatusWith<RecordId> _insertRecord(OperationContext* txn, const char* data, int len);
+
     // TODO figure out a proper solution to metadata
     const bool _isCapped;
     const int64_t _cappedMaxSize;
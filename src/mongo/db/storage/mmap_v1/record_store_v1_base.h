@@ -199,6 +199,11 @@ public:
                                       const DocWriter* doc,
                                       bool enforceQuota);
 
+    // insertRecords() is deliberately left to RecordStore's default, which calls insertRecord()
+    // once per record. Every record is allocated from the free list of its own size bucket, or
+    // in a capped collection from the space after the previous record, and the journal is
+    // written per record in either case, so a batch has nothing to share but the stats update.
+
     virtual StatusWith<RecordId> updateRecord(OperationContext* txn,
                                               const RecordId& oldLocation,
                                               const char* data,
@@ -31,6 +31,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/mutable/damage_vector.h"
@@ -359,6 +360,27 @@ public:
                                               const DocWriter* doc,
                                               bool enforceQuota) = 0;
 
+    /**
+     * Inserts every Record in 'records' as insertRecord() would, and sets the id of each one to
+     * the RecordId it was stored at. Stops at the first failure and returns it; the caller must
+     * then abandon the WriteUnitOfWork, as the records before the failure remain inserted.
+     *
+     * Storage engines that can insert a batch more cheaply than one record at a time, for
+     * example with a single cursor, should override this.
+     */
+    virtual Status insertRecords(OperationContext* txn,
+                                 std::vector<Record>* records,
+                                 bool enforceQuota) {
+        for (auto& record : *records) {
+            StatusWith<RecordId> res =
+                insertRecord(txn, record.data.data(), record.data.size(), enforceQuota);
+            if (!res.isOK())
+                return res.getStatus();
+            record.id = res.getValue();
+        }
+        return Status::OK();
+    }
+
     /**
      * @param notifier - Only used by record stores which do not support doc-locking.
      *                   In the case of a document move, this is called after the document
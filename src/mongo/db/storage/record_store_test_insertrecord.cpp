@@ -39,6 +39,7 @@
 
 using std::string;
 using std::stringstream;
+using std::vector;
 
 namespace mongo {
 
@@ -174,4 +175,48 @@ TEST(RecordStoreTestHarness, InsertMultipleRecordsUsingDocWriter) {
     }
 }
 
+// Insert several records with one insertRecords() call and verify that each one is assigned its
+// own RecordId and can be read back.
+TEST(RecordStoreTestHarness, InsertRecords) {
+    unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int nToInsert = 10;
+    vector<string> datas;
+    for (int i = 0; i < nToInsert; i++) {
+        stringstream ss;
+        ss << "record " << i;
+        datas.push_back(ss.str());
+    }
+
+    vector<Record> records;
+    for (const auto& data : datas) {
+        records.push_back({RecordId(), RecordData(data.c_str(), data.size() + 1)});
+    }
+
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(rs->insertRecords(opCtx.get(), &records, false));
+            uow.commit();
+        }
+    }
+
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(nToInsert, rs->numRecords(opCtx.get()));
+
+        for (int i = 0; i < nToInsert; i++) {
+            ASSERT(!records[i].id.isNull());
+            for (int j = 0; j < i; j++) {
+                ASSERT_NOT_EQUALS(records[j].id, records[i].id);
+            }
+
+            RecordData record = rs->dataFor(opCtx.get(), records[i].id);
+            ASSERT_EQUALS(datas[i], string(record.data()));
+        }
+    }
+}
+
 }  // namespace mongo
@@ -814,28 +814,31 @@ StatusWith<RecordId> WiredTigerRecordStore::insertRecord(OperationContext* txn,
                                                          const char* data,
                                                          int len,
                                                          bool enforceQuota) {
-    if (_isCapped && len > _cappedMaxSize) {
-        return StatusWith<RecordId>(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
-    }
+    Record record = {RecordId(), RecordData(data, len)};
+    Status status = _insertRecords(txn, &record, 1);
+    if (!status.isOK())
+        return StatusWith<RecordId>(status);
+    return StatusWith<RecordId>(record.id);
+}
 
-    RecordId loc;
-    if (_useOplogHack) {
-        StatusWith<RecordId> status = extractAndCheckLocForOplog(data, len);
-        if (!status.isOK())
-            return status;
-        loc = status.getValue();
-        if (loc > _oplog_highestSeen) {
-            stdx::lock_guard<stdx::mutex> lk(_uncommittedDiskLocsMutex);
-            if (loc > _oplog_highestSeen) {
-                _oplog_highestSeen = loc;
-            }
+Status WiredTigerRecordStore::insertRecords(OperationContext* txn,
+                                            std::vector<Record>* records,
+                                            bool enforceQuota) {
+    if (records->empty())
+        return Status::OK();
+    return _insertRecords(txn, records->data(), records->size());
+}
+
+Status WiredTigerRecordStore::_insertRecords(OperationContext* txn,
+                                             Record* records,
+                                             size_t nRecords) {
+    int64_t totalLength = 0;
+    for (size_t i = 0; i < nRecords; i++) {
+        const int len = records[i].data.size();
+        if (_isCapped && len > _cappedMaxSize) {
+            return Status(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
         }
-    } else if (_isCapped) {
-        stdx::lock_guard<stdx::mutex> lk(_uncommittedDiskLocsMutex);
-        loc = _nextId();
-        _addUncommitedDiskLoc_inlock(txn, loc);
-    } else {
-        loc = _nextId();
+        totalLength += len;
     }
 
     WiredTigerCursor curwrap(_uri, _tableId, true, txn);
@@ -843,20 +846,51 @@ StatusWith<RecordId> WiredTigerRecordStore::insertRecord(OperationContext* txn,
     WT_CURSOR* c = curwrap.get();
     invariant(c);
 
-    c->set_key(c, _makeKey(loc));
-    WiredTigerItem value(data, len);
-    c->set_value(c, value.Get());
-    int ret = WT_OP_CHECK(c->insert(c));
-    if (ret) {
-        return StatusWith<RecordId>(wtRCToStatus(ret, "WiredTigerRecordStore::insertRecord"));
+    RecordId highestLoc;
+    for (size_t i = 0; i < nRecords; i++) {
+        Record& record = records[i];
+        const char* data = record.data.data();
+        const int len = record.data.size();
+
+        RecordId loc;
+        if (_useOplogHack) {
+            StatusWith<RecordId> status = extractAndCheckLocForOplog(data, len);
+            if (!status.isOK())
+                return status.getStatus();
+            loc = status.getValue();
+            if (loc > _oplog_highestSeen) {
+                stdx::lock_guard<stdx::mutex> lk(_uncommittedDiskLocsMutex);
+                if (loc > _oplog_highestSeen) {
+                    _oplog_highestSeen = loc;
+                }
+            }
+        } else if (_isCapped) {
+            stdx::lock_guard<stdx::mutex> lk(_uncommittedDiskLocsMutex);
+            loc = _nextId();
+            _addUncommitedDiskLoc_inlock(txn, loc);
+        } else {
+            loc = _nextId();
+        }
+
+        c->set_key(c, _makeKey(loc));
+        WiredTigerItem value(data, len);
+        c->set_value(c, value.Get());
+        int ret = WT_OP_CHECK(c->insert(c));
+        if (ret) {
+            return wtRCToStatus(ret, "WiredTigerRecordStore::insertRecord");
+        }
+
+        record.id = loc;
+        if (highestLoc < loc)
+            highestLoc = loc;
     }
 
-    _changeNumRecords(txn, 1);
-    _increaseDataSize(txn, len);
+    _changeNumRecords(txn, nRecords);
+    _increaseDataSize(txn, totalLength);
 
-    cappedDeleteAsNeeded(txn, loc);
+    cappedDeleteAsNeeded(txn, highestLoc);
 
-    return StatusWith<RecordId>(loc);
+    return Status::OK();
 }
 
 void WiredTigerRecordStore::dealtWithCappedLoc(const RecordId& loc) {
@@ -1138,6 +1172,12 @@ public:
 
     virtual void rollback() {
         _rs->dealtWithCappedLoc(_loc);
+
+        // Records committed after '_loc' by other transactions were hidden behind it, and may
+        // have just become visible. Commits notify through the collection.
+        if (_rs->_cappedDeleteCallback) {
+            _rs->_cappedDeleteCallback->notifyCappedWaitersIfNeeded();
+        }
     }
 
 private:
@@ -122,6 +122,10 @@ public:
                                               const DocWriter* doc,
                                               bool enforceQuota);
 
+    virtual Status insertRecords(OperationContext* txn,
+                                 std::vector<Record>* records,
+                                 bool enforceQuota);
+
     virtual StatusWith<RecordId> updateRecord(OperationContext* txn,
                                               const RecordId& oldLocation,
                                               const char* data,
@@ -230,6 +234,12 @@ private:
 
     void _addUncommitedDiskLoc_inlock(OperationContext* txn, const RecordId& loc);
 
+    /**
+     * Inserts 'nRecords' records through one cursor, setting the id of each, and updates the
+     * record count and data size once for all of them.
+     */
+    Status _insertRecords(OperationContext* txn, Record* records, size_t nRecords);
+
     RecordId _nextId();
     void _setId(RecordId loc);
     bool cappedAndNeedDelete() const;
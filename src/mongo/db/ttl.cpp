@@ -34,6 +34,8 @@
 
 #include "mongo/db/ttl.h"
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -47,6 +49,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/delete.h"
+#include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/ops/insert.h"
@@ -54,9 +57,13 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/background.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -69,14 +76,72 @@ using std::unique_ptr;
 
 Counter64 ttlPasses;
 Counter64 ttlDeletedDocuments;
+Counter64 ttlDeleteBatches;
+Counter64 ttlPendingIndexes;
 
 ServerStatusMetricField<Counter64> ttlPassesDisplay("ttl.passes", &ttlPasses);
 ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocuments",
                                                               &ttlDeletedDocuments);
+ServerStatusMetricField<Counter64> ttlDeleteBatchesDisplay("ttl.deleteBatches", &ttlDeleteBatches);
+ServerStatusMetricField<Counter64> ttlPendingIndexesDisplay("ttl.pendingIndexes",
+                                                            &ttlPendingIndexes);
 
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorEnabled, bool, true);
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60);  // used for testing
 
+// The number of TTL indexes a pass works on at the same time.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorMaxConcurrentIndexes, int, 4);
+
+// The number of documents deleted from one TTL index before its locks are released and the
+// throttle is consulted.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorDeleteBatchSize, int, 1000);
+
+// The most documents per second deleted through any one TTL index, or 0 for no limit.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorMaxDeletesPerSecond, int, 0);
+
+namespace {
+
+// The longest a worker sleeps at a time to keep within ttlMonitorMaxDeletesPerSecond.
+const long long kMaxThrottleSleepMillis = 1000;
+
+/**
+ * Reports in serverStatus how long the oldest document deleted so far by the current TTL pass,
+ * or else by the last one, had been expired when it was deleted.
+ */
+class TTLLagMetric : public ServerStatusMetric {
+public:
+    TTLLagMetric() : ServerStatusMetric("ttl.lagMillis") {}
+
+    virtual void appendAtLeaf(BSONObjBuilder& b) const {
+        b.appendNumber(_leafName, lagMillis.load());
+    }
+
+    AtomicInt64 lagMillis;
+} ttlLagMetric;
+
+/**
+ * Returns the earliest date in 'elt', looking inside an array of dates, or boost::none if it
+ * holds no date.
+ */
+boost::optional<Date_t> earliestDate(const BSONElement& elt) {
+    if (elt.type() == Date) {
+        return elt.date();
+    }
+    if (elt.type() != Array) {
+        return boost::none;
+    }
+
+    boost::optional<Date_t> earliest;
+    BSONForEach(arrayElt, elt.Obj()) {
+        if (arrayElt.type() == Date && (!earliest || arrayElt.date() < *earliest)) {
+            earliest = arrayElt.date();
+        }
+    }
+    return earliest;
+}
+
+}  // namespace
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor() {}
@@ -118,6 +183,18 @@ public:
     }
 
 private:
+    /**
+     * The progress of one TTL pass over one index, carried between its delete batches.
+     */
+    struct IndexProgress {
+        long long numDeleted = 0;
+
+        // The earliest key date among the documents deleted, and the expiration time it was
+        // compared against.
+        boost::optional<Date_t> earliestDeleted;
+        Date_t expirationTime;
+    };
+
     void doTTLPass() {
         // Count it as active from the moment the TTL thread wakes up
         OperationContextImpl txn;
@@ -133,25 +210,103 @@ private:
 
         ttlPasses.increment();
 
+        // The indexes are worked on by a pool which lives for this pass only, so that a change to
+        // ttlMonitorMaxConcurrentIndexes applies from the next pass on.
+        ThreadPool::Options options;
+        options.poolName = "TTLMonitorWorkers";
+        options.minThreads = 0;
+        options.maxThreads = std::max(1, ttlMonitorMaxConcurrentIndexes);
+        ThreadPool pool(options);
+        pool.startup();
+
+        _passLagMillis.store(0);
+
         for (set<string>::const_iterator i = dbs.begin(); i != dbs.end(); ++i) {
-            string db = *i;
+            const string db = *i;
 
             vector<BSONObj> indexes;
             getTTLIndexesForDB(&txn, db, &indexes);
 
             for (vector<BSONObj>::const_iterator it = indexes.begin(); it != indexes.end(); ++it) {
-                BSONObj idx = *it;
-                try {
-                    if (!doTTLForIndex(&txn, db, idx)) {
-                        break;  // stop processing TTL indexes on this database
+                const BSONObj idx = *it;
+                ttlPendingIndexes.increment();
+                Status status = pool.schedule([this, db, idx]() {
+                    doTTLForIndexInWorker(db, idx);
+                    ttlPendingIndexes.decrement();
+                });
+                if (!status.isOK()) {
+                    ttlPendingIndexes.decrement();
+                    error() << "Could not schedule ttl job for index " << idx << " -- " << status;
+                }
+            }
+        }
+
+        pool.shutdown();
+        pool.join();
+
+        ttlLagMetric.lagMillis.store(_passLagMillis.load());
+    }
+
+    /**
+     * Runs on a thread of the pass's pool, and deletes the expired documents of the index 'idx'
+     * in batches, sleeping between batches as needed to keep within
+     * ttlMonitorMaxDeletesPerSecond.
+     */
+    void doTTLForIndexInWorker(const string& dbName, const BSONObj& idx) {
+        Client::initThreadIfNotAlready("TTLMonitorWorker");
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+
+        OperationContextImpl txn;
+        IndexProgress progress;
+        Timer timer;
+
+        try {
+            while (!inShutdown() && ttlMonitorEnabled) {
+                if (!doTTLBatchForIndex(&txn, dbName, idx, &progress)) {
+                    break;
+                }
+
+                // Sleeps in slices, so that shutdown, disabling the monitor or raising the rate
+                // takes effect without waiting out the whole delay.
+                while (!inShutdown() && ttlMonitorEnabled) {
+                    const int maxDeletesPerSecond = ttlMonitorMaxDeletesPerSecond;
+                    if (maxDeletesPerSecond <= 0) {
+                        break;
+                    }
+
+                    const long long dueMillis = progress.numDeleted * 1000 / maxDeletesPerSecond;
+                    const long long aheadMillis = dueMillis - timer.millis();
+                    if (aheadMillis <= 0) {
+                        break;
                     }
-                } catch (const DBException& dbex) {
-                    error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
-                    // continue on to the next index
-                    continue;
+
+                    sleepmillis(std::min(aheadMillis, kMaxThrottleSleepMillis));
                 }
             }
+        } catch (const WriteConflictException& e) {
+            LOG(1) << "Got WriteConflictException in TTL thread";
+        } catch (const DBException& dbex) {
+            error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
         }
+
+        if (progress.earliestDeleted) {
+            const long long lagMillis =
+                durationCount<Milliseconds>(progress.expirationTime - *progress.earliestDeleted);
+            long long passLag = _passLagMillis.load();
+            while (lagMillis > passLag) {
+                const long long seen = _passLagMillis.compareAndSwap(passLag, lagMillis);
+                if (seen == passLag) {
+                    break;
+                }
+                passLag = seen;
+            }
+            if (lagMillis > ttlLagMetric.lagMillis.load()) {
+                ttlLagMetric.lagMillis.store(lagMillis);
+            }
+        }
+
+        LOG(1) << "\tTTL deleted: " << progress.numDeleted << " from " << idx["ns"].String()
+               << " in " << timer.millis() << "ms" << endl;
     }
 
     /**
@@ -200,26 +355,29 @@ private:
     }
 
     /**
-     * Remove documents from the collection using the specified TTL index
-     * after a sufficient amount of time has passed according to its expiry
-     * specification.
+     * Remove up to ttlMonitorDeleteBatchSize documents from the collection using the specified
+     * TTL index after a sufficient amount of time has passed according to its expiry
+     * specification. The locks are held for this one batch only.
      *
-     * @return true if caller should continue processing TTL indexes of collections
-     *         on the specified database, and false otherwise
+     * @return true if the batch was full, so that more documents may have expired, and false
+     *         if the index has nothing more to delete or should be skipped
      */
-    bool doTTLForIndex(OperationContext* txn, const string& dbName, BSONObj idx) {
+    bool doTTLBatchForIndex(OperationContext* txn,
+                            const string& dbName,
+                            BSONObj idx,
+                            IndexProgress* progress) {
         const string ns = idx["ns"].String();
         NamespaceString nss(ns);
         if (!userAllowedWriteNS(nss).isOK()) {
             error() << "namespace '" << ns
                     << "' doesn't allow deletes, skipping ttl job for: " << idx;
-            return true;
+            return false;
         }
 
         BSONObj key = idx["key"].Obj();
         if (key.nFields() != 1) {
             error() << "key for ttl index can only have 1 field, skipping ttl job for: " << idx;
-            return true;
+            return false;
         }
 
         LOG(1) << "TTL -- ns: " << ns << " key: " << key;
@@ -236,7 +394,7 @@ private:
         Collection* collection = db->getCollection(ns);
         if (!collection) {
             // Collection was dropped.
-            return true;
+            return false;
         }
 
         if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(nss)) {
@@ -249,7 +407,7 @@ private:
         if (!desc) {
             LOG(1) << "index not found (index build in progress? index dropped?), skipping "
                    << "ttl job for: " << idx;
-            return true;
+            return false;
         }
 
         // Re-read 'idx' from the descriptor, in case the collection or index definition
@@ -258,7 +416,7 @@ private:
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             error() << "special index can't be used as a ttl index, skipping ttl job for: " << idx;
-            return true;
+            return false;
         }
 
         BSONElement secondsExpireElt = idx[secondsExpireField];
@@ -266,7 +424,7 @@ private:
             error() << "ttl indexes require the " << secondsExpireField << " field to be "
                     << "numeric but received a type of " << typeName(secondsExpireElt.type())
                     << ", skipping ttl job for: " << idx;
-            return true;
+            return false;
         }
 
         const Date_t kDawnOfTime =
@@ -290,8 +448,12 @@ private:
         auto canonicalQuery = CanonicalQuery::canonicalize(nss, query);
         invariantOK(canonicalQuery.getStatus());
 
+        // The deleted documents are returned so that the batch can stop after
+        // ttlMonitorDeleteBatchSize of them. The next batch starts a new scan over the expired
+        // range, which no longer holds the documents deleted here.
         DeleteStageParams params;
         params.isMulti = true;
+        params.returnDeleted = true;
         params.canonicalQuery = canonicalQuery.getValue().get();
 
         unique_ptr<PlanExecutor> exec =
@@ -305,18 +467,37 @@ private:
                                                  PlanExecutor::YIELD_AUTO,
                                                  direction);
 
-        Status result = exec->executePlan();
-        if (!result.isOK()) {
-            error() << "ttl query execution for index " << idx << " failed with status: " << result;
-            return true;
+        const long long batchSize = std::max(1, ttlMonitorDeleteBatchSize);
+        long long numDeleted = 0;
+        BSONObj deletedDoc;
+        PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+        while (numDeleted < batchSize &&
+               PlanExecutor::ADVANCED == (state = exec->getNext(&deletedDoc, NULL))) {
+            ++numDeleted;
+
+            boost::optional<Date_t> keyDate =
+                earliestDate(deletedDoc.getFieldDotted(keyFieldName));
+            if (keyDate && (!progress->earliestDeleted || *keyDate < *progress->earliestDeleted)) {
+                progress->earliestDeleted = keyDate;
+                progress->expirationTime = expirationTime;
+            }
         }
 
-        const long long numDeleted = DeleteStage::getNumDeleted(*exec);
+        progress->numDeleted += numDeleted;
         ttlDeletedDocuments.increment(numDeleted);
-        LOG(1) << "\tTTL deleted: " << numDeleted << endl;
+        ttlDeleteBatches.increment();
 
-        return true;
+        if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
+            error() << "ttl query execution for index " << idx
+                    << " failed with status: " << WorkingSetCommon::toStatusString(deletedDoc);
+            return false;
+        }
+
+        return numDeleted == batchSize;
     }
+
+    // The longest time a document deleted by the current pass had been expired, in milliseconds.
+    AtomicInt64 _passLagMillis;
 };
 
 void startTTLBackgroundJob() {
@@ -59,7 +59,7 @@ public:
             _chunkMap[mySplitPoints[i]] = chunk;
         }
 
-        _chunkRanges.reloadAll(_chunkMap);
+        _routingTable = std::make_shared<ChunkRoutingTable>(_chunkMap, nullptr);
     }
 };
 
@@ -330,6 +330,80 @@ class InMultiShard : public CompoundKeyBase {
     }
 };
 
+/**
+ * Checks that ChunkRoutingTable finds the same chunk for each of a range of keys of mixed types as
+ * a lookup in the ChunkMap does, whether or not it was built from an older table.
+ */
+class RoutingTableMatchesChunkMap {
+public:
+    void run() {
+        ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+
+        vector<BSONObj> splitPoints = {BSON("a" << -1),
+                                       BSON("a" << 0),
+                                       BSON("a" << 2.5),
+                                       BSON("a" << 10LL),
+                                       BSON("a"
+                                            << ""),
+                                       BSON("a"
+                                            << "m"),
+                                       BSON("a" << BSON("x" << 1)),
+                                       BSON("a" << OID("000000000000000000000001"))};
+        TestableChunkManager chunkManager("", shardKeyPattern, false);
+        chunkManager.setSingleChunkForShards(splitPoints);
+        const ChunkMap& chunkMap = chunkManager.getChunkMap();
+
+        ChunkRoutingTable table(chunkMap, nullptr);
+        ASSERT_EQUALS(chunkMap.size(), table.size());
+        assertRoutesLikeChunkMap(table, chunkMap);
+
+        // An older version of the chunks, with one chunk since split and two since merged.
+        vector<BSONObj> oldSplitPoints = {BSON("a" << -1),
+                                          BSON("a" << 2.5),
+                                          BSON("a" << 5),
+                                          BSON("a" << 10LL),
+                                          BSON("a"
+                                               << ""),
+                                          BSON("a"
+                                               << "m"),
+                                          BSON("a" << BSON("x" << 1)),
+                                          BSON("a" << OID("000000000000000000000001"))};
+        TestableChunkManager oldChunkManager("", shardKeyPattern, false);
+        oldChunkManager.setSingleChunkForShards(oldSplitPoints);
+        ChunkRoutingTable oldTable(oldChunkManager.getChunkMap(), nullptr);
+
+        ChunkRoutingTable newTable(chunkMap, &oldTable);
+        ASSERT_EQUALS(chunkMap.size(), newTable.size());
+        assertRoutesLikeChunkMap(newTable, chunkMap);
+    }
+
+private:
+    static void assertRoutesLikeChunkMap(const ChunkRoutingTable& table, const ChunkMap& chunkMap) {
+        BSONArrayBuilder values;
+        values << -5 << -1 << -0.5 << 0 << 1 << 2 << 2.5 << 3 << 10 << 10.0 << 11LL << 1e300;
+        values << ""
+               << "a"
+               << "m"
+               << "z";
+        values << BSONObj() << BSON("x" << 1) << BSON("x" << 2);
+        values << OID("000000000000000000000000") << OID("000000000000000000000001")
+               << OID("000000000000000000000002");
+        values << true << Date_t::fromMillisSinceEpoch(0);
+
+        const BSONArray valuesArray = values.arr();
+        vector<BSONObj> keys = {BSON("a" << MINKEY), BSON("a" << MAXKEY)};
+        BSONForEach(value, valuesArray) {
+            keys.push_back(BSON("a" << value));
+        }
+
+        for (const BSONObj& key : keys) {
+            ChunkMap::const_iterator it = chunkMap.upper_bound(key);
+            ChunkPtr expected = (it == chunkMap.end()) ? ChunkPtr() : it->second;
+            ASSERT_EQUALS(expected.get(), table.findIntersectingChunk(key).get());
+        }
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("chunk") {}
@@ -354,6 +428,7 @@ public:
         add<InequalityThenUnsatisfiable>();
         add<OrEqualityUnsatisfiableInequality>();
         add<InMultiShard>();
+        add<RoutingTableMatchesChunkMap>();
     }
 };
 
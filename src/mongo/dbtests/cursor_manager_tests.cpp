@@ -0,0 +1,226 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file tests CursorManager, including many clients registering, pinning and erasing
+ * cursors at once.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/cursor_manager.h"
+#include "mongo/db/clientcursor.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/operation_context_impl.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/log.h"
+#include "mongo/util/timer.h"
+
+namespace CursorManagerTests {
+
+static const NamespaceString nss("unittests.CursorManagerTests");
+
+class CursorManagerBase {
+public:
+    CursorManagerBase() : _client(&_txn) {
+        OldClientWriteContext ctx(&_txn, nss.ns());
+        _client.dropCollection(nss.ns());
+        _client.insert(nss.ns(), BSON("_id" << 1));
+    }
+
+    virtual ~CursorManagerBase() {
+        _client.dropCollection(nss.ns());
+    }
+
+protected:
+    OperationContextImpl _txn;
+
+private:
+    DBDirectClient _client;
+};
+
+/**
+ * Registers enough cursors to land in every partition of the cursor manager, and checks that each
+ * can be found, pinned and erased.
+ */
+class RegisterFindErase : public CursorManagerBase {
+public:
+    void run() {
+        AutoGetCollectionForRead ctx(&_txn, nss.ns());
+        Collection* collection = ctx.getCollection();
+        CursorManager* manager = collection->getCursorManager();
+        ASSERT_EQUALS(0U, manager->numCursors());
+
+        const size_t kNumCursors = 1000;
+        std::set<CursorId> ids;
+        for (size_t i = 0; i < kNumCursors; ++i) {
+            ClientCursor* cc = new ClientCursor(collection);
+            ASSERT(manager->ownsCursorId(cc->cursorid()));
+            ASSERT(ids.insert(cc->cursorid()).second);
+        }
+        ASSERT_EQUALS(kNumCursors, manager->numCursors());
+
+        std::set<CursorId> openCursors;
+        manager->getCursorIds(&openCursors);
+        ASSERT(ids == openCursors);
+
+        // Every cursor can be pinned, and can't be erased while it is pinned.
+        for (CursorId id : ids) {
+            ClientCursorPin pin(manager, id);
+            ASSERT(pin.c());
+            ASSERT_EQUALS(id, pin.c()->cursorid());
+            ASSERT_EQUALS(ErrorCodes::OperationFailed,
+                          manager->eraseCursor(&_txn, id, false).code());
+        }
+
+        // Erase half of the cursors.
+        std::set<CursorId> erased;
+        for (CursorId id : ids) {
+            if (erased.size() == kNumCursors / 2) {
+                break;
+            }
+            ASSERT_OK(manager->eraseCursor(&_txn, id, false));
+            erased.insert(id);
+        }
+        ASSERT_EQUALS(kNumCursors - erased.size(), manager->numCursors());
+
+        for (CursorId id : ids) {
+            if (erased.count(id)) {
+                ASSERT(!manager->find(id, false));
+                ASSERT_EQUALS(ErrorCodes::CursorNotFound,
+                              manager->eraseCursor(&_txn, id, false).code());
+            } else {
+                ASSERT(manager->find(id, false));
+            }
+        }
+
+        // The remaining cursors are deleted along with the collection.
+    }
+};
+
+/**
+ * Runs thousands of cursors, each pinned and unpinned over and over as a getMore would, from
+ * many threads at once, while the cursor manager is repeatedly walked as the cursor timeout
+ * thread does. Reports the rate of getMores.
+ */
+class ConcurrentGetMores : public CursorManagerBase {
+public:
+    void run() {
+        AutoGetCollectionForRead ctx(&_txn, nss.ns());
+        Collection* collection = ctx.getCollection();
+        CursorManager* manager = collection->getCursorManager();
+
+        const int kNumThreads = 32;
+        const int kCursorsPerThread = 64;
+        const int kGetMoresPerCursor = 100;
+
+        std::vector<int> failures(kNumThreads, 0);
+        AtomicUInt32 threadsDone;
+
+        Timer timer;
+        std::vector<stdx::thread> threads;
+        for (int t = 0; t < kNumThreads; ++t) {
+            threads.emplace_back([&, t] {
+                std::vector<CursorId> ids;
+                for (int i = 0; i < kCursorsPerThread; ++i) {
+                    ids.push_back((new ClientCursor(collection))->cursorid());
+                }
+
+                for (int round = 0; round < kGetMoresPerCursor; ++round) {
+                    for (CursorId id : ids) {
+                        ClientCursorPin pin(manager, id);
+                        if (!pin.c()) {
+                            ++failures[t];
+                            continue;
+                        }
+                        pin.c()->incPos(1);
+                    }
+                }
+
+                for (CursorId id : ids) {
+                    ClientCursorPin pin(manager, id);
+                    if (!pin.c() || pin.c()->pos() != kGetMoresPerCursor) {
+                        ++failures[t];
+                        continue;
+                    }
+                    pin.deleteUnderlying();
+                }
+
+                threadsDone.fetchAndAdd(1);
+            });
+        }
+
+        size_t numWalks = 0;
+        while (threadsDone.load() < static_cast<unsigned>(kNumThreads)) {
+            ASSERT_EQUALS(0U, manager->timeoutCursors(0));
+            std::set<CursorId> openCursors;
+            manager->getCursorIds(&openCursors);
+            ++numWalks;
+        }
+
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+        const long long micros = timer.micros();
+
+        for (int t = 0; t < kNumThreads; ++t) {
+            ASSERT_EQUALS(0, failures[t]);
+        }
+        ASSERT_EQUALS(0U, manager->numCursors());
+
+        const long long numGetMores = kNumThreads * kCursorsPerThread * kGetMoresPerCursor;
+        ::mongo::log() << kNumThreads * kCursorsPerThread << " cursors on " << kNumThreads
+                       << " threads ran " << numGetMores << " pins in " << micros << "us ("
+                       << (numGetMores * 1000 * 1000) / std::max(micros, 1LL)
+                       << " per second), with " << numWalks << " walks of the cursor manager";
+    }
+};
+
+class All : public Suite {
+public:
+    All() : Suite("cursor_manager") {}
+
+    void setupTests() {
+        add<RegisterFindErase>();
+        add<ConcurrentGetMores>();
+    }
+};
+
+SuiteInstance<All> cursorManagerAll;
+
+}  // namespace CursorManagerTests
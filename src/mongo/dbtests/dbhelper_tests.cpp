@@ -55,13 +55,14 @@ static const char* const ns = "unittests.removetests";
 /** Simple test for Helpers::RemoveRange. */
 class RemoveRange {
 public:
-    RemoveRange() : _min(4), _max(8) {}
+    RemoveRange() : _min(4), _max(8), _numDocs(10) {}
 
     void run() {
         OperationContextImpl txn;
         DBDirectClient client(&txn);
 
-        for (int i = 0; i < 10; ++i) {
+        client.dropCollection(ns);
+        for (int i = 0; i < _numDocs; ++i) {
             client.insert(ns, BSON("_id" << i));
         }
 
@@ -86,7 +87,7 @@ private:
         for (int i = 0; i < _min; ++i) {
             bab << BSON("_id" << i);
         }
-        for (int i = _max; i < 10; ++i) {
+        for (int i = _max; i < _numDocs; ++i) {
             bab << BSON("_id" << i);
         }
         return bab.arr();
@@ -101,8 +102,20 @@ private:
         }
         return bab.arr();
     }
+
+protected:
+    RemoveRange(int min, int max, int numDocs) : _min(min), _max(max), _numDocs(numDocs) {}
+
+private:
     int _min;
     int _max;
+    int _numDocs;
+};
+
+/** Helpers::RemoveRange over a range which takes several batches to delete. */
+class RemoveRangeInBatches : public RemoveRange {
+public:
+    RemoveRangeInBatches() : RemoveRange(100, 900, 1000) {}
 };
 
 class All : public Suite {
@@ -110,6 +123,7 @@ public:
     All() : Suite("remove") {}
     void setupTests() {
         add<RemoveRange>();
+        add<RemoveRangeInBatches>();
     }
 } myall;
 
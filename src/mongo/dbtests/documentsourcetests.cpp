@@ -236,6 +236,45 @@ public:
     }
 };
 
+/** Documents extracted for a $group are built on the layout of the one before them. */
+class ExtractFieldsWithLayout : public Base {
+public:
+    void run() {
+        for (int i = 0; i < 10; ++i) {
+            if (i == 4) {
+                client.insert(nss.ns(), BSON("_id" << i << "a" << i % 2 << "c"
+                                                   << "x"));
+            } else {
+                client.insert(nss.ns(), BSON("_id" << i << "a" << i % 2 << "b" << i << "c"
+                                                   << "x"));
+            }
+        }
+        createSource();
+
+        BSONObj groupSpec = fromjson("{$group: {_id: '$a', total: {$sum: '$b'}}}");
+        intrusive_ptr<DocumentSource> group =
+            DocumentSourceGroup::createFromBson(groupSpec.firstElement(), ctx());
+        DepsTracker deps;
+        ASSERT_EQUALS(DocumentSource::EXHAUSTIVE_ALL, group->getDependencies(&deps));
+        source()->setProjection(deps.toProjection(), deps.toParsedDeps());
+
+        for (int i = 0; i < 10; ++i) {
+            boost::optional<Document> next = source()->getNext();
+            ASSERT(bool(next));
+            if (i == 4) {
+                ASSERT_EQUALS(DOC("a" << i % 2), *next);
+            } else {
+                ASSERT_EQUALS(DOC("a" << i % 2 << "b" << i), *next);
+            }
+        }
+        ASSERT(!source()->getNext());
+
+        // Only the first document and those whose shape differs from the one before them are
+        // built field by field.
+        ASSERT_EQUALS(7, source()->getDocsBuiltOnLayout());
+    }
+};
+
 }  // namespace DocumentSourceCursor
 
 class All : public Suite {
@@ -247,6 +286,7 @@ public:
         add<DocumentSourceCursor::Dispose>();
         add<DocumentSourceCursor::IterateDispose>();
         add<DocumentSourceCursor::LimitCoalesce>();
+        add<DocumentSourceCursor::ExtractFieldsWithLayout>();
     }
 };
 
@@ -0,0 +1,565 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+/**
+ * This file tests PlanStage::workBatch(), the stages that implement it and PlanExecutor's use of
+ * it, checking that a plan run in batches returns the same results as one run a unit of work at
+ * a time.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/delete.h"
+#include "mongo/db/exec/fetch.h"
+#include "mongo/db/exec/index_scan.h"
+#include "mongo/db/exec/limit.h"
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/projection.h"
+#include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/exec/skip.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/operation_context_impl.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
+#include "mongo/util/timer.h"
+
+namespace QueryStageBatch {
+
+using std::unique_ptr;
+using std::vector;
+using stdx::make_unique;
+
+class QueryStageBatchBase {
+public:
+    QueryStageBatchBase()
+        : _scopedXact(&_txn, MODE_IX),
+          _dbLock(_txn.lockState(), nsToDatabaseSubstring(ns()), MODE_X),
+          _ctx(&_txn, ns()) {
+        WriteUnitOfWork wunit(&_txn);
+        _ctx.db()->dropCollection(&_txn, ns());
+        _coll = _ctx.db()->createCollection(&_txn, ns());
+        ASSERT_OK(_coll->getIndexCatalog()->createIndexOnEmptyCollection(
+            &_txn,
+            BSON("ns" << ns() << "key" << BSON("foo" << 1) << "name"
+                      << DBClientBase::genIndexName(BSON("foo" << 1)))));
+        wunit.commit();
+    }
+
+    virtual ~QueryStageBatchBase() {
+        WriteUnitOfWork wunit(&_txn);
+        _ctx.db()->dropCollection(&_txn, ns());
+        wunit.commit();
+    }
+
+    /**
+     * Inserts 'numDocs' documents with 'foo' counting up from zero, each padded out with
+     * 'numExtraFields' more fields.
+     */
+    void insertDocs(int numDocs, int numExtraFields) {
+        for (int i = 0; i < numDocs; ++i) {
+            BSONObjBuilder bob;
+            bob.append("foo", i);
+            for (int j = 0; j < numExtraFields; ++j) {
+                bob.append(std::string(str::stream() << "field" << j), j);
+            }
+
+            WriteUnitOfWork wunit(&_txn);
+            ASSERT_OK(_coll->insertDocument(&_txn, bob.obj(), false).getStatus());
+            wunit.commit();
+        }
+    }
+
+    MatchExpression* parseFilter(const BSONObj& filterObj) {
+        StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(filterObj);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        return statusWithMatcher.getValue().release();
+    }
+
+    CollectionScan* makeCollectionScan(const MatchExpression* filter) {
+        CollectionScanParams params;
+        params.collection = _coll;
+        params.direction = CollectionScanParams::FORWARD;
+        params.tailable = false;
+        return new CollectionScan(&_txn, params, &_ws, filter);
+    }
+
+    IndexScan* makeIndexScan(int start, int end, WorkingSet* ws = nullptr) {
+        IndexScanParams params;
+        params.descriptor =
+            _coll->getIndexCatalog()->findIndexByKeyPattern(&_txn, BSON("foo" << 1));
+        invariant(params.descriptor);
+        params.bounds.isSimpleRange = true;
+        params.bounds.startKey = BSON("" << start);
+        params.bounds.endKey = BSON("" << end);
+        params.bounds.endKeyInclusive = true;
+        params.direction = 1;
+        return new IndexScan(&_txn, params, ws ? ws : &_ws, NULL);
+    }
+
+    ProjectionStageParams makeProjectionParams(const BSONObj& projObj) {
+        ProjectionStageParams params(_whereCallback);
+        params.projObj = projObj;
+        params.projImpl = ProjectionStageParams::SIMPLE_DOC;
+        return params;
+    }
+
+    /**
+     * Runs 'root' to EOF and returns the 'foo' field of each result. If 'batchSize' is zero,
+     * calls work() for each unit of work, and otherwise calls workBatch() with 'batchSize'.
+     */
+    vector<int> runToEOF(PlanStage* root, size_t batchSize) {
+        vector<int> out;
+        vector<WorkingSetID> results;
+        while (true) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state;
+            if (0 == batchSize) {
+                state = root->work(&id);
+                if (PlanStage::ADVANCED == state) {
+                    results.push_back(id);
+                }
+            } else {
+                state = root->workBatch(batchSize, &results, &id);
+                ASSERT_LESS_THAN_OR_EQUALS(results.size(), batchSize);
+            }
+
+            for (WorkingSetID result : results) {
+                out.push_back(_ws.get(result)->obj.value()["foo"].numberInt());
+                _ws.free(result);
+            }
+            results.clear();
+
+            if (PlanStage::IS_EOF == state) {
+                return out;
+            }
+            ASSERT(PlanStage::ADVANCED == state || PlanStage::NEED_TIME == state);
+        }
+    }
+
+    static void assertSameResults(const vector<int>& expected, const vector<int>& actual) {
+        ASSERT_EQUALS(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQUALS(expected[i], actual[i]);
+        }
+    }
+
+    static const char* ns() {
+        return "unittests.QueryStageBatch";
+    }
+
+protected:
+    OperationContextImpl _txn;
+    ScopedTransaction _scopedXact;
+    Lock::DBLock _dbLock;
+    OldClientContext _ctx;
+    Collection* _coll;
+    WorkingSet _ws;
+    WhereCallbackNoop _whereCallback;
+};
+
+/**
+ * COLLSCAN with a filter, under SKIP, LIMIT and PROJECTION, returns the same results in batches
+ * of any size as it does one unit of work at a time.
+ */
+class CollscanSkipLimitProjectMatchesWork : public QueryStageBatchBase {
+public:
+    void run() {
+        insertDocs(200, 3);
+        unique_ptr<MatchExpression> filter(
+            parseFilter(BSON("foo" << BSON("$mod" << BSON_ARRAY(3 << 0)))));
+
+        vector<int> expected;
+        for (int i = 30; i < 30 + 3 * 40; i += 3) {
+            expected.push_back(i);
+        }
+
+        for (size_t batchSize : {0, 1, 2, 7, 101, 1000}) {
+            unique_ptr<PlanStage> root = make_unique<ProjectionStage>(
+                &_txn,
+                makeProjectionParams(BSON("foo" << 1)),
+                &_ws,
+                new LimitStage(&_txn,
+                               40,
+                               &_ws,
+                               new SkipStage(&_txn, 10, &_ws, makeCollectionScan(filter.get()))));
+            assertSameResults(expected, runToEOF(root.get(), batchSize));
+            ASSERT_EQUALS(40U, root->getCommonStats()->advanced);
+        }
+    }
+};
+
+/**
+ * IXSCAN under a FETCH with a filter returns the same results in batches of any size as it does
+ * one unit of work at a time.
+ */
+class IxscanFetchFilterMatchesWork : public QueryStageBatchBase {
+public:
+    void run() {
+        insertDocs(200, 3);
+        unique_ptr<MatchExpression> filter(
+            parseFilter(BSON("foo" << BSON("$mod" << BSON_ARRAY(5 << 1)))));
+
+        vector<int> expected;
+        for (int i = 51; i <= 150; i += 5) {
+            expected.push_back(i);
+        }
+
+        for (size_t batchSize : {0, 1, 3, 64, 1000}) {
+            unique_ptr<PlanStage> root =
+                make_unique<FetchStage>(&_txn, &_ws, makeIndexScan(50, 150), filter.get(), _coll);
+            assertSameResults(expected, runToEOF(root.get(), batchSize));
+
+            const FetchStats* stats = static_cast<const FetchStats*>(root->getSpecificStats());
+            ASSERT_EQUALS(101U, stats->docsExamined);
+        }
+    }
+};
+
+/**
+ * A batch ended by its child's FAILURE still passes up the results produced before it, and then
+ * the FAILURE.
+ */
+class FetchPassesUpResultsBeforeChildFailure : public QueryStageBatchBase {
+public:
+    void run() {
+        auto queued = make_unique<QueuedDataStage>(&_txn, &_ws);
+        for (int i = 0; i < 3; ++i) {
+            WorkingSetID id = _ws.allocate();
+            WorkingSetMember* member = _ws.get(id);
+            member->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("foo" << i));
+            member->transitionToOwnedObj();
+            queued->pushBack(id);
+        }
+        queued->pushBack(PlanStage::NEED_TIME);
+        queued->pushBack(PlanStage::FAILURE);
+
+        FetchStage fetch(&_txn, &_ws, queued.release(), NULL, _coll);
+        vector<WorkingSetID> results;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        ASSERT_EQUALS(PlanStage::FAILURE, fetch.workBatch(10, &results, &id));
+        ASSERT_EQUALS(3U, results.size());
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_EQUALS(i, _ws.get(results[i])->obj.value()["foo"].numberInt());
+        }
+        ASSERT_NOT_EQUALS(WorkingSet::INVALID_ID, id);
+        ASSERT_EQUALS(3U, fetch.getCommonStats()->advanced);
+    }
+};
+
+/**
+ * Sets internalQueryExecWorkBatchSize for the lifetime of a test.
+ */
+class WorkBatchSizeSetting {
+public:
+    WorkBatchSizeSetting(int batchSize) : _oldBatchSize(internalQueryExecWorkBatchSize) {
+        internalQueryExecWorkBatchSize = batchSize;
+    }
+
+    ~WorkBatchSizeSetting() {
+        internalQueryExecWorkBatchSize = _oldBatchSize;
+    }
+
+private:
+    const int _oldBatchSize;
+};
+
+/**
+ * PlanExecutor hands out the results of a batch one at a time, and only then the state which
+ * ended it. It is not at EOF while results are left, even though its root is.
+ */
+class ExecutorReturnsResultsBeforeBatchEndState : public QueryStageBatchBase {
+public:
+    void run() {
+        WorkBatchSizeSetting batchSizeSetting(10);
+
+        auto ws = make_unique<WorkingSet>();
+        auto queued = make_unique<QueuedDataStage>(&_txn, ws.get());
+        for (int i = 0; i < 3; ++i) {
+            WorkingSetID id = ws->allocate();
+            WorkingSetMember* member = ws->get(id);
+            member->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("foo" << i));
+            member->transitionToOwnedObj();
+            queued->pushBack(id);
+        }
+        queued->pushBack(PlanStage::NEED_TIME);
+        queued->pushBack(PlanStage::FAILURE);
+
+        auto statusWithPlanExecutor = PlanExecutor::make(
+            &_txn, std::move(ws), std::move(queued), _coll, PlanExecutor::YIELD_MANUAL);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        unique_ptr<PlanExecutor> exec = std::move(statusWithPlanExecutor.getValue());
+
+        BSONObj obj;
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&obj, NULL));
+            ASSERT_EQUALS(i, obj["foo"].numberInt());
+            if (i < 2) {
+                ASSERT_FALSE(exec->isEOF());
+            }
+        }
+        ASSERT_EQUALS(PlanExecutor::FAILURE, exec->getNext(&obj, NULL));
+    }
+};
+
+/**
+ * Invalidating the RecordId of a result PlanExecutor has yet to return force-fetches it, so the
+ * result is still returned with its document.
+ */
+class ExecutorInvalidatesBatchedResults : public QueryStageBatchBase {
+public:
+    void run() {
+        WorkBatchSizeSetting batchSizeSetting(64);
+        insertDocs(10, 0);
+
+        vector<RecordId> locs;
+        auto cursor = _coll->getCursor(&_txn);
+        while (auto record = cursor->next()) {
+            locs.push_back(record->id);
+        }
+        ASSERT_EQUALS(10U, locs.size());
+
+        auto ws = make_unique<WorkingSet>();
+        CollectionScanParams params;
+        params.collection = _coll;
+        params.direction = CollectionScanParams::FORWARD;
+        params.tailable = false;
+        auto scan = make_unique<CollectionScan>(&_txn, params, ws.get(), nullptr);
+
+        auto statusWithPlanExecutor = PlanExecutor::make(
+            &_txn, std::move(ws), std::move(scan), _coll, PlanExecutor::YIELD_MANUAL);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        unique_ptr<PlanExecutor> exec = std::move(statusWithPlanExecutor.getValue());
+
+        // The first call runs the whole scan as one batch.
+        BSONObj obj;
+        ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&obj, NULL));
+        ASSERT_EQUALS(0, obj["foo"].numberInt());
+
+        exec->saveState();
+        exec->invalidate(&_txn, locs[1], INVALIDATION_DELETION);
+        ASSERT(exec->restoreState());
+
+        for (int i = 1; i < 10; ++i) {
+            ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&obj, NULL));
+            ASSERT_EQUALS(i, obj["foo"].numberInt());
+        }
+        ASSERT_EQUALS(PlanExecutor::IS_EOF, exec->getNext(&obj, NULL));
+    }
+};
+
+/**
+ * Invalidating the RecordId of an index-only result PlanExecutor has yet to return drops it, as
+ * the index entry it came from may be gone.
+ */
+class ExecutorDropsInvalidatedIndexOnlyResults : public QueryStageBatchBase {
+public:
+    void run() {
+        WorkBatchSizeSetting batchSizeSetting(64);
+        insertDocs(10, 0);
+
+        vector<RecordId> locs;
+        auto cursor = _coll->getCursor(&_txn);
+        while (auto record = cursor->next()) {
+            locs.push_back(record->id);
+        }
+        ASSERT_EQUALS(10U, locs.size());
+
+        auto ws = make_unique<WorkingSet>();
+        unique_ptr<PlanStage> scan(makeIndexScan(0, 9, ws.get()));
+
+        auto statusWithPlanExecutor = PlanExecutor::make(
+            &_txn, std::move(ws), std::move(scan), _coll, PlanExecutor::YIELD_MANUAL);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        unique_ptr<PlanExecutor> exec = std::move(statusWithPlanExecutor.getValue());
+
+        // The first call runs the whole scan as one batch. Results are index keys.
+        BSONObj obj;
+        ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&obj, NULL));
+        ASSERT_EQUALS(0, obj.firstElement().numberInt());
+
+        exec->saveState();
+        exec->invalidate(&_txn, locs[1], INVALIDATION_DELETION);
+        ASSERT(exec->restoreState());
+
+        for (int i = 2; i < 10; ++i) {
+            ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&obj, NULL));
+            ASSERT_EQUALS(i, obj.firstElement().numberInt());
+        }
+        ASSERT_EQUALS(PlanExecutor::IS_EOF, exec->getNext(&obj, NULL));
+    }
+};
+
+/**
+ * PlanExecutor does not work its tree further ahead than the number of results its caller said
+ * it wants.
+ */
+class ExecutorStopsBatchAtResultsWanted : public QueryStageBatchBase {
+public:
+    void run() {
+        WorkBatchSizeSetting batchSizeSetting(64);
+
+        auto ws = make_unique<WorkingSet>();
+        auto queued = make_unique<QueuedDataStage>(&_txn, ws.get());
+        for (int i = 0; i < 10; ++i) {
+            WorkingSetID id = ws->allocate();
+            WorkingSetMember* member = ws->get(id);
+            member->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("foo" << i));
+            member->transitionToOwnedObj();
+            queued->pushBack(id);
+        }
+        QueuedDataStage* queuedStage = queued.get();
+
+        auto statusWithPlanExecutor = PlanExecutor::make(
+            &_txn, std::move(ws), std::move(queued), _coll, PlanExecutor::YIELD_MANUAL);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        unique_ptr<PlanExecutor> exec = std::move(statusWithPlanExecutor.getValue());
+
+        BSONObj obj;
+        exec->setNumResultsWanted(3);
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&obj, NULL));
+            ASSERT_EQUALS(i, obj["foo"].numberInt());
+        }
+        ASSERT_EQUALS(3U, queuedStage->getCommonStats()->works);
+
+        // Asking for more results than were wanted works the tree one unit at a time.
+        ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&obj, NULL));
+        ASSERT_EQUALS(3, obj["foo"].numberInt());
+        ASSERT_EQUALS(4U, queuedStage->getCommonStats()->works);
+
+        // A caller which does not know how many results it wants gets the full batch size.
+        exec->setNumResultsWanted(0);
+        for (int i = 4; i < 10; ++i) {
+            ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&obj, NULL));
+            ASSERT_EQUALS(i, obj["foo"].numberInt());
+        }
+        ASSERT_EQUALS(PlanExecutor::IS_EOF, exec->getNext(&obj, NULL));
+    }
+};
+
+/**
+ * A tree which writes is worked one unit at a time whatever the batch size, so a DELETE does not
+ * remove documents its caller has yet to ask for.
+ */
+class ExecutorDoesNotBatchWrites : public QueryStageBatchBase {
+public:
+    void run() {
+        WorkBatchSizeSetting batchSizeSetting(64);
+        insertDocs(10, 0);
+
+        auto ws = make_unique<WorkingSet>();
+        CollectionScanParams scanParams;
+        scanParams.collection = _coll;
+        scanParams.direction = CollectionScanParams::FORWARD;
+        scanParams.tailable = false;
+        DeleteStageParams deleteParams;
+        deleteParams.isMulti = true;
+        deleteParams.returnDeleted = true;
+        auto deleteStage = make_unique<DeleteStage>(
+            &_txn,
+            deleteParams,
+            ws.get(),
+            _coll,
+            new CollectionScan(&_txn, scanParams, ws.get(), nullptr));
+
+        auto statusWithPlanExecutor = PlanExecutor::make(
+            &_txn, std::move(ws), std::move(deleteStage), _coll, PlanExecutor::YIELD_MANUAL);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        unique_ptr<PlanExecutor> exec = std::move(statusWithPlanExecutor.getValue());
+
+        BSONObj obj;
+        ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&obj, NULL));
+        ASSERT_EQUALS(0, obj["foo"].numberInt());
+        ASSERT_EQUALS(9U, _coll->numRecords(&_txn));
+    }
+};
+
+/**
+ * Reports the per-document cost of a wide COLLSCAN -> FETCH -> PROJECTION scan run one unit of
+ * work at a time and in batches. Timings are logged rather than asserted on.
+ */
+class WideScanBenchmark : public QueryStageBatchBase {
+public:
+    void run() {
+        const int kNumDocs = 20000;
+        insertDocs(kNumDocs, 20);
+
+        for (size_t batchSize : {0, 16, 128, 1024}) {
+            unique_ptr<PlanStage> root = make_unique<ProjectionStage>(
+                &_txn,
+                makeProjectionParams(BSON("foo" << 1 << "field0" << 1)),
+                &_ws,
+                new FetchStage(&_txn, &_ws, makeCollectionScan(NULL), NULL, _coll));
+
+            Timer timer;
+            ASSERT_EQUALS(size_t(kNumDocs), runToEOF(root.get(), batchSize).size());
+            const long long micros = timer.micros();
+
+            const std::string mode = batchSize
+                ? std::string(str::stream() << "workBatch(" << batchSize << ")")
+                : std::string("work()");
+            ::mongo::log() << "wide scan of " << kNumDocs << " documents using " << mode << ": "
+                           << micros << "us, " << (micros * 1000) / kNumDocs
+                           << "ns per document";
+        }
+    }
+};
+
+class All : public Suite {
+public:
+    All() : Suite("QueryStageBatch") {}
+
+    void setupTests() {
+        add<CollscanSkipLimitProjectMatchesWork>();
+        add<IxscanFetchFilterMatchesWork>();
+        add<FetchPassesUpResultsBeforeChildFailure>();
+        add<ExecutorReturnsResultsBeforeBatchEndState>();
+        add<ExecutorInvalidatesBatchedResults>();
+        add<ExecutorDropsInvalidatedIndexOnlyResults>();
+        add<ExecutorStopsBatchAtResultsWanted>();
+        add<ExecutorDoesNotBatchWrites>();
+        add<WideScanBenchmark>();
+    }
+};
+
+SuiteInstance<All> all;
+
+}  // namespace QueryStageBatch
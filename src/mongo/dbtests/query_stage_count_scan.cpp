@@ -39,6 +39,7 @@
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/operation_context_impl.h"
+#include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_registry.h"
@@ -635,6 +636,92 @@ public:
     }
 };
 
+//
+// Counts the keys in several intervals, yielding part way through
+//
+class QueryStageCountScanMultipleIntervals : public CountBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_txn, ns());
+
+        // Insert documents, add index
+        for (int i = 0; i < 20; ++i) {
+            insert(BSON("a" << i));
+        }
+        addIndex(BSON("a" << 1));
+
+        // Count a in [2, 4], (10, 12) and [15, 15]
+        CountScanParams params;
+        params.descriptor = getIndex(ctx.db(), BSON("a" << 1));
+        OrderedIntervalList oil("a");
+        oil.intervals.push_back(
+            IndexBoundsBuilder::makeRangeInterval(BSON("" << 2 << "" << 4), true, true));
+        oil.intervals.push_back(
+            IndexBoundsBuilder::makeRangeInterval(BSON("" << 10 << "" << 12), false, false));
+        oil.intervals.push_back(IndexBoundsBuilder::makePointInterval(15));
+        params.bounds.fields.push_back(oil);
+
+        WorkingSet ws;
+        CountScan count(&_txn, params, &ws);
+        WorkingSetID wsid;
+
+        int numCounted = 0;
+        PlanStage::StageState countState;
+
+        // Begin running the count
+        while (numCounted < 3) {
+            countState = count.work(&wsid);
+            if (PlanStage::ADVANCED == countState)
+                numCounted++;
+        }
+
+        // Yield between the first and the second interval
+        count.saveState();
+        count.restoreState();
+
+        // finish counting
+        while (PlanStage::IS_EOF != countState) {
+            countState = count.work(&wsid);
+            if (PlanStage::ADVANCED == countState)
+                numCounted++;
+        }
+        ASSERT_EQUALS(5, numCounted);
+
+        // The scan seeks over the gaps between intervals rather than reading the whole index.
+        const CountScanStats* stats = static_cast<const CountScanStats*>(count.getSpecificStats());
+        ASSERT_LESS_THAN(stats->keysExamined, 10U);
+    }
+};
+
+//
+// Counts each document once when its array matches in more than one interval
+//
+class QueryStageCountScanMultipleIntervalsDups : public CountBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_txn, ns());
+
+        insert(BSON("a" << BSON_ARRAY(1 << 5)));
+        insert(BSON("a" << BSON_ARRAY(5 << 9)));
+        insert(BSON("a" << 3));
+        addIndex(BSON("a" << 1));
+
+        CountScanParams params;
+        params.descriptor = getIndex(ctx.db(), BSON("a" << 1));
+        OrderedIntervalList oil("a");
+        oil.intervals.push_back(IndexBoundsBuilder::makePointInterval(1));
+        oil.intervals.push_back(IndexBoundsBuilder::makePointInterval(5));
+        oil.intervals.push_back(IndexBoundsBuilder::makePointInterval(9));
+        params.bounds.fields.push_back(oil);
+
+        WorkingSet ws;
+        CountScan count(&_txn, params, &ws);
+
+        int numCounted = runCount(&count);
+        ASSERT_EQUALS(2, numCounted);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_count_scan") {}
@@ -651,6 +738,8 @@ public:
         add<QueryStageCountScanInsertNewDocsDuringYield>();
         add<QueryStageCountScanBecomesMultiKeyDuringYield>();
         add<QueryStageCountScanUnusedKeys>();
+        add<QueryStageCountScanMultipleIntervals>();
+        add<QueryStageCountScanMultipleIntervalsDups>();
     }
 };
 
@@ -0,0 +1,243 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/skip_scan.h"
+#include "mongo/db/json.h"
+#include "mongo/db/operation_context_impl.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/dbtests/dbtests.h"
+
+/**
+ * This file tests db/exec/skip_scan.cpp
+ */
+
+namespace QueryStageSkipScan {
+
+class SkipScanBase {
+public:
+    SkipScanBase() : _client(&_txn) {}
+
+    virtual ~SkipScanBase() {
+        _client.dropCollection(ns());
+    }
+
+    void addIndex(const BSONObj& obj) {
+        ASSERT_OK(dbtests::createIndex(&_txn, ns(), obj));
+    }
+
+    void insert(const BSONObj& obj) {
+        _client.insert(ns(), obj);
+    }
+
+    /**
+     * Runs a skip scan over the index {a: 1, b: 1} with all values of 'a' and the given
+     * intervals for 'b'. Returns the keys in the order they are returned, and sets 'seeksOut' to
+     * the number of seeks the stage made and 'dupsDroppedOut', if given, to the number of
+     * duplicate RecordIds it dropped.
+     */
+    std::vector<BSONObj> runSkipScan(const std::vector<Interval>& bIntervals,
+                                     size_t* seeksOut,
+                                     size_t* dupsDroppedOut = NULL) {
+        AutoGetCollectionForRead ctx(&_txn, ns());
+        Collection* coll = ctx.getCollection();
+
+        SkipScanParams params;
+        params.descriptor =
+            coll->getIndexCatalog()->findIndexByKeyPattern(&_txn, BSON("a" << 1 << "b" << 1));
+        ASSERT(params.descriptor);
+        params.direction = 1;
+        params.bounds.isSimpleRange = false;
+        OrderedIntervalList aOil("a");
+        aOil.intervals.push_back(IndexBoundsBuilder::allValues());
+        params.bounds.fields.push_back(aOil);
+        OrderedIntervalList bOil("b");
+        bOil.intervals = bIntervals;
+        params.bounds.fields.push_back(bOil);
+
+        WorkingSet ws;
+        SkipScan scan(&_txn, params, &ws);
+
+        std::vector<BSONObj> keys;
+        WorkingSetID wsid;
+        PlanStage::StageState state;
+        while (PlanStage::IS_EOF != (state = scan.work(&wsid))) {
+            if (PlanStage::ADVANCED == state) {
+                WorkingSetMember* member = ws.get(wsid);
+                ASSERT_FALSE(member->hasObj());
+                ASSERT_EQUALS(1U, member->keyData.size());
+                keys.push_back(member->keyData[0].keyData.getOwned());
+                ws.free(wsid);
+            }
+        }
+
+        const SkipScanStats* stats = static_cast<const SkipScanStats*>(scan.getSpecificStats());
+        *seeksOut = stats->seeks;
+        if (dupsDroppedOut) {
+            *dupsDroppedOut = stats->dupsDropped;
+        }
+        return keys;
+    }
+
+    static const char* ns() {
+        return "unittests.QueryStageSkipScan";
+    }
+
+protected:
+    OperationContextImpl _txn;
+
+private:
+    DBDirectClient _client;
+};
+
+// A point interval on the trailing field is found under each value of the leading field, and
+// the keys in between are skipped over.
+class QueryStageSkipScanPoint : public SkipScanBase {
+public:
+    void run() {
+        for (int a = 0; a < 3; ++a) {
+            for (int b = 0; b < 500; ++b) {
+                insert(BSON("a" << a << "b" << b));
+            }
+        }
+        addIndex(BSON("a" << 1 << "b" << 1));
+
+        size_t seeks;
+        std::vector<BSONObj> keys =
+            runSkipScan({IndexBoundsBuilder::makePointInterval(17)}, &seeks);
+
+        ASSERT_EQUALS(3U, keys.size());
+        for (int a = 0; a < 3; ++a) {
+            ASSERT_EQUALS(BSON("" << a << "" << 17), keys[a]);
+        }
+
+        // Two seeks for each value of 'a', and one more to find there are no others.
+        ASSERT_LESS_THAN_OR_EQUALS(seeks, 7U);
+    }
+};
+
+// Several ranges on the trailing field are each scanned under every value of the leading field.
+class QueryStageSkipScanRanges : public SkipScanBase {
+public:
+    void run() {
+        for (int a = 0; a < 4; ++a) {
+            for (int b = 0; b < 100; ++b) {
+                insert(BSON("a" << a << "b" << b));
+            }
+        }
+        addIndex(BSON("a" << 1 << "b" << 1));
+
+        std::vector<Interval> bIntervals;
+        bIntervals.push_back(
+            IndexBoundsBuilder::makeRangeInterval(BSON("" << 10 << "" << 13), true, false));
+        bIntervals.push_back(
+            IndexBoundsBuilder::makeRangeInterval(BSON("" << 50 << "" << 52), true, true));
+
+        size_t seeks;
+        std::vector<BSONObj> keys = runSkipScan(bIntervals, &seeks);
+
+        std::vector<BSONObj> expected;
+        for (int a = 0; a < 4; ++a) {
+            for (int b : {10, 11, 12, 50, 51, 52}) {
+                expected.push_back(BSON("" << a << "" << b));
+            }
+        }
+
+        ASSERT_EQUALS(expected.size(), keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            ASSERT_EQUALS(expected[i], keys[i]);
+        }
+        // Each value of 'a' takes a seek to each of the two ranges, and one past them.
+        ASSERT_LESS_THAN_OR_EQUALS(seeks, 4U * 3U + 1U);
+    }
+};
+
+// Bounds on the trailing field which match nothing make the scan skip through every value of the
+// leading field without returning anything.
+class QueryStageSkipScanNoMatches : public SkipScanBase {
+public:
+    void run() {
+        for (int a = 0; a < 10; ++a) {
+            for (int b = 0; b < 100; ++b) {
+                insert(BSON("a" << a << "b" << b));
+            }
+        }
+        addIndex(BSON("a" << 1 << "b" << 1));
+
+        size_t seeks;
+        std::vector<BSONObj> keys =
+            runSkipScan({IndexBoundsBuilder::makePointInterval(1000)}, &seeks);
+
+        ASSERT_EQUALS(0U, keys.size());
+        ASSERT_LESS_THAN_OR_EQUALS(seeks, 11U);
+    }
+};
+
+// If the index is multikey, a document with several values of the leading field is returned only
+// once, under the first of them.
+class QueryStageSkipScanMultikeyDedup : public SkipScanBase {
+public:
+    void run() {
+        insert(BSON("a" << BSON_ARRAY(0 << 1 << 2) << "b" << 5));
+        insert(BSON("a" << 1 << "b" << 5));
+        insert(BSON("a" << 2 << "b" << 6));
+        addIndex(BSON("a" << 1 << "b" << 1));
+
+        size_t seeks;
+        size_t dupsDropped;
+        std::vector<BSONObj> keys =
+            runSkipScan({IndexBoundsBuilder::makePointInterval(5)}, &seeks, &dupsDropped);
+
+        ASSERT_EQUALS(2U, keys.size());
+        ASSERT_EQUALS(BSON("" << 0 << "" << 5), keys[0]);
+        ASSERT_EQUALS(BSON("" << 1 << "" << 5), keys[1]);
+        ASSERT_EQUALS(2U, dupsDropped);
+    }
+};
+
+class All : public Suite {
+public:
+    All() : Suite("query_stage_skip_scan") {}
+
+    void setupTests() {
+        add<QueryStageSkipScanPoint>();
+        add<QueryStageSkipScanRanges>();
+        add<QueryStageSkipScanNoMatches>();
+        add<QueryStageSkipScanMultikeyDedup>();
+    }
+};
+
+SuiteInstance<All> queryStageSkipScanAll;
+
+}  // namespace QueryStageSkipScan
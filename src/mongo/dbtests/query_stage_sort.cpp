@@ -26,6 +26,10 @@
  *    then also delete it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
@@ -38,8 +42,11 @@
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 /**
  * This file tests db/exec/sort.cpp
@@ -572,6 +579,79 @@ public:
     }
 };
 
+// Sorts on a compound key with sort keys compared as KeyStrings and as BSON, checking that both
+// produce the same order and logging how long each takes.
+class QueryStageSortKeyStringComparison : public QueryStageSortTestBase {
+public:
+    virtual int numObj() {
+        return 50 * 1000;
+    }
+
+    void run() {
+        OldClientWriteContext ctx(&_txn, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(ns());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_txn);
+            coll = db->createCollection(&_txn, ns());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < numObj(); ++i) {
+            const int n = (i * 7919) % numObj();
+            insert(BSON("_id" << i << "a" << n % 10 << "b"
+                              << ("user" + std::to_string(n % 1000)) << "c" << n * 0.5));
+        }
+
+        const bool oldUseKeyString = internalQueryExecSortUseKeyString;
+        std::vector<BSONObj> results[2];
+        for (int useKeyString = 0; useKeyString < 2; useKeyString++) {
+            internalQueryExecSortUseKeyString = useKeyString;
+            Timer timer;
+            results[useKeyString] = sortAll(coll);
+            ::mongo::log() << "sorted " << numObj() << " documents on {a: 1, b: -1, c: 1} "
+                           << (useKeyString ? "as KeyStrings" : "as BSON") << ": "
+                           << timer.millis() << "ms";
+        }
+        internalQueryExecSortUseKeyString = oldUseKeyString;
+
+        ASSERT_EQUALS(results[0].size(), static_cast<size_t>(numObj()));
+        ASSERT_EQUALS(results[1].size(), static_cast<size_t>(numObj()));
+        for (int i = 0; i < numObj(); ++i) {
+            ASSERT_EQUALS(results[0][i], results[1][i]);
+        }
+    }
+
+private:
+    std::vector<BSONObj> sortAll(Collection* coll) {
+        auto ws = make_unique<WorkingSet>();
+        auto queuedDataStage = make_unique<QueuedDataStage>(&_txn, ws.get());
+        insertVarietyOfObjects(ws.get(), queuedDataStage.get(), coll);
+
+        SortStageParams params;
+        params.collection = coll;
+        params.pattern = BSON("a" << 1 << "b" << -1 << "c" << 1);
+
+        auto keyGenStage = make_unique<SortKeyGeneratorStage>(
+            &_txn, queuedDataStage.release(), ws.get(), coll, params.pattern, BSONObj());
+        auto sortStage = make_unique<SortStage>(&_txn, params, ws.get(), keyGenStage.release());
+        auto fetchStage =
+            make_unique<FetchStage>(&_txn, ws.get(), sortStage.release(), nullptr, coll);
+
+        auto statusWithPlanExecutor = PlanExecutor::make(
+            &_txn, std::move(ws), std::move(fetchStage), coll, PlanExecutor::YIELD_MANUAL);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        unique_ptr<PlanExecutor> exec = std::move(statusWithPlanExecutor.getValue());
+
+        std::vector<BSONObj> out;
+        BSONObj obj;
+        while (PlanExecutor::ADVANCED == exec->getNext(&obj, NULL)) {
+            out.push_back(obj.getOwned());
+        }
+        return out;
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_sort") {}
@@ -589,6 +669,7 @@ public:
         add<QueryStageSortDeletionInvalidationWithLimit<10>>();
         add<QueryStageSortDeletionInvalidationWithLimit<1>>();
         add<QueryStageSortParallelArrays>();
+        add<QueryStageSortKeyStringComparison>();
     }
 };
 
@@ -1344,6 +1344,41 @@ public:
     int _n;
 };
 
+/**
+ * Waiters on a capped collection are told of an insert only once it commits.
+ */
+class CappedInsertNotifiedOnCommit : public CollectionBase {
+public:
+    CappedInsertNotifiedOnCommit() : CollectionBase("cappedinsertnotifiedoncommit") {
+        _client.dropCollection(ns());
+    }
+    void run() {
+        OldClientWriteContext ctx(&_txn, ns());
+        {
+            WriteUnitOfWork wunit(&_txn);
+            ASSERT(userCreateNS(&_txn,
+                                ctx.db(),
+                                ns(),
+                                fromjson("{ capped : true, size : 8192 }"),
+                                false).isOK());
+            wunit.commit();
+        }
+
+        Collection* collection = ctx.getCollection();
+        ASSERT(collection);
+        auto notifier = collection->getCappedInsertNotifier();
+        uint64_t count = notifier->getCount();
+
+        {
+            WriteUnitOfWork wunit(&_txn);
+            ASSERT_OK(collection->insertDocument(&_txn, BSON("_id" << 1), false).getStatus());
+            ASSERT_EQUALS(count, notifier->getCount());
+            wunit.commit();
+        }
+        ASSERT_LESS_THAN(count, notifier->getCount());
+    }
+};
+
 class HelperTest : public CollectionBase {
 public:
     HelperTest() : CollectionBase("helpertest") {}
@@ -1766,6 +1801,7 @@ public:
         add<DifferentNumbers>();
         add<SymbolStringSame>();
         add<TailableCappedRaceCondition>();
+        add<CappedInsertNotifiedOnCommit>();
         add<HelperTest>();
         add<HelperByIdTest>();
         add<FindingStartPartiallyFull>();
@@ -40,6 +40,7 @@
 #include "mongo/config.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/dbtests/dbtests.h"
@@ -766,6 +767,54 @@ private:
     }
 };
 
+// Measures how the throughput of uncontended intent lock acquisitions on the global and database
+// resources scales with the number of threads. The timings are logged, not asserted on.
+class IntentLockScaling {
+public:
+    void run() {
+        const unsigned maxThreads = std::max(2U, stdx::thread::hardware_concurrency());
+        for (unsigned numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+            Timer timer;
+            std::vector<stdx::thread> threads;
+            for (unsigned i = 0; i < numThreads; i++) {
+                threads.emplace_back(stdx::bind(&IntentLockScaling::lockUnlock, this));
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            const long long micros = std::max(1LL, timer.micros());
+            ::mongo::log() << "IntentLockScaling threads: " << numThreads
+                           << " lock/unlock pairs per second: "
+                           << (numThreads * kIterations * 1000000LL) / micros;
+        }
+    }
+
+private:
+    static const int kIterations = 200000;
+
+    void lockUnlock() {
+        const ResourceId globalId(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL);
+        const ResourceId dbId(RESOURCE_DATABASE, string("TestDB"));
+
+        DefaultLockerImpl locker;
+        TrackingLockGrantNotification notify;
+        LockRequest globalRequest;
+        LockRequest dbRequest;
+        for (int i = 0; i < kIterations; i++) {
+            globalRequest.initNew(&locker, &notify);
+            invariant(LOCK_OK == _lockMgr.lock(globalId, &globalRequest, MODE_IX));
+            dbRequest.initNew(&locker, &notify);
+            invariant(LOCK_OK == _lockMgr.lock(dbId, &dbRequest, MODE_IS));
+
+            _lockMgr.unlock(&dbRequest);
+            _lockMgr.unlock(&globalRequest);
+        }
+    }
+
+    LockManager _lockMgr;
+};
+
 class All : public Suite {
 public:
     All() : Suite("threading") {}
@@ -793,6 +842,7 @@ public:
 
         add<MongoMutexTest>();
         add<TicketHolderWaits>();
+        add<IntentLockScaling>();
     }
 };
 
@@ -43,6 +43,8 @@ const unsigned int NetworkInterface::kMessagingPortKeepOpen;
 NetworkInterface::NetworkInterface() {}
 NetworkInterface::~NetworkInterface() {}
 
+void NetworkInterface::appendConnectionStats(BSONObjBuilder* b) const {}
+
 
 }  // namespace executor
 }  // namespace mongo
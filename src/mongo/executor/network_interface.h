@@ -36,6 +36,9 @@
 #include "mongo/stdx/functional.h"
 
 namespace mongo {
+
+class BSONObjBuilder;
+
 namespace executor {
 
 /**
@@ -58,6 +61,12 @@ public:
      */
     virtual std::string getDiagnosticString() = 0;
 
+    /**
+     * Appends statistics about the connections this network interface keeps open to remote
+     * hosts. The default implementation appends nothing.
+     */
+    virtual void appendConnectionStats(BSONObjBuilder* b) const;
+
     /**
      * Starts up the network interface.
      *
@@ -53,11 +53,20 @@ NetworkInterfaceASIO::NetworkInterfaceASIO(
 NetworkInterfaceASIO::NetworkInterfaceASIO(
     std::unique_ptr<AsyncStreamFactoryInterface> streamFactory,
     std::unique_ptr<NetworkConnectionHook> networkConnectionHook)
+    : NetworkInterfaceASIO(
+          std::move(streamFactory), std::move(networkConnectionHook), ConnectionPoolOptions()) {}
+
+NetworkInterfaceASIO::NetworkInterfaceASIO(
+    std::unique_ptr<AsyncStreamFactoryInterface> streamFactory,
+    std::unique_ptr<NetworkConnectionHook> networkConnectionHook,
+    const ConnectionPoolOptions& poolOptions)
     : _io_service(),
       _hook(std::move(networkConnectionHook)),
       _resolver(_io_service),
       _state(State::kReady),
       _streamFactory(std::move(streamFactory)),
+      _poolOptions(poolOptions),
+      _poolExpiryTimer(_io_service),
       _isExecutorRunnable(false) {}
 
 std::string NetworkInterfaceASIO::getDiagnosticString() {
@@ -72,6 +81,7 @@ std::string NetworkInterfaceASIO::getHostName() {
 }
 
 void NetworkInterfaceASIO::startup() {
+    asio::post(_io_service, [this]() { _scheduleIdleConnectionExpiry(); });
     _serviceRunner = stdx::thread([this]() {
         asio::io_service::work work(_io_service);
         _io_service.run();
@@ -83,6 +93,9 @@ void NetworkInterfaceASIO::shutdown() {
     _state.store(State::kShutdown);
     _io_service.stop();
     _serviceRunner.join();
+
+    // Nothing runs on the io_service any more, so the timer can safely be touched from here.
+    _poolExpiryTimer.cancel();
 }
 
 void NetworkInterfaceASIO::waitForWork() {
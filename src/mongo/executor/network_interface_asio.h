@@ -31,6 +31,7 @@
 #include <asio.hpp>
 
 #include <boost/optional.hpp>
+#include <deque>
 #include <memory>
 #include <string>
 #include <system_error>
@@ -48,7 +49,9 @@
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/net/hostandport.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace executor {
@@ -62,10 +65,38 @@ class AsyncStreamInterface;
  */
 class NetworkInterfaceASIO final : public NetworkInterface {
 public:
+    /**
+     * Limits on the connections kept open to each remote host between commands. Connections are
+     * returned to the pool after a command completes without a network error, and are reused by
+     * later commands to the same host instead of connecting and authenticating again.
+     */
+    struct ConnectionPoolOptions {
+        // Idle connections to a host are never expired below this count.
+        size_t minConnectionsPerHost = 1;
+
+        // At most this many idle connections are kept per host. A connection returned to a full
+        // pool is closed.
+        size_t maxConnectionsPerHost = 16;
+
+        // Idle connections that have not been used for this long are closed.
+        Milliseconds hostTimeout = Minutes(5);
+
+        // Connections that have been idle for at least this long are checked with an isMaster
+        // before they are reused, and replaced by a new connection if the check fails.
+        Milliseconds refreshRequirement = Minutes(1);
+
+        // How often idle connections are checked against hostTimeout.
+        Milliseconds expiryInterval = Seconds(10);
+    };
+
+    NetworkInterfaceASIO(std::unique_ptr<AsyncStreamFactoryInterface> streamFactory,
+                         std::unique_ptr<NetworkConnectionHook> networkConnectionHook,
+                         const ConnectionPoolOptions& poolOptions);
     NetworkInterfaceASIO(std::unique_ptr<AsyncStreamFactoryInterface> streamFactory,
                          std::unique_ptr<NetworkConnectionHook> networkConnectionHook);
     NetworkInterfaceASIO(std::unique_ptr<AsyncStreamFactoryInterface> streamFactory);
     std::string getDiagnosticString() override;
+    void appendConnectionStats(BSONObjBuilder* b) const override;
     std::string getHostName() override;
     void startup() override;
     void shutdown() override;
@@ -163,6 +194,10 @@ private:
 
         void setConnection(AsyncConnection&& conn);
 
+        // Detaches the connection from this operation, so that it can be returned to the
+        // connection pool or closed. Any current command is discarded with it.
+        AsyncConnection releaseConnection();
+
         // AsyncOp may run multiple commands over its lifetime (for example, an ismaster
         // command, the command provided to the NetworkInterface via startCommand(), etc.)
         // Calling beginCommand() resets internal state to prepare to run newCommand.
@@ -240,6 +275,8 @@ private:
     // setup plaintext TCP socket
     void _setupSocket(AsyncOp* op, asio::ip::tcp::resolver::iterator endpoints);
 
+    static std::unique_ptr<Message> _makeIsMasterRequest();
+
     void _runIsMaster(AsyncOp* op);
     void _runConnectionHook(AsyncOp* op);
     void _authenticate(AsyncOp* op);
@@ -254,6 +291,47 @@ private:
 
     void _asyncRunCommand(AsyncCommand* cmd, NetworkOpHandler handler);
 
+    // Connection pool
+    struct PooledConnection {
+        PooledConnection(AsyncConnection&& conn, Date_t lastUsed);
+
+// Explicit move construction and assignment to support MSVC
+#if defined(_MSC_VER) && _MSC_VER < 1900
+        PooledConnection(PooledConnection&&);
+        PooledConnection& operator=(PooledConnection&&);
+#else
+        PooledConnection(PooledConnection&&) = default;
+        PooledConnection& operator=(PooledConnection&&) = default;
+#endif
+
+        AsyncConnection conn;
+        Date_t lastUsed;
+    };
+
+    struct HostConnectionPool {
+        // Ordered from least to most recently used.
+        std::deque<PooledConnection> idle;
+
+        // Number of connections opened to the host, and number of commands that reused an idle
+        // connection instead.
+        long long created = 0;
+        long long reused = 0;
+    };
+
+    // Starts "op" on an idle pooled connection to its target if there is one, and otherwise
+    // connects as usual.
+    void _acquireConnection(AsyncOp* op);
+
+    // Checks that a connection which has been idle for a while still works before using it.
+    void _refreshConnection(AsyncOp* op);
+    void _runOnPooledConnection(AsyncOp* op);
+
+    void _returnConnection(AsyncOp* op);
+    void _noteConnectionCreated(const HostAndPort& target);
+
+    void _scheduleIdleConnectionExpiry();
+    void _expireIdleConnections(Date_t now);
+
     asio::io_service _io_service;
     stdx::thread _serviceRunner;
 
@@ -265,6 +343,14 @@ private:
 
     std::unique_ptr<AsyncStreamFactoryInterface> _streamFactory;
 
+    const ConnectionPoolOptions _poolOptions;
+
+    // Declared after _io_service and _streamFactory, so that pooled connections are closed
+    // before either is destroyed.
+    mutable stdx::mutex _poolMutex;
+    std::unordered_map<HostAndPort, HostConnectionPool> _pool;
+    asio::steady_timer _poolExpiryTimer;
+
     stdx::mutex _inProgressMutex;
     std::unordered_map<AsyncOp*, std::unique_ptr<AsyncOp>> _inProgress;
 
@@ -48,7 +48,7 @@ namespace executor {
 
 using ResponseStatus = TaskExecutor::ResponseStatus;
 
-void NetworkInterfaceASIO::_runIsMaster(AsyncOp* op) {
+std::unique_ptr<Message> NetworkInterfaceASIO::_makeIsMasterRequest() {
     // We use a legacy builder to create our ismaster request because we may
     // have to communicate with servers that do not support OP_COMMAND
     rpc::LegacyRequestBuilder requestBuilder{};
@@ -56,9 +56,12 @@ void NetworkInterfaceASIO::_runIsMaster(AsyncOp* op) {
     requestBuilder.setCommandName("isMaster");
     requestBuilder.setMetadata(rpc::makeEmptyMetadata());
     requestBuilder.setCommandArgs(BSON("isMaster" << 1));
+    return requestBuilder.done();
+}
 
+void NetworkInterfaceASIO::_runIsMaster(AsyncOp* op) {
     // Set current command to ismaster request and run
-    auto& cmd = op->beginCommand(std::move(*(requestBuilder.done())), now());
+    auto& cmd = op->beginCommand(std::move(*_makeIsMasterRequest()), now());
 
     // Callback to parse protocol information out of received ismaster response
     auto parseIsMaster = [this, op]() {
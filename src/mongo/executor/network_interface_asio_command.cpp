@@ -183,8 +183,8 @@ void NetworkInterfaceASIO::_startCommand(AsyncOp* op) {
         return;
     }
 
-    // _connect() will continue the state machine.
-    _connect(op);
+    // _acquireConnection() will continue the state machine.
+    _acquireConnection(op);
 }
 
 void NetworkInterfaceASIO::_beginCommunication(AsyncOp* op) {
@@ -199,6 +199,10 @@ void NetworkInterfaceASIO::_beginCommunication(AsyncOp* op) {
 void NetworkInterfaceASIO::_completedOpCallback(AsyncOp* op) {
     // TODO: handle metadata readers.
     auto response = op->command().response(op->operationProtocol(), now());
+    if (response.isOK()) {
+        // The connection is in a known state, so later commands to this host can reuse it.
+        _returnConnection(op);
+    }
     _completeOperation(op, response);
 }
 
@@ -99,6 +99,7 @@ void NetworkInterfaceASIO::_setupSocket(AsyncOp* op, tcp::resolver::iterator end
         auto stream = _streamFactory->makeStream(&_io_service, op->request().target);
         op->setConnection({std::move(stream), rpc::supports::kOpQueryOnly});
     }
+    _noteConnectionCreated(op->request().target);
 
     auto& stream = op->connection().stream();
 
@@ -0,0 +1,221 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/network_interface_asio.h"
+
+#include <utility>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/executor/async_stream_interface.h"
+#include "mongo/rpc/protocol.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace executor {
+
+NetworkInterfaceASIO::PooledConnection::PooledConnection(AsyncConnection&& conn, Date_t lastUsed)
+    : conn(std::move(conn)), lastUsed(lastUsed) {}
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+NetworkInterfaceASIO::PooledConnection::PooledConnection(PooledConnection&& other)
+    : conn(std::move(other.conn)), lastUsed(other.lastUsed) {}
+
+NetworkInterfaceASIO::PooledConnection& NetworkInterfaceASIO::PooledConnection::operator=(
+    PooledConnection&& other) {
+    conn = std::move(other.conn);
+    lastUsed = other.lastUsed;
+    return *this;
+}
+#endif
+
+void NetworkInterfaceASIO::appendConnectionStats(BSONObjBuilder* b) const {
+    long long totalAvailable = 0;
+    long long totalCreated = 0;
+    long long totalReused = 0;
+
+    stdx::lock_guard<stdx::mutex> lk(_poolMutex);
+    BSONObjBuilder hostsBuilder(b->subobjStart("hosts"));
+    for (auto&& entry : _pool) {
+        const auto& hostPool = entry.second;
+        const long long available = static_cast<long long>(hostPool.idle.size());
+
+        BSONObjBuilder hostBuilder(hostsBuilder.subobjStart(entry.first.toString()));
+        hostBuilder.appendNumber("available", available);
+        hostBuilder.appendNumber("created", hostPool.created);
+        hostBuilder.appendNumber("reused", hostPool.reused);
+        hostBuilder.done();
+
+        totalAvailable += available;
+        totalCreated += hostPool.created;
+        totalReused += hostPool.reused;
+    }
+    hostsBuilder.done();
+
+    b->appendNumber("totalAvailable", totalAvailable);
+    b->appendNumber("totalCreated", totalCreated);
+    b->appendNumber("totalReused", totalReused);
+}
+
+void NetworkInterfaceASIO::_acquireConnection(AsyncOp* op) {
+    boost::optional<PooledConnection> pooled;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_poolMutex);
+        auto it = _pool.find(op->request().target);
+        if (it != _pool.end() && !it->second.idle.empty()) {
+            // Take the most recently used connection, so that the others can expire.
+            pooled.emplace(std::move(it->second.idle.back()));
+            it->second.idle.pop_back();
+            ++it->second.reused;
+        }
+    }
+
+    if (!pooled) {
+        // _connect() will continue the state machine.
+        return _connect(op);
+    }
+
+    const bool needsRefresh = (now() - pooled->lastUsed) >= _poolOptions.refreshRequirement;
+    op->setConnection(std::move(pooled->conn));
+
+    if (needsRefresh) {
+        return _refreshConnection(op);
+    }
+    _runOnPooledConnection(op);
+}
+
+void NetworkInterfaceASIO::_refreshConnection(AsyncOp* op) {
+    auto& cmd = op->beginCommand(std::move(*_makeIsMasterRequest()), now());
+
+    auto checkIsMaster = [this, op](std::error_code ec, size_t bytes) {
+        if (op->canceled()) {
+            return _completeOperation(op,
+                                      Status(ErrorCodes::CallbackCanceled, "Callback canceled"));
+        }
+
+        Status status = Status::OK();
+        if (ec) {
+            status = Status(ErrorCodes::HostUnreachable, ec.message());
+        } else {
+            auto swCommandReply = op->command().response(rpc::Protocol::kOpQuery, now());
+            if (swCommandReply.isOK()) {
+                auto protocolSet =
+                    rpc::parseProtocolSetFromIsMasterReply(swCommandReply.getValue().data);
+                if (protocolSet.isOK()) {
+                    op->connection().setServerProtocols(protocolSet.getValue());
+                    return _runOnPooledConnection(op);
+                }
+                status = protocolSet.getStatus();
+            } else {
+                status = swCommandReply.getStatus();
+            }
+        }
+
+        // The connection went bad while it sat in the pool. Close it and open a new one, which
+        // runs the full connection handshake.
+        LOG(2) << "discarding idle connection to " << op->request().target
+               << " that failed its health check: " << status;
+        op->releaseConnection();
+        _connect(op);
+    };
+
+    _asyncRunCommand(&cmd, std::move(checkIsMaster));
+}
+
+void NetworkInterfaceASIO::_runOnPooledConnection(AsyncOp* op) {
+    // Pooled connections have already been authenticated and have run the connection hook, so
+    // all that remains is to pick the protocol for this operation.
+    auto negotiatedProtocol =
+        rpc::negotiate(op->connection().serverProtocols(), op->connection().clientProtocols());
+    if (!negotiatedProtocol.isOK()) {
+        return _completeOperation(op, negotiatedProtocol.getStatus());
+    }
+    op->setOperationProtocol(negotiatedProtocol.getValue());
+
+    _beginCommunication(op);
+}
+
+void NetworkInterfaceASIO::_returnConnection(AsyncOp* op) {
+    if (inShutdown()) {
+        return;
+    }
+
+    // Declared before the lock is taken, so that a connection which does not fit in the pool is
+    // closed after the lock is released.
+    auto conn = op->releaseConnection();
+
+    stdx::lock_guard<stdx::mutex> lk(_poolMutex);
+    auto& hostPool = _pool[op->request().target];
+    if (hostPool.idle.size() >= _poolOptions.maxConnectionsPerHost) {
+        return;
+    }
+    hostPool.idle.emplace_back(std::move(conn), now());
+}
+
+void NetworkInterfaceASIO::_noteConnectionCreated(const HostAndPort& target) {
+    stdx::lock_guard<stdx::mutex> lk(_poolMutex);
+    ++_pool[target].created;
+}
+
+void NetworkInterfaceASIO::_scheduleIdleConnectionExpiry() {
+    _poolExpiryTimer.expires_after(_poolOptions.expiryInterval);
+    _poolExpiryTimer.async_wait([this](std::error_code ec) {
+        if (ec || inShutdown()) {
+            // The timer is canceled when the network interface is shut down.
+            return;
+        }
+        _expireIdleConnections(now());
+        _scheduleIdleConnectionExpiry();
+    });
+}
+
+void NetworkInterfaceASIO::_expireIdleConnections(Date_t now) {
+    std::vector<PooledConnection> expired;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_poolMutex);
+        for (auto&& entry : _pool) {
+            auto& idle = entry.second.idle;
+            while (idle.size() > _poolOptions.minConnectionsPerHost &&
+                   (now - idle.front().lastUsed) >= _poolOptions.hostTimeout) {
+                expired.push_back(std::move(idle.front()));
+                idle.pop_front();
+            }
+        }
+    }
+
+    if (!expired.empty()) {
+        LOG(2) << "closing " << expired.size() << " idle connections";
+    }
+}
+
+}  // namespace executor
+}  // namespace mongo
@@ -91,6 +91,15 @@ void NetworkInterfaceASIO::AsyncOp::setConnection(AsyncConnection&& conn) {
     _connection = std::move(conn);
 }
 
+NetworkInterfaceASIO::AsyncConnection NetworkInterfaceASIO::AsyncOp::releaseConnection() {
+    invariant(_connection.is_initialized());
+    _command = boost::none;
+    _operationProtocol = boost::none;
+    AsyncConnection conn(std::move(*_connection));
+    _connection = boost::none;
+    return conn;
+}
+
 NetworkInterfaceASIO::AsyncCommand& NetworkInterfaceASIO::AsyncOp::beginCommand(
     Message&& newCommand, Date_t now) {
     // NOTE: We operate based on the assumption that AsyncOp's
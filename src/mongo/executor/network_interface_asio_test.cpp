@@ -44,6 +44,8 @@
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace executor {
@@ -458,6 +460,186 @@ TEST_F(NetworkInterfaceASIOTest, setAlarm) {
     ASSERT(status == stdx::future_status::timeout);
 }
 
+class NetworkInterfaceASIOConnectionPoolTest : public NetworkInterfaceASIOTest {
+public:
+    void setUp() override {}
+
+    void start(const NetworkInterfaceASIO::ConnectionPoolOptions& options) {
+        auto factory = stdx::make_unique<AsyncMockStreamFactory>();
+        // keep unowned pointer, but pass ownership to NIA
+        _streamFactory = factory.get();
+        _net = stdx::make_unique<NetworkInterfaceASIO>(std::move(factory), nullptr, options);
+        _net->startup();
+    }
+
+    stdx::future<RemoteCommandResponse> startCommand(const BSONObj& cmdObj) {
+        auto prom = std::make_shared<stdx::promise<RemoteCommandResponse>>();
+        net().startCommand({},
+                           {testHost, "testDB", cmdObj},
+                           [prom](StatusWith<RemoteCommandResponse> resp) {
+                               try {
+                                   prom->set_value(uassertStatusOK(resp));
+                               } catch (...) {
+                                   prom->set_exception(std::current_exception());
+                               }
+                           });
+        return prom->get_future();
+    }
+
+    static void simulateIsMaster(AsyncMockStreamFactory::MockStream* stream) {
+        stream->simulateServer(
+            rpc::Protocol::kOpQuery,
+            [](RemoteCommandRequest request) -> RemoteCommandResponse {
+                ASSERT_EQ(std::string{request.cmdObj.firstElementFieldName()}, "isMaster");
+
+                RemoteCommandResponse response;
+                response.data = BSON("minWireVersion" << mongo::minWireVersion << "maxWireVersion"
+                                                      << mongo::maxWireVersion);
+                return response;
+            });
+    }
+
+    static void simulateCommand(AsyncMockStreamFactory::MockStream* stream, int n) {
+        stream->simulateServer(rpc::Protocol::kOpCommandV1,
+                               [n](RemoteCommandRequest request) -> RemoteCommandResponse {
+                                   ASSERT_EQ(request.cmdObj["n"].numberInt(), n);
+
+                                   RemoteCommandResponse response;
+                                   response.data = BSON("n" << n << "ok" << 1.0);
+                                   return response;
+                               });
+    }
+
+    BSONObj connectionStats() {
+        BSONObjBuilder b;
+        _net->appendConnectionStats(&b);
+        return b.obj();
+    }
+
+    BSONObj hostStats() {
+        return connectionStats()["hosts"].Obj()[testHost.toString()].Obj();
+    }
+};
+
+TEST_F(NetworkInterfaceASIOConnectionPoolTest, SecondCommandReusesConnection) {
+    start({});
+
+    auto first = startCommand(BSON("ping" << 1 << "n" << 1));
+    auto stream = streamFactory().blockUntilStreamExists(testHost);
+    ConnectEvent{stream}.skip();
+    simulateIsMaster(stream);
+    simulateCommand(stream, 1);
+    ASSERT_EQ(first.get().data["n"].numberInt(), 1);
+
+    auto stats = hostStats();
+    ASSERT_EQ(stats["available"].numberLong(), 1);
+    ASSERT_EQ(stats["created"].numberLong(), 1);
+    ASSERT_EQ(stats["reused"].numberLong(), 0);
+
+    // The second command goes straight to the pooled connection: there is no connect and no
+    // isMaster.
+    auto second = startCommand(BSON("ping" << 1 << "n" << 2));
+    simulateCommand(stream, 2);
+    ASSERT_EQ(second.get().data["n"].numberInt(), 2);
+
+    stats = hostStats();
+    ASSERT_EQ(stats["available"].numberLong(), 1);
+    ASSERT_EQ(stats["created"].numberLong(), 1);
+    ASSERT_EQ(stats["reused"].numberLong(), 1);
+
+    auto totals = connectionStats();
+    ASSERT_EQ(totals["totalAvailable"].numberLong(), 1);
+    ASSERT_EQ(totals["totalCreated"].numberLong(), 1);
+    ASSERT_EQ(totals["totalReused"].numberLong(), 1);
+}
+
+TEST_F(NetworkInterfaceASIOConnectionPoolTest, StaleConnectionIsRefreshed) {
+    NetworkInterfaceASIO::ConnectionPoolOptions options;
+    options.refreshRequirement = Milliseconds(0);
+    start(options);
+
+    auto first = startCommand(BSON("ping" << 1 << "n" << 1));
+    auto stream = streamFactory().blockUntilStreamExists(testHost);
+    ConnectEvent{stream}.skip();
+    simulateIsMaster(stream);
+    simulateCommand(stream, 1);
+    first.get();
+
+    // Every idle connection is stale, so it is checked with an isMaster before it is used, but
+    // is not reconnected.
+    auto second = startCommand(BSON("ping" << 1 << "n" << 2));
+    simulateIsMaster(stream);
+    simulateCommand(stream, 2);
+    ASSERT_EQ(second.get().data["n"].numberInt(), 2);
+
+    auto stats = hostStats();
+    ASSERT_EQ(stats["created"].numberLong(), 1);
+    ASSERT_EQ(stats["reused"].numberLong(), 1);
+}
+
+TEST_F(NetworkInterfaceASIOConnectionPoolTest, FullPoolClosesReturnedConnection) {
+    NetworkInterfaceASIO::ConnectionPoolOptions options;
+    options.maxConnectionsPerHost = 0;
+    start(options);
+
+    auto first = startCommand(BSON("ping" << 1 << "n" << 1));
+    auto stream = streamFactory().blockUntilStreamExists(testHost);
+    ConnectEvent{stream}.skip();
+    simulateIsMaster(stream);
+    simulateCommand(stream, 1);
+    first.get();
+
+    auto stats = hostStats();
+    ASSERT_EQ(stats["available"].numberLong(), 0);
+    ASSERT_EQ(stats["created"].numberLong(), 1);
+}
+
+TEST_F(NetworkInterfaceASIOConnectionPoolTest, IdleConnectionsExpire) {
+    NetworkInterfaceASIO::ConnectionPoolOptions options;
+    options.minConnectionsPerHost = 0;
+    options.hostTimeout = Milliseconds(0);
+    options.expiryInterval = Milliseconds(10);
+    start(options);
+
+    auto first = startCommand(BSON("ping" << 1 << "n" << 1));
+    auto stream = streamFactory().blockUntilStreamExists(testHost);
+    ConnectEvent{stream}.skip();
+    simulateIsMaster(stream);
+    simulateCommand(stream, 1);
+    first.get();
+
+    Timer timer;
+    while (hostStats()["available"].numberLong() != 0) {
+        ASSERT_LESS_THAN(timer.millis(), 10 * 1000);
+        sleepmillis(10);
+    }
+}
+
+TEST_F(NetworkInterfaceASIOConnectionPoolTest, ManyCommandsShareOneConnection) {
+    start({});
+    const int kNumCommands = 1000;
+
+    Timer timer;
+    auto first = startCommand(BSON("ping" << 1 << "n" << 0));
+    auto stream = streamFactory().blockUntilStreamExists(testHost);
+    ConnectEvent{stream}.skip();
+    simulateIsMaster(stream);
+    simulateCommand(stream, 0);
+    first.get();
+
+    for (int i = 1; i < kNumCommands; ++i) {
+        auto next = startCommand(BSON("ping" << 1 << "n" << i));
+        simulateCommand(stream, i);
+        ASSERT_EQ(next.get().data["n"].numberInt(), i);
+    }
+    log() << "ran " << kNumCommands << " commands over pooled connections in " << timer.millis()
+          << "ms";
+
+    auto stats = hostStats();
+    ASSERT_EQ(stats["created"].numberLong(), 1);
+    ASSERT_EQ(stats["reused"].numberLong(), kNumCommands - 1);
+}
+
 }  // namespace
 }  // namespace executor
 }  // namespace mongo
@@ -36,6 +36,8 @@
 #include "mongo/s/catalog/type_database.h"
 #include "mongo/s/config.h"
 #include "mongo/s/grid.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 
@@ -43,18 +45,79 @@ using std::shared_ptr;
 using std::string;
 
 
+/**
+ * A load of a database's metadata, which the threads that find the database missing from the
+ * cache while it is in progress wait for.
+ */
+struct CatalogCache::DatabaseLoad {
+    // Set, along with 'result', once the load has finished.
+    bool done = false;
+    StatusWith<shared_ptr<DBConfig>> result{ErrorCodes::InternalError, "load not finished"};
+
+    // Set if the cache was invalidated while the load was in progress, in which case its result
+    // is handed to the threads waiting for it, but not cached.
+    bool invalidated = false;
+
+    stdx::condition_variable doneCondition;
+};
+
 CatalogCache::CatalogCache() {}
 
 StatusWith<shared_ptr<DBConfig>> CatalogCache::getDatabase(OperationContext* txn,
                                                            const string& dbName) {
-    stdx::lock_guard<stdx::mutex> guard(_mutex);
+    shared_ptr<DatabaseLoad> load;
 
-    ShardedDatabasesMap::iterator it = _databases.find(dbName);
-    if (it != _databases.end()) {
-        return it->second;
+    {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+        ShardedDatabasesMap::iterator it = _databases.find(dbName);
+        if (it != _databases.end()) {
+            return it->second;
+        }
+
+        DatabaseLoadMap::iterator loadIt = _loadsInFlight.find(dbName);
+        if (loadIt != _loadsInFlight.end()) {
+            shared_ptr<DatabaseLoad> inFlight = loadIt->second;
+            inFlight->doneCondition.wait(lk, [&inFlight] { return inFlight->done; });
+            return inFlight->result;
+        }
+
+        load = std::make_shared<DatabaseLoad>();
+        _loadsInFlight[dbName] = load;
+    }
+
+    // Publishes the result of the load to the cache and to the threads waiting for it
+    const auto finishLoad = [this, &dbName, &load](const StatusWith<shared_ptr<DBConfig>>& result) {
+        stdx::lock_guard<stdx::mutex> guard(_mutex);
+
+        if (!load->invalidated) {
+            invariant(_loadsInFlight.erase(dbName) == 1);
+
+            if (result.isOK()) {
+                invariant(_databases.insert(std::make_pair(dbName, result.getValue())).second);
+            }
+        }
+
+        load->done = true;
+        load->result = result;
+        load->doneCondition.notify_all();
+    };
+
+    // Need to load from the store, which is done without holding the mutex
+    StatusWith<shared_ptr<DBConfig>> result(ErrorCodes::InternalError, "load not finished");
+    try {
+        result = _loadDatabase(txn, dbName);
+    } catch (...) {
+        finishLoad(exceptionToStatus());
+        throw;
     }
 
-    // Need to load from the store
+    finishLoad(result);
+    return result;
+}
+
+StatusWith<shared_ptr<DBConfig>> CatalogCache::_loadDatabase(OperationContext* txn,
+                                                            const string& dbName) {
     auto status = grid.catalogManager(txn)->getDatabase(dbName);
     if (!status.isOK()) {
         return status.getStatus();
@@ -65,8 +128,6 @@ StatusWith<shared_ptr<DBConfig>> CatalogCache::getDatabase(OperationContext* txn
         std::make_shared<DBConfig>(dbName, dbOpTimePair.value, dbOpTimePair.opTime);
     db->load(txn);
 
-    invariant(_databases.insert(std::make_pair(dbName, db)).second);
-
     return db;
 }
 
@@ -77,12 +138,23 @@ void CatalogCache::invalidate(const string& dbName) {
     if (it != _databases.end()) {
         _databases.erase(it);
     }
+
+    DatabaseLoadMap::iterator loadIt = _loadsInFlight.find(dbName);
+    if (loadIt != _loadsInFlight.end()) {
+        loadIt->second->invalidated = true;
+        _loadsInFlight.erase(loadIt);
+    }
 }
 
 void CatalogCache::invalidateAll() {
     stdx::lock_guard<stdx::mutex> guard(_mutex);
 
     _databases.clear();
+
+    for (auto& loadInFlight : _loadsInFlight) {
+        loadInFlight.second->invalidated = true;
+    }
+    _loadsInFlight.clear();
 }
 
 }  // namespace mongo
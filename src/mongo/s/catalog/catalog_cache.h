@@ -61,6 +61,9 @@ public:
      * local variable. The reason for this is so that if the cache gets invalidated, the caller
      * does not miss getting the most up-to-date value.
      *
+     * Only one thread loads a database which is not cached; others asking for the same database
+     * meanwhile wait for its result, and lookups of other databases are not held up by it.
+     *
      * @param dbname The name of the database (must not contain dots, etc).
      * @return The database if it exists, NULL otherwise.
      */
@@ -79,11 +82,25 @@ public:
     void invalidateAll();
 
 private:
+    struct DatabaseLoad;
+
     typedef std::map<std::string, std::shared_ptr<DBConfig>> ShardedDatabasesMap;
+    typedef std::map<std::string, std::shared_ptr<DatabaseLoad>> DatabaseLoadMap;
+
+    /**
+     * Reads the metadata for the specified database from the config server. Called without
+     * '_mutex' held.
+     */
+    StatusWith<std::shared_ptr<DBConfig>> _loadDatabase(OperationContext* txn,
+                                                        const std::string& dbName);
 
     // Databases catalog map and mutex to protect it
     stdx::mutex _mutex;
     ShardedDatabasesMap _databases;
+
+    // Loads of databases missing from '_databases' which are in progress, by database name.
+    // Protected by '_mutex'.
+    DatabaseLoadMap _loadsInFlight;
 };
 
 }  // namespace mongo
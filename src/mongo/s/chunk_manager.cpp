@@ -32,6 +32,7 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <algorithm>
 #include <boost/next_prior.hpp>
 #include <map>
 #include <set>
@@ -43,6 +44,7 @@
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/catalog/catalog_manager.h"
 #include "mongo/s/catalog/type_chunk.h"
@@ -152,6 +154,15 @@ bool isChunkMapValid(const ChunkMap& chunkMap) {
 #undef ENSURE
 }
 
+/**
+ * Returns the KeyString encoding of the shard key 'key', which orders the same way as comparing
+ * the keys with BSONObj::woCompare().
+ */
+std::string encodeShardKey(const BSONObj& key) {
+    const KeyString keyString(key, Ordering::make(BSONObj()));
+    return std::string(keyString.getBuffer(), keyString.getSize());
+}
+
 }  // namespace
 
 AtomicUInt32 ChunkManager::NextSequenceNumber(1U);
@@ -161,14 +172,14 @@ ChunkManager::ChunkManager(const string& ns, const ShardKeyPattern& pattern, boo
       _keyPattern(pattern.getKeyPattern()),
       _unique(unique),
       _sequenceNumber(NextSequenceNumber.addAndFetch(1)),
-      _chunkRanges() {}
+      _routingTable(std::make_shared<ChunkRoutingTable>(ChunkMap(), nullptr)) {}
 
 ChunkManager::ChunkManager(const CollectionType& coll)
     : _ns(coll.getNs().ns()),
       _keyPattern(coll.getKeyPattern()),
       _unique(coll.getUnique()),
       _sequenceNumber(NextSequenceNumber.addAndFetch(1)),
-      _chunkRanges() {
+      _routingTable(std::make_shared<ChunkRoutingTable>(ChunkMap(), nullptr)) {
     _version = ChunkVersion::fromBSON(coll.toBSON());
 }
 
@@ -194,7 +205,8 @@ void ChunkManager::loadExistingRanges(OperationContext* txn, const ChunkManager*
                 _chunkMap.swap(chunkMap);
                 _shardIds.swap(shardIds);
                 _shardVersions.swap(shardVersions);
-                _chunkRanges.reloadAll(_chunkMap);
+                _routingTable = std::make_shared<ChunkRoutingTable>(
+                    _chunkMap, oldManager ? oldManager->_routingTable.get() : nullptr);
 
                 return;
             }
@@ -444,22 +456,12 @@ void ChunkManager::createFirstChunks(OperationContext* txn,
 
 ChunkPtr ChunkManager::findIntersectingChunk(OperationContext* txn, const BSONObj& shardKey) const {
     {
-        BSONObj chunkMin;
-        ChunkPtr chunk;
-        {
-            ChunkMap::const_iterator it = _chunkMap.upper_bound(shardKey);
-            if (it != _chunkMap.end()) {
-                chunkMin = it->first;
-                chunk = it->second;
-            }
-        }
-
+        ChunkPtr chunk = _routingTable->findIntersectingChunk(shardKey);
         if (chunk) {
             if (chunk->containsKey(shardKey)) {
                 return chunk;
             }
 
-            log() << chunkMin;
             log() << *chunk;
             log() << shardKey;
 
@@ -513,31 +515,17 @@ void ChunkManager::getShardIdsForQuery(set<ShardId>& shardIds, const BSONObj& qu
     // returned.  For now, we satisfy that assumption by adding a shard with no matches rather
     // than return an empty set of shards.
     if (shardIds.empty()) {
-        massert(16068, "no chunk ranges available", !_chunkRanges.ranges().empty());
-        shardIds.insert(_chunkRanges.ranges().begin()->second->getShardId());
+        massert(16068, "no chunk ranges available", _routingTable->size() > 0);
+        shardIds.insert(_routingTable->getFirstShardId());
     }
 }
 
 void ChunkManager::getShardIdsForRange(set<ShardId>& shardIds,
                                        const BSONObj& min,
                                        const BSONObj& max) const {
-    ChunkRangeMap::const_iterator it = _chunkRanges.upper_bound(min);
-    ChunkRangeMap::const_iterator end = _chunkRanges.upper_bound(max);
-
     massert(13507,
             str::stream() << "no chunks found between bounds " << min << " and " << max,
-            it != _chunkRanges.ranges().end());
-
-    if (end != _chunkRanges.ranges().end())
-        ++end;
-
-    for (; it != end; ++it) {
-        shardIds.insert(it->second->getShardId());
-
-        // once we know we need to visit all shards no need to keep looping
-        if (shardIds.size() == _shardIds.size())
-            break;
-    }
+            _routingTable->getShardIdsForRange(&shardIds, min, max, _shardIds.size()));
 }
 
 void ChunkManager::getAllShardIds(set<ShardId>* all) const {
@@ -687,114 +675,110 @@ string ChunkManager::toString() const {
 }
 
 
-ChunkRange::ChunkRange(ChunkMap::const_iterator begin, const ChunkMap::const_iterator end)
-    : _manager(begin->second->getManager()),
-      _shardId(begin->second->getShardId()),
-      _min(begin->second->getMin()),
-      _max(boost::prior(end)->second->getMax()) {
-    invariant(begin != end);
-
-    DEV while (begin != end) {
-        dassert(begin->second->getManager() == _manager);
-        dassert(begin->second->getShardId() == _shardId);
-        ++begin;
-    }
-}
-
-ChunkRange::ChunkRange(const ChunkRange& min, const ChunkRange& max)
-    : _manager(min.getManager()),
-      _shardId(min.getShardId()),
-      _min(min.getMin()),
-      _max(max.getMax()) {
-    invariant(min.getShardId() == max.getShardId());
-    invariant(min.getManager() == max.getManager());
-    invariant(min.getMax() == max.getMin());
-}
-
-string ChunkRange::toString() const {
-    StringBuilder sb;
-    sb << "ChunkRange(min=" << _min << ", max=" << _max << ", shard=" << _shardId << ")";
+ChunkRoutingTable::ChunkRoutingTable(const ChunkMap& chunks, const ChunkRoutingTable* previous) {
+    _maxKeyEnds.reserve(chunks.size());
+    _chunks.reserve(chunks.size());
 
-    return sb.str();
-}
+    // Walks the chunks of 'previous' alongside 'chunks', both in order of their max bounds, so
+    // that the bound of a chunk which is in both is copied rather than encoded.
+    size_t prevPos = 0;
+    const size_t prevSize = previous ? previous->size() : 0;
 
+    for (const auto& chunkMapEntry : chunks) {
+        const ChunkPtr& chunk = chunkMapEntry.second;
 
-void ChunkRangeManager::assertValid() const {
-    if (_ranges.empty())
-        return;
+        if (prevPos < prevSize &&
+            previous->_chunks[prevPos]->getMax().binaryEqual(chunk->getMax())) {
+            const StringData encoded = previous->_getMaxKey(prevPos);
+            _maxKeys.append(encoded.rawData(), encoded.size());
+            ++prevPos;
+        } else {
+            const std::string encoded = encodeShardKey(chunk->getMax());
+            _maxKeys.append(encoded);
 
-    try {
-        // No Nulls
-        for (ChunkRangeMap::const_iterator it = _ranges.begin(), end = _ranges.end(); it != end;
-             ++it) {
-            verify(it->second);
+            while (prevPos < prevSize && previous->_getMaxKey(prevPos).compare(encoded) <= 0) {
+                ++prevPos;
+            }
         }
 
-        // Check endpoints
-        verify(allOfType(MinKey, _ranges.begin()->second->getMin()));
-        verify(allOfType(MaxKey, boost::prior(_ranges.end())->second->getMax()));
-
-        // Make sure there are no gaps or overlaps
-        for (ChunkRangeMap::const_iterator it = boost::next(_ranges.begin()), end = _ranges.end();
-             it != end;
-             ++it) {
-            ChunkRangeMap::const_iterator last = boost::prior(it);
-            verify(it->second->getMin() == last->second->getMax());
+        if (_runs.empty() || _runs.back().shardId != chunk->getShardId()) {
+            _runs.push_back(Run{static_cast<uint32_t>(_chunks.size()), chunk->getShardId()});
+        } else {
+            _runs.back().lastChunk = _chunks.size();
         }
 
-        // Check Map keys
-        for (ChunkRangeMap::const_iterator it = _ranges.begin(), end = _ranges.end(); it != end;
-             ++it) {
-            verify(it->first == it->second->getMax());
-        }
+        _maxKeyEnds.push_back(_maxKeys.size());
+        _chunks.push_back(chunk);
+    }
 
-        // Make sure we match the original chunks
-        const ChunkMap chunks = _ranges.begin()->second->getManager()->_chunkMap;
-        for (ChunkMap::const_iterator i = chunks.begin(); i != chunks.end(); ++i) {
-            const ChunkPtr chunk = i->second;
-
-            ChunkRangeMap::const_iterator min = _ranges.upper_bound(chunk->getMin());
-            ChunkRangeMap::const_iterator max = _ranges.lower_bound(chunk->getMax());
-
-            verify(min != _ranges.end());
-            verify(max != _ranges.end());
-            verify(min == max);
-            verify(min->second->getShardId() == chunk->getShardId());
-            verify(min->second->containsKey(chunk->getMin()));
-            verify(min->second->containsKey(chunk->getMax()) ||
-                   (min->second->getMax() == chunk->getMax()));
-        }
+    _runs.shrink_to_fit();
+}
 
-    } catch (...) {
-        error() << "\t invalid ChunkRangeMap! printing ranges:";
+StringData ChunkRoutingTable::_getMaxKey(size_t i) const {
+    const size_t begin = (i == 0) ? 0 : _maxKeyEnds[i - 1];
+    return StringData(_maxKeys.data() + begin, _maxKeyEnds[i] - begin);
+}
 
-        for (ChunkRangeMap::const_iterator it = _ranges.begin(), end = _ranges.end(); it != end;
-             ++it) {
-            log() << it->first << ": " << it->second->toString();
+size_t ChunkRoutingTable::_upperBound(StringData key) const {
+    size_t low = 0;
+    size_t high = _chunks.size();
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (_getMaxKey(mid).compare(key) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
         }
-
-        throw;
     }
+
+    return low;
 }
 
-void ChunkRangeManager::reloadAll(const ChunkMap& chunks) {
-    _ranges.clear();
-    _insertRange(chunks.begin(), chunks.end());
+ChunkPtr ChunkRoutingTable::findIntersectingChunk(const BSONObj& shardKey) const {
+    const size_t pos = _upperBound(encodeShardKey(shardKey));
+    if (pos == _chunks.size()) {
+        return ChunkPtr();
+    }
 
-    DEV assertValid();
+    return _chunks[pos];
 }
 
-void ChunkRangeManager::_insertRange(ChunkMap::const_iterator begin,
-                                     const ChunkMap::const_iterator end) {
-    while (begin != end) {
-        ChunkMap::const_iterator first = begin;
-        ShardId shardId = first->second->getShardId();
-        while (begin != end && (begin->second->getShardId() == shardId))
-            ++begin;
+bool ChunkRoutingTable::getShardIdsForRange(std::set<ShardId>* shardIds,
+                                            const BSONObj& min,
+                                            const BSONObj& max,
+                                            size_t maxShardIds) const {
+    size_t pos = _upperBound(encodeShardKey(min));
+    if (pos == _chunks.size()) {
+        return false;
+    }
+
+    // [min, max] is inclusive, so the chunk containing 'max' is visited too.
+    size_t last = _upperBound(encodeShardKey(max));
+    if (last == _chunks.size()) {
+        last = _chunks.size() - 1;
+    }
 
-        shared_ptr<ChunkRange> cr(new ChunkRange(first, begin));
-        _ranges[cr->getMax()] = cr;
+    // The first run which ends at or after 'pos' is the one containing it.
+    auto run = std::lower_bound(
+        _runs.begin(), _runs.end(), pos, [](const Run& candidate, size_t chunkPos) {
+            return candidate.lastChunk < chunkPos;
+        });
+
+    for (; run != _runs.end(); ++run) {
+        shardIds->insert(run->shardId);
+
+        // once we know we need to visit all shards no need to keep looping
+        if (shardIds->size() == maxShardIds || run->lastChunk >= last) {
+            break;
+        }
     }
+
+    return true;
+}
+
+const ShardId& ChunkRoutingTable::getFirstShardId() const {
+    invariant(!_runs.empty());
+    return _runs.front().shardId;
 }
 
 int ChunkManager::getCurrentDesiredChunkSize() const {
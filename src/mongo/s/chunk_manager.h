@@ -29,9 +29,13 @@
 #pragma once
 
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/s/chunk.h"
 #include "mongo/s/shard_key_pattern.h"
@@ -47,77 +51,77 @@ class OperationContext;
 
 typedef std::shared_ptr<ChunkManager> ChunkManagerPtr;
 
-// The key for the map is max for each Chunk or ChunkRange
+// The key for the map is max for each Chunk
 typedef std::map<BSONObj, std::shared_ptr<Chunk>, BSONObjCmp> ChunkMap;
 
-class ChunkRange {
-public:
-    ChunkRange(ChunkMap::const_iterator begin, const ChunkMap::const_iterator end);
+/**
+ * An immutable index of a collection's chunks, laid out flat for routing. It holds the KeyString
+ * encodings of the chunks' max bounds in order in one buffer, alongside the chunks, so that a
+ * shard key is routed by a binary search which compares bytes rather than BSONObjs. Consecutive
+ * chunks on the same shard are grouped into runs, which hold the shard ids, so that the shards for
+ * a range of keys are found without visiting every chunk in it.
+ *
+ * A ChunkManager shares its table with every thread routing through it; loading a newer version
+ * of the chunks builds a new table rather than changing the old one.
+ */
+class ChunkRoutingTable {
+    MONGO_DISALLOW_COPYING(ChunkRoutingTable);
 
-    // Merge min and max (must be adjacent ranges)
-    ChunkRange(const ChunkRange& min, const ChunkRange& max);
+public:
+    /**
+     * Builds the table for 'chunks'. The encoded bounds of chunks unchanged from 'previous', the
+     * table for an older version of the same chunks, are copied from it rather than encoded
+     * again. 'previous' may be NULL.
+     */
+    ChunkRoutingTable(const ChunkMap& chunks, const ChunkRoutingTable* previous);
 
-    const ChunkManager* getManager() const {
-        return _manager;
-    }
-    ShardId getShardId() const {
-        return _shardId;
+    size_t size() const {
+        return _chunks.size();
     }
 
-    const BSONObj& getMin() const {
-        return _min;
-    }
-    const BSONObj& getMax() const {
-        return _max;
-    }
+    /**
+     * Returns the chunk whose range contains the extracted shard key 'shardKey', or NULL if it is
+     * past the last chunk.
+     */
+    ChunkPtr findIntersectingChunk(const BSONObj& shardKey) const;
 
-    // clones of Chunk methods
-    // Returns true if this ChunkRange contains the given shard key, and false otherwise
-    //
-    // Note: this function takes an extracted *key*, not an original document
-    // (the point may be computed by, say, hashing a given field or projecting
-    //  to a subset of fields).
-    bool containsKey(const BSONObj& shardKey) const;
+    /**
+     * Adds to 'shardIds' the shards of the chunks which intersect [min, max], see SERVER-4791.
+     * Stops once 'shardIds' holds 'maxShardIds' shards. Returns false if no chunk ends after
+     * 'min'.
+     */
+    bool getShardIdsForRange(std::set<ShardId>* shardIds,
+                             const BSONObj& min,
+                             const BSONObj& max,
+                             size_t maxShardIds) const;
 
-    std::string toString() const;
+    /**
+     * Returns the shard of the first chunk. Invalid to call if the table is empty.
+     */
+    const ShardId& getFirstShardId() const;
 
 private:
-    const ChunkManager* _manager;
-    const ShardId _shardId;
-    const BSONObj _min;
-    const BSONObj _max;
-};
-
-typedef std::map<BSONObj, std::shared_ptr<ChunkRange>, BSONObjCmp> ChunkRangeMap;
-
-
-class ChunkRangeManager {
-public:
-    const ChunkRangeMap& ranges() const {
-        return _ranges;
-    }
-
-    void clear() {
-        _ranges.clear();
-    }
+    /**
+     * Returns the position of the first chunk whose encoded max bound is greater than 'key'.
+     */
+    size_t _upperBound(StringData key) const;
 
-    void reloadAll(const ChunkMap& chunks);
+    StringData _getMaxKey(size_t i) const;
 
-    // Slow operation -- wrap with DEV
-    void assertValid() const;
+    // The encoded max bounds of the chunks, back to back, and where each one ends in the buffer.
+    std::string _maxKeys;
+    std::vector<uint32_t> _maxKeyEnds;
 
-    ChunkRangeMap::const_iterator upper_bound(const BSONObj& o) const {
-        return _ranges.upper_bound(o);
-    }
-    ChunkRangeMap::const_iterator lower_bound(const BSONObj& o) const {
-        return _ranges.lower_bound(o);
-    }
+    std::vector<ChunkPtr> _chunks;
 
-private:
-    // assumes nothing in this range exists in _ranges
-    void _insertRange(ChunkMap::const_iterator begin, const ChunkMap::const_iterator end);
+    // A maximal run of consecutive chunks on one shard.
+    struct Run {
+        uint32_t lastChunk;  // Position in '_chunks' of the last chunk of the run.
+        ShardId shardId;
+    };
 
-    ChunkRangeMap _ranges;
+    // The runs in order; together they cover every chunk.
+    std::vector<Run> _runs;
 };
 
 
@@ -269,7 +273,9 @@ private:
     const unsigned long long _sequenceNumber;
 
     ChunkMap _chunkMap;
-    ChunkRangeManager _chunkRanges;
+
+    // Routes keys to '_chunkMap'. Never NULL.
+    std::shared_ptr<const ChunkRoutingTable> _routingTable;
 
     std::set<ShardId> _shardIds;
 
@@ -312,7 +318,6 @@ private:
     //
 
     friend class Chunk;
-    friend class ChunkRangeManager;  // only needed for CRM::assertValid()
     static AtomicUInt32 NextSequenceNumber;
 
     friend class TestableChunkManager;
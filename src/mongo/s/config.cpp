@@ -53,6 +53,8 @@
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/cluster_write.h"
 #include "mongo/s/grid.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -275,16 +277,33 @@ ChunkManagerPtr DBConfig::getChunkManagerIfExists(OperationContext* txn,
     }
 }
 
+/**
+ * A reload of a collection's chunk manager, which the threads asking for a reload of the same
+ * collection while it is in progress wait for rather than reloading it again.
+ */
+struct DBConfig::ChunkManagerReload {
+    // Whether the reload was forced, in which case threads asking for a forced reload may also
+    // wait for it.
+    bool forced = false;
+
+    // Set, along with 'status' and 'result', once the reload has finished.
+    bool done = false;
+    Status status = Status::OK();
+    ChunkManagerPtr result;
+
+    // Signaled with '_lock' held when 'done' is set.
+    stdx::condition_variable doneCondition;
+};
+
 std::shared_ptr<ChunkManager> DBConfig::getChunkManager(OperationContext* txn,
                                                         const string& ns,
                                                         bool shouldReload,
                                                         bool forceReload) {
-    BSONObj key;
-    ChunkVersion oldVersion;
     ChunkManagerPtr oldManager;
+    std::shared_ptr<ChunkManagerReload> ownReload;
 
     {
-        stdx::lock_guard<stdx::mutex> lk(_lock);
+        stdx::unique_lock<stdx::mutex> lk(_lock);
 
         bool earlyReload = !_collections[ns].isSharded() && (shouldReload || forceReload);
         if (earlyReload) {
@@ -301,15 +320,63 @@ std::shared_ptr<ChunkManager> DBConfig::getChunkManager(OperationContext* txn,
             return ci.getCM();
         }
 
-        key = ci.key().copy();
-
-        if (ci.getCM()) {
-            oldManager = ci.getCM();
-            oldVersion = ci.getCM()->getVersion();
+        oldManager = ci.getCM();
+
+        // When many threads find the chunk manager stale at once, for instance after a
+        // migration, only the first reloads it and the others share the result.
+        ChunkManagerReloadMap::iterator it = _chunkManagerReloads.find(ns);
+        if (it != _chunkManagerReloads.end()) {
+            std::shared_ptr<ChunkManagerReload> inFlight = it->second;
+            if (inFlight->forced || !forceReload) {
+                inFlight->doneCondition.wait(lk, [&inFlight] { return inFlight->done; });
+                uassertStatusOK(inFlight->status);
+                return inFlight->result;
+            }
+        } else {
+            ownReload = std::make_shared<ChunkManagerReload>();
+            ownReload->forced = forceReload;
+            _chunkManagerReloads[ns] = ownReload;
         }
     }
 
-    invariant(!key.isEmpty());
+    // A forced reload which finds a non-forced one in progress goes ahead on its own, without
+    // being waited for.
+    if (!ownReload) {
+        return _reloadChunkManager(txn, ns, oldManager, forceReload);
+    }
+
+    // Publishes the result of the reload to the threads waiting for it
+    const auto finishReload = [this, &ns, &ownReload](Status status, ChunkManagerPtr result) {
+        stdx::lock_guard<stdx::mutex> lk(_lock);
+
+        ChunkManagerReloadMap::iterator it = _chunkManagerReloads.find(ns);
+        invariant(it != _chunkManagerReloads.end() && it->second == ownReload);
+        _chunkManagerReloads.erase(it);
+
+        ownReload->done = true;
+        ownReload->status = std::move(status);
+        ownReload->result = std::move(result);
+        ownReload->doneCondition.notify_all();
+    };
+
+    ChunkManagerPtr manager;
+    try {
+        manager = _reloadChunkManager(txn, ns, oldManager, forceReload);
+    } catch (...) {
+        finishReload(exceptionToStatus(), nullptr);
+        throw;
+    }
+
+    finishReload(Status::OK(), manager);
+    return manager;
+}
+
+std::shared_ptr<ChunkManager> DBConfig::_reloadChunkManager(OperationContext* txn,
+                                                            const string& ns,
+                                                            ChunkManagerPtr oldManager,
+                                                            bool forceReload) {
+    invariant(oldManager);
+    const ChunkVersion oldVersion = oldManager->getVersion();
 
     // TODO: We need to keep this first one-chunk check in until we have a more efficient way of
     // creating/reusing a chunk manager, as doing so requires copying the full set of chunks
@@ -345,36 +412,32 @@ std::shared_ptr<ChunkManager> DBConfig::getChunkManager(OperationContext* txn,
 
     unique_ptr<ChunkManager> tempChunkManager;
 
-    {
-        stdx::lock_guard<stdx::mutex> lll(_hitConfigServerLock);
-
-        if (!newestChunk.empty() && !forceReload) {
-            // If we have a target we're going for see if we've hit already
-            stdx::lock_guard<stdx::mutex> lk(_lock);
+    if (!newestChunk.empty() && !forceReload) {
+        // If we have a target we're going for see if we've hit already
+        stdx::lock_guard<stdx::mutex> lk(_lock);
 
-            CollectionInfo& ci = _collections[ns];
+        CollectionInfo& ci = _collections[ns];
 
-            if (ci.isSharded() && ci.getCM()) {
-                ChunkVersion currentVersion = newestChunk[0].getVersion();
+        if (ci.isSharded() && ci.getCM()) {
+            ChunkVersion currentVersion = newestChunk[0].getVersion();
 
-                // Only reload if the version we found is newer than our own in the same epoch
-                if (currentVersion <= ci.getCM()->getVersion() &&
-                    ci.getCM()->getVersion().hasEqualEpoch(currentVersion)) {
-                    return ci.getCM();
-                }
+            // Only reload if the version we found is newer than our own in the same epoch
+            if (currentVersion <= ci.getCM()->getVersion() &&
+                ci.getCM()->getVersion().hasEqualEpoch(currentVersion)) {
+                return ci.getCM();
             }
         }
+    }
 
-        tempChunkManager.reset(new ChunkManager(
-            oldManager->getns(), oldManager->getShardKeyPattern(), oldManager->isUnique()));
-        tempChunkManager->loadExistingRanges(txn, oldManager.get());
+    tempChunkManager.reset(new ChunkManager(
+        oldManager->getns(), oldManager->getShardKeyPattern(), oldManager->isUnique()));
+    tempChunkManager->loadExistingRanges(txn, oldManager.get());
 
-        if (tempChunkManager->numChunks() == 0) {
-            // Maybe we're not sharded any more, so do a full reload
-            reload(txn);
+    if (tempChunkManager->numChunks() == 0) {
+        // Maybe we're not sharded any more, so do a full reload
+        reload(txn);
 
-            return getChunkManager(txn, ns, false);
-        }
+        return getChunkManager(txn, ns, false);
     }
 
     stdx::lock_guard<stdx::mutex> lk(_lock);
@@ -149,6 +149,12 @@ public:
                                   std::shared_ptr<ChunkManager>& manager,
                                   std::shared_ptr<Shard>& primary);
 
+    /**
+     * Returns the chunk manager for 'ns', reloading it first from the config server if 'reload'
+     * or 'forceReload' is set. Only one thread reloads a collection's chunk manager at a time;
+     * others asking for a reload meanwhile wait for it and share its result, and threads only
+     * reading the cached chunk manager are not held up by it.
+     */
     std::shared_ptr<ChunkManager> getChunkManager(OperationContext* txn,
                                                   const std::string& ns,
                                                   bool reload = false,
@@ -174,7 +180,10 @@ public:
     void getAllShardedCollections(std::set<std::string>& namespaces);
 
 protected:
+    struct ChunkManagerReload;
+
     typedef std::map<std::string, CollectionInfo> CollectionInfoMap;
+    typedef std::map<std::string, std::shared_ptr<ChunkManagerReload>> ChunkManagerReloadMap;
 
     bool _dropShardedCollections(OperationContext* txn,
                                  int& num,
@@ -183,6 +192,15 @@ protected:
 
     bool _load(OperationContext* txn);
 
+    /**
+     * Loads the chunks of 'ns' changed since 'oldManager' was loaded and installs the resulting
+     * chunk manager, if it is newer. Called without '_lock' held.
+     */
+    std::shared_ptr<ChunkManager> _reloadChunkManager(OperationContext* txn,
+                                                      const std::string& ns,
+                                                      std::shared_ptr<ChunkManager> oldManager,
+                                                      bool forceReload);
+
     void _save(OperationContext* txn, bool db = true, bool coll = true);
 
     // Name of the database which this entry caches
@@ -201,9 +219,8 @@ protected:
     // OpTime of config server when the database definition was loaded.
     repl::OpTime _configOpTime;
 
-    // Ensures that only one thread at a time loads collection configuration data from
-    // the config server
-    stdx::mutex _hitConfigServerLock;
+    // Chunk manager reloads in progress, by namespace. Protected by '_lock'.
+    ChunkManagerReloadMap _chunkManagerReloads;
 };
 
 
@@ -32,9 +32,12 @@
 
 #include "mongo/s/query/async_results_merger.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/getmore_response.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/util/assert_util.h"
@@ -42,10 +45,22 @@
 
 namespace mongo {
 
+// Ask remotes for their next batch before their buffers run dry?
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryRouterPrefetchGetMores, bool, true);
+
+namespace {
+
+// Sort keys larger than this are compared with BSONObj::woSortOrder() rather than by KeyString.
+const int kMaxSortKeyStringBytes = 1024;
+
+}  // namespace
+
 AsyncResultsMerger::AsyncResultsMerger(executor::TaskExecutor* executor,
                                        ClusterClientCursorParams params)
     : _executor(executor),
       _params(std::move(params)),
+      _useSortKeyStrings(!_params.sort.isEmpty() && _params.sort.nFields() <= 32),
+      _sortKeyOrdering(Ordering::make(_useSortKeyStrings ? _params.sort : BSONObj())),
       _mergeQueue(MergingComparator(_remotes, _params.sort)) {
     for (const auto& remote : _params.remotes) {
         _remotes.emplace_back(remote);
@@ -147,6 +162,7 @@ boost::optional<BSONObj> AsyncResultsMerger::nextReadySorted() {
 
     BSONObj front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
+    _remotes[smallestRemote].sortKeyBuffer.pop();
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -154,6 +170,7 @@ boost::optional<BSONObj> AsyncResultsMerger::nextReadySorted() {
         _mergeQueue.push(smallestRemote);
     }
 
+    prefetchNextBatch_inlock(smallestRemote);
     return front;
 }
 
@@ -166,6 +183,7 @@ boost::optional<BSONObj> AsyncResultsMerger::nextReadyUnsorted() {
         if (_remotes[_gettingFromRemote].hasNext()) {
             BSONObj front = _remotes[_gettingFromRemote].docBuffer.front();
             _remotes[_gettingFromRemote].docBuffer.pop();
+            prefetchNextBatch_inlock(_gettingFromRemote);
             return front;
         }
 
@@ -204,6 +222,53 @@ Status AsyncResultsMerger::askForNextBatch_inlock(size_t remoteIndex) {
     return Status::OK();
 }
 
+void AsyncResultsMerger::prefetchNextBatch_inlock(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    if (!internalQueryRouterPrefetchGetMores || !remote.gotFirstResponse ||
+        !remote.status.isOK() || remote.exhausted() || remote.cbHandle.isValid()) {
+        return;
+    }
+
+    if (remote.docBuffer.size() > remote.lastBatchSize / 2) {
+        return;
+    }
+
+    auto nextBatchStatus = askForNextBatch_inlock(remoteIndex);
+    if (!nextBatchStatus.isOK()) {
+        // Report the error from the next call to nextReady(), whether or not ready() is called
+        // first.
+        remote.status = nextBatchStatus;
+        _status = nextBatchStatus;
+    }
+}
+
+std::string AsyncResultsMerger::encodeSortKey(const BSONObj& doc) const {
+    // BSONObj::woSortOrder() orders empty documents before all others, whatever their sort keys.
+    if (!_useSortKeyStrings || doc.isEmpty()) {
+        return std::string();
+    }
+
+    // Build the sort key the way woSortOrder() reads it: by dotted field name, with missing fields
+    // treated as null.
+    BSONObjBuilder keyBuilder;
+    BSONForEach(sortField, _params.sort) {
+        BSONElement elt = doc.getFieldDotted(sortField.fieldName());
+        if (elt.eoo()) {
+            keyBuilder.appendNull("");
+        } else {
+            keyBuilder.appendAs(elt, "");
+        }
+    }
+    BSONObj sortKey = keyBuilder.done();
+    if (sortKey.objsize() > kMaxSortKeyStringBytes) {
+        return std::string();
+    }
+
+    KeyString keyString(sortKey, _sortKeyOrdering);
+    return std::string(keyString.getBuffer(), keyString.getSize());
+}
+
 StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
@@ -224,8 +289,11 @@ StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent()
     for (size_t i = 0; i < _remotes.size(); ++i) {
         auto& remote = _remotes[i];
 
-        // It is illegal to call this method if there is an error received from any shard.
-        invariant(remote.status.isOK());
+        // A prefetched batch may have failed since the caller last checked ready(). The error is
+        // reported once the event is signaled, below.
+        if (!remote.status.isOK()) {
+            continue;
+        }
 
         if (!remote.hasNext() && !remote.exhausted() && !remote.cbHandle.isValid()) {
             // If we already have established a cursor with this remote, and there is no outstanding
@@ -243,7 +311,12 @@ StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent()
         return eventStatus;
     }
     _currentEvent = eventStatus.getValue();
-    return _currentEvent;
+    auto event = _currentEvent;
+
+    // A prefetched batch may also have arrived since the caller last checked ready(), in which case
+    // no further response is coming to signal the event.
+    signalCurrentEvent_inlock();
+    return event;
 }
 
 void AsyncResultsMerger::handleBatchResponse(
@@ -311,14 +384,23 @@ void AsyncResultsMerger::handleBatchResponse(
     remote.gotFirstResponse = true;
 
     remote.cursorId = getMoreResponse.cursorId;
+    remote.lastBatchSize = getMoreResponse.batch.size();
+
+    // A prefetched batch can arrive while results from the previous one are still buffered, in
+    // which case this remote is already on the merge queue.
+    const bool hasSort = !_params.sort.isEmpty();
+    const bool wasOnMergeQueue = hasSort && remote.hasNext();
 
     for (const auto& obj : getMoreResponse.batch) {
         remote.docBuffer.push(obj);
+        if (hasSort) {
+            remote.sortKeyBuffer.push(encodeSortKey(obj));
+        }
     }
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the
     // merge queue.
-    if (!_params.sort.isEmpty() && !getMoreResponse.batch.empty()) {
+    if (hasSort && !wasOnMergeQueue && !getMoreResponse.batch.empty()) {
         _mergeQueue.push(remoteIndex);
     }
 
@@ -444,6 +526,14 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 //
 
 bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+    // The KeyString encodings order the same way as woSortOrder(), so they can be compared
+    // directly whenever both documents' sort keys were encoded.
+    const std::string& leftKey = _remotes[lhs].sortKeyBuffer.front();
+    const std::string& rightKey = _remotes[rhs].sortKeyBuffer.front();
+    if (!leftKey.empty() && !rightKey.empty()) {
+        return leftKey > rightKey;
+    }
+
     const BSONObj& leftDoc = _remotes[lhs].docBuffer.front();
     const BSONObj& rightDoc = _remotes[rhs].docBuffer.front();
 
@@ -30,11 +30,13 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/cluster_client_cursor_params.h"
@@ -60,6 +62,11 @@ namespace mongo {
  * must be sorted, we pass the sort through to the remote nodes and then merge the sorted streams.
  * This requires waiting until we have a response from every remote before returning results.
  * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
+ * The sorted merge compares the KeyString encodings of the documents' sort keys where it can.
+ *
+ * Once a remote's buffer has drained to half of the last batch it returned, the ARM asks it for
+ * the next batch without waiting for a call to nextEvent(), so that the merge does not stall on
+ * the round trip every time a buffer empties.
  *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
@@ -118,7 +125,9 @@ public:
      * results are available.
      *
      * Invalid to call unless ready() has returned false (i.e. invalid to call if the next result is
-     * available without scheduling remote work).
+     * available without scheduling remote work). Since batches may be prefetched in the background,
+     * the ARM may have become ready again in the meantime; the returned event is then already
+     * signaled.
      *
      * Also invalid to call if there is an outstanding event, created by a previous call to this
      * function, that has not yet been signaled. If there is an outstanding unsignaled event,
@@ -164,9 +173,17 @@ private:
         BSONObj cmdObj;
         boost::optional<CursorId> cursorId;
         std::queue<BSONObj> docBuffer;
+
+        // Parallel to 'docBuffer' when there is a sort: the KeyString encoding of each buffered
+        // document's sort key, or the empty string if it was not encoded.
+        std::queue<std::string> sortKeyBuffer;
+
         executor::TaskExecutor::CallbackHandle cbHandle;
         Status status = Status::OK();
 
+        // The number of documents in the most recent batch received from the remote.
+        size_t lastBatchSize = 0;
+
         // Set to true once we have heard from the remote node at least once.
         bool gotFirstResponse = false;
     };
@@ -202,6 +219,19 @@ private:
      */
     Status askForNextBatch_inlock(size_t remoteIndex);
 
+    /**
+     * Asks the remote at 'remoteIndex' for its next batch if the remote has an open cursor, no
+     * outstanding request, and at most half of its last batch left in its buffer. A failure to
+     * schedule the request is recorded as an error on the remote.
+     */
+    void prefetchNextBatch_inlock(size_t remoteIndex);
+
+    /**
+     * Returns the KeyString encoding of the sort key of 'doc', or the empty string if the sort key
+     * cannot be encoded, in which case documents are compared with BSONObj::woSortOrder().
+     */
+    std::string encodeSortKey(const BSONObj& doc) const;
+
     //
     // Helpers for ready().
     //
@@ -249,6 +279,11 @@ private:
 
     ClusterClientCursorParams _params;
 
+    // Whether the sorted merge compares KeyString encoded sort keys, and the Ordering used to
+    // encode them. An Ordering can describe at most 32 fields.
+    const bool _useSortKeyStrings;
+    const Ordering _sortKeyOrdering;
+
     // Must be acquired before accessing any data members (other than _params, which is read-only).
     // Must also be held when calling any of the '_inlock()' helper functions.
     stdx::mutex _mutex;
@@ -26,10 +26,14 @@
  *    it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
 #include "mongo/platform/basic.h"
 
 #include "mongo/s/query/async_results_merger.h"
 
+#include <algorithm>
+
 #include "mongo/db/json.h"
 #include "mongo/db/query/getmore_response.h"
 #include "mongo/db/query/lite_parsed_query.h"
@@ -38,6 +42,8 @@
 #include "mongo/executor/task_executor.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -145,6 +151,25 @@ protected:
         net->exitNetwork();
     }
 
+    bool hasReadyRequests() {
+        executor::NetworkInterfaceMock* net = getNet();
+        net->enterNetwork();
+        bool hasReadyRequests = net->hasReadyRequests();
+        net->exitNetwork();
+        return hasReadyRequests;
+    }
+
+    /**
+     * Returns the next result from the ARM, waiting for it to become ready if necessary. Every
+     * request the ARM is waiting on must already have been answered.
+     */
+    boost::optional<BSONObj> nextResult() {
+        while (!arm->ready()) {
+            executor->waitForEvent(unittest::assertGet(arm->nextEvent()));
+        }
+        return unittest::assertGet(arm->nextReady());
+    }
+
     const NamespaceString _nss;
     const std::vector<HostAndPort> _remotes;
 
@@ -735,6 +760,217 @@ TEST_F(AsyncResultsMergerTest, KillCalledTwice) {
     executor->waitForEvent(killedEvent2);
 }
 
+TEST_F(AsyncResultsMergerTest, GetMoreIsSentBeforeBufferEmpties) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', batchSize: 4}");
+    makeCursorFromFindCmd(findCmd, {_remotes[0]});
+
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_FALSE(arm->ready());
+
+    std::vector<GetMoreResponse> responses;
+    std::vector<BSONObj> batch1 = {
+        fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}"), fromjson("{_id: 4}")};
+    responses.emplace_back(_nss, CursorId(1), batch1);
+    scheduleNetworkResponses(responses);
+    executor->waitForEvent(readyEvent);
+
+    // The getMore goes out once half of the batch has been returned.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_FALSE(hasReadyRequests());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(hasReadyRequests());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 3}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 4}"), *unittest::assertGet(arm->nextReady()));
+
+    // Waiting for the next batch does not send another getMore.
+    ASSERT_FALSE(arm->ready());
+    readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_FALSE(arm->ready());
+
+    responses.clear();
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 5}")};
+    responses.emplace_back(_nss, CursorId(0), batch2);
+    scheduleNetworkResponses(responses);
+    ASSERT_FALSE(hasReadyRequests());
+    executor->waitForEvent(readyEvent);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 5}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT(!unittest::assertGet(arm->nextReady()));
+}
+
+TEST_F(AsyncResultsMergerTest, PrefetchedBatchesAreMergedOnce) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}, batchSize: 4}");
+    makeCursorFromFindCmd(findCmd, {_remotes[0], _remotes[1]});
+
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_FALSE(arm->ready());
+
+    std::vector<GetMoreResponse> responses;
+    std::vector<BSONObj> batch1 = {
+        fromjson("{_id: 1}"), fromjson("{_id: 3}"), fromjson("{_id: 5}"), fromjson("{_id: 7}")};
+    responses.emplace_back(_nss, CursorId(1), batch1);
+    std::vector<BSONObj> batch2 = {
+        fromjson("{_id: 2}"), fromjson("{_id: 4}"), fromjson("{_id: 6}"), fromjson("{_id: 8}")};
+    responses.emplace_back(_nss, CursorId(2), batch2);
+    scheduleNetworkResponses(responses);
+    executor->waitForEvent(readyEvent);
+
+    ASSERT_EQ(fromjson("{_id: 1}"), *nextResult());
+    ASSERT_EQ(fromjson("{_id: 2}"), *nextResult());
+    ASSERT_FALSE(hasReadyRequests());
+    ASSERT_EQ(fromjson("{_id: 3}"), *nextResult());
+    ASSERT_EQ(fromjson("{_id: 4}"), *nextResult());
+
+    // Both remotes have been asked for their next batch while they still have results buffered.
+    // The remotes are already on the merge queue, so the new batches must not add them again.
+    responses.clear();
+    std::vector<BSONObj> batch3 = {fromjson("{_id: 9}"), fromjson("{_id: 11}")};
+    responses.emplace_back(_nss, CursorId(0), batch3);
+    std::vector<BSONObj> batch4 = {fromjson("{_id: 10}"), fromjson("{_id: 12}")};
+    responses.emplace_back(_nss, CursorId(0), batch4);
+    scheduleNetworkResponses(responses);
+
+    for (int i = 5; i <= 12; ++i) {
+        ASSERT_EQ(BSON("_id" << i), *nextResult());
+    }
+    ASSERT(!nextResult());
+}
+
+TEST_F(AsyncResultsMergerTest, SortedMergeMatchesWoSortOrder) {
+    const BSONObj sort = fromjson("{'a.b': 1, c: -1}");
+    BSONObj findCmd = BSON("find"
+                           << "testcoll"
+                           << "sort" << sort);
+    makeCursorFromFindCmd(findCmd, _remotes);
+
+    // Sort keys of mixed types, missing fields, nested fields and arrays, and one too large to
+    // encode as a KeyString.
+    const std::string bigString(2000, 'x');
+    std::vector<BSONObj> docs = {fromjson("{a: {b: 1}, c: 1}"),
+                                 fromjson("{a: {b: 1.5}, c: 'str'}"),
+                                 fromjson("{a: {b: NumberLong(2)}, c: 2}"),
+                                 fromjson("{a: {b: 'abc'}}"),
+                                 fromjson("{a: {b: 'ab'}, c: null}"),
+                                 fromjson("{a: {b: null}, c: 3}"),
+                                 fromjson("{a: 1, c: 4}"),
+                                 fromjson("{c: 5}"),
+                                 fromjson("{a: {b: [3, 1]}, c: 6}"),
+                                 fromjson("{a: {b: {x: 1}}, c: 7}"),
+                                 fromjson("{a: {b: true}, c: [1, 2]}"),
+                                 fromjson("{a: {b: -0.0}, c: -1}"),
+                                 fromjson("{a: {b: 0}, c: {}}"),
+                                 BSON("a" << BSON("b" << bigString) << "c" << 8),
+                                 BSON("a" << BSON("b" << bigString) << "c" << 9),
+                                 BSON("a" << BSON("b" << MINKEY) << "c" << 10),
+                                 BSON("a" << BSON("b" << MAXKEY) << "c" << 11),
+                                 BSON("a" << BSON("b" << OID()) << "c" << 12),
+                                 BSONObj()};
+
+    auto woSortOrderLess = [&sort](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs.woSortOrder(rhs, sort, true /*useDotted*/) < 0;
+    };
+
+    // Deal the documents out to the remotes, each of which returns them in sorted order.
+    std::vector<std::vector<BSONObj>> batches(_remotes.size());
+    for (size_t i = 0; i < docs.size(); ++i) {
+        batches[i % _remotes.size()].push_back(docs[i]);
+    }
+
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_FALSE(arm->ready());
+
+    std::vector<GetMoreResponse> responses;
+    for (auto&& batch : batches) {
+        std::stable_sort(batch.begin(), batch.end(), woSortOrderLess);
+        responses.emplace_back(_nss, CursorId(0), batch);
+    }
+    scheduleNetworkResponses(responses);
+    executor->waitForEvent(readyEvent);
+
+    std::vector<BSONObj> results;
+    while (auto next = nextResult()) {
+        results.push_back(*next);
+    }
+
+    ASSERT_EQ(docs.size(), results.size());
+    for (size_t i = 1; i < results.size(); ++i) {
+        ASSERT_FALSE(woSortOrderLess(results[i], results[i - 1])) << results[i - 1] << " "
+                                                                   << results[i];
+    }
+}
+
+TEST_F(AsyncResultsMergerTest, SortedMergeFromManyRemotes) {
+    const size_t kNumRemotes = 128;
+    const int kDocsPerRemote = 500;
+    const int kBatchSize = 100;
+
+    BSONObj findCmd = BSON("find"
+                           << "testcoll"
+                           << "sort" << BSON("_id" << 1) << "batchSize" << kBatchSize);
+    std::vector<HostAndPort> remotes;
+    for (size_t i = 0; i < kNumRemotes; ++i) {
+        remotes.emplace_back("localhost", 10000 + static_cast<int>(i));
+    }
+    makeCursorFromFindCmd(findCmd, remotes);
+
+    // Remote i holds the _ids congruent to i modulo kNumRemotes, so the merge interleaves all of
+    // the remotes throughout.
+    std::vector<int> nextDoc(kNumRemotes, 0);
+    auto answerRequests = [&]() {
+        executor::NetworkInterfaceMock* net = getNet();
+        net->enterNetwork();
+        while (net->hasReadyRequests()) {
+            auto request = net->getNextReadyRequest();
+            size_t remote = request->getRequest().target.port() - 10000;
+
+            std::vector<BSONObj> batch;
+            for (int i = 0; i < kBatchSize && nextDoc[remote] < kDocsPerRemote; ++i) {
+                batch.push_back(BSON("_id" << static_cast<int>(nextDoc[remote]++ * kNumRemotes +
+                                                               remote)));
+            }
+            CursorId cursorId = nextDoc[remote] < kDocsPerRemote ? CursorId(remote + 1) : 0;
+
+            RemoteCommandResponse response(
+                GetMoreResponse(_nss, cursorId, batch).toBSON(), BSONObj(), Milliseconds(0));
+            net->scheduleResponse(
+                request, net->now(), executor::TaskExecutor::ResponseStatus(response));
+        }
+        net->runReadyNetworkOperations();
+        net->exitNetwork();
+    };
+
+    Timer timer;
+    int numResults = 0;
+    while (true) {
+        answerRequests();
+        while (!arm->ready()) {
+            auto readyEvent = unittest::assertGet(arm->nextEvent());
+            answerRequests();
+            executor->waitForEvent(readyEvent);
+        }
+
+        auto next = unittest::assertGet(arm->nextReady());
+        if (!next) {
+            break;
+        }
+        ASSERT_EQ(BSON("_id" << numResults), *next);
+        ++numResults;
+    }
+
+    ASSERT_EQ(static_cast<int>(kNumRemotes) * kDocsPerRemote, numResults);
+    log() << "merged " << numResults << " documents from " << kNumRemotes << " remotes in "
+          << timer.millis() << "ms";
+}
+
 }  // namespace
 
 }  // namespace mongo
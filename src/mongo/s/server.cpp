@@ -32,6 +32,7 @@
 
 #include "mongo/s/server.h"
 
+#include "mongo/base/checked_cast.h"
 #include "mongo/base/init.h"
 #include "mongo/base/initializer.h"
 #include "mongo/base/status.h"
@@ -127,6 +128,14 @@ public:
         Client::initThread("conn", getGlobalServiceContext(), p);
     }
 
+    virtual std::unique_ptr<ConnectionState> suspend(AbstractMessagingPort* p) {
+        return stdx::make_unique<ClientState>(Client::releaseCurrent());
+    }
+
+    virtual void resume(std::unique_ptr<ConnectionState> state, AbstractMessagingPort* p) {
+        Client::setCurrent(std::move(checked_cast<ClientState*>(state.get())->client));
+    }
+
     virtual void process(Message& m, AbstractMessagingPort* p) {
         verify(p);
         Request r(m, p);
@@ -165,6 +174,14 @@ public:
         // Release connections back to pool, if any still cached
         ShardConnection::releaseMyConnections();
     }
+
+private:
+    // Carries the connection's Client from one worker thread to the next.
+    struct ClientState : public ConnectionState {
+        explicit ClientState(ServiceContext::UniqueClient c) : client(std::move(c)) {}
+
+        ServiceContext::UniqueClient client;
+    };
 };
 
 void start(const MessageServer::Options& opts) {
@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+const size_t Arena::kMaxAlignment;
+const size_t Arena::kMinChunkBytes;
+const size_t Arena::kMaxChunkBytes;
+
+struct Arena::Chunk {
+    Chunk* next;
+    size_t size;  // Usable bytes following this header.
+
+    char* begin() {
+        return reinterpret_cast<char*>(this) + sizeof(Chunk);
+    }
+    char* end() {
+        return begin() + size;
+    }
+};
+
+struct Arena::Cleanup {
+    void* obj;
+    void (*destroy)(void*);
+    Cleanup* next;
+};
+
+namespace {
+
+char* alignUp(char* ptr, size_t alignment) {
+    const uintptr_t mask = alignment - 1;
+    return reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(ptr) + mask) & ~mask);
+}
+
+}  // namespace
+
+Arena::Scope::Scope(Arena* arena)
+    : _arena(arena),
+      _chunk(arena->_current),
+      _next(arena->_next),
+      _end(arena->_end),
+      _cleanups(arena->_cleanups),
+      _depth(++arena->_scopeDepth) {}
+
+Arena::Scope::~Scope() {
+    invariant(_arena->_scopeDepth == _depth);
+    --_arena->_scopeDepth;
+
+    _arena->runCleanups(_cleanups);
+
+    // Rewind to where the Scope began. Chunks started since then stay on the list, after
+    // '_current', to be reused.
+    if (_chunk) {
+        _arena->_current = _chunk;
+        _arena->_next = _next;
+        _arena->_end = _end;
+    } else if (_arena->_first) {
+        _arena->_current = _arena->_first;
+        _arena->_next = _arena->_first->begin();
+        _arena->_end = _arena->_first->end();
+    }
+}
+
+Arena::~Arena() {
+    invariant(_scopeDepth == 0);
+    runCleanups(nullptr);
+
+    Chunk* chunk = _first;
+    while (chunk) {
+        Chunk* next = chunk->next;
+        std::free(chunk);
+        chunk = next;
+    }
+}
+
+void* Arena::allocate(size_t bytes, size_t alignment) {
+    dassert(alignment && (alignment & (alignment - 1)) == 0);
+    dassert(alignment <= kMaxAlignment);
+
+    char* start = _next ? alignUp(_next, alignment) : nullptr;
+    if (!start || static_cast<size_t>(_end - start) < bytes) {
+        nextChunk(bytes, alignment);
+        start = alignUp(_next, alignment);
+    }
+
+    _next = start + bytes;
+    ++_stats.allocations;
+    _stats.bytesAllocated += bytes;
+    return start;
+}
+
+void Arena::nextChunk(size_t bytes, size_t alignment) {
+    // Leave room to align the allocation at the start of the chunk.
+    const size_t needed = bytes + alignment - 1;
+
+    if (_current && _current->next && _current->next->size >= needed) {
+        _current = _current->next;
+    } else {
+        const size_t lastSize = _current ? _current->size : kMinChunkBytes / 2;
+        const size_t size = std::max(needed, std::min(lastSize * 2, kMaxChunkBytes));
+
+        void* memory = std::malloc(sizeof(Chunk) + size);
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+
+        Chunk* chunk = static_cast<Chunk*>(memory);
+        chunk->size = size;
+        if (_current) {
+            // Insert after '_current', ahead of any chunks too small to have been reused.
+            chunk->next = _current->next;
+            _current->next = chunk;
+        } else {
+            chunk->next = _first;
+            _first = chunk;
+        }
+        _current = chunk;
+
+        ++_stats.chunksAllocated;
+        _stats.bytesReserved += size;
+    }
+
+    _next = _current->begin();
+    _end = _current->end();
+}
+
+void Arena::addCleanup(void* obj, void (*destroy)(void*)) {
+    Cleanup* cleanup = static_cast<Cleanup*>(allocate(sizeof(Cleanup), alignof(Cleanup)));
+    cleanup->obj = obj;
+    cleanup->destroy = destroy;
+    cleanup->next = _cleanups;
+    _cleanups = cleanup;
+}
+
+void Arena::runCleanups(Cleanup* stopAt) {
+    while (_cleanups != stopAt) {
+        Cleanup* cleanup = _cleanups;
+        _cleanups = cleanup->next;
+        cleanup->destroy(cleanup->obj);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,199 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "mongo/base/disallow_copying.h"
+
+namespace mongo {
+
+/**
+ * A region allocator for many small objects with a common lifetime. Allocation bumps a pointer
+ * through chunks obtained from the heap, and nothing is freed individually: everything is freed
+ * at once when the Arena is destroyed, or when an enclosing Arena::Scope ends.
+ *
+ * Objects created with make() have their destructors run when their memory is released, in the
+ * reverse order of creation. Memory from allocate() or ArenaAllocator is released without running
+ * any destructors.
+ *
+ * Not thread safe.
+ */
+class Arena {
+    MONGO_DISALLOW_COPYING(Arena);
+    struct Chunk;
+    struct Cleanup;
+
+public:
+    /**
+     * Counters describing the use of an Arena over its whole lifetime.
+     */
+    struct Stats {
+        // Number of calls to allocate(), including those made by make() and ArenaAllocator.
+        uint64_t allocations = 0;
+
+        // Bytes handed out by allocate(), not counting alignment padding.
+        uint64_t bytesAllocated = 0;
+
+        // Number of chunks obtained from the heap, and their total size.
+        uint64_t chunksAllocated = 0;
+        uint64_t bytesReserved = 0;
+    };
+
+    /**
+     * Marks the current end of an Arena. When the Scope ends, everything allocated from the Arena
+     * since the Scope began is released for reuse, running the destructors of objects created
+     * with make(). The Arena keeps its chunks, so code which allocates in a loop within a Scope
+     * stops obtaining memory from the heap after the first pass.
+     *
+     * Scopes on one Arena must nest.
+     */
+    class Scope {
+        MONGO_DISALLOW_COPYING(Scope);
+
+    public:
+        explicit Scope(Arena* arena);
+        ~Scope();
+
+    private:
+        Arena* const _arena;
+        Chunk* const _chunk;
+        char* const _next;
+        char* const _end;
+        Cleanup* const _cleanups;
+        const int _depth;
+    };
+
+    // The strictest alignment allocate() supports.
+    static const size_t kMaxAlignment = 16;
+
+    // The size of the first chunk. Each later chunk doubles in size, up to kMaxChunkBytes.
+    static const size_t kMinChunkBytes = 1024;
+    static const size_t kMaxChunkBytes = 64 * 1024;
+
+    Arena() = default;
+    ~Arena();
+
+    /**
+     * Returns 'bytes' of uninitialized memory aligned to 'alignment', which must be a power of two
+     * no larger than kMaxAlignment.
+     */
+    void* allocate(size_t bytes, size_t alignment = kMaxAlignment);
+
+    /**
+     * Constructs a T in memory from this Arena. The caller must not delete the result: it is
+     * destroyed when its memory is released.
+     */
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        void* storage = allocate(sizeof(T), alignof(T));
+        T* obj = new (storage) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value) {
+            addCleanup(obj, [](void* p) { static_cast<T*>(p)->~T(); });
+        }
+        return obj;
+    }
+
+    const Stats& stats() const {
+        return _stats;
+    }
+
+private:
+    void addCleanup(void* obj, void (*destroy)(void*));
+
+    /**
+     * Runs the destructors registered after 'stopAt', most recent first.
+     */
+    void runCleanups(Cleanup* stopAt);
+
+    /**
+     * Makes a chunk with room for 'bytes' aligned to 'alignment' the current chunk, reusing the
+     * next chunk in the list if it is large enough.
+     */
+    void nextChunk(size_t bytes, size_t alignment);
+
+    // Chunks form a singly linked list in the order in which they were first used. '_current' is
+    // the chunk being allocated from; chunks after it were released by a Scope and will be reused.
+    Chunk* _first = nullptr;
+    Chunk* _current = nullptr;
+    char* _next = nullptr;
+    char* _end = nullptr;
+
+    // Destructors to run, most recently registered first.
+    Cleanup* _cleanups = nullptr;
+
+    // Number of live Scopes, to check that they nest.
+    int _scopeDepth = 0;
+
+    Stats _stats;
+};
+
+/**
+ * A standard allocator drawing from an Arena, for containers whose elements share the Arena's
+ * lifetime. Deallocation does nothing; the memory is reclaimed with the rest of the Arena.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(Arena* arena) : _arena(arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : _arena(other.arena()) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {}
+
+    Arena* arena() const {
+        return _arena;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const {
+        return _arena == other.arena();
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const {
+        return _arena != other.arena();
+    }
+
+private:
+    Arena* _arena;
+};
+
+}  // namespace mongo
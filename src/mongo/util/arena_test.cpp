@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/arena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+// Records its destruction in a shared log.
+class Tracked {
+public:
+    Tracked(std::vector<int>* log, int id) : _log(log), _id(id) {}
+    ~Tracked() {
+        _log->push_back(_id);
+    }
+
+private:
+    std::vector<int>* const _log;
+    const int _id;
+};
+
+bool isAligned(const void* ptr, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST(ArenaTest, AllocationsAreAlignedAndDistinct) {
+    Arena arena;
+    char* last = nullptr;
+    for (size_t i = 1; i < 200; ++i) {
+        const size_t alignment = size_t(1) << (i % 5);
+        char* ptr = static_cast<char*>(arena.allocate(i, alignment));
+        ASSERT(isAligned(ptr, alignment));
+        memset(ptr, 'x', i);
+        ASSERT_NOT_EQUALS(last, ptr);
+        last = ptr;
+    }
+    ASSERT_EQUALS(199U, arena.stats().allocations);
+    ASSERT_EQUALS(199U * 200U / 2U, arena.stats().bytesAllocated);
+    ASSERT_GREATER_THAN(arena.stats().chunksAllocated, 1U);
+}
+
+TEST(ArenaTest, LargeAllocationsGetTheirOwnChunk) {
+    Arena arena;
+    arena.allocate(8);
+    const size_t big = 4 * Arena::kMaxChunkBytes;
+    char* ptr = static_cast<char*>(arena.allocate(big));
+    memset(ptr, 'x', big);
+    ASSERT_GREATER_THAN_OR_EQUALS(arena.stats().bytesReserved, big);
+}
+
+TEST(ArenaTest, DestructorsRunInReverseOrder) {
+    std::vector<int> log;
+    {
+        Arena arena;
+        arena.make<Tracked>(&log, 1);
+        ASSERT_EQUALS(7, *arena.make<int>(7));
+        arena.make<Tracked>(&log, 2);
+        arena.make<std::string>(1000, 'x');
+        ASSERT(log.empty());
+    }
+    ASSERT_EQUALS(2U, log.size());
+    ASSERT_EQUALS(2, log[0]);
+    ASSERT_EQUALS(1, log[1]);
+}
+
+TEST(ArenaTest, ScopeReleasesAndReusesMemory) {
+    std::vector<int> log;
+    Arena arena;
+    arena.make<Tracked>(&log, 0);
+
+    uint64_t chunksAfterFirstPass = 0;
+    for (int pass = 0; pass < 10; ++pass) {
+        {
+            Arena::Scope scope(&arena);
+            for (int i = 0; i < 1000; ++i) {
+                arena.make<Tracked>(&log, 1);
+            }
+            {
+                Arena::Scope inner(&arena);
+                arena.make<Tracked>(&log, 2);
+            }
+            ASSERT_EQUALS(2, log.back());
+        }
+        ASSERT_EQUALS(1001U * (pass + 1), log.size());
+
+        if (pass == 0) {
+            chunksAfterFirstPass = arena.stats().chunksAllocated;
+        }
+        ASSERT_EQUALS(chunksAfterFirstPass, arena.stats().chunksAllocated);
+    }
+
+    // Objects made outside of any Scope last as long as the Arena.
+    ASSERT_EQUALS(0, std::count(log.begin(), log.end(), 0));
+}
+
+TEST(ArenaTest, ScopeOnEmptyArena) {
+    Arena arena;
+    {
+        Arena::Scope scope(&arena);
+        arena.allocate(Arena::kMaxChunkBytes);
+        arena.allocate(Arena::kMaxChunkBytes);
+    }
+    const uint64_t chunks = arena.stats().chunksAllocated;
+    {
+        Arena::Scope scope(&arena);
+        arena.allocate(Arena::kMaxChunkBytes);
+        arena.allocate(Arena::kMaxChunkBytes);
+    }
+    ASSERT_EQUALS(chunks, arena.stats().chunksAllocated);
+}
+
+TEST(ArenaTest, ArenaAllocatorBacksContainers) {
+    Arena arena;
+    std::vector<int, ArenaAllocator<int>> values{ArenaAllocator<int>(&arena)};
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+    ASSERT_EQUALS(999, values.back());
+    ASSERT_GREATER_THAN(arena.stats().allocations, 1U);
+}
+
+}  // namespace
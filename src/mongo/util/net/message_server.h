@@ -36,10 +36,21 @@
 
 #include "mongo/platform/basic.h"
 
+#include <memory>
+
 namespace mongo {
 
 class MessageHandler {
 public:
+    /**
+     * Opaque per-connection state that a handler moves off of the calling thread between
+     * messages, when the server multiplexes connections over a pool of worker threads.
+     */
+    class ConnectionState {
+    public:
+        virtual ~ConnectionState() {}
+    };
+
     virtual ~MessageHandler() {}
 
     /**
@@ -52,6 +63,23 @@ public:
      * handler is responsible for responding to client
      */
     virtual void process(Message& m, AbstractMessagingPort* p) = 0;
+
+    /**
+     * Only used when connections are multiplexed over a pool of worker threads.
+     *
+     * Called after connected() or process() returns, to detach whatever thread-local state the
+     * handler keeps for "p" from the calling thread. The returned state is handed back to
+     * resume() on whichever thread processes the next message for "p", and is destroyed when the
+     * connection closes.
+     */
+    virtual std::unique_ptr<ConnectionState> suspend(AbstractMessagingPort* p) {
+        return {};
+    }
+
+    /**
+     * Reattaches state previously returned by suspend() to the calling thread.
+     */
+    virtual void resume(std::unique_ptr<ConnectionState> state, AbstractMessagingPort* p) {}
 };
 
 class MessageServer {
@@ -31,18 +31,29 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+#include <deque>
+#include <limits>
 #include <memory>
+#include <sstream>
 #include <system_error>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/init.h"
 #include "mongo/config.h"
 #include "mongo/db/lasterror.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/unordered_set.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/concurrency/synchronization.h"
 #include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/exit.h"
@@ -53,9 +64,13 @@
 #include "mongo/util/net/message_port.h"
 #include "mongo/util/net/message_server.h"
 #include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/net/ssl_options.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 #ifdef __linux__  // TODO: consider making this ifndef _WIN32
+#include <sys/epoll.h>
 #include <sys/resource.h>
 #endif
 
@@ -70,6 +85,60 @@ using std::endl;
 
 namespace {
 
+const char kListenerModeThreadPerConnection[] = "threadPerConnection";
+const char kListenerModeWorkerPool[] = "workerPool";
+
+}  // namespace
+
+/**
+ * How accepted connections are serviced. In "threadPerConnection" mode every connection gets a
+ * dedicated thread. In "workerPool" mode (Linux only) idle connections are multiplexed over a
+ * single epoll instance and each complete request is dispatched to a pool of worker threads.
+ */
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(listenerMode, std::string, kListenerModeThreadPerConnection);
+
+/**
+ * Number of worker threads kept alive in "workerPool" mode. Zero means one per core.
+ */
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(listenerWorkerThreads, int, 0);
+
+/**
+ * Number of requests the worker pool processes at once in "workerPool" mode. Further requests
+ * wait for one of them to finish. Zero means four times listenerWorkerThreads.
+ */
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(listenerMaxWorkerThreads, int, 0);
+
+/**
+ * A request which has been processed for longer than this stops counting against
+ * listenerMaxWorkerThreads, so that requests which block for a long time (awaitData getMores,
+ * writes waiting behind fsyncLock, w:majority waits) cannot keep the others from being serviced.
+ */
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(listenerBlockingRequestMillis, int, 100);
+
+MONGO_INITIALIZER(listenerMode)(InitializerContext*) {
+    if (listenerMode != kListenerModeThreadPerConnection &&
+        listenerMode != kListenerModeWorkerPool) {
+        return Status(ErrorCodes::BadValue, "unsupported listenerMode: " + listenerMode);
+    }
+#ifndef __linux__
+    if (listenerMode == kListenerModeWorkerPool) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "listenerMode " << kListenerModeWorkerPool
+                                    << " is only supported on Linux");
+    }
+#endif
+    if (listenerWorkerThreads < 0 || listenerMaxWorkerThreads < 0) {
+        return Status(ErrorCodes::BadValue,
+                      "listenerWorkerThreads and listenerMaxWorkerThreads must not be negative");
+    }
+    if (listenerBlockingRequestMillis <= 0) {
+        return Status(ErrorCodes::BadValue, "listenerBlockingRequestMillis must be positive");
+    }
+    return Status::OK();
+}
+
+namespace {
+
 class MessagingPortWithHandler : public MessagingPort {
     MONGO_DISALLOW_COPYING(MessagingPortWithHandler);
 
@@ -90,6 +159,452 @@ private:
     MessageHandler* const _handler;
 };
 
+/**
+ * Runs "work" against "port", which must return whether servicing the connection should go on.
+ * Assertions and socket errors thrown by "work" close the connection, any other exception
+ * terminates the process.
+ *
+ * Returns false if the connection has been closed.
+ */
+template <typename Work>
+bool closeConnectionOnError(MessagingPortWithHandler* port, const Work& work) {
+    try {
+        return work();
+    } catch (AssertionException& e) {
+        log() << "AssertionException handling request, closing client connection: " << e << endl;
+    } catch (SocketException& e) {
+        log() << "SocketException handling request, closing client connection: " << e << endl;
+    } catch (const DBException& e) {  // must be right above std::exception to avoid catching
+                                      // subclasses
+        log() << "DBException handling request, closing client connection: " << e << endl;
+    } catch (std::exception& e) {
+        error() << "Uncaught std::exception: " << e.what() << ", terminating" << endl;
+        dbexit(EXIT_UNCAUGHT);
+    }
+    port->shutdown();
+    return false;
+}
+
+/**
+ * Logs that the remote end of "port" closed the connection.
+ */
+void logEndConnection(MessagingPortWithHandler* port) {
+    if (!serverGlobalParams.quiet) {
+        int conns = Listener::globalTicketHolder.used() - 1;
+        const char* word = (conns == 1 ? " connection" : " connections");
+        log() << "end connection " << port->psock->remoteString() << " (" << conns << word
+              << " now open)" << endl;
+    }
+}
+
+/**
+ * Receives the next message from "port" into "m" and hands it to the port's handler.
+ *
+ * Returns false if the remote end closed the connection or sent an invalid message.
+ */
+bool receiveAndProcess(MessagingPortWithHandler* port, Message& m) {
+    m.reset();
+    port->psock->clearCounters();
+
+    if (!port->recv(m)) {
+        logEndConnection(port);
+        port->shutdown();
+        return false;
+    }
+
+    port->getHandler()->process(m, port);
+    networkCounter.hit(port->psock->getBytesIn(), port->psock->getBytesOut());
+    return true;
+}
+
+#ifdef __linux__
+/**
+ * Services connections without dedicating a thread to each of them.
+ *
+ * Sockets are registered with a single epoll instance, watched by one poller thread. The poller
+ * reads each request without blocking, so that a client which sends a message slowly, or only
+ * part of it, never holds up a worker. Once a message is complete, it is handed to a pool of
+ * worker threads, which processes it with the MessageHandler and re-arms the socket. Sockets are
+ * registered with EPOLLONESHOT, so a connection is owned by at most one thread at a time and its
+ * requests are still processed in order.
+ *
+ * At most "maxRequests" requests are processed at once, and the rest wait in a queue. A request
+ * which runs for longer than listenerBlockingRequestMillis no longer counts against that limit,
+ * and the pool grows by a thread to take its place. Otherwise requests which block until another
+ * request comes in, such as writes waiting for fsyncUnlock, could deadlock the server.
+ *
+ * Thread-local handler state (such as the Client) is moved between workers with
+ * MessageHandler::suspend() and MessageHandler::resume().
+ */
+class EpollConnectionDispatcher {
+    MONGO_DISALLOW_COPYING(EpollConnectionDispatcher);
+
+public:
+    EpollConnectionDispatcher(size_t minWorkers, size_t maxRequests)
+        : _workers(_makePoolOptions(minWorkers)), _maxRequests(maxRequests) {
+        _epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (_epollFd < 0) {
+            int err = errno;
+            severe() << "epoll_create1 failed: " << errnoWithDescription(err);
+            fassertFailed(28793);
+        }
+    }
+
+    ~EpollConnectionDispatcher() {
+        _inShutdown.store(true);
+        if (_poller.joinable()) {
+            _poller.join();
+        }
+        _workers.shutdown();
+        _workers.join();
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (Connection* conn : _connections) {
+            delete conn;
+            Listener::globalTicketHolder.release();
+        }
+        ::close(_epollFd);
+    }
+
+    void startup() {
+        _workers.startup();
+        _poller = stdx::thread(stdx::bind(&EpollConnectionDispatcher::_pollLoop, this));
+    }
+
+    /**
+     * Takes ownership of a newly accepted connection, for which the caller acquired a ticket
+     * from Listener::globalTicketHolder. The ticket is released once the connection closes.
+     */
+    void add(std::unique_ptr<MessagingPortWithHandler> port) {
+        port->psock->setLogLevel(logger::LogSeverity::Debug(1));
+        Connection* conn = new Connection(std::move(port));
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _connections.insert(conn);
+        }
+        Status status = _workers.schedule(
+            stdx::bind(&EpollConnectionDispatcher::_onConnected, this, conn));
+        if (!status.isOK()) {
+            log() << "failed to dispatch new connection, closing it: " << status;
+            conn->port->shutdown();
+            _close(conn);
+        }
+    }
+
+private:
+    struct Connection {
+        explicit Connection(std::unique_ptr<MessagingPortWithHandler> p) : port(std::move(p)) {}
+
+        std::unique_ptr<MessagingPortWithHandler> port;
+        std::unique_ptr<MessageHandler::ConnectionState> state;
+
+        // The request being read by the poller, and then processed by a worker. The header is
+        // read into "header" and the whole message, once its length is known, into "message".
+        MSGHEADER::Value header;
+        Message message;
+        size_t bytesRead = 0;
+
+        // When a worker started processing "message", and whether it has been running for long
+        // enough not to count against _maxRequests anymore.
+        Date_t started;
+        bool blocking = false;
+    };
+
+    // What the poller did with a connection whose socket became readable.
+    enum ReadResult { kPartialMessage, kCompleteMessage, kClosed };
+
+    static ThreadPool::Options _makePoolOptions(size_t minWorkers) {
+        ThreadPool::Options options;
+        options.poolName = "listenerWorkers";
+        options.threadNamePrefix = "listenerWorker";
+        options.minThreads = minWorkers;
+        // Concurrency is bounded by _maxRequests, except for requests which are blocked.
+        options.maxThreads = std::numeric_limits<size_t>::max();
+        return options;
+    }
+
+    void _pollLoop() {
+        setThreadName("listenerPoller");
+
+        const int kMaxEvents = 256;
+        const int kPollTimeoutMillis = std::min(listenerBlockingRequestMillis, 500);
+        struct epoll_event events[kMaxEvents];
+
+        while (!_inShutdown.load() && !inShutdown()) {
+            int n = epoll_wait(_epollFd, events, kMaxEvents, kPollTimeoutMillis);
+            if (n < 0) {
+                int err = errno;
+                if (err == EINTR) {
+                    continue;
+                }
+                severe() << "epoll_wait failed: " << errnoWithDescription(err);
+                fassertFailed(28794);
+            }
+            for (int i = 0; i < n; ++i) {
+                Connection* conn = static_cast<Connection*>(events[i].data.ptr);
+                switch (_read(conn)) {
+                    case kPartialMessage:
+                        _arm(conn, EPOLL_CTL_MOD);
+                        break;
+                    case kCompleteMessage:
+                        _enqueue(conn);
+                        break;
+                    case kClosed:
+                        conn->port->shutdown();
+                        _close(conn);
+                        break;
+                }
+            }
+            _releaseBlockedRequests();
+        }
+    }
+
+    /**
+     * Reads as much of the next message on "conn" as is available without blocking. Only reads
+     * up to the end of that message, so that pipelined requests stay in the socket until the
+     * previous one has been processed.
+     */
+    ReadResult _read(Connection* conn) {
+        MessagingPortWithHandler* port = conn->port.get();
+        const size_t headerLen = sizeof(MSGHEADER::Value);
+
+        while (true) {
+            char* buf;
+            size_t wanted;
+            if (conn->bytesRead < headerLen) {
+                buf = reinterpret_cast<char*>(&conn->header) + conn->bytesRead;
+                wanted = headerLen - conn->bytesRead;
+            } else {
+                buf = conn->message.buf() + conn->bytesRead;
+                wanted = conn->message.header().getLen() - conn->bytesRead;
+            }
+
+            ssize_t n = ::recv(port->psock->rawFD(), buf, wanted, MSG_DONTWAIT);
+            if (n < 0) {
+                int err = errno;
+                if (err == EINTR) {
+                    continue;
+                }
+                if (err == EAGAIN || err == EWOULDBLOCK) {
+                    return kPartialMessage;
+                }
+                LOG(port->psock->getLogLevel()) << "SocketException: remote: " << port->remote()
+                                                << " error: " << errnoWithDescription(err);
+                return kClosed;
+            }
+            if (n == 0) {
+                logEndConnection(port);
+                return kClosed;
+            }
+
+            conn->bytesRead += n;
+            if (conn->bytesRead == headerLen && !_startMessage(conn)) {
+                return kClosed;
+            }
+            if (conn->bytesRead >= headerLen &&
+                conn->bytesRead == static_cast<size_t>(conn->message.header().getLen())) {
+                return kCompleteMessage;
+            }
+        }
+    }
+
+    /**
+     * Validates the header of the message being read on "conn", as MessagingPort::recv() does,
+     * and allocates room for the rest of the message. Returns false if the connection must be
+     * closed.
+     */
+    bool _startMessage(Connection* conn) {
+        MessagingPortWithHandler* port = conn->port.get();
+        const int len = conn->header.constView().getMessageLength();
+
+        if (len == 542393671) {
+            // An http GET. The reply is small enough to fit in the empty send buffer of the
+            // socket, so sending it does not block the poller.
+            std::string msg =
+                "It looks like you are trying to access MongoDB over HTTP on the native driver "
+                "port.\n";
+            LOG(port->psock->getLogLevel()) << msg;
+            std::stringstream ss;
+            ss << "HTTP/1.0 200 OK\r\nConnection: close\r\nContent-Type: "
+                  "text/plain\r\nContent-Length: " << msg.size() << "\r\n\r\n" << msg;
+            std::string s = ss.str();
+            closeConnectionOnError(port, [&] {
+                port->send(s.c_str(), s.size(), "http");
+                return true;
+            });
+            return false;
+        }
+        if (port->psock->isAwaitingHandshake() && conn->header.constView().getResponseTo() != 0 &&
+            conn->header.constView().getResponseTo() != -1) {
+            log() << "SSL handshake received but the server does not accept SSL on this port, "
+                  << "closing connection from " << port->remote();
+            return false;
+        }
+        if (static_cast<size_t>(len) < sizeof(MSGHEADER::Value) ||
+            static_cast<size_t>(len) > MaxMessageSizeBytes) {
+            LOG(0) << "recv(): message len " << len << " is invalid. "
+                   << "Min " << sizeof(MSGHEADER::Value) << " Max: " << MaxMessageSizeBytes;
+            return false;
+        }
+        port->psock->setHandshakeReceived();
+
+        int z = (len + 1023) & 0xfffffc00;
+        verify(z >= len);
+        char* data = reinterpret_cast<char*>(mongoMalloc(z));
+        memcpy(data, &conn->header, sizeof(MSGHEADER::Value));
+        conn->message.setData(data, true);
+        return true;
+    }
+
+    /**
+     * Hands the complete message read on "conn" to a worker, or queues it if _maxRequests
+     * requests are already being processed.
+     */
+    void _enqueue(Connection* conn) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _pending.push_back(conn);
+        _dispatchPending_inlock();
+    }
+
+    void _dispatchPending_inlock() {
+        while (!_pending.empty() && _numRequests < _maxRequests) {
+            Connection* conn = _pending.front();
+            _pending.pop_front();
+
+            conn->started = Date_t::now();
+            conn->blocking = false;
+            _running.insert(conn);
+            ++_numRequests;
+
+            Status status =
+                _workers.schedule(stdx::bind(&EpollConnectionDispatcher::_onMessage, this, conn));
+            if (!status.isOK()) {
+                // Only fails once the pool is shutting down, and the destructor then closes
+                // every connection.
+                log() << "failed to dispatch request: " << status;
+                _running.erase(conn);
+                --_numRequests;
+                return;
+            }
+        }
+    }
+
+    /**
+     * Stops counting requests which have been running for listenerBlockingRequestMillis against
+     * _maxRequests, and dispatches queued requests in their place.
+     */
+    void _releaseBlockedRequests() {
+        const Date_t now = Date_t::now();
+        const Milliseconds threshold(listenerBlockingRequestMillis);
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (Connection* conn : _running) {
+            if (!conn->blocking && now - conn->started >= threshold) {
+                LOG(1) << "request from " << conn->port->remote() << " has been running for "
+                       << (now - conn->started) << ", not counting it against the "
+                       << _maxRequests << " requests processed at once";
+                conn->blocking = true;
+                --_numRequests;
+            }
+        }
+        _dispatchPending_inlock();
+    }
+
+    void _onConnected(Connection* conn) {
+        MessagingPortWithHandler* port = conn->port.get();
+        MessageHandler* handler = port->getHandler();
+
+        bool connected = closeConnectionOnError(port, [&] {
+            handler->connected(port);
+            return true;
+        });
+
+        conn->state = handler->suspend(port);
+        if (connected) {
+            _arm(conn, EPOLL_CTL_ADD);
+        } else {
+            _close(conn);
+        }
+    }
+
+    void _onMessage(Connection* conn) {
+        MessagingPortWithHandler* port = conn->port.get();
+        MessageHandler* handler = port->getHandler();
+
+        handler->resume(std::move(conn->state), port);
+        port->psock->clearCounters();
+        bool keepOpen = !inShutdown() && closeConnectionOnError(port, [&] {
+            handler->process(conn->message, port);
+            networkCounter.hit(conn->bytesRead, port->psock->getBytesOut());
+            return true;
+        });
+        conn->message.reset();
+        conn->bytesRead = 0;
+
+        // The connection state must be detached before re-arming the socket, since the next
+        // request may be picked up by another worker as soon as it is.
+        conn->state = handler->suspend(port);
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _running.erase(conn);
+            if (!conn->blocking) {
+                --_numRequests;
+            }
+            _dispatchPending_inlock();
+        }
+        if (keepOpen) {
+            _arm(conn, EPOLL_CTL_MOD);
+        } else {
+            _close(conn);
+        }
+    }
+
+    void _arm(Connection* conn, int op) {
+        struct epoll_event event;
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        event.data.ptr = conn;
+        if (epoll_ctl(_epollFd, op, conn->port->psock->rawFD(), &event) != 0) {
+            int err = errno;
+            log() << "epoll_ctl failed, closing connection: " << errnoWithDescription(err);
+            conn->port->shutdown();
+            _close(conn);
+        }
+    }
+
+    void _close(Connection* conn) {
+        // The socket may never have been registered, so failures to deregister it are expected.
+        epoll_ctl(_epollFd, EPOLL_CTL_DEL, conn->port->psock->rawFD(), nullptr);
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _connections.erase(conn);
+        }
+        delete conn;
+        Listener::globalTicketHolder.release();
+    }
+
+    int _epollFd;
+    AtomicWord<bool> _inShutdown{false};
+    ThreadPool _workers;
+    stdx::thread _poller;
+
+    // Number of requests counted against the limit of requests processed at once.
+    const size_t _maxRequests;
+
+    stdx::mutex _mutex;
+
+    // Every connection owned by this dispatcher, so that they can be released on destruction.
+    unordered_set<Connection*> _connections;
+
+    // Connections with a complete message waiting for a worker, in arrival order.
+    std::deque<Connection*> _pending;
+
+    // Connections whose message is being processed by a worker, and how many of them are not
+    // blocking.
+    unordered_set<Connection*> _running;
+    size_t _numRequests = 0;
+};
+#endif  // __linux__
+
 }  // namespace
 
 class PortMessageServer : public MessageServer, public Listener {
@@ -102,7 +617,36 @@ public:
      *     and should make sure that it lives longer than this server.
      */
     PortMessageServer(const MessageServer::Options& opts, MessageHandler* handler)
-        : Listener("", opts.ipList, opts.port), _handler(handler) {}
+        : Listener("", opts.ipList, opts.port), _handler(handler) {
+#ifdef __linux__
+        if (listenerMode == kListenerModeWorkerPool) {
+#ifdef MONGO_CONFIG_SSL
+            if (sslGlobalParams.sslMode.load() != SSLParams::SSLMode_disabled) {
+                // Decrypted data buffered by OpenSSL is invisible to epoll, so a request could
+                // sit unprocessed on an idle socket.
+                warning() << "listenerMode " << kListenerModeWorkerPool
+                          << " does not support SSL, using one thread per connection";
+                return;
+            }
+#endif
+            size_t minWorkers = listenerWorkerThreads;
+            if (minWorkers == 0) {
+                ProcessInfo p;
+                minWorkers = std::max(p.getNumCores(), 1U);
+            }
+            size_t maxRequests = listenerMaxWorkerThreads;
+            if (maxRequests == 0) {
+                maxRequests = 4 * minWorkers;
+            }
+            maxRequests = std::max(maxRequests, minWorkers);
+
+            log() << "servicing connections with a pool of " << minWorkers
+                  << " worker threads, processing up to " << maxRequests << " requests at once";
+            _dispatcher = stdx::make_unique<EpollConnectionDispatcher>(minWorkers, maxRequests);
+            _dispatcher->startup();
+        }
+#endif  // __linux__
+    }
 
     virtual void accepted(std::shared_ptr<Socket> psocket, long long connectionId) {
         ScopeGuard sleepAfterClosingPort = MakeGuard(sleepmillis, 2);
@@ -115,6 +659,14 @@ public:
             return;
         }
 
+#ifdef __linux__
+        if (_dispatcher) {
+            _dispatcher->add(std::move(portWithHandler));
+            sleepAfterClosingPort.Dismiss();
+            return;
+        }
+#endif
+
         try {
 #ifndef __linux__  // TODO: consider making this ifdef _WIN32
             {
@@ -183,6 +735,11 @@ public:
 private:
     MessageHandler* _handler;
 
+#ifdef __linux__
+    // Set when connections are multiplexed over a worker pool rather than given their own thread.
+    std::unique_ptr<EpollConnectionDispatcher> _dispatcher;
+#endif
+
     /**
      * Handles incoming messages from a given socket.
      *
@@ -208,48 +765,21 @@ private:
 
         Message m;
         int64_t counter = 0;
-        try {
+        closeConnectionOnError(portWithHandler.get(), [&] {
             handler->connected(portWithHandler.get());
 
             while (!inShutdown()) {
-                m.reset();
-                portWithHandler->psock->clearCounters();
-
-                if (!portWithHandler->recv(m)) {
-                    if (!serverGlobalParams.quiet) {
-                        int conns = Listener::globalTicketHolder.used() - 1;
-                        const char* word = (conns == 1 ? " connection" : " connections");
-                        log() << "end connection " << portWithHandler->psock->remoteString() << " ("
-                              << conns << word << " now open)" << endl;
-                    }
-                    portWithHandler->shutdown();
+                if (!receiveAndProcess(portWithHandler.get(), m)) {
                     break;
                 }
 
-                handler->process(m, portWithHandler.get());
-                networkCounter.hit(portWithHandler->psock->getBytesIn(),
-                                   portWithHandler->psock->getBytesOut());
-
                 // Occasionally we want to see if we're using too much memory.
                 if ((counter++ & 0xf) == 0) {
                     markThreadIdle();
                 }
             }
-        } catch (AssertionException& e) {
-            log() << "AssertionException handling request, closing client connection: " << e
-                  << endl;
-            portWithHandler->shutdown();
-        } catch (SocketException& e) {
-            log() << "SocketException handling request, closing client connection: " << e << endl;
-            portWithHandler->shutdown();
-        } catch (const DBException&
-                     e) {  // must be right above std::exception to avoid catching subclasses
-            log() << "DBException handling request, closing client connection: " << e << endl;
-            portWithHandler->shutdown();
-        } catch (std::exception& e) {
-            error() << "Uncaught std::exception: " << e.what() << ", terminating" << endl;
-            dbexit(EXIT_UNCAUGHT);
-        }
+            return true;
+        });
 
 // Normal disconnect path.
 #ifdef MONGO_CONFIG_SSL